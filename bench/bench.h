@@ -0,0 +1,92 @@
+#ifndef EAST_BENCH_H
+#define EAST_BENCH_H
+
+#include <east/builtins.h>
+#include <east/compiler.h>
+#include <east/ir.h>
+#include <east/platform.h>
+#include <east/types.h>
+#include <east/values.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Microbenchmark harness for the east-c runtime.
+ *
+ * A benchmark is a setup / run / teardown triple. setup() builds whatever
+ * the benchmark needs (IR programs, input values, encoded bytes) and
+ * reports how many operations and bytes a single run() processes; only
+ * run() is timed. The runner repeats run() after a warmup phase and
+ * reports the distribution of per-run times, normalised per operation.
+ */
+
+typedef struct {
+    double scale;           // multiplier for problem sizes (--quick uses 0.1)
+    size_t ops;             // set by setup: operations per run
+    size_t bytes;           // set by setup: bytes processed per run (0 = n/a)
+    size_t flops;           // set by setup: floating-point ops per run (0 = n/a)
+    const char *unit;       // set by setup: name of one operation
+    PlatformRegistry *platform;
+    BuiltinRegistry *builtins;
+} BenchContext;
+
+typedef void *(*BenchSetupFn)(BenchContext *ctx);
+typedef bool (*BenchRunFn)(void *state);
+typedef void (*BenchTeardownFn)(void *state);
+
+typedef struct BenchSuite BenchSuite;
+
+// Register a benchmark. Names are "group/name" and are used for --filter
+// and to match results against a baseline, so keep them stable.
+void bench_add(BenchSuite *suite, const char *name, BenchSetupFn setup,
+               BenchRunFn run, BenchTeardownFn teardown);
+
+void bench_register_eval(BenchSuite *suite);
+void bench_register_collections(BenchSuite *suite);
+void bench_register_strings(BenchSuite *suite);
+void bench_register_datetime(BenchSuite *suite);
+void bench_register_codecs(BenchSuite *suite);
+void bench_register_runtime(BenchSuite *suite);
+void bench_register_vectors(BenchSuite *suite);
+void bench_register_matrix(BenchSuite *suite);
+
+// Scale a problem size, never going below min.
+size_t bench_size(const BenchContext *ctx, size_t n, size_t min);
+
+/* ------------------------------------------------------------------ */
+/*  IR construction helpers                                            */
+/*                                                                     */
+/*  Unlike the ir_* builders these take ownership of their child nodes */
+/*  (and of literal values), so programs can be written as nested      */
+/*  expressions without tracking every intermediate reference.         */
+/* ------------------------------------------------------------------ */
+
+IRNode *b_int(int64_t v);
+IRNode *b_float(double v);
+IRNode *b_value(EastType *type, EastValue *v);
+IRNode *b_var(EastType *type, const char *name);
+IRNode *b_mvar(EastType *type, const char *name);
+IRNode *b_let(const char *name, IRNode *value);
+IRNode *b_let_mut(const char *name, IRNode *value);
+IRNode *b_assign(const char *name, IRNode *value);
+IRNode *b_block(EastType *type, IRNode **stmts, size_t n);
+IRNode *b_while(IRNode *cond, IRNode *body);
+IRNode *b_builtin(EastType *type, const char *name, EastType *tp,
+                  IRNode **args, size_t n);
+IRNode *b_call(EastType *type, IRNode *fn, IRNode **args, size_t n);
+IRNode *b_platform(EastType *type, const char *name, IRNode **args, size_t n);
+
+// "while i < n { body; i = i + 1 }" over a mutable counter named by var,
+// followed by result (which may be NULL for a Null-typed loop).
+IRNode *b_count_loop(const char *var, int64_t n, IRNode *body,
+                     EastType *result_type, IRNode *result);
+
+// A program compiled from a function node, with its parameters bound.
+EastCompiledFn *bench_compile(const BenchContext *ctx, IRNode *fn_node);
+
+// Call a compiled program, discarding the result. Returns false and
+// prints the error on failure.
+bool bench_call(EastCompiledFn *fn, EastValue **args, size_t n);
+
+#endif
@@ -0,0 +1,259 @@
+/*
+ * Serialization throughput: Beast2, JSON, CSV and East text, encoding and
+ * decoding the same table of flat records. Throughput is reported against
+ * the encoded size in each format. The *_floats variants use an
+ * Array<Float> of full-precision values instead, where number formatting
+ * and parsing dominate, and the *_numeric variants a table of records that
+ * are all numbers, as in a typical numeric CSV ingest. east_parse_stream
+ * reads the East text through a reader in STREAM_CHUNK-byte pieces.
+ */
+
+#include "bench.h"
+
+#include <east/serialization.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CODEC_ROWS 20000
+#define CODEC_FLOATS 100000
+#define STREAM_CHUNK 4096
+
+typedef enum { CODEC_BEAST2, CODEC_JSON, CODEC_CSV, CODEC_EAST } CodecKind;
+typedef enum { DATA_RECORDS, DATA_FLOATS, DATA_NUMERIC } CodecData;
+
+typedef struct {
+    CodecKind kind;
+    EastType *row_type;
+    EastType *table_type;
+    EastValue *table;
+    ByteBuffer *beast2;     // encoded forms, for the decode benchmarks
+    char *text;
+} CodecState;
+
+static void codec_teardown(void *state);
+
+static const char *row_fields[] = { "id", "name", "score", "active", "created" };
+static const char *numeric_fields[] = { "id", "x", "y", "z" };
+
+static EastValue *make_table(EastType *row_type, size_t rows)
+{
+    EastValue *table = east_array_new(row_type);
+    for (size_t i = 0; i < rows; i++) {
+        char name[32];
+        snprintf(name, sizeof(name), "user-%zu", i * 7919 % 100000);
+        EastValue *vals[] = {
+            east_integer((int64_t)i),
+            east_string(name),
+            east_float((double)(i % 1000) / 8.0),
+            east_boolean(i % 3 == 0),
+            east_datetime(1700000000000LL + (int64_t)i * 60000),
+        };
+        EastValue *row = east_struct_new(row_fields, vals, 5, row_type);
+        for (int k = 0; k < 5; k++) east_value_release(vals[k]);
+        east_array_push(table, row);
+        east_value_release(row);
+    }
+    return table;
+}
+
+/* Doubles spread over many magnitudes, most needing 15-17 digits */
+static double next_float(uint64_t *x, size_t i)
+{
+    static const double scales[] = { 1e-3, 1.0, 1e3, 1e6, 1e12, 1e-9 };
+    *x ^= *x << 13; *x ^= *x >> 7; *x ^= *x << 17;
+    double mantissa = (double)(*x >> 11) / 9007199254740992.0 - 0.5;
+    return mantissa * scales[i % 6];
+}
+
+static EastValue *make_floats(size_t n)
+{
+    EastValue *arr = east_array_new(&east_float_type);
+    uint64_t x = 88172645463325252ULL;
+    for (size_t i = 0; i < n; i++) {
+        EastValue *v = east_float(next_float(&x, i));
+        east_array_push(arr, v);
+        east_value_release(v);
+    }
+    return arr;
+}
+
+/* {id: Integer, x: Float, y: Float, z: Float} with large ids */
+static EastValue *make_numeric(EastType *row_type, size_t rows)
+{
+    EastValue *table = east_array_new(row_type);
+    uint64_t x = 88172645463325252ULL;
+    for (size_t i = 0; i < rows; i++) {
+        EastValue *vals[] = {
+            east_integer((int64_t)(i * 2654435761u)),
+            east_float(next_float(&x, i)),
+            east_float(next_float(&x, i + 1)),
+            east_float(next_float(&x, i + 2)),
+        };
+        EastValue *row = east_struct_new(numeric_fields, vals, 4, row_type);
+        for (int k = 0; k < 4; k++) east_value_release(vals[k]);
+        east_array_push(table, row);
+        east_value_release(row);
+    }
+    return table;
+}
+
+static void *codec_setup(BenchContext *ctx, CodecKind kind, CodecData data)
+{
+    CodecState *s = calloc(1, sizeof(CodecState));
+    size_t rows;
+    s->kind = kind;
+    if (data == DATA_FLOATS) {
+        rows = bench_size(ctx, CODEC_FLOATS, 1000);
+        s->table_type = east_array_type(&east_float_type);
+        s->table = make_floats(rows);
+    } else if (data == DATA_NUMERIC) {
+        EastType *types[] = {
+            &east_integer_type, &east_float_type, &east_float_type, &east_float_type,
+        };
+        rows = bench_size(ctx, CODEC_ROWS, 100);
+        s->row_type = east_struct_type(numeric_fields, types, 4);
+        s->table_type = east_array_type(s->row_type);
+        s->table = make_numeric(s->row_type, rows);
+    } else {
+        EastType *types[] = {
+            &east_integer_type, &east_string_type, &east_float_type,
+            &east_boolean_type, &east_datetime_type,
+        };
+        rows = bench_size(ctx, CODEC_ROWS, 100);
+        s->row_type = east_struct_type(row_fields, types, 5);
+        s->table_type = east_array_type(s->row_type);
+        s->table = make_table(s->row_type, rows);
+    }
+
+    switch (kind) {
+    case CODEC_BEAST2:
+        s->beast2 = east_beast2_encode(s->table, s->table_type);
+        ctx->bytes = s->beast2->len;
+        break;
+    case CODEC_JSON:
+        s->text = east_json_encode(s->table, s->table_type);
+        break;
+    case CODEC_CSV:
+        s->text = east_csv_encode(s->table, s->table_type, NULL);
+        break;
+    case CODEC_EAST:
+        s->text = east_print_value(s->table, s->table_type);
+        break;
+    }
+    if (kind != CODEC_BEAST2) {
+        if (!s->text) {
+            codec_teardown(s);
+            return NULL;
+        }
+        ctx->bytes = strlen(s->text);
+    }
+    ctx->ops = rows;
+    ctx->unit = data == DATA_FLOATS ? "value" : "row";
+    return s;
+}
+
+static bool codec_encode_run(void *state)
+{
+    CodecState *s = state;
+    if (s->kind == CODEC_BEAST2) {
+        ByteBuffer *buf = east_beast2_encode(s->table, s->table_type);
+        if (!buf) return false;
+        byte_buffer_free(buf);
+        return true;
+    }
+    char *text = NULL;
+    switch (s->kind) {
+    case CODEC_JSON: text = east_json_encode(s->table, s->table_type); break;
+    case CODEC_CSV: text = east_csv_encode(s->table, s->table_type, NULL); break;
+    case CODEC_EAST: text = east_print_value(s->table, s->table_type); break;
+    default: break;
+    }
+    if (!text) return false;
+    free(text);
+    return true;
+}
+
+static bool codec_decode_run(void *state)
+{
+    CodecState *s = state;
+    EastValue *v = NULL;
+    switch (s->kind) {
+    case CODEC_BEAST2:
+        v = east_beast2_decode(s->beast2->data, s->beast2->len, s->table_type);
+        break;
+    case CODEC_JSON: v = east_json_decode(s->text, s->table_type); break;
+    case CODEC_CSV: v = east_csv_decode(s->text, s->table_type, NULL); break;
+    case CODEC_EAST: v = east_parse_value(s->text, s->table_type); break;
+    }
+    if (!v) return false;
+    east_value_release(v);
+    return true;
+}
+
+typedef struct {
+    const char *text;
+    size_t len;
+    size_t pos;
+} TextReader;
+
+static size_t read_chunk(void *ctx, char *buf, size_t cap)
+{
+    TextReader *r = ctx;
+    size_t n = r->len - r->pos;
+    if (n > STREAM_CHUNK) n = STREAM_CHUNK;
+    if (n > cap) n = cap;
+    memcpy(buf, r->text + r->pos, n);
+    r->pos += n;
+    return n;
+}
+
+static bool codec_stream_run(void *state)
+{
+    CodecState *s = state;
+    TextReader r = { s->text, strlen(s->text), 0 };
+    EastValue *v = east_parse_value_stream(read_chunk, &r, s->table_type, NULL);
+    if (!v) return false;
+    east_value_release(v);
+    return true;
+}
+
+static void codec_teardown(void *state)
+{
+    CodecState *s = state;
+    east_value_release(s->table);
+    if (s->beast2) byte_buffer_free(s->beast2);
+    free(s->text);
+    east_type_release(s->table_type);
+    if (s->row_type) east_type_release(s->row_type);
+    free(s);
+}
+
+static void *setup_beast2(BenchContext *ctx) { return codec_setup(ctx, CODEC_BEAST2, DATA_RECORDS); }
+static void *setup_json(BenchContext *ctx) { return codec_setup(ctx, CODEC_JSON, DATA_RECORDS); }
+static void *setup_csv(BenchContext *ctx) { return codec_setup(ctx, CODEC_CSV, DATA_RECORDS); }
+static void *setup_east(BenchContext *ctx) { return codec_setup(ctx, CODEC_EAST, DATA_RECORDS); }
+static void *setup_json_floats(BenchContext *ctx) { return codec_setup(ctx, CODEC_JSON, DATA_FLOATS); }
+static void *setup_east_floats(BenchContext *ctx) { return codec_setup(ctx, CODEC_EAST, DATA_FLOATS); }
+static void *setup_json_numeric(BenchContext *ctx) { return codec_setup(ctx, CODEC_JSON, DATA_NUMERIC); }
+static void *setup_csv_numeric(BenchContext *ctx) { return codec_setup(ctx, CODEC_CSV, DATA_NUMERIC); }
+
+void bench_register_codecs(BenchSuite *suite)
+{
+    bench_add(suite, "codecs/beast2_encode", setup_beast2, codec_encode_run, codec_teardown);
+    bench_add(suite, "codecs/beast2_decode", setup_beast2, codec_decode_run, codec_teardown);
+    bench_add(suite, "codecs/json_encode", setup_json, codec_encode_run, codec_teardown);
+    bench_add(suite, "codecs/json_decode", setup_json, codec_decode_run, codec_teardown);
+    bench_add(suite, "codecs/csv_encode", setup_csv, codec_encode_run, codec_teardown);
+    bench_add(suite, "codecs/csv_decode", setup_csv, codec_decode_run, codec_teardown);
+    bench_add(suite, "codecs/east_print", setup_east, codec_encode_run, codec_teardown);
+    bench_add(suite, "codecs/east_parse", setup_east, codec_decode_run, codec_teardown);
+    bench_add(suite, "codecs/east_parse_stream", setup_east, codec_stream_run, codec_teardown);
+    bench_add(suite, "codecs/json_encode_floats", setup_json_floats, codec_encode_run, codec_teardown);
+    bench_add(suite, "codecs/json_decode_floats", setup_json_floats, codec_decode_run, codec_teardown);
+    bench_add(suite, "codecs/east_print_floats", setup_east_floats, codec_encode_run, codec_teardown);
+    bench_add(suite, "codecs/east_parse_floats", setup_east_floats, codec_decode_run, codec_teardown);
+    bench_add(suite, "codecs/json_decode_numeric", setup_json_numeric, codec_decode_run, codec_teardown);
+    bench_add(suite, "codecs/csv_decode_numeric", setup_csv_numeric, codec_decode_run, codec_teardown);
+}
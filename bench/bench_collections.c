@@ -0,0 +1,195 @@
+/*
+ * Collection benchmarks: Dict and Set insert/lookup through the value API,
+ * and ArraySort through the evaluator (key function calls included).
+ */
+
+#include "bench.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define COLLECTION_SIZE 50000
+#define SORT_SIZE 20000
+
+/* Deterministic shuffled keys so runs are comparable across machines. */
+static uint64_t lcg_next(uint64_t *state)
+{
+    *state = *state * 6364136223846793005ull + 1442695040888963407ull;
+    return *state >> 33;
+}
+
+typedef struct {
+    EastValue **keys;
+    size_t n;
+    EastValue *filled;      // collection pre-populated with every key
+    EastValue *value;       // dict value stored under every key
+    EastType *key_type;
+    bool is_set;
+} CollectionState;
+
+static EastValue *make_key(EastType *key_type, uint64_t k)
+{
+    if (key_type == &east_string_type) {
+        char buf[32];
+        snprintf(buf, sizeof(buf), "key-%08llu", (unsigned long long)k);
+        return east_string(buf);
+    }
+    return east_integer((int64_t)k);
+}
+
+static EastValue *collection_new(CollectionState *s)
+{
+    if (s->is_set) return east_set_new(s->key_type);
+    return east_dict_new(s->key_type, &east_integer_type);
+}
+
+static void collection_put(CollectionState *s, EastValue *c, EastValue *key)
+{
+    if (s->is_set) east_set_insert(c, key);
+    else east_dict_set(c, key, s->value);
+}
+
+static void *collection_setup(BenchContext *ctx, EastType *key_type, bool is_set)
+{
+    CollectionState *s = calloc(1, sizeof(CollectionState));
+    s->n = bench_size(ctx, COLLECTION_SIZE, 100);
+    s->key_type = key_type;
+    s->is_set = is_set;
+    s->keys = calloc(s->n, sizeof(EastValue *));
+    s->value = east_integer(1);
+
+    uint64_t seed = 42;
+    for (size_t i = 0; i < s->n; i++) s->keys[i] = make_key(key_type, lcg_next(&seed));
+
+    s->filled = collection_new(s);
+    for (size_t i = 0; i < s->n; i++) collection_put(s, s->filled, s->keys[i]);
+
+    ctx->ops = s->n;
+    return s;
+}
+
+static void collection_teardown(void *state)
+{
+    CollectionState *s = state;
+    for (size_t i = 0; i < s->n; i++) east_value_release(s->keys[i]);
+    free(s->keys);
+    east_value_release(s->filled);
+    east_value_release(s->value);
+    free(s);
+}
+
+static bool collection_insert_run(void *state)
+{
+    CollectionState *s = state;
+    EastValue *c = collection_new(s);
+    for (size_t i = 0; i < s->n; i++) collection_put(s, c, s->keys[i]);
+    east_value_release(c);
+    return true;
+}
+
+static bool collection_lookup_run(void *state)
+{
+    CollectionState *s = state;
+    size_t found = 0;
+    for (size_t i = 0; i < s->n; i++) {
+        if (s->is_set) found += east_set_has(s->filled, s->keys[i]);
+        else found += east_dict_has(s->filled, s->keys[i]);
+    }
+    return found == s->n;
+}
+
+static void *setup_dict_int(BenchContext *ctx)
+{
+    ctx->unit = "key";
+    return collection_setup(ctx, &east_integer_type, false);
+}
+
+static void *setup_dict_string(BenchContext *ctx)
+{
+    ctx->unit = "key";
+    return collection_setup(ctx, &east_string_type, false);
+}
+
+static void *setup_set_int(BenchContext *ctx)
+{
+    ctx->unit = "key";
+    return collection_setup(ctx, &east_integer_type, true);
+}
+
+/* ------------------------------------------------------------------ */
+/*  ArraySort(xs, fn(x) { x })                                         */
+/* ------------------------------------------------------------------ */
+
+typedef struct {
+    EastCompiledFn *fn;
+    EastValue *input;
+} SortState;
+
+static void *sort_setup(BenchContext *ctx, EastType *elem)
+{
+    SortState *s = calloc(1, sizeof(SortState));
+    size_t n = bench_size(ctx, SORT_SIZE, 100);
+
+    s->input = east_array_new(elem);
+    uint64_t seed = 7;
+    for (size_t i = 0; i < n; i++) {
+        EastValue *v = make_key(elem, lcg_next(&seed));
+        east_array_push(s->input, v);
+        east_value_release(v);
+    }
+
+    EastType *arr_type = east_array_type(elem);
+    EastType *key_fn_type = east_function_type(&elem, 1, elem);
+    IRVariable key_params[] = { { .name = "x", .mutable = false, .captured = false } };
+    IRNode *key_body = b_var(elem, "x");
+    IRNode *key_fn = ir_function(key_fn_type, NULL, 0, key_params, 1, key_body);
+    ir_node_release(key_body);
+
+    IRNode *args[] = { b_var(arr_type, "xs"), key_fn };
+    IRNode *body = b_builtin(arr_type, "ArraySort", elem, args, 2);
+
+    EastType *prog_type = east_function_type(&arr_type, 1, arr_type);
+    IRVariable params[] = { { .name = "xs", .mutable = false, .captured = false } };
+    IRNode *prog = ir_function(prog_type, NULL, 0, params, 1, body);
+    ir_node_release(body);
+
+    s->fn = bench_compile(ctx, prog);
+    ir_node_release(prog);
+    east_type_release(prog_type);
+    east_type_release(key_fn_type);
+    east_type_release(arr_type);
+
+    ctx->ops = n;
+    ctx->unit = "elem";
+    return s;
+}
+
+static bool sort_run(void *state)
+{
+    SortState *s = state;
+    EastValue *args[] = { s->input };
+    return bench_call(s->fn, args, 1);
+}
+
+static void sort_teardown(void *state)
+{
+    SortState *s = state;
+    east_compiled_fn_free(s->fn);
+    east_value_release(s->input);
+    free(s);
+}
+
+static void *setup_sort_int(BenchContext *ctx) { return sort_setup(ctx, &east_integer_type); }
+static void *setup_sort_string(BenchContext *ctx) { return sort_setup(ctx, &east_string_type); }
+
+void bench_register_collections(BenchSuite *suite)
+{
+    bench_add(suite, "collections/dict_insert_int", setup_dict_int, collection_insert_run, collection_teardown);
+    bench_add(suite, "collections/dict_lookup_int", setup_dict_int, collection_lookup_run, collection_teardown);
+    bench_add(suite, "collections/dict_insert_string", setup_dict_string, collection_insert_run, collection_teardown);
+    bench_add(suite, "collections/dict_lookup_string", setup_dict_string, collection_lookup_run, collection_teardown);
+    bench_add(suite, "collections/set_insert_int", setup_set_int, collection_insert_run, collection_teardown);
+    bench_add(suite, "collections/set_lookup_int", setup_set_int, collection_lookup_run, collection_teardown);
+    bench_add(suite, "collections/sort_int", setup_sort_int, sort_run, sort_teardown);
+    bench_add(suite, "collections/sort_string", setup_sort_string, sort_run, sort_teardown);
+}
@@ -0,0 +1,135 @@
+/*
+ * DateTime benchmarks over a column of timestamps between 1950 and 2050:
+ * printing and parsing with one ISO-style format, as when exporting a
+ * table, and splitting into calendar fields, either with one
+ * DateTimeComponents call or with year / month / day getters per value.
+ */
+
+#include "bench.h"
+
+#include <stdlib.h>
+
+#define DATETIME_ROWS 100000
+
+typedef enum {
+    DT_PRINT,
+    DT_PARSE,
+    DT_COMPONENTS,
+    DT_GETTERS,
+} DateTimeBench;
+
+typedef struct {
+    DateTimeBench which;
+    BuiltinImpl impl;
+    BuiltinImpl getters[3];
+    EastValue *format;
+    EastValue *array;       // DT_COMPONENTS: the column as one Array<DateTime>
+    EastValue **values;
+    size_t n;
+} DateTimeState;
+
+static void push_token(EastValue *fmt, const char *name, const char *lit)
+{
+    EastValue *v = lit ? east_string(lit) : east_null();
+    EastValue *t = east_variant_new(name, v, NULL);
+    east_array_push(fmt, t);
+    east_value_release(t);
+    east_value_release(v);
+}
+
+static void *datetime_state(BenchContext *ctx, DateTimeBench which)
+{
+    DateTimeState *s = calloc(1, sizeof(DateTimeState));
+    s->which = which;
+    s->n = bench_size(ctx, DATETIME_ROWS, 1000);
+    s->format = east_array_new(NULL);
+    const char *fields[] = {"year4", "month2", "day2", "hour24_2",
+                            "minute2", "second2", "millisecond3"};
+    const char *seps[] = {"-", "-", "T", ":", ":", ".", "Z"};
+    for (size_t i = 0; i < 7; i++) {
+        push_token(s->format, fields[i], NULL);
+        push_token(s->format, "literal", seps[i]);
+    }
+
+    BuiltinImpl print = builtin_registry_get(ctx->builtins, "DateTimePrintFormat", NULL, 0);
+    s->impl = which == DT_PARSE ? builtin_registry_get(ctx->builtins, "DateTimeParseFormat", NULL, 0)
+            : which == DT_COMPONENTS ? builtin_registry_get(ctx->builtins, "DateTimeComponents", NULL, 0)
+            : print;
+    const char *getters[] = {"DateTimeGetYear", "DateTimeGetMonth", "DateTimeGetDayOfMonth"};
+    for (int k = 0; k < 3; k++)
+        s->getters[k] = builtin_registry_get(ctx->builtins, getters[k], NULL, 0);
+    s->values = calloc(s->n, sizeof(EastValue *));
+    uint64_t x = 88172645463325252ULL;
+    for (size_t i = 0; i < s->n; i++) {
+        x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+        /* 1950 to 2050 */
+        EastValue *d = east_datetime((int64_t)(x % 3155760000000ULL) - 631152000000LL);
+        if (which == DT_PARSE) {
+            EastValue *a[2] = {d, s->format};
+            s->values[i] = print(a, 2);
+            east_value_release(d);
+        } else {
+            s->values[i] = d;
+        }
+    }
+
+    if (which == DT_COMPONENTS) {
+        s->array = east_array_new(NULL);
+        for (size_t i = 0; i < s->n; i++) east_array_push(s->array, s->values[i]);
+    }
+
+    ctx->ops = s->n;
+    ctx->unit = "value";
+    return s;
+}
+
+static void *setup_print(BenchContext *ctx) { return datetime_state(ctx, DT_PRINT); }
+static void *setup_parse(BenchContext *ctx) { return datetime_state(ctx, DT_PARSE); }
+static void *setup_components(BenchContext *ctx) { return datetime_state(ctx, DT_COMPONENTS); }
+static void *setup_getters(BenchContext *ctx) { return datetime_state(ctx, DT_GETTERS); }
+
+static bool datetime_run(void *state)
+{
+    DateTimeState *s = state;
+    if (s->which == DT_COMPONENTS) {
+        EastValue *r = s->impl(&s->array, 1);
+        if (!r) return false;
+        east_value_release(r);
+        return true;
+    }
+    if (s->which == DT_GETTERS) {
+        for (size_t i = 0; i < s->n; i++) {
+            for (int k = 0; k < 3; k++) {
+                EastValue *r = s->getters[k](&s->values[i], 1);
+                if (!r) return false;
+                east_value_release(r);
+            }
+        }
+        return true;
+    }
+    for (size_t i = 0; i < s->n; i++) {
+        EastValue *a[2] = {s->values[i], s->format};
+        EastValue *r = s->impl(a, 2);
+        if (!r) return false;
+        east_value_release(r);
+    }
+    return true;
+}
+
+static void datetime_teardown(void *state)
+{
+    DateTimeState *s = state;
+    for (size_t i = 0; i < s->n; i++) east_value_release(s->values[i]);
+    free(s->values);
+    if (s->array) east_value_release(s->array);
+    east_value_release(s->format);
+    free(s);
+}
+
+void bench_register_datetime(BenchSuite *suite)
+{
+    bench_add(suite, "datetime/print", setup_print, datetime_run, datetime_teardown);
+    bench_add(suite, "datetime/parse", setup_parse, datetime_run, datetime_teardown);
+    bench_add(suite, "datetime/components", setup_components, datetime_run, datetime_teardown);
+    bench_add(suite, "datetime/getters", setup_getters, datetime_run, datetime_teardown);
+}
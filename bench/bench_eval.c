@@ -0,0 +1,191 @@
+/*
+ * Evaluator benchmarks: the per-node cost of the tree-walking interpreter.
+ *
+ * Every program here is a counted while loop, so loop_iteration is the
+ * baseline the others should be read against. platform_call is the C side
+ * of a platform function call; the WASM bridge adds its JS crossing.
+ */
+
+#include "bench.h"
+
+#include <stdlib.h>
+
+#define EVAL_ITERS 200000
+
+typedef struct {
+    EastCompiledFn *fn;
+} ProgramState;
+
+/* Compile a parameterless program and report ops per run. */
+static void *program_state(BenchContext *ctx, IRNode *body, size_t ops,
+                           const char *unit)
+{
+    ProgramState *s = calloc(1, sizeof(ProgramState));
+    s->fn = east_compile(body, ctx->platform, ctx->builtins);
+    ir_node_release(body);
+    ctx->ops = ops;
+    ctx->unit = unit;
+    return s;
+}
+
+static bool program_run(void *state)
+{
+    ProgramState *s = state;
+    return bench_call(s->fn, NULL, 0);
+}
+
+static void program_teardown(void *state)
+{
+    ProgramState *s = state;
+    east_compiled_fn_free(s->fn);
+    free(s);
+}
+
+/* while i < n { null } */
+static void *setup_loop_iteration(BenchContext *ctx)
+{
+    size_t n = bench_size(ctx, EVAL_ITERS, 1000);
+    IRNode *body = b_value(&east_null_type, east_null());
+    return program_state(ctx, b_count_loop("i", (int64_t)n, body, NULL, NULL),
+                         n, "iter");
+}
+
+/*
+ * Eight variables bound in enclosing scopes, read from inside the loop
+ * body, so each lookup walks the environment chain.
+ */
+static void *setup_variable_lookup(BenchContext *ctx)
+{
+    static const char *names[] = { "a", "b", "c", "d", "e", "f", "g", "h" };
+    size_t n = bench_size(ctx, EVAL_ITERS, 1000);
+
+    IRNode *reads[8];
+    for (int k = 0; k < 8; k++) reads[k] = b_var(&east_integer_type, names[k]);
+    IRNode *body = b_block(&east_integer_type, reads, 8);
+    IRNode *prog = b_count_loop("i", (int64_t)n, body, NULL, NULL);
+
+    for (int k = 7; k >= 0; k--) {
+        IRNode *stmts[] = { b_let(names[k], b_int(k)), prog };
+        prog = b_block(&east_null_type, stmts, 2);
+    }
+    return program_state(ctx, prog, n * 8, "lookup");
+}
+
+/* let f = fn(x) { x }; while i < n { f(i) } */
+static void *setup_function_call(BenchContext *ctx)
+{
+    size_t n = bench_size(ctx, EVAL_ITERS, 1000);
+
+    EastType *in[] = { &east_integer_type };
+    EastType *fn_type = east_function_type(in, 1, &east_integer_type);
+    IRVariable params[] = { { .name = "x", .mutable = false, .captured = false } };
+    IRNode *fn_body = b_var(&east_integer_type, "x");
+    IRNode *fn_node = ir_function(fn_type, NULL, 0, params, 1, fn_body);
+    ir_node_release(fn_body);
+
+    IRNode *args[] = { b_mvar(&east_integer_type, "i") };
+    IRNode *call = b_call(&east_integer_type, b_var(fn_type, "f"), args, 1);
+    IRNode *stmts[] = {
+        b_let("f", fn_node),
+        b_count_loop("i", (int64_t)n, call, NULL, NULL),
+    };
+    IRNode *prog = b_block(&east_null_type, stmts, 2);
+    east_type_release(fn_type);
+    return program_state(ctx, prog, n, "call");
+}
+
+static EvalResult bench_double(EastValue **args, size_t num_args)
+{
+    (void)num_args;
+    return eval_ok(east_integer(args[0]->data.integer * 2));
+}
+
+/* while i < n { bench_double(i) } */
+static void *setup_platform_call(BenchContext *ctx)
+{
+    size_t n = bench_size(ctx, EVAL_ITERS, 1000);
+    if (!platform_registry_get(ctx->platform, "bench_double", NULL, 0))
+        platform_registry_add(ctx->platform, "bench_double", bench_double, false);
+
+    IRNode *args[] = { b_mvar(&east_integer_type, "i") };
+    IRNode *call = b_platform(&east_integer_type, "bench_double", args, 1);
+    return program_state(ctx, b_count_loop("i", (int64_t)n, call, NULL, NULL), n, "call");
+}
+
+/* acc = IntegerAdd(acc, IntegerMultiply(i, 3)) */
+static void *setup_integer_arith(BenchContext *ctx)
+{
+    size_t n = bench_size(ctx, EVAL_ITERS, 1000);
+
+    IRNode *mul_args[] = { b_mvar(&east_integer_type, "i"), b_int(3) };
+    IRNode *mul = b_builtin(&east_integer_type, "IntegerMultiply", NULL, mul_args, 2);
+    IRNode *add_args[] = { b_mvar(&east_integer_type, "acc"), mul };
+    IRNode *body = b_assign("acc",
+        b_builtin(&east_integer_type, "IntegerAdd", NULL, add_args, 2));
+
+    IRNode *stmts[] = {
+        b_let_mut("acc", b_int(0)),
+        b_count_loop("i", (int64_t)n, body, NULL, NULL),
+    };
+    return program_state(ctx, b_block(&east_null_type, stmts, 2), n * 2, "op");
+}
+
+/* acc = FloatAdd(acc, FloatMultiply(x, 1.5)) */
+static void *setup_float_arith(BenchContext *ctx)
+{
+    size_t n = bench_size(ctx, EVAL_ITERS, 1000);
+
+    IRNode *mul_args[] = { b_var(&east_float_type, "x"), b_float(1.5) };
+    IRNode *mul = b_builtin(&east_float_type, "FloatMultiply", NULL, mul_args, 2);
+    IRNode *add_args[] = { b_mvar(&east_float_type, "acc"), mul };
+    IRNode *body = b_assign("acc",
+        b_builtin(&east_float_type, "FloatAdd", NULL, add_args, 2));
+
+    IRNode *stmts[] = {
+        b_let("x", b_float(0.25)),
+        b_let_mut("acc", b_float(0.0)),
+        b_count_loop("i", (int64_t)n, body, NULL, NULL),
+    };
+    return program_state(ctx, b_block(&east_null_type, stmts, 3), n * 2, "op");
+}
+
+/* let s = (a: 1, b: 2, c: 3); while i < n { s.a; s.c } */
+static void *setup_struct_field(BenchContext *ctx)
+{
+    size_t n = bench_size(ctx, EVAL_ITERS, 1000);
+
+    const char *names[] = { "a", "b", "c" };
+    EastType *types[] = { &east_integer_type, &east_integer_type, &east_integer_type };
+    EastType *st = east_struct_type(names, types, 3);
+    IRNode *values[] = { b_int(1), b_int(2), b_int(3) };
+    IRNode *lit = ir_struct(st, (char **)names, values, 3);
+    for (int k = 0; k < 3; k++) ir_node_release(values[k]);
+
+    IRNode *sa = b_var(st, "s");
+    IRNode *sc = b_var(st, "s");
+    IRNode *reads[] = {
+        ir_get_field(&east_integer_type, sa, "a"),
+        ir_get_field(&east_integer_type, sc, "c"),
+    };
+    ir_node_release(sa);
+    ir_node_release(sc);
+    IRNode *body = b_block(&east_integer_type, reads, 2);
+
+    IRNode *stmts[] = {
+        b_let("s", lit),
+        b_count_loop("i", (int64_t)n, body, NULL, NULL),
+    };
+    east_type_release(st);
+    return program_state(ctx, b_block(&east_null_type, stmts, 2), n * 2, "field");
+}
+
+void bench_register_eval(BenchSuite *suite)
+{
+    bench_add(suite, "eval/loop_iteration", setup_loop_iteration, program_run, program_teardown);
+    bench_add(suite, "eval/variable_lookup", setup_variable_lookup, program_run, program_teardown);
+    bench_add(suite, "eval/function_call", setup_function_call, program_run, program_teardown);
+    bench_add(suite, "eval/platform_call", setup_platform_call, program_run, program_teardown);
+    bench_add(suite, "eval/integer_arith", setup_integer_arith, program_run, program_teardown);
+    bench_add(suite, "eval/float_arith", setup_float_arith, program_run, program_teardown);
+    bench_add(suite, "eval/struct_field", setup_struct_field, program_run, program_teardown);
+}
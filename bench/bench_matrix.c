@@ -0,0 +1,155 @@
+/*
+ * Dense Matrix<Float> numerics: products, matrix-vector products and
+ * linear solves, each a one-builtin program over square matrices.
+ * Runs report GFLOP/s using the textbook operation counts; the layout
+ * benchmarks (transpose, rows) report bytes moved instead.
+ */
+
+#include "bench.h"
+
+#include <stdlib.h>
+
+typedef enum {
+    MAT_MULTIPLY,
+    MAT_VECTOR,
+    MAT_SOLVE,
+    MAT_CHOLESKY,
+    MAT_TRANSPOSE,
+    MAT_TO_ROWS,
+} MatrixBench;
+
+typedef struct {
+    EastCompiledFn *fn;
+    EastValue *a;
+    EastValue *b;           // NULL for one-argument builtins
+    size_t nargs;
+} MatrixState;
+
+/* Diagonally dominant and symmetric, so both solvers accept it */
+static EastValue *square_matrix(size_t n)
+{
+    EastValue *m = east_matrix_new(&east_float_type, n, n);
+    double *d = m->data.matrix.data;
+    for (size_t i = 0; i < n; i++) {
+        for (size_t j = 0; j < n; j++) {
+            d[i * n + j] = i == j ? (double)n : 1.0 / (double)(1 + i + j);
+        }
+    }
+    return m;
+}
+
+static void *matrix_setup(BenchContext *ctx, MatrixBench which, size_t size)
+{
+    size_t n = bench_size(ctx, size, 16);
+    EastType *mat_type = east_matrix_type(&east_float_type);
+    EastType *vec_type = east_vector_type(&east_float_type);
+    bool vector_rhs = which == MAT_VECTOR;
+    bool unary = which == MAT_TRANSPOSE || which == MAT_TO_ROWS;
+    EastType *b_type = vector_rhs ? vec_type : mat_type;
+    EastType *out_type = vector_rhs ? vec_type : mat_type;
+    EastType *rows_type = east_array_type(vec_type);
+    const char *name = NULL;
+    double flops = 0;
+
+    switch (which) {
+    case MAT_MULTIPLY:
+        name = "MatrixMultiply";
+        flops = 2.0 * n * n * n;
+        break;
+    case MAT_VECTOR:
+        name = "MatrixVectorMultiply";
+        flops = 2.0 * n * n;
+        break;
+    case MAT_SOLVE:
+        /* n right-hand sides: factorization plus two triangular solves */
+        name = "MatrixSolve";
+        flops = 2.0 / 3.0 * n * n * n + 2.0 * n * n * n;
+        break;
+    case MAT_CHOLESKY:
+        name = "MatrixCholeskySolve";
+        flops = 1.0 / 3.0 * n * n * n + 2.0 * n * n * n;
+        break;
+    case MAT_TRANSPOSE:
+        name = "MatrixTranspose";
+        break;
+    case MAT_TO_ROWS:
+        name = "MatrixToRows";
+        out_type = rows_type;
+        break;
+    }
+
+    size_t nargs = unary ? 1 : 2;
+    IRNode *args[] = { b_var(mat_type, "a"), unary ? NULL : b_var(b_type, "b") };
+    IRNode *body = b_builtin(out_type, name, &east_float_type, args, nargs);
+    EastType *inputs[] = { mat_type, b_type };
+    EastType *prog_type = east_function_type(inputs, nargs, body->type);
+    IRVariable params[] = {
+        { .name = "a", .mutable = false, .captured = false },
+        { .name = "b", .mutable = false, .captured = false },
+    };
+    IRNode *prog = ir_function(prog_type, NULL, 0, params, nargs, body);
+    ir_node_release(body);
+
+    MatrixState *s = calloc(1, sizeof(MatrixState));
+    s->fn = bench_compile(ctx, prog);
+    ir_node_release(prog);
+    east_type_release(prog_type);
+
+    s->a = square_matrix(n);
+    s->nargs = nargs;
+    if (unary) {
+        s->b = NULL;
+    } else if (vector_rhs) {
+        s->b = east_vector_new(&east_float_type, n);
+        double *d = s->b->data.vector.data;
+        for (size_t i = 0; i < n; i++) d[i] = (double)(i % 7) - 3.0;
+    } else {
+        s->b = square_matrix(n);
+    }
+
+    east_type_release(rows_type);
+    east_type_release(vec_type);
+    east_type_release(mat_type);
+    ctx->ops = 1;
+    ctx->unit = "call";
+    ctx->flops = (size_t)flops;
+    if (unary) ctx->bytes = n * n * sizeof(double);
+    return s;
+}
+
+static bool matrix_run(void *state)
+{
+    MatrixState *s = state;
+    EastValue *args[] = { s->a, s->b };
+    return bench_call(s->fn, args, s->nargs);
+}
+
+static void matrix_teardown(void *state)
+{
+    MatrixState *s = state;
+    east_compiled_fn_free(s->fn);
+    east_value_release(s->a);
+    east_value_release(s->b);
+    free(s);
+}
+
+static void *setup_matmul_64(BenchContext *ctx) { return matrix_setup(ctx, MAT_MULTIPLY, 64); }
+static void *setup_matmul_256(BenchContext *ctx) { return matrix_setup(ctx, MAT_MULTIPLY, 256); }
+static void *setup_matmul_512(BenchContext *ctx) { return matrix_setup(ctx, MAT_MULTIPLY, 512); }
+static void *setup_matvec_1024(BenchContext *ctx) { return matrix_setup(ctx, MAT_VECTOR, 1024); }
+static void *setup_solve_256(BenchContext *ctx) { return matrix_setup(ctx, MAT_SOLVE, 256); }
+static void *setup_cholesky_256(BenchContext *ctx) { return matrix_setup(ctx, MAT_CHOLESKY, 256); }
+static void *setup_transpose_2048(BenchContext *ctx) { return matrix_setup(ctx, MAT_TRANSPOSE, 2048); }
+static void *setup_to_rows_2048(BenchContext *ctx) { return matrix_setup(ctx, MAT_TO_ROWS, 2048); }
+
+void bench_register_matrix(BenchSuite *suite)
+{
+    bench_add(suite, "matrix/matmul_64", setup_matmul_64, matrix_run, matrix_teardown);
+    bench_add(suite, "matrix/matmul_256", setup_matmul_256, matrix_run, matrix_teardown);
+    bench_add(suite, "matrix/matmul_512", setup_matmul_512, matrix_run, matrix_teardown);
+    bench_add(suite, "matrix/matvec_1024", setup_matvec_1024, matrix_run, matrix_teardown);
+    bench_add(suite, "matrix/solve_256", setup_solve_256, matrix_run, matrix_teardown);
+    bench_add(suite, "matrix/cholesky_256", setup_cholesky_256, matrix_run, matrix_teardown);
+    bench_add(suite, "matrix/transpose_2048", setup_transpose_2048, matrix_run, matrix_teardown);
+    bench_add(suite, "matrix/to_rows_2048", setup_to_rows_2048, matrix_run, matrix_teardown);
+}
@@ -0,0 +1,194 @@
+/*
+ * Runtime services: the cycle collector and parallel_map scaling.
+ */
+
+#include "bench.h"
+
+#include <east/gc.h>
+#include <east/serialization.h>
+#include <east/type_of_type.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define GC_OBJECTS 20000
+#define PARALLEL_ITEMS 2000
+
+/* ------------------------------------------------------------------ */
+/*  Cycle collection                                                   */
+/* ------------------------------------------------------------------ */
+
+typedef struct {
+    size_t n;
+    EastValue **live;       // tracked values kept alive across collections
+} GcState;
+
+static void *setup_gc_cycles(BenchContext *ctx)
+{
+    GcState *s = calloc(1, sizeof(GcState));
+    s->n = bench_size(ctx, GC_OBJECTS, 100);
+    ctx->ops = s->n;
+    ctx->unit = "cycle";
+    return s;
+}
+
+/* Build n ref <-> array cycles, drop them, and collect. */
+static bool gc_cycles_run(void *state)
+{
+    GcState *s = state;
+    for (size_t i = 0; i < s->n; i++) {
+        EastValue *arr = east_array_new(&east_null_type);
+        EastValue *ref = east_ref_new(arr);
+        east_array_push(arr, ref);
+        east_value_release(ref);
+        east_value_release(arr);
+    }
+    east_gc_collect();
+    return true;
+}
+
+static void *setup_gc_live(BenchContext *ctx)
+{
+    GcState *s = calloc(1, sizeof(GcState));
+    s->n = bench_size(ctx, GC_OBJECTS, 100);
+    s->live = calloc(s->n, sizeof(EastValue *));
+    for (size_t i = 0; i < s->n; i++) {
+        EastValue *v = east_integer((int64_t)i);
+        s->live[i] = east_ref_new(v);
+        east_value_release(v);
+    }
+    ctx->ops = s->n;
+    ctx->unit = "object";
+    return s;
+}
+
+/* Collect with nothing to free: the cost of scanning live objects. */
+static bool gc_live_run(void *state)
+{
+    (void)state;
+    east_gc_collect();
+    return true;
+}
+
+static void gc_teardown(void *state)
+{
+    GcState *s = state;
+    if (s->live) {
+        for (size_t i = 0; i < s->n; i++) east_value_release(s->live[i]);
+        free(s->live);
+    }
+    free(s);
+}
+
+/* ------------------------------------------------------------------ */
+/*  parallel_map scaling                                               */
+/*                                                                     */
+/*  The same workload at 1, 2, 4 and 8 workers. Each element runs a    */
+/*  short loop so per-item work dominates the Beast2 hand-off. The     */
+/*  program is parsed from IR text rather than built with ir_*: the    */
+/*  mapped function is shipped to workers as its source IR, which only */
+/*  exists for IR that was converted from an IR value.                 */
+/* ------------------------------------------------------------------ */
+
+#define LOC "location=[(filename=\"bench\", line=1, column=1)]"
+#define VAR(t, name, mut) \
+    ".Variable (type=" t ", " LOC ", name=\"" name "\", mutable=" mut ", captured=false)"
+#define INT(n) ".Value (type=.Integer, " LOC ", value=.Integer " #n ")"
+#define ADD(a, b) \
+    ".Builtin (type=.Integer, " LOC ", builtin=\"IntegerAdd\", type_parameters=[], " \
+    "arguments=[" a ", " b "])"
+
+/*
+ * fn(xs) {
+ *     parallel_map<Integer, Integer>(xs, fn(x) {
+ *         let acc = 0; let j = 0;
+ *         while j < 200 { acc = acc + x; j = j + 1 }
+ *         acc
+ *     })
+ * }
+ */
+static const char *parallel_program =
+    ".Function (type=.Function (inputs=[.Array .Integer], output=.Array .Integer), "
+    LOC ", captures=[], parameters=[" VAR(".Array .Integer", "xs", "false") "], "
+    "body=.Platform (type=.Array .Integer, " LOC ", name=\"parallel_map\", "
+    "type_parameters=[.Integer, .Integer], arguments=[" VAR(".Array .Integer", "xs", "false") ", "
+    ".Function (type=.Function (inputs=[.Integer], output=.Integer), " LOC ", captures=[], "
+    "parameters=[" VAR(".Integer", "x", "false") "], body=.Block (type=.Integer, " LOC ", statements=["
+    ".Let (type=.Null, " LOC ", variable=" VAR(".Integer", "acc", "true") ", value=" INT(0) "), "
+    ".Let (type=.Null, " LOC ", variable=" VAR(".Integer", "j", "true") ", value=" INT(0) "), "
+    ".While (type=.Null, " LOC ", predicate=.Builtin (type=.Boolean, " LOC ", builtin=\"Less\", "
+    "type_parameters=[.Integer], arguments=[" VAR(".Integer", "j", "true") ", " INT(200) "]), "
+    "label=(name=\"\", location=[]), body=.Block (type=.Null, " LOC ", statements=["
+    ".Assign (type=.Null, " LOC ", variable=" VAR(".Integer", "acc", "true") ", "
+    "value=" ADD(VAR(".Integer", "acc", "true"), VAR(".Integer", "x", "false")) "), "
+    ".Assign (type=.Null, " LOC ", variable=" VAR(".Integer", "j", "true") ", "
+    "value=" ADD(VAR(".Integer", "j", "true"), INT(1)) ")])), "
+    VAR(".Integer", "acc", "true") "]))], async=true, optional=false))";
+
+typedef struct {
+    EastCompiledFn *fn;
+    IRNode *ir;
+    EastValue *input;
+    const char *workers;
+} ParallelState;
+
+static void *parallel_setup(BenchContext *ctx, const char *workers)
+{
+    east_type_of_type_init();
+    EastValue *ir_val = east_parse_value(parallel_program, east_ir_type);
+    if (!ir_val) {
+        fprintf(stderr, "parallel_map: failed to parse IR\n");
+        return NULL;
+    }
+    ParallelState *s = calloc(1, sizeof(ParallelState));
+    s->ir = east_ir_from_value(ir_val);
+    east_value_release(ir_val);
+    s->fn = bench_compile(ctx, s->ir);
+    s->workers = workers;
+
+    size_t n = bench_size(ctx, PARALLEL_ITEMS, 16);
+    s->input = east_array_new(&east_integer_type);
+    for (size_t i = 0; i < n; i++) {
+        EastValue *v = east_integer((int64_t)i);
+        east_array_push(s->input, v);
+        east_value_release(v);
+    }
+
+    ctx->ops = n;
+    ctx->unit = "item";
+    return s;
+}
+
+static bool parallel_run(void *state)
+{
+    ParallelState *s = state;
+    setenv("EAST_C_PARALLEL_WORKERS", s->workers, 1);
+    EastValue *args[] = { s->input };
+    bool ok = bench_call(s->fn, args, 1);
+    unsetenv("EAST_C_PARALLEL_WORKERS");
+    return ok;
+}
+
+static void parallel_teardown(void *state)
+{
+    ParallelState *s = state;
+    east_compiled_fn_free(s->fn);
+    ir_node_release(s->ir);
+    east_value_release(s->input);
+    free(s);
+}
+
+static void *setup_parallel_1(BenchContext *ctx) { return parallel_setup(ctx, "1"); }
+static void *setup_parallel_2(BenchContext *ctx) { return parallel_setup(ctx, "2"); }
+static void *setup_parallel_4(BenchContext *ctx) { return parallel_setup(ctx, "4"); }
+static void *setup_parallel_8(BenchContext *ctx) { return parallel_setup(ctx, "8"); }
+
+void bench_register_runtime(BenchSuite *suite)
+{
+    bench_add(suite, "runtime/gc_cycles", setup_gc_cycles, gc_cycles_run, gc_teardown);
+    bench_add(suite, "runtime/gc_scan_live", setup_gc_live, gc_live_run, gc_teardown);
+    bench_add(suite, "runtime/parallel_map_1", setup_parallel_1, parallel_run, parallel_teardown);
+    bench_add(suite, "runtime/parallel_map_2", setup_parallel_2, parallel_run, parallel_teardown);
+    bench_add(suite, "runtime/parallel_map_4", setup_parallel_4, parallel_run, parallel_teardown);
+    bench_add(suite, "runtime/parallel_map_8", setup_parallel_8, parallel_run, parallel_teardown);
+}
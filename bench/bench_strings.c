@@ -0,0 +1,265 @@
+/*
+ * String benchmarks. Bulk operations call the builtin implementations
+ * directly on a ~64 KiB text; repeated appends go through the evaluator
+ * since that is where accumulation patterns show up in real programs.
+ */
+
+#include "bench.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TEXT_BYTES 65536
+#define SUBSTRING_CALLS 2000
+#define APPEND_ITERS 5000
+#define APPEND_PIECES 1000000
+
+static const char *words[] = {
+    "the", "quick", "brown", "fox", "jumps", "over", "the", "lazy", "dog",
+    "and", "runs", "through", "a", "field", "of", "tall", "grass",
+};
+
+typedef struct {
+    BuiltinImpl impl;
+    EastValue *args[3];
+    size_t num_args;
+    size_t calls;
+    EastValue **call_args;  // per-call argument triples (substring only)
+} StringState;
+
+static EastValue *make_text(size_t target)
+{
+    size_t n_words = sizeof(words) / sizeof(words[0]);
+    char *buf = malloc(target + 16);
+    size_t len = 0;
+    for (size_t i = 0; len < target; i++) {
+        const char *w = words[(i * 7) % n_words];
+        size_t wl = strlen(w);
+        memcpy(buf + len, w, wl);
+        len += wl;
+        buf[len++] = ' ';
+    }
+    buf[len - 1] = '.';
+    EastValue *v = east_string_len(buf, len);
+    free(buf);
+    return v;
+}
+
+static void *string_setup(BenchContext *ctx, const char *builtin,
+                          EastValue *a1, EastValue *a2)
+{
+    StringState *s = calloc(1, sizeof(StringState));
+    s->impl = builtin_registry_get(ctx->builtins, builtin, NULL, 0);
+    s->args[0] = make_text(bench_size(ctx, TEXT_BYTES, 1024));
+    s->num_args = 1;
+    if (a1) s->args[s->num_args++] = a1;
+    if (a2) s->args[s->num_args++] = a2;
+    s->calls = 1;
+    ctx->bytes = s->args[0]->data.string.len;
+    ctx->unit = "call";
+    return s;
+}
+
+static bool string_run(void *state)
+{
+    StringState *s = state;
+    if (s->call_args) {
+        for (size_t i = 0; i < s->calls; i++) {
+            EastValue *r = s->impl(&s->call_args[i * 3], 3);
+            if (!r) return false;
+            east_value_release(r);
+        }
+        return true;
+    }
+    EastValue *r = s->impl(s->args, s->num_args);
+    if (!r) return false;
+    east_value_release(r);
+    return true;
+}
+
+static void string_teardown(void *state)
+{
+    StringState *s = state;
+    for (size_t i = 0; i < s->num_args; i++) east_value_release(s->args[i]);
+    if (s->call_args) {
+        for (size_t i = 0; i < s->calls; i++) {
+            east_value_release(s->call_args[i * 3 + 1]);
+            east_value_release(s->call_args[i * 3 + 2]);
+        }
+        free(s->call_args);
+    }
+    free(s);
+}
+
+static void *setup_split(BenchContext *ctx)
+{
+    return string_setup(ctx, "StringSplit", east_string(" "), NULL);
+}
+
+/* Service log lines, split on newlines and then on a field separator */
+static const char *log_lines[] = {
+    "2024-05-01T12:00:00.123Z INFO  [worker-3] request done | path=/api/v1/items | status=200 | latency_ms=12",
+    "2024-05-01T12:00:00.187Z WARN  [worker-1] slow upstream | host=inventory.internal | latency_ms=913",
+    "2024-05-01T12:00:00.201Z DEBUG [scheduler] queue depth | jobs=17 | oldest_ms=4021",
+    "2024-05-01T12:00:00.245Z ERROR [worker-7] request failed | path=/api/v1/orders/991 | status=502",
+};
+
+static EastValue *make_log(size_t target)
+{
+    size_t n_lines = sizeof(log_lines) / sizeof(log_lines[0]);
+    char *buf = malloc(target + 256);
+    size_t len = 0;
+    for (size_t i = 0; len < target; i++) {
+        const char *l = log_lines[(i * 3) % n_lines];
+        size_t ll = strlen(l);
+        memcpy(buf + len, l, ll);
+        len += ll;
+        buf[len++] = '\n';
+    }
+    EastValue *v = east_string_len(buf, len);
+    free(buf);
+    return v;
+}
+
+static void *setup_split_log_lines(BenchContext *ctx)
+{
+    StringState *s = string_setup(ctx, "StringSplit", east_string("\n"), NULL);
+    east_value_release(s->args[0]);
+    s->args[0] = make_log(bench_size(ctx, TEXT_BYTES, 1024));
+    ctx->bytes = s->args[0]->data.string.len;
+    return s;
+}
+
+static void *setup_split_log_fields(BenchContext *ctx)
+{
+    StringState *s = string_setup(ctx, "StringSplit", east_string(" | "), NULL);
+    east_value_release(s->args[0]);
+    s->args[0] = make_log(bench_size(ctx, TEXT_BYTES, 1024));
+    ctx->bytes = s->args[0]->data.string.len;
+    return s;
+}
+
+static void *setup_index_of(BenchContext *ctx)
+{
+    /* Not present in the text, so the whole string is scanned. */
+    return string_setup(ctx, "StringIndexOf", east_string("grass dog"), NULL);
+}
+
+static void *setup_replace(BenchContext *ctx)
+{
+    return string_setup(ctx, "StringReplace", east_string("fox"), east_string("cat"));
+}
+
+static void *setup_upper_case(BenchContext *ctx)
+{
+    return string_setup(ctx, "StringUpperCase", NULL, NULL);
+}
+
+static void *setup_join(BenchContext *ctx)
+{
+    StringState *s = calloc(1, sizeof(StringState));
+    s->impl = builtin_registry_get(ctx->builtins, "ArrayStringJoin", NULL, 0);
+
+    size_t n_words = sizeof(words) / sizeof(words[0]);
+    size_t target = bench_size(ctx, TEXT_BYTES, 1024), len = 0;
+    EastValue *arr = east_array_new(&east_string_type);
+    for (size_t i = 0; len < target; i++) {
+        const char *w = words[(i * 7) % n_words];
+        EastValue *v = east_string(w);
+        east_array_push(arr, v);
+        east_value_release(v);
+        len += strlen(w) + 1;
+    }
+    s->args[0] = arr;
+    s->args[1] = east_string(" ");
+    s->num_args = 2;
+    s->calls = 1;
+    ctx->bytes = len;
+    ctx->unit = "call";
+    return s;
+}
+
+/* Substrings at scattered codepoint offsets. */
+static void *setup_substring(BenchContext *ctx)
+{
+    StringState *s = string_setup(ctx, "StringSubstring", NULL, NULL);
+    size_t text_len = s->args[0]->data.string.len;
+    s->calls = bench_size(ctx, SUBSTRING_CALLS, 100);
+    s->call_args = calloc(s->calls * 3, sizeof(EastValue *));
+    for (size_t i = 0; i < s->calls; i++) {
+        int64_t from = (int64_t)((i * 2654435761u) % (text_len - 32));
+        s->call_args[i * 3] = s->args[0];
+        s->call_args[i * 3 + 1] = east_integer(from);
+        s->call_args[i * 3 + 2] = east_integer(from + 16);
+    }
+    ctx->ops = s->calls;
+    ctx->bytes = 0;
+    return s;
+}
+
+/* let acc = ""; while i < n { acc = StringConcat(acc, "abcd") } */
+typedef struct {
+    EastCompiledFn *fn;
+} AppendState;
+
+static void *append_state(BenchContext *ctx, size_t n)
+{
+    AppendState *s = calloc(1, sizeof(AppendState));
+
+    IRNode *args[] = {
+        b_mvar(&east_string_type, "acc"),
+        b_value(&east_string_type, east_string("abcd")),
+    };
+    IRNode *body = b_assign("acc",
+        b_builtin(&east_string_type, "StringConcat", NULL, args, 2));
+    IRNode *stmts[] = {
+        b_let_mut("acc", b_value(&east_string_type, east_string(""))),
+        b_count_loop("i", (int64_t)n, body, NULL, NULL),
+    };
+    IRNode *prog = b_block(&east_null_type, stmts, 2);
+    s->fn = east_compile(prog, ctx->platform, ctx->builtins);
+    ir_node_release(prog);
+
+    ctx->ops = n;
+    ctx->unit = "append";
+    return s;
+}
+
+static void *setup_append(BenchContext *ctx)
+{
+    return append_state(ctx, bench_size(ctx, APPEND_ITERS, 100));
+}
+
+/* One string built from a million pieces */
+static void *setup_append_1m(BenchContext *ctx)
+{
+    return append_state(ctx, bench_size(ctx, APPEND_PIECES, 1000));
+}
+
+static bool append_run(void *state)
+{
+    AppendState *s = state;
+    return bench_call(s->fn, NULL, 0);
+}
+
+static void append_teardown(void *state)
+{
+    AppendState *s = state;
+    east_compiled_fn_free(s->fn);
+    free(s);
+}
+
+void bench_register_strings(BenchSuite *suite)
+{
+    bench_add(suite, "strings/split", setup_split, string_run, string_teardown);
+    bench_add(suite, "strings/join", setup_join, string_run, string_teardown);
+    bench_add(suite, "strings/split_log_lines", setup_split_log_lines, string_run, string_teardown);
+    bench_add(suite, "strings/split_log_fields", setup_split_log_fields, string_run, string_teardown);
+    bench_add(suite, "strings/index_of_miss", setup_index_of, string_run, string_teardown);
+    bench_add(suite, "strings/replace", setup_replace, string_run, string_teardown);
+    bench_add(suite, "strings/upper_case", setup_upper_case, string_run, string_teardown);
+    bench_add(suite, "strings/substring", setup_substring, string_run, string_teardown);
+    bench_add(suite, "strings/append_loop", setup_append, append_run, append_teardown);
+    bench_add(suite, "strings/append_1m", setup_append_1m, append_run, append_teardown);
+}
@@ -0,0 +1,160 @@
+/*
+ * Vector numerics: the native element-wise builtins against the same
+ * computation written with VectorFold / VectorMap and an East closure.
+ * Every benchmark runs a one-builtin program over a Vector<Float>.
+ */
+
+#include "bench.h"
+
+#include <stdlib.h>
+
+#define VECTOR_SIZE 200000
+
+typedef enum {
+    VEC_SUM_NATIVE,
+    VEC_SUM_FOLD,
+    VEC_SCALE_NATIVE,
+    VEC_SCALE_MAP,
+    VEC_DOT_NATIVE,
+    VEC_LESS_NATIVE,
+} VectorBench;
+
+typedef struct {
+    EastCompiledFn *fn;
+    EastValue *input;
+} VectorState;
+
+static IRNode *closure(EastType *fn_type, IRVariable *params, size_t n, IRNode *body)
+{
+    IRNode *fn = ir_function(fn_type, NULL, 0, params, n, body);
+    ir_node_release(body);
+    return fn;
+}
+
+/* fn(acc, x, i) { acc + x } */
+static IRNode *fold_add_fn(void)
+{
+    EastType *inputs[] = { &east_float_type, &east_float_type, &east_integer_type };
+    EastType *fn_type = east_function_type(inputs, 3, &east_float_type);
+    IRVariable params[] = {
+        { .name = "acc", .mutable = false, .captured = false },
+        { .name = "x", .mutable = false, .captured = false },
+        { .name = "i", .mutable = false, .captured = false },
+    };
+    IRNode *add[] = { b_var(&east_float_type, "acc"), b_var(&east_float_type, "x") };
+    IRNode *fn = closure(fn_type, params, 3,
+                         b_builtin(&east_float_type, "FloatAdd", NULL, add, 2));
+    east_type_release(fn_type);
+    return fn;
+}
+
+/* fn(x, i) { x * 2.0 } */
+static IRNode *map_scale_fn(void)
+{
+    EastType *inputs[] = { &east_float_type, &east_integer_type };
+    EastType *fn_type = east_function_type(inputs, 2, &east_float_type);
+    IRVariable params[] = {
+        { .name = "x", .mutable = false, .captured = false },
+        { .name = "i", .mutable = false, .captured = false },
+    };
+    IRNode *mul[] = { b_var(&east_float_type, "x"), b_float(2.0) };
+    IRNode *fn = closure(fn_type, params, 2,
+                         b_builtin(&east_float_type, "FloatMultiply", NULL, mul, 2));
+    east_type_release(fn_type);
+    return fn;
+}
+
+static void *vector_setup(BenchContext *ctx, VectorBench which)
+{
+    EastType *vec_type = east_vector_type(&east_float_type);
+    EastType *bool_vec_type = east_vector_type(&east_boolean_type);
+    IRNode *v = b_var(vec_type, "v");
+    IRNode *body = NULL;
+
+    switch (which) {
+    case VEC_SUM_NATIVE: {
+        IRNode *args[] = { v };
+        body = b_builtin(&east_float_type, "VectorSum", &east_float_type, args, 1);
+        break;
+    }
+    case VEC_SUM_FOLD: {
+        IRNode *args[] = { v, b_float(0.0), fold_add_fn() };
+        body = b_builtin(&east_float_type, "VectorFold", &east_float_type, args, 3);
+        break;
+    }
+    case VEC_SCALE_NATIVE: {
+        IRNode *args[] = { v, b_float(2.0) };
+        body = b_builtin(vec_type, "VectorMultiply", &east_float_type, args, 2);
+        break;
+    }
+    case VEC_SCALE_MAP: {
+        IRNode *args[] = { v, map_scale_fn() };
+        body = b_builtin(vec_type, "VectorMap", &east_float_type, args, 2);
+        break;
+    }
+    case VEC_DOT_NATIVE: {
+        IRNode *args[] = { v, b_var(vec_type, "v") };
+        body = b_builtin(&east_float_type, "VectorDot", &east_float_type, args, 2);
+        break;
+    }
+    case VEC_LESS_NATIVE: {
+        IRNode *args[] = { v, b_float(0.5) };
+        body = b_builtin(bool_vec_type, "VectorLess", &east_float_type, args, 2);
+        break;
+    }
+    }
+
+    EastType *out_type = body->type;
+    EastType *prog_type = east_function_type(&vec_type, 1, out_type);
+    IRVariable params[] = { { .name = "v", .mutable = false, .captured = false } };
+    IRNode *prog = closure(prog_type, params, 1, body);
+
+    VectorState *s = calloc(1, sizeof(VectorState));
+    s->fn = bench_compile(ctx, prog);
+    ir_node_release(prog);
+    east_type_release(prog_type);
+
+    size_t n = bench_size(ctx, VECTOR_SIZE, 1000);
+    s->input = east_vector_new(&east_float_type, n);
+    double *data = s->input->data.vector.data;
+    for (size_t i = 0; i < n; i++) data[i] = (double)(i % 1000) / 1000.0;
+
+    east_type_release(bool_vec_type);
+    east_type_release(vec_type);
+    ctx->ops = n;
+    ctx->bytes = n * sizeof(double);
+    ctx->unit = "elem";
+    return s;
+}
+
+static bool vector_run(void *state)
+{
+    VectorState *s = state;
+    EastValue *args[] = { s->input };
+    return bench_call(s->fn, args, 1);
+}
+
+static void vector_teardown(void *state)
+{
+    VectorState *s = state;
+    east_compiled_fn_free(s->fn);
+    east_value_release(s->input);
+    free(s);
+}
+
+static void *setup_sum_native(BenchContext *ctx) { return vector_setup(ctx, VEC_SUM_NATIVE); }
+static void *setup_sum_fold(BenchContext *ctx) { return vector_setup(ctx, VEC_SUM_FOLD); }
+static void *setup_scale_native(BenchContext *ctx) { return vector_setup(ctx, VEC_SCALE_NATIVE); }
+static void *setup_scale_map(BenchContext *ctx) { return vector_setup(ctx, VEC_SCALE_MAP); }
+static void *setup_dot_native(BenchContext *ctx) { return vector_setup(ctx, VEC_DOT_NATIVE); }
+static void *setup_less_native(BenchContext *ctx) { return vector_setup(ctx, VEC_LESS_NATIVE); }
+
+void bench_register_vectors(BenchSuite *suite)
+{
+    bench_add(suite, "vectors/sum_native", setup_sum_native, vector_run, vector_teardown);
+    bench_add(suite, "vectors/sum_fold", setup_sum_fold, vector_run, vector_teardown);
+    bench_add(suite, "vectors/scale_native", setup_scale_native, vector_run, vector_teardown);
+    bench_add(suite, "vectors/scale_map", setup_scale_map, vector_run, vector_teardown);
+    bench_add(suite, "vectors/dot_native", setup_dot_native, vector_run, vector_teardown);
+    bench_add(suite, "vectors/less_native", setup_less_native, vector_run, vector_teardown);
+}
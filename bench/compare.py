@@ -0,0 +1,85 @@
+#!/usr/bin/env python3
+"""Compare east-c-bench JSON results against a saved baseline.
+
+Usage: bench/compare.py BASELINE.json CURRENT.json [--threshold 0.10]
+                        [--metric median|p99|min]
+
+Benchmarks are matched by name. A benchmark regresses when its per-op time
+grew by more than the threshold (a fraction: 0.10 = 10% slower); on noisy
+machines --metric min is the most stable choice. Results only present on
+one side are listed but do not fail the comparison.
+
+Exits 1 if any benchmark regressed, 0 otherwise.
+"""
+
+import argparse
+import json
+import sys
+
+
+def load(path):
+    with open(path) as f:
+        data = json.load(f)
+    if data.get("format") != "east-c-bench/1":
+        sys.exit(f"{path}: not an east-c-bench result file")
+    return data, {r["name"]: r for r in data["results"]}
+
+
+def fmt_ns(ns):
+    for unit, scale in (("s", 1e9), ("ms", 1e6), ("us", 1e3)):
+        if ns >= scale:
+            return f"{ns / scale:.2f} {unit}"
+    return f"{ns:.1f} ns"
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("baseline")
+    parser.add_argument("current")
+    parser.add_argument("--threshold", type=float, default=0.10)
+    parser.add_argument("--metric", choices=("median", "p99", "min"), default="median")
+    args = parser.parse_args()
+
+    base_meta, base = load(args.baseline)
+    cur_meta, cur = load(args.current)
+    key = f"{args.metric}_ns"
+
+    def per_op(r):
+        return r[key] / max(r["ops"], 1)
+
+    if base_meta.get("scale") != cur_meta.get("scale"):
+        print(f"warning: problem sizes differ (scale {base_meta.get('scale')} "
+              f"vs {cur_meta.get('scale')}); per-op times may not be comparable")
+    if base_meta.get("host") != cur_meta.get("host"):
+        print(f"warning: results come from different hosts "
+              f"({base_meta.get('host')} vs {cur_meta.get('host')})")
+
+    regressions = []
+    print(f"{'benchmark':<34} {'baseline':>12} {'current':>12} {'change':>9}")
+    for name in sorted(set(base) | set(cur)):
+        if name not in cur:
+            print(f"{name:<34} {fmt_ns(per_op(base[name])):>12} {'-':>12}   removed")
+            continue
+        if name not in base:
+            print(f"{name:<34} {'-':>12} {fmt_ns(per_op(cur[name])):>12}       new")
+            continue
+        old, new = per_op(base[name]), per_op(cur[name])
+        change = (new - old) / old if old > 0 else 0.0
+        flag = ""
+        if change > args.threshold:
+            flag = "  REGRESSION"
+            regressions.append(name)
+        elif change < -args.threshold:
+            flag = "  improved"
+        print(f"{name:<34} {fmt_ns(old):>12} {fmt_ns(new):>12} {change:>+8.1%}{flag}")
+
+    if regressions:
+        print(f"\n{len(regressions)} regression(s) over {args.threshold:.0%}: "
+              + ", ".join(regressions))
+        return 1
+    print(f"\nNo regressions over {args.threshold:.0%}.")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,136 @@
+/*
+ * Ownership-taking IR builders for benchmark programs (see bench.h).
+ */
+
+#include "bench.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static void release_all(IRNode **nodes, size_t n)
+{
+    for (size_t i = 0; i < n; i++) ir_node_release(nodes[i]);
+}
+
+IRNode *b_value(EastType *type, EastValue *v)
+{
+    IRNode *n = ir_value(type, v);
+    east_value_release(v);
+    return n;
+}
+
+IRNode *b_int(int64_t v) { return b_value(&east_integer_type, east_integer(v)); }
+IRNode *b_float(double v) { return b_value(&east_float_type, east_float(v)); }
+
+IRNode *b_var(EastType *type, const char *name)
+{
+    return ir_variable(type, name, false, false);
+}
+
+IRNode *b_mvar(EastType *type, const char *name)
+{
+    return ir_variable(type, name, true, false);
+}
+
+static IRNode *let_impl(const char *name, bool mutable, IRNode *value)
+{
+    IRNode *n = ir_let(&east_null_type, name, mutable, false, value);
+    ir_node_release(value);
+    return n;
+}
+
+IRNode *b_let(const char *name, IRNode *value) { return let_impl(name, false, value); }
+IRNode *b_let_mut(const char *name, IRNode *value) { return let_impl(name, true, value); }
+
+IRNode *b_assign(const char *name, IRNode *value)
+{
+    IRNode *n = ir_assign(&east_null_type, name, value);
+    ir_node_release(value);
+    return n;
+}
+
+IRNode *b_block(EastType *type, IRNode **stmts, size_t n)
+{
+    IRNode *b = ir_block(type, stmts, n);
+    release_all(stmts, n);
+    return b;
+}
+
+IRNode *b_while(IRNode *cond, IRNode *body)
+{
+    IRNode *n = ir_while(&east_null_type, cond, body, NULL);
+    ir_node_release(cond);
+    ir_node_release(body);
+    return n;
+}
+
+IRNode *b_builtin(EastType *type, const char *name, EastType *tp,
+                  IRNode **args, size_t n)
+{
+    IRNode *b = ir_builtin(type, name, tp ? &tp : NULL, tp ? 1 : 0, args, n);
+    release_all(args, n);
+    return b;
+}
+
+IRNode *b_call(EastType *type, IRNode *fn, IRNode **args, size_t n)
+{
+    IRNode *c = ir_call(type, fn, args, n);
+    ir_node_release(fn);
+    release_all(args, n);
+    return c;
+}
+
+IRNode *b_platform(EastType *type, const char *name, IRNode **args, size_t n)
+{
+    IRNode *p = ir_platform(type, name, NULL, 0, args, n, false, false);
+    release_all(args, n);
+    return p;
+}
+
+IRNode *b_count_loop(const char *var, int64_t n, IRNode *body,
+                     EastType *result_type, IRNode *result)
+{
+    IRNode *cmp[] = { b_mvar(&east_integer_type, var), b_int(n) };
+    IRNode *cond = b_builtin(&east_boolean_type, "Less", &east_integer_type, cmp, 2);
+    IRNode *inc[] = { b_mvar(&east_integer_type, var), b_int(1) };
+    IRNode *step = b_assign(var,
+        b_builtin(&east_integer_type, "IntegerAdd", NULL, inc, 2));
+    IRNode *loop_body[] = { body, step };
+    IRNode *loop = b_while(cond, b_block(&east_null_type, loop_body, 2));
+
+    IRNode *stmts[] = { b_let_mut(var, b_int(0)), loop, result };
+    if (!result) {
+        return b_block(&east_null_type, stmts, 2);
+    }
+    return b_block(result_type, stmts, 3);
+}
+
+EastCompiledFn *bench_compile(const BenchContext *ctx, IRNode *fn_node)
+{
+    EastCompiledFn *fn = east_compile(fn_node->data.function.body,
+                                      ctx->platform, ctx->builtins);
+    if (!fn) return NULL;
+
+    fn->num_params = fn_node->data.function.num_params;
+    if (fn->num_params > 0) {
+        fn->param_names = calloc(fn->num_params, sizeof(char *));
+        for (size_t i = 0; i < fn->num_params; i++) {
+            fn->param_names[i] = strdup(fn_node->data.function.params[i].name);
+        }
+    }
+    return fn;
+}
+
+bool bench_call(EastCompiledFn *fn, EastValue **args, size_t n)
+{
+    EvalResult r = east_call(fn, args, n);
+    bool ok = r.status == EVAL_OK || r.status == EVAL_RETURN;
+    if (!ok) {
+        fprintf(stderr, "  error: %s\n",
+                r.error_message ? r.error_message : "evaluation failed");
+    }
+    if (r.value) east_value_release(r.value);
+    eval_result_free(&r);
+    return ok;
+}
@@ -0,0 +1,317 @@
+/*
+ * east-c-bench: microbenchmark runner.
+ *
+ * Usage: east-c-bench [options]
+ *   --filter STR     Only run benchmarks whose name contains STR
+ *   --reps N         Timed repetitions per benchmark (default 15)
+ *   --warmup N       Untimed repetitions before measuring (default 3)
+ *   --quick          Shrink problem sizes 10x (smoke runs, CI)
+ *   --json FILE      Write results as JSON (see bench/compare.py)
+ *   --list           List benchmark names and exit
+ *
+ * Each benchmark reports the median, p99 and minimum time per operation
+ * across repetitions, plus throughput for benchmarks that process bytes
+ * and GFLOP/s for those that report floating-point work.
+ * Collectable cycles are cleared between repetitions so one run's garbage
+ * does not land in the next run's timing.
+ */
+
+#include "bench.h"
+
+#include <east/gc.h>
+#include <east_std/east_std.h>
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+typedef struct {
+    char *name;
+    BenchSetupFn setup;
+    BenchRunFn run;
+    BenchTeardownFn teardown;
+} BenchEntry;
+
+struct BenchSuite {
+    BenchEntry *entries;
+    size_t count;
+    size_t cap;
+};
+
+typedef struct {
+    const char *name;
+    const char *unit;
+    size_t ops;
+    size_t bytes;
+    size_t flops;
+    size_t reps;
+    double median_ns;   // per run
+    double p99_ns;
+    double min_ns;
+    double mean_ns;
+} BenchResult;
+
+void bench_add(BenchSuite *suite, const char *name, BenchSetupFn setup,
+               BenchRunFn run, BenchTeardownFn teardown)
+{
+    if (suite->count == suite->cap) {
+        suite->cap = suite->cap ? suite->cap * 2 : 32;
+        suite->entries = realloc(suite->entries, suite->cap * sizeof(BenchEntry));
+    }
+    BenchEntry *e = &suite->entries[suite->count++];
+    e->name = strdup(name);
+    e->setup = setup;
+    e->run = run;
+    e->teardown = teardown;
+}
+
+size_t bench_size(const BenchContext *ctx, size_t n, size_t min)
+{
+    size_t scaled = (size_t)((double)n * ctx->scale);
+    return scaled < min ? min : scaled;
+}
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static int cmp_double(const void *a, const void *b)
+{
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+/* Nearest-rank percentile over sorted samples. */
+static double percentile(const double *sorted, size_t n, double p)
+{
+    size_t rank = (size_t)ceil(p * (double)n);
+    if (rank < 1) rank = 1;
+    if (rank > n) rank = n;
+    return sorted[rank - 1];
+}
+
+static double median(const double *sorted, size_t n)
+{
+    if (n % 2) return sorted[n / 2];
+    return (sorted[n / 2 - 1] + sorted[n / 2]) / 2.0;
+}
+
+static bool run_one(BenchEntry *e, BenchContext *ctx, size_t warmup,
+                    size_t reps, BenchResult *out)
+{
+    ctx->ops = 1;
+    ctx->bytes = 0;
+    ctx->flops = 0;
+    ctx->unit = "op";
+    void *state = e->setup(ctx);
+    if (!state) {
+        fprintf(stderr, "%s: setup failed\n", e->name);
+        return false;
+    }
+
+    bool ok = true;
+    for (size_t i = 0; i < warmup && ok; i++) {
+        ok = e->run(state);
+        east_gc_collect();
+    }
+
+    double *samples = calloc(reps, sizeof(double));
+    for (size_t i = 0; i < reps && ok; i++) {
+        uint64_t t0 = now_ns();
+        ok = e->run(state);
+        samples[i] = (double)(now_ns() - t0);
+        east_gc_collect();
+    }
+    e->teardown(state);
+    east_gc_collect();
+
+    if (!ok) {
+        fprintf(stderr, "%s: run failed\n", e->name);
+        free(samples);
+        return false;
+    }
+
+    qsort(samples, reps, sizeof(double), cmp_double);
+    double sum = 0;
+    for (size_t i = 0; i < reps; i++) sum += samples[i];
+
+    out->name = e->name;
+    out->unit = ctx->unit;
+    out->ops = ctx->ops ? ctx->ops : 1;
+    out->bytes = ctx->bytes;
+    out->flops = ctx->flops;
+    out->reps = reps;
+    out->median_ns = median(samples, reps);
+    out->p99_ns = percentile(samples, reps, 0.99);
+    out->min_ns = samples[0];
+    out->mean_ns = sum / (double)reps;
+    free(samples);
+    return true;
+}
+
+static void format_time(char *buf, size_t size, double ns)
+{
+    if (ns < 1e3) snprintf(buf, size, "%.1f ns", ns);
+    else if (ns < 1e6) snprintf(buf, size, "%.2f us", ns / 1e3);
+    else if (ns < 1e9) snprintf(buf, size, "%.2f ms", ns / 1e6);
+    else snprintf(buf, size, "%.2f s", ns / 1e9);
+}
+
+static void print_result(const BenchResult *r)
+{
+    char med[32], p99[32], min[32];
+    double ops = (double)r->ops;
+    format_time(med, sizeof(med), r->median_ns / ops);
+    format_time(p99, sizeof(p99), r->p99_ns / ops);
+    format_time(min, sizeof(min), r->min_ns / ops);
+    printf("%-34s %12s %12s %12s  /%s", r->name, med, p99, min, r->unit);
+    if (r->bytes) {
+        printf("  %8.1f MB/s", (double)r->bytes / (r->median_ns / 1e9) / 1e6);
+    }
+    if (r->flops) {
+        printf("  %8.2f GFLOP/s", (double)r->flops / r->median_ns);
+    }
+    printf("\n");
+    fflush(stdout);
+}
+
+static void json_string(FILE *f, const char *s)
+{
+    fputc('"', f);
+    for (; *s; s++) {
+        if (*s == '"' || *s == '\\') fputc('\\', f);
+        fputc(*s, f);
+    }
+    fputc('"', f);
+}
+
+static bool write_json(const char *path, const BenchResult *results, size_t n,
+                       size_t warmup, size_t reps, double scale)
+{
+    FILE *f = fopen(path, "w");
+    if (!f) {
+        perror(path);
+        return false;
+    }
+    char host[256] = "unknown";
+    gethostname(host, sizeof(host) - 1);
+
+    fprintf(f, "{\n  \"format\": \"east-c-bench/1\",\n");
+    fprintf(f, "  \"timestamp\": %lld,\n", (long long)time(NULL));
+    fprintf(f, "  \"host\": ");
+    json_string(f, host);
+    fprintf(f, ",\n  \"cpus\": %ld,\n", sysconf(_SC_NPROCESSORS_ONLN));
+    fprintf(f, "  \"warmup\": %zu,\n  \"reps\": %zu,\n  \"scale\": %g,\n",
+            warmup, reps, scale);
+    fprintf(f, "  \"results\": [");
+    for (size_t i = 0; i < n; i++) {
+        const BenchResult *r = &results[i];
+        double ops = (double)r->ops;
+        fprintf(f, "%s\n    {\"name\": ", i ? "," : "");
+        json_string(f, r->name);
+        fprintf(f, ", \"unit\": ");
+        json_string(f, r->unit);
+        fprintf(f, ", \"ops\": %zu, \"bytes\": %zu, \"flops\": %zu,"
+                   " \"reps\": %zu,"
+                   " \"median_ns\": %.1f, \"p99_ns\": %.1f, \"min_ns\": %.1f,"
+                   " \"mean_ns\": %.1f, \"median_ns_per_op\": %.3f,"
+                   " \"p99_ns_per_op\": %.3f}",
+                r->ops, r->bytes, r->flops, r->reps, r->median_ns, r->p99_ns,
+                r->min_ns, r->mean_ns, r->median_ns / ops, r->p99_ns / ops);
+    }
+    fprintf(f, "\n  ]\n}\n");
+    return fclose(f) == 0;
+}
+
+static void usage(void)
+{
+    fprintf(stderr,
+        "Usage: east-c-bench [--filter STR] [--reps N] [--warmup N] [--quick]\n"
+        "                    [--json FILE] [--list]\n");
+}
+
+int main(int argc, char **argv)
+{
+    const char *filter = NULL;
+    const char *json_path = NULL;
+    size_t reps = 15, warmup = 3;
+    double scale = 1.0;
+    bool list = false;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            filter = argv[++i];
+        } else if (strcmp(argv[i], "--reps") == 0 && i + 1 < argc) {
+            reps = (size_t)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--warmup") == 0 && i + 1 < argc) {
+            warmup = (size_t)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--quick") == 0) {
+            scale = 0.1;
+        } else if (strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+            json_path = argv[++i];
+        } else if (strcmp(argv[i], "--list") == 0) {
+            list = true;
+        } else {
+            usage();
+            return 2;
+        }
+    }
+    if (reps == 0) reps = 1;
+
+    BenchSuite suite = {0};
+    bench_register_eval(&suite);
+    bench_register_collections(&suite);
+    bench_register_strings(&suite);
+    bench_register_datetime(&suite);
+    bench_register_codecs(&suite);
+    bench_register_runtime(&suite);
+    bench_register_vectors(&suite);
+    bench_register_matrix(&suite);
+
+    BenchContext ctx = {0};
+    ctx.scale = scale;
+    ctx.builtins = builtin_registry_new();
+    east_register_all_builtins(ctx.builtins);
+    ctx.platform = platform_registry_new();
+    east_std_register_all(ctx.platform);
+
+    BenchResult *results = calloc(suite.count, sizeof(BenchResult));
+    size_t num_results = 0;
+    int failures = 0;
+
+    if (!list) {
+        printf("%-34s %12s %12s %12s\n", "benchmark", "median", "p99", "min");
+    }
+    for (size_t i = 0; i < suite.count; i++) {
+        BenchEntry *e = &suite.entries[i];
+        if (filter && !strstr(e->name, filter)) continue;
+        if (list) {
+            printf("%s\n", e->name);
+            continue;
+        }
+        if (run_one(e, &ctx, warmup, reps, &results[num_results])) {
+            print_result(&results[num_results]);
+            num_results++;
+        } else {
+            failures++;
+        }
+    }
+
+    if (json_path && !list
+        && !write_json(json_path, results, num_results, warmup, reps, scale)) {
+        failures++;
+    }
+
+    free(results);
+    for (size_t i = 0; i < suite.count; i++) free(suite.entries[i].name);
+    free(suite.entries);
+    platform_registry_free(ctx.platform);
+    builtin_registry_free(ctx.builtins);
+    return failures ? 1 : 0;
+}
@@ -2,20 +2,34 @@
  * east-c CLI — Run compiled East IR programs from the command line.
  *
  * Usage:
- *   east-c run <ir_file> [-p PACKAGE...] [-i FILE...] [-o FILE] [-v]
+ *   east-c run <ir_file> [-p PACKAGE...] [-i FILE...] [-o FILE] [-v] [--cache DIR]
+ *              [--profile FILE] [--mem-report] [--mem-limit SIZE] [--console MODE]
+ *   east-c serve [-p PACKAGE...] [--socket PATH] [--cache DIR] [--console MODE] [-v]
  *   east-c version [-p PACKAGE...]
  */
 
 #include <east/east.h>
 #include <east/eval_result.h>
 #include <east/type_of_type.h>
+#include <east/ir_image.h>
+#include <east/memory.h>
+#include <east/profiler.h>
 #include <east_std/east_std.h>
 
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdarg.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
 #include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
 
 static double elapsed_ms(struct timespec *start, struct timespec *end)
 {
@@ -136,54 +150,30 @@ static int write_file_binary(const char *path, const uint8_t *data, size_t len)
 /*  IR / value loading and saving                                      */
 /* ------------------------------------------------------------------ */
 
-static EastValue *load_ir(const char *path, bool verbose)
+static EastValue *decode_ir(FileFormat fmt, const char *path, const char *data, size_t len)
 {
-    FileFormat fmt = detect_format(path);
-    if (fmt == FMT_UNKNOWN) {
-        fprintf(stderr, "Error: Unknown file extension for: %s\n"
-                "Supported: .beast2, .beast, .east, .json\n", path);
-        return NULL;
-    }
-
-    if (verbose) fprintf(stderr, "Loading IR from %s (format: %s)\n", path, format_name(fmt));
-
-    if (fmt == FMT_JSON) {
-        size_t len = 0;
-        char *text = read_file_text(path, &len);
-        if (!text) return NULL;
-        EastValue *val = east_json_decode(text, east_ir_type);
-        free(text);
+    EastValue *val = NULL;
+    switch (fmt) {
+    case FMT_JSON:
+        val = east_json_decode(data, east_ir_type);
         if (!val) fprintf(stderr, "Error: Failed to decode JSON IR from %s\n", path);
-        return val;
-    }
-    if (fmt == FMT_BEAST2) {
-        size_t len = 0;
-        uint8_t *data = read_file_binary(path, &len);
-        if (!data) return NULL;
-        EastValue *val = east_beast2_decode_full(data, len, east_ir_type);
-        free(data);
+        break;
+    case FMT_BEAST2:
+        val = east_beast2_decode_full((const uint8_t *)data, len, east_ir_type);
         if (!val) fprintf(stderr, "Error: Failed to decode Beast2 IR from %s\n", path);
-        return val;
-    }
-    if (fmt == FMT_BEAST) {
-        size_t len = 0;
-        uint8_t *data = read_file_binary(path, &len);
-        if (!data) return NULL;
-        EastValue *val = east_beast_decode(data, len, east_ir_type);
-        free(data);
+        break;
+    case FMT_BEAST:
+        val = east_beast_decode((const uint8_t *)data, len, east_ir_type);
         if (!val) fprintf(stderr, "Error: Failed to decode Beast IR from %s\n", path);
-        return val;
-    }
-    if (fmt == FMT_EAST) {
-        size_t len = 0;
-        char *text = read_file_text(path, &len);
-        if (!text) return NULL;
-        EastValue *val = east_parse_value(text, east_ir_type);
-        free(text);
+        break;
+    case FMT_EAST:
+        val = east_parse_value(data, east_ir_type);
         if (!val) fprintf(stderr, "Error: Failed to parse East IR from %s\n", path);
-        return val;
+        break;
+    default:
+        break;
     }
-    return NULL;
+    return val;
 }
 
 static EastValue *load_value(const char *path, EastType *type)
@@ -272,6 +262,194 @@ static int save_value(const char *path, EastValue *value, EastType *type)
     return -1;
 }
 
+/* ------------------------------------------------------------------ */
+/*  Program image cache                                                */
+/* ------------------------------------------------------------------ */
+
+/*
+ * Cached images are keyed by the IR file bytes together with the format and
+ * runtime version, so editing the program or upgrading east-c simply misses.
+ * Each entry is a single file, DIR/<key>.eimg, replaced atomically.
+ */
+
+static uint64_t program_cache_key(FileFormat fmt, const uint8_t *data, size_t len)
+{
+    char key[160];
+    int n = snprintf(key, sizeof(key), "%016llx:%s:%s:%d",
+                     (unsigned long long)east_ir_image_hash(data, len),
+                     format_name(fmt), EAST_RUNTIME_VERSION, EAST_IR_IMAGE_VERSION);
+    if (n < 0) n = 0;
+    if ((size_t)n >= sizeof(key)) n = (int)sizeof(key) - 1;
+    return east_ir_image_hash((const uint8_t *)key, (size_t)n);
+}
+
+static char *program_cache_path(const char *dir, uint64_t key)
+{
+    size_t len = strlen(dir) + 32;
+    char *path = malloc(len);
+    if (!path) return NULL;
+    snprintf(path, len, "%s/%016llx.eimg", dir, (unsigned long long)key);
+    return path;
+}
+
+static IRNode *program_cache_load(const char *path, uint64_t key)
+{
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return NULL;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        close(fd);
+        return NULL;
+    }
+
+    size_t len = (size_t)st.st_size;
+    void *map = mmap(NULL, len, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) return NULL;
+
+    IRNode *ir = east_ir_image_decode((const uint8_t *)map, len, key);
+    munmap(map, len);
+    return ir;
+}
+
+static void program_cache_store(const char *dir, const char *path,
+                                IRNode *ir, uint64_t key, bool verbose)
+{
+    ByteBuffer *img = east_ir_image_encode(ir, key);
+    if (!img) {
+        if (verbose) fprintf(stderr, "Program cache: IR cannot be cached\n");
+        return;
+    }
+
+    if (mkdir(dir, 0755) != 0 && errno != EEXIST) {
+        if (verbose) fprintf(stderr, "Program cache: cannot create %s\n", dir);
+        byte_buffer_free(img);
+        return;
+    }
+
+    size_t tmp_len = strlen(path) + 32;
+    char *tmp = malloc(tmp_len);
+    if (!tmp) {
+        byte_buffer_free(img);
+        return;
+    }
+    snprintf(tmp, tmp_len, "%s.%ld.tmp", path, (long)getpid());
+
+    bool ok = false;
+    FILE *f = fopen(tmp, "wb");
+    if (f) {
+        ok = fwrite(img->data, 1, img->len, f) == img->len;
+        ok = (fclose(f) == 0) && ok;
+    }
+    if (ok) ok = rename(tmp, path) == 0;
+    if (!ok) {
+        unlink(tmp);
+        if (verbose) fprintf(stderr, "Program cache: cannot write %s\n", path);
+    } else if (verbose) {
+        fprintf(stderr, "Program cache: stored %s (%zu bytes)\n", path, img->len);
+    }
+
+    free(tmp);
+    byte_buffer_free(img);
+}
+
+/*
+ * Convert IR file contents (NUL-terminated, as read_file_text returns) into
+ * an IRNode tree, going through the image cache in cache_dir when one is
+ * given. name is only used in messages. t_decode / t_convert are stamped
+ * after the IR value is decoded and converted (both at once on a cache hit).
+ */
+static IRNode *load_ir_data(FileFormat fmt, const char *name,
+                            const char *data, size_t len,
+                            const char *cache_dir, bool verbose,
+                            struct timespec *t_decode, struct timespec *t_convert,
+                            bool *cache_hit)
+{
+    *cache_hit = false;
+
+    uint64_t key = 0;
+    char *image_path = NULL;
+    if (cache_dir) {
+        key = program_cache_key(fmt, (const uint8_t *)data, len);
+        image_path = program_cache_path(cache_dir, key);
+        IRNode *ir = image_path ? program_cache_load(image_path, key) : NULL;
+        if (ir) {
+            if (verbose) fprintf(stderr, "Program cache: hit %s\n", image_path);
+            free(image_path);
+            clock_gettime(CLOCK_MONOTONIC, t_decode);
+            *t_convert = *t_decode;
+            *cache_hit = true;
+            return ir;
+        }
+        if (verbose) fprintf(stderr, "Program cache: miss\n");
+    }
+
+    EastValue *ir_val = decode_ir(fmt, name, data, len);
+    clock_gettime(CLOCK_MONOTONIC, t_decode);
+    if (!ir_val) {
+        free(image_path);
+        return NULL;
+    }
+
+    IRNode *ir = east_ir_from_value(ir_val);
+    clock_gettime(CLOCK_MONOTONIC, t_convert);
+    east_value_release(ir_val);
+
+    if (!ir) {
+        fprintf(stderr, "Error: Failed to convert IR value to IR node\n");
+    } else if (image_path) {
+        program_cache_store(cache_dir, image_path, ir, key, verbose);
+    }
+    free(image_path);
+    return ir;
+}
+
+static IRNode *load_ir(const char *path, const char *cache_dir, bool verbose,
+                       struct timespec *t_decode, struct timespec *t_convert,
+                       bool *cache_hit)
+{
+    *cache_hit = false;
+
+    FileFormat fmt = detect_format(path);
+    if (fmt == FMT_UNKNOWN) {
+        fprintf(stderr, "Error: Unknown file extension for: %s\n"
+                "Supported: .beast2, .beast, .east, .json\n", path);
+        return NULL;
+    }
+
+    if (verbose) fprintf(stderr, "Loading IR from %s (format: %s)\n", path, format_name(fmt));
+
+    size_t len = 0;
+    char *data = read_file_text(path, &len);
+    if (!data) return NULL;
+
+    IRNode *ir = load_ir_data(fmt, path, data, len, cache_dir, verbose,
+                              t_decode, t_convert, cache_hit);
+    free(data);
+    return ir;
+}
+
+/*
+ * Compile the body of a program's entry function and bind its parameter
+ * names so east_call can be used on the result.
+ */
+static EastCompiledFn *compile_entry(IRNode *ir, PlatformRegistry *platform,
+                                     BuiltinRegistry *builtins)
+{
+    EastCompiledFn *fn = east_compile(ir->data.function.body, platform, builtins);
+    if (!fn) return NULL;
+
+    fn->num_params = ir->data.function.num_params;
+    if (fn->num_params > 0) {
+        fn->param_names = calloc(fn->num_params, sizeof(char *));
+        for (size_t i = 0; i < fn->num_params; i++) {
+            fn->param_names[i] = strdup(ir->data.function.params[i].name);
+        }
+    }
+    return fn;
+}
+
 /* ------------------------------------------------------------------ */
 /*  Package resolution                                                 */
 /* ------------------------------------------------------------------ */
@@ -282,6 +460,23 @@ static bool is_std_package(const char *name)
         || strcmp(name, "std") == 0;
 }
 
+static bool register_packages(PlatformRegistry *platform,
+                              const char **packages, int num_packages, bool verbose)
+{
+    for (int i = 0; i < num_packages; i++) {
+        if (is_std_package(packages[i])) {
+            if (verbose) fprintf(stderr, "Loading platform: %s\n", packages[i]);
+            east_std_register_all(platform);
+        } else {
+            fprintf(stderr, "Error: Unknown platform package: %s\n"
+                    "Available: east-c-std (or shorthand: std)\n",
+                    packages[i]);
+            return false;
+        }
+    }
+    return true;
+}
+
 /* ------------------------------------------------------------------ */
 /*  Commands                                                           */
 /* ------------------------------------------------------------------ */
@@ -290,6 +485,9 @@ static int cmd_run(const char *ir_path,
                    const char **packages, int num_packages,
                    const char **input_files, int num_inputs,
                    const char *output_file,
+                   const char *cache_dir,
+                   const char *profile_file,
+                   bool mem_report,
                    bool verbose)
 {
     /* Init type system */
@@ -302,39 +500,20 @@ static int cmd_run(const char *ir_path,
     PlatformRegistry *platform = platform_registry_new();
 
     /* Register platform packages */
-    for (int i = 0; i < num_packages; i++) {
-        if (is_std_package(packages[i])) {
-            if (verbose) fprintf(stderr, "Loading platform: %s\n", packages[i]);
-            east_std_register_all(platform);
-        } else {
-            fprintf(stderr, "Error: Unknown platform package: %s\n"
-                    "Available: east-c-std (or shorthand: std)\n",
-                    packages[i]);
-            platform_registry_free(platform);
-            builtin_registry_free(builtins);
-            return 1;
-        }
+    if (!register_packages(platform, packages, num_packages, verbose)) {
+        platform_registry_free(platform);
+        builtin_registry_free(builtins);
+        return 1;
     }
 
     struct timespec t0, t1, t2, t3, t4, t5;
 
     /* Load IR */
     struct timespec t_decode, t_convert;
+    bool cache_hit = false;
     clock_gettime(CLOCK_MONOTONIC, &t0);
-    EastValue *ir_val = load_ir(ir_path, verbose);
-    if (!ir_val) {
-        platform_registry_free(platform);
-        builtin_registry_free(builtins);
-        return 1;
-    }
-    clock_gettime(CLOCK_MONOTONIC, &t_decode);
-
-    IRNode *ir = east_ir_from_value(ir_val);
-    clock_gettime(CLOCK_MONOTONIC, &t_convert);
-    east_value_release(ir_val);
-
+    IRNode *ir = load_ir(ir_path, cache_dir, verbose, &t_decode, &t_convert, &cache_hit);
     if (!ir) {
-        fprintf(stderr, "Error: Failed to convert IR value to IR node\n");
         platform_registry_free(platform);
         builtin_registry_free(builtins);
         return 1;
@@ -428,8 +607,7 @@ static int cmd_run(const char *ir_path,
     clock_gettime(CLOCK_MONOTONIC, &t1);
     if (verbose) fprintf(stderr, "Compiling...\n");
 
-    IRNode *body = ir->data.function.body;
-    EastCompiledFn *fn = east_compile(body, platform, builtins);
+    EastCompiledFn *fn = compile_entry(ir, platform, builtins);
     if (!fn) {
         fprintf(stderr, "Error: Failed to compile IR\n");
         for (int i = 0; i < num_inputs; i++) east_value_release(args[i]);
@@ -440,22 +618,37 @@ static int cmd_run(const char *ir_path,
         return 1;
     }
 
-    /* Set parameter names so east_call can bind arguments */
-    fn->num_params = ir->data.function.num_params;
-    if (fn->num_params > 0) {
-        fn->param_names = calloc(fn->num_params, sizeof(char *));
-        for (size_t i = 0; i < fn->num_params; i++) {
-            fn->param_names[i] = strdup(ir->data.function.params[i].name);
-        }
-    }
-
     /* Execute */
     clock_gettime(CLOCK_MONOTONIC, &t2);
     if (verbose) fprintf(stderr, "Executing...\n");
 
+    EastProfiler *profiler = profile_file ? east_profiler_new() : NULL;
+    if (profiler) east_profiler_start(profiler);
+
     EvalResult result = east_call(fn, args, (size_t)num_inputs);
+    /* Program output goes out before any report, error or result */
+    east_std_console_flush();
     clock_gettime(CLOCK_MONOTONIC, &t3);
 
+    if (profiler) {
+        east_profiler_stop(profiler);
+        FILE *pf = fopen(profile_file, "w");
+        if (!pf || !east_profiler_write_folded(profiler, pf)) {
+            fprintf(stderr, "Error: Cannot write profile: %s\n", profile_file);
+        }
+        if (pf) fclose(pf);
+        fprintf(stderr, "\n");
+        east_profiler_write_summary(profiler, stderr, 30);
+        fprintf(stderr, "\nFolded stacks written to %s\n\n", profile_file);
+        east_profiler_free(profiler);
+    }
+
+    if (mem_report) {
+        fprintf(stderr, "\n");
+        east_mem_write_report(stderr, 30);
+        fprintf(stderr, "\n");
+    }
+
     int exit_code = 0;
 
     if (result.status == EVAL_ERROR) {
@@ -509,8 +702,13 @@ static int cmd_run(const char *ir_path,
         long peak_kb = usage.ru_maxrss;
 
         fprintf(stderr, "\nTiming:\n");
-        fprintf(stderr, "  Load IR:    %8.1f ms  (decode: %.1f ms, ir_from_value: %.1f ms, release: %.1f ms)\n",
-                elapsed_ms(&t0, &t1), elapsed_ms(&t0, &t_decode), elapsed_ms(&t_decode, &t_convert), elapsed_ms(&t_convert, &t1));
+        if (cache_hit) {
+            fprintf(stderr, "  Load IR:    %8.1f ms  (cached image: %.1f ms)\n",
+                    elapsed_ms(&t0, &t1), elapsed_ms(&t0, &t_decode));
+        } else {
+            fprintf(stderr, "  Load IR:    %8.1f ms  (decode: %.1f ms, ir_from_value: %.1f ms, release: %.1f ms)\n",
+                    elapsed_ms(&t0, &t1), elapsed_ms(&t0, &t_decode), elapsed_ms(&t_decode, &t_convert), elapsed_ms(&t_convert, &t1));
+        }
         fprintf(stderr, "  Compile:    %8.1f ms\n", elapsed_ms(&t1, &t2));
         fprintf(stderr, "  Execute:    %8.1f ms\n", elapsed_ms(&t2, &t3));
         fprintf(stderr, "  Output:     %8.1f ms\n", elapsed_ms(&t3, &t4));
@@ -551,6 +749,500 @@ static int cmd_version(const char **packages, int num_packages)
     return 0;
 }
 
+/* ------------------------------------------------------------------ */
+/*  Serve mode                                                         */
+/* ------------------------------------------------------------------ */
+
+/*
+ * `east-c serve` keeps registries and compiled programs resident and
+ * answers requests over stdin/stdout or a Unix domain socket.
+ *
+ * Every message is a frame: u32 little-endian payload length + payload.
+ * Request payloads start with an op byte; all integers are little-endian.
+ *
+ *   'L' load    format name, NUL, IR file bytes
+ *               -> ok: u64 program id, u64 load ns
+ *   'R' run     u64 program id, u32 argc, argc x (u32 len, Beast2 full value)
+ *               -> ok: u64 decode ns, u64 execute ns, u64 encode ns,
+ *                      Beast2 full encoded result
+ *   'U' unload  u64 program id -> ok: (empty)
+ *   'T' stats   -> ok: u64 programs loaded, u64 runs, u64 failed runs
+ *   'S' stop    -> ok: (empty), then the server exits
+ *
+ * Response payloads start with a status byte: 0 = ok followed by the body
+ * above, 1 = error followed by a UTF-8 message. Program ids are the same
+ * content hash used for the image cache, so loading identical IR twice is
+ * a no-op. A frame longer than SERVE_MAX_FRAME gets an error and closes the
+ * connection, since the rest of the stream cannot be resynchronized. In
+ * stdio mode the program's own stdout is redirected to stderr
+ * so it cannot corrupt the framing.
+ */
+
+#define SERVE_MAX_FRAME (1u << 30)
+
+typedef struct {
+    IRNode *ir;
+    EastCompiledFn *fn;
+} ServedProgram;
+
+typedef struct {
+    BuiltinRegistry *builtins;
+    PlatformRegistry *platform;
+    Hashmap *programs;          /* "%016llx" program id -> ServedProgram */
+    const char *cache_dir;
+    uint64_t runs;              /* run requests that reached the program */
+    uint64_t run_errors;        /* ... and ended in an East error */
+    bool verbose;
+    bool stop;
+} Server;
+
+static void served_program_free(void *p)
+{
+    ServedProgram *prog = p;
+    east_compiled_fn_free(prog->fn);
+    ir_node_release(prog->ir);
+    free(prog);
+}
+
+static uint64_t elapsed_ns(struct timespec *start, struct timespec *end)
+{
+    return (uint64_t)(end->tv_sec - start->tv_sec) * 1000000000ull
+         + (uint64_t)(end->tv_nsec - start->tv_nsec);
+}
+
+static bool read_full(int fd, void *buf, size_t n)
+{
+    uint8_t *p = buf;
+    while (n > 0) {
+        ssize_t r = read(fd, p, n);
+        if (r < 0 && errno == EINTR) continue;
+        if (r <= 0) return false;
+        p += r;
+        n -= (size_t)r;
+    }
+    return true;
+}
+
+static bool write_full(int fd, const void *buf, size_t n)
+{
+    const uint8_t *p = buf;
+    while (n > 0) {
+        ssize_t w = write(fd, p, n);
+        if (w < 0 && errno == EINTR) continue;
+        if (w <= 0) return false;
+        p += w;
+        n -= (size_t)w;
+    }
+    return true;
+}
+
+static void put_u32(uint8_t *p, uint32_t v)
+{
+    for (int i = 0; i < 4; i++) p[i] = (uint8_t)(v >> (8 * i));
+}
+
+static uint32_t get_u32(const uint8_t *p)
+{
+    uint32_t v = 0;
+    for (int i = 0; i < 4; i++) v |= (uint32_t)p[i] << (8 * i);
+    return v;
+}
+
+static void put_u64(uint8_t *p, uint64_t v)
+{
+    for (int i = 0; i < 8; i++) p[i] = (uint8_t)(v >> (8 * i));
+}
+
+static uint64_t get_u64(const uint8_t *p)
+{
+    uint64_t v = 0;
+    for (int i = 0; i < 8; i++) v |= (uint64_t)p[i] << (8 * i);
+    return v;
+}
+
+/* Returns a malloc'd, NUL-terminated payload, or NULL on EOF / bad frame.
+ * A frame over SERVE_MAX_FRAME also sets *too_large. */
+static uint8_t *serve_read_frame(int fd, size_t *out_len, bool *too_large)
+{
+    uint8_t hdr[4];
+    *too_large = false;
+    if (!read_full(fd, hdr, 4)) return NULL;
+    uint32_t len = get_u32(hdr);
+    if (len > SERVE_MAX_FRAME) {
+        *too_large = true;
+        *out_len = len;
+        return NULL;
+    }
+    uint8_t *buf = malloc((size_t)len + 1);
+    if (!buf) return NULL;
+    if (!read_full(fd, buf, len)) {
+        free(buf);
+        return NULL;
+    }
+    buf[len] = '\0';
+    *out_len = len;
+    return buf;
+}
+
+static bool serve_write_frame(int fd, uint8_t status, const uint8_t *body, size_t len)
+{
+    uint8_t hdr[5];
+    put_u32(hdr, (uint32_t)(len + 1));
+    hdr[4] = status;
+    return write_full(fd, hdr, 5) && (len == 0 || write_full(fd, body, len));
+}
+
+static bool serve_error(int fd, const char *fmt, ...)
+    __attribute__((format(printf, 2, 3)));
+
+static bool serve_error(int fd, const char *fmt, ...)
+{
+    char msg[1024];
+    va_list ap;
+    va_start(ap, fmt);
+    int n = vsnprintf(msg, sizeof(msg), fmt, ap);
+    va_end(ap);
+    if (n < 0) n = 0;
+    if ((size_t)n >= sizeof(msg)) n = (int)sizeof(msg) - 1;
+    return serve_write_frame(fd, 1, (const uint8_t *)msg, (size_t)n);
+}
+
+static FileFormat format_from_name(const char *name)
+{
+    if (strcmp(name, "json") == 0) return FMT_JSON;
+    if (strcmp(name, "beast2") == 0) return FMT_BEAST2;
+    if (strcmp(name, "beast") == 0) return FMT_BEAST;
+    if (strcmp(name, "east") == 0) return FMT_EAST;
+    return FMT_UNKNOWN;
+}
+
+static bool serve_load(Server *srv, int fd, const uint8_t *req, size_t len)
+{
+    struct timespec t0, t_decode, t_convert, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+
+    const uint8_t *nul = memchr(req, '\0', len);
+    if (!nul) return serve_error(fd, "load: missing format name");
+    FileFormat fmt = format_from_name((const char *)req);
+    if (fmt == FMT_UNKNOWN) {
+        return serve_error(fd, "load: unknown format '%s' (expected json, beast2, beast or east)",
+                           (const char *)req);
+    }
+
+    /* The frame buffer is NUL-terminated, so text formats can parse in place. */
+    const char *data = (const char *)nul + 1;
+    size_t data_len = len - (size_t)(nul + 1 - req);
+    uint64_t id = program_cache_key(fmt, (const uint8_t *)data, data_len);
+    char key[17];
+    snprintf(key, sizeof(key), "%016llx", (unsigned long long)id);
+
+    if (!hashmap_has(srv->programs, key)) {
+        bool cache_hit = false;
+        IRNode *ir = load_ir_data(fmt, "request", data, data_len, srv->cache_dir,
+                                  srv->verbose, &t_decode, &t_convert, &cache_hit);
+        if (!ir) return serve_error(fd, "load: failed to decode %s IR", format_name(fmt));
+
+        if ((ir->kind != IR_FUNCTION && ir->kind != IR_ASYNC_FUNCTION) || !ir->type ||
+            (ir->type->kind != EAST_TYPE_FUNCTION && ir->type->kind != EAST_TYPE_ASYNC_FUNCTION)) {
+            ir_node_release(ir);
+            return serve_error(fd, "load: IR must be a Function or AsyncFunction node");
+        }
+
+        EastCompiledFn *fn = compile_entry(ir, srv->platform, srv->builtins);
+        if (!fn) {
+            ir_node_release(ir);
+            return serve_error(fd, "load: failed to compile IR");
+        }
+
+        ServedProgram *prog = calloc(1, sizeof(ServedProgram));
+        if (!prog) {
+            east_compiled_fn_free(fn);
+            ir_node_release(ir);
+            return serve_error(fd, "load: out of memory");
+        }
+        prog->ir = ir;
+        prog->fn = fn;
+        hashmap_set(srv->programs, key, prog);
+        if (srv->verbose) fprintf(stderr, "serve: loaded program %s\n", key);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    uint8_t body[16];
+    put_u64(body, id);
+    put_u64(body + 8, elapsed_ns(&t0, &t1));
+    return serve_write_frame(fd, 0, body, sizeof(body));
+}
+
+static bool serve_run(Server *srv, int fd, const uint8_t *req, size_t len)
+{
+    if (len < 12) return serve_error(fd, "run: truncated request");
+
+    char key[17];
+    snprintf(key, sizeof(key), "%016llx", (unsigned long long)get_u64(req));
+    ServedProgram *prog = hashmap_get(srv->programs, key);
+    if (!prog) return serve_error(fd, "run: unknown program %s", key);
+
+    EastType *fn_type = prog->ir->type;
+    size_t num_params = fn_type->data.function.num_inputs;
+    uint32_t argc = get_u32(req + 8);
+    if (argc != num_params) {
+        return serve_error(fd, "run: program %s expects %zu inputs, got %u",
+                           key, num_params, (unsigned)argc);
+    }
+
+    struct timespec t0, t1, t2, t3;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+
+    EastValue **args = argc ? calloc(argc, sizeof(EastValue *)) : NULL;
+    size_t pos = 12;
+    for (uint32_t i = 0; i < argc; i++) {
+        uint32_t alen = (len - pos >= 4) ? get_u32(req + pos) : 0;
+        if (len - pos < 4 || alen > len - pos - 4) {
+            for (uint32_t j = 0; j < i; j++) east_value_release(args[j]);
+            free(args);
+            return serve_error(fd, "run: truncated input %u", (unsigned)i);
+        }
+        args[i] = east_beast2_decode_full(req + pos + 4, alen, fn_type->data.function.inputs[i]);
+        pos += 4 + (size_t)alen;
+        if (!args[i]) {
+            char tbuf[256];
+            east_type_print(fn_type->data.function.inputs[i], tbuf, sizeof(tbuf));
+            for (uint32_t j = 0; j < i; j++) east_value_release(args[j]);
+            free(args);
+            return serve_error(fd, "run: failed to decode input %u as %s", (unsigned)i, tbuf);
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+
+    EvalResult result = east_call(prog->fn, args, argc);
+    east_std_console_flush();
+    srv->runs++;
+    if (result.status == EVAL_ERROR) srv->run_errors++;
+    clock_gettime(CLOCK_MONOTONIC, &t2);
+
+    for (uint32_t i = 0; i < argc; i++) east_value_release(args[i]);
+    free(args);
+
+    bool ok;
+    if (result.status == EVAL_ERROR) {
+        char msg[4096];
+        int off = snprintf(msg, sizeof(msg), "%s",
+                           result.error_message ? result.error_message : "unknown error");
+        for (size_t i = 0; i < result.num_locations && off > 0 && (size_t)off < sizeof(msg); i++) {
+            off += snprintf(msg + off, sizeof(msg) - (size_t)off, "\n  at %s:%ld:%ld",
+                            result.locations[i].filename ? result.locations[i].filename : "?",
+                            (long)result.locations[i].line,
+                            (long)result.locations[i].column);
+        }
+        ok = serve_error(fd, "%s", msg);
+    } else {
+        ByteBuffer *out = east_beast2_encode_full(result.value, fn_type->data.function.output);
+        clock_gettime(CLOCK_MONOTONIC, &t3);
+        if (!out) {
+            ok = serve_error(fd, "run: failed to encode result");
+        } else {
+            size_t blen = 24 + out->len;
+            uint8_t *body = malloc(blen);
+            put_u64(body, elapsed_ns(&t0, &t1));
+            put_u64(body + 8, elapsed_ns(&t1, &t2));
+            put_u64(body + 16, elapsed_ns(&t2, &t3));
+            memcpy(body + 24, out->data, out->len);
+            ok = serve_write_frame(fd, 0, body, blen);
+            free(body);
+            byte_buffer_free(out);
+        }
+    }
+
+    if (srv->verbose) {
+        fprintf(stderr, "serve: run %s %s in %.3f ms\n", key,
+                result.status == EVAL_ERROR ? "failed" : "ok", elapsed_ms(&t0, &t2));
+    }
+    if (result.value) east_value_release(result.value);
+    eval_result_free(&result);
+    return ok;
+}
+
+/* Handle frames on one connection until EOF, an I/O error, or stop. */
+static void serve_connection(Server *srv, int in_fd, int out_fd)
+{
+    while (!srv->stop) {
+        size_t len = 0;
+        bool too_large;
+        uint8_t *req = serve_read_frame(in_fd, &len, &too_large);
+        if (!req) {
+            if (too_large) {
+                serve_error(out_fd, "frame of %zu bytes exceeds the %u byte limit",
+                            len, SERVE_MAX_FRAME);
+            }
+            return;
+        }
+
+        bool ok;
+        if (len == 0) {
+            ok = serve_error(out_fd, "empty request");
+        } else {
+            switch (req[0]) {
+            case 'L':
+                ok = serve_load(srv, out_fd, req + 1, len - 1);
+                break;
+            case 'R':
+                ok = serve_run(srv, out_fd, req + 1, len - 1);
+                break;
+            case 'U': {
+                char key[17];
+                if (len < 9) {
+                    ok = serve_error(out_fd, "unload: truncated request");
+                    break;
+                }
+                snprintf(key, sizeof(key), "%016llx", (unsigned long long)get_u64(req + 1));
+                hashmap_delete(srv->programs, key, served_program_free);
+                ok = serve_write_frame(out_fd, 0, NULL, 0);
+                break;
+            }
+            case 'T': {
+                uint8_t body[24];
+                put_u64(body, hashmap_count(srv->programs));
+                put_u64(body + 8, srv->runs);
+                put_u64(body + 16, srv->run_errors);
+                ok = serve_write_frame(out_fd, 0, body, sizeof(body));
+                break;
+            }
+            case 'S':
+                srv->stop = true;
+                ok = serve_write_frame(out_fd, 0, NULL, 0);
+                break;
+            default:
+                ok = serve_error(out_fd, "unknown op 0x%02x", req[0]);
+                break;
+            }
+        }
+        free(req);
+        if (!ok) return;
+    }
+}
+
+static int serve_socket(Server *srv, const char *path)
+{
+    struct sockaddr_un addr;
+    if (strlen(path) >= sizeof(addr.sun_path)) {
+        fprintf(stderr, "Error: Socket path too long: %s\n", path);
+        return 1;
+    }
+
+    int sock = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (sock < 0) {
+        fprintf(stderr, "Error: Cannot create socket: %s\n", strerror(errno));
+        return 1;
+    }
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, path);
+    unlink(path);
+    if (bind(sock, (struct sockaddr *)&addr, sizeof(addr)) != 0 || listen(sock, 16) != 0) {
+        fprintf(stderr, "Error: Cannot listen on %s: %s\n", path, strerror(errno));
+        close(sock);
+        return 1;
+    }
+    if (srv->verbose) fprintf(stderr, "serve: listening on %s\n", path);
+
+    /* Connections are served one at a time; the interpreter is single-threaded. */
+    while (!srv->stop) {
+        int conn = accept(sock, NULL, NULL);
+        if (conn < 0) {
+            if (errno == EINTR) continue;
+            fprintf(stderr, "Error: accept failed: %s\n", strerror(errno));
+            break;
+        }
+        serve_connection(srv, conn, conn);
+        close(conn);
+    }
+
+    close(sock);
+    unlink(path);
+    return 0;
+}
+
+static int cmd_serve(const char **packages, int num_packages,
+                     const char *socket_path, const char *cache_dir, bool verbose)
+{
+    east_type_of_type_init();
+
+    Server srv = {
+        .builtins = builtin_registry_new(),
+        .platform = platform_registry_new(),
+        .programs = hashmap_new(),
+        .cache_dir = cache_dir,
+        .verbose = verbose,
+    };
+    east_register_all_builtins(srv.builtins);
+
+    int rc = 0;
+    if (!register_packages(srv.platform, packages, num_packages, verbose)) {
+        rc = 1;
+    } else {
+        /* A client going away mid-response must not kill the server. */
+        signal(SIGPIPE, SIG_IGN);
+
+        if (socket_path) {
+            rc = serve_socket(&srv, socket_path);
+        } else {
+            /* Keep the real stdout for frames; program output goes to stderr. */
+            fflush(stdout);
+            int out_fd = dup(STDOUT_FILENO);
+            if (out_fd < 0 || dup2(STDERR_FILENO, STDOUT_FILENO) < 0) {
+                fprintf(stderr, "Error: Cannot redirect stdout: %s\n", strerror(errno));
+                rc = 1;
+            } else {
+                serve_connection(&srv, STDIN_FILENO, out_fd);
+                close(out_fd);
+            }
+        }
+    }
+
+    hashmap_free(srv.programs, served_program_free);
+    platform_registry_free(srv.platform);
+    builtin_registry_free(srv.builtins);
+    return rc;
+}
+
+/* Parse a byte count with an optional K, M or G (binary) suffix. */
+static bool parse_size(const char *text, uint64_t *out)
+{
+    char *end;
+    errno = 0;
+    unsigned long long n = strtoull(text, &end, 10);
+    if (errno || end == text) return false;
+    uint64_t scale = 1;
+    switch (*end) {
+    case 'k': case 'K': scale = 1024ULL; end++; break;
+    case 'm': case 'M': scale = 1024ULL * 1024; end++; break;
+    case 'g': case 'G': scale = 1024ULL * 1024 * 1024; end++; break;
+    default: break;
+    }
+    if (*end == 'B' || *end == 'b') end++;
+    if (*end != '\0' || n > UINT64_MAX / scale) return false;
+    *out = (uint64_t)n * scale;
+    return true;
+}
+
+/* ------------------------------------------------------------------ */
+/*  Console output mode                                                */
+/* ------------------------------------------------------------------ */
+
+static bool configure_console(const char *spec)
+{
+    if (!spec || !spec[0]) return true;
+    EastConsoleConfig config;
+    if (!east_std_console_parse_mode(spec, &config)) {
+        fprintf(stderr, "Error: Invalid console mode: %s\n"
+                "Expected unbuffered, line or block[:SIZE[:MS]]\n", spec);
+        return false;
+    }
+    east_std_console_configure(&config);
+    return true;
+}
+
 /* ------------------------------------------------------------------ */
 /*  Usage / help                                                       */
 /* ------------------------------------------------------------------ */
@@ -559,11 +1251,15 @@ static void print_usage(const char *prog)
 {
     fprintf(stderr,
         "Usage:\n"
-        "  %s run <ir_file> [-p PACKAGE...] [-i FILE...] [-o FILE] [-v]\n"
+        "  %s run <ir_file> [-p PACKAGE...] [-i FILE...] [-o FILE] [-v] [--cache DIR]\n"
+        "         [--profile FILE] [--mem-report] [--mem-limit SIZE] [--console MODE]\n"
+        "  %s serve [-p PACKAGE...] [--socket PATH] [--cache DIR] [--console MODE] [-v]\n"
         "  %s version [-p PACKAGE...]\n"
         "\n"
         "Commands:\n"
         "  run      Run an East IR program\n"
+        "  serve    Keep programs loaded and run them on request\n"
+        "           (length-prefixed frames on stdin/stdout, or a Unix socket)\n"
         "  version  Show version information\n"
         "\n"
         "Options:\n"
@@ -571,9 +1267,21 @@ static void print_usage(const char *prog)
         "  -i, --input FILE        Input data file (repeatable, order matches params)\n"
         "  -o, --output FILE       Output file for result\n"
         "  -v, --verbose           Enable verbose output\n"
+        "  --cache DIR             Cache compiled program images in DIR\n"
+        "                          (default: $EAST_C_CACHE_DIR, unset = no cache)\n"
+        "  --profile FILE          run: profile execution, write folded stacks to FILE\n"
+        "                          and print a per-site summary to stderr\n"
+        "  --mem-report            run: print live/peak memory by subsystem, value kind\n"
+        "                          and builtin call site to stderr after the run\n"
+        "  --mem-limit SIZE        run: fail with an East error once accounted memory\n"
+        "                          exceeds SIZE (bytes, or with a K/M/G suffix)\n"
+        "  --console MODE          console_* output: unbuffered (default), line, or\n"
+        "                          block[:SIZE[:MS]] to flush every SIZE bytes (64K)\n"
+        "                          or MS milliseconds (default: $EAST_C_CONSOLE)\n"
+        "  --socket PATH           serve: listen on a Unix socket instead of stdio\n"
         "\n"
         "Supported formats: .json, .beast2, .beast, .east\n",
-        prog, prog);
+        prog, prog, prog);
 }
 
 /* ------------------------------------------------------------------ */
@@ -597,6 +1305,11 @@ int main(int argc, char **argv)
     const char *output_file = NULL;
     bool verbose = false;
     const char *ir_path = NULL;
+    const char *cache_dir = getenv("EAST_C_CACHE_DIR");
+    const char *profile_file = NULL;
+    bool mem_report = false;
+    uint64_t mem_limit = 0;
+    const char *console_mode = getenv("EAST_C_CONSOLE");
 
     if (strcmp(command, "run") == 0) {
         /* Parse run arguments */
@@ -630,6 +1343,24 @@ int main(int argc, char **argv)
             } else if (strcmp(argv[i], "-v") == 0 || strcmp(argv[i], "--verbose") == 0) {
                 verbose = true;
                 i++;
+            } else if (strcmp(argv[i], "--cache") == 0 && i + 1 < argc) {
+                cache_dir = argv[i + 1];
+                i += 2;
+            } else if (strcmp(argv[i], "--profile") == 0 && i + 1 < argc) {
+                profile_file = argv[i + 1];
+                i += 2;
+            } else if (strcmp(argv[i], "--mem-report") == 0) {
+                mem_report = true;
+                i++;
+            } else if (strcmp(argv[i], "--console") == 0 && i + 1 < argc) {
+                console_mode = argv[i + 1];
+                i += 2;
+            } else if (strcmp(argv[i], "--mem-limit") == 0 && i + 1 < argc) {
+                if (!parse_size(argv[i + 1], &mem_limit) || mem_limit == 0) {
+                    fprintf(stderr, "Error: Invalid --mem-limit: %s\n", argv[i + 1]);
+                    return 1;
+                }
+                i += 2;
             } else {
                 fprintf(stderr, "Error: Unknown option: %s\n", argv[i]);
                 print_usage(argv[0]);
@@ -665,14 +1396,72 @@ int main(int argc, char **argv)
             } else if (strcmp(argv[i], "-v") == 0 || strcmp(argv[i], "--verbose") == 0) {
                 verbose = true;
                 i++;
+            } else if (strcmp(argv[i], "--cache") == 0 && i + 1 < argc) {
+                cache_dir = argv[i + 1];
+                i += 2;
+            } else if (strcmp(argv[i], "--profile") == 0 && i + 1 < argc) {
+                profile_file = argv[i + 1];
+                i += 2;
+            } else if (strcmp(argv[i], "--mem-report") == 0) {
+                mem_report = true;
+                i++;
+            } else if (strcmp(argv[i], "--console") == 0 && i + 1 < argc) {
+                console_mode = argv[i + 1];
+                i += 2;
+            } else if (strcmp(argv[i], "--mem-limit") == 0 && i + 1 < argc) {
+                if (!parse_size(argv[i + 1], &mem_limit) || mem_limit == 0) {
+                    fprintf(stderr, "Error: Invalid --mem-limit: %s\n", argv[i + 1]);
+                    return 1;
+                }
+                i += 2;
+            } else {
+                fprintf(stderr, "Error: Unknown option: %s\n", argv[i]);
+                print_usage(argv[0]);
+                return 1;
+            }
+        }
+
+        if (cache_dir && !cache_dir[0]) cache_dir = NULL;
+        if (!configure_console(console_mode)) return 1;
+
+        /* Accounting must be on before anything it should see is created. */
+        if (mem_report || mem_limit) east_mem_enable();
+        if (mem_limit) east_mem_set_limit(mem_limit);
+
+        return cmd_run(ir_path, packages, num_packages, input_files, num_inputs,
+                       output_file, cache_dir, profile_file, mem_report, verbose);
+
+    } else if (strcmp(command, "serve") == 0) {
+        const char *socket_path = NULL;
+        for (int i = 2; i < argc; i++) {
+            if ((strcmp(argv[i], "-p") == 0 || strcmp(argv[i], "--package") == 0) && i + 1 < argc) {
+                if (num_packages >= MAX_PACKAGES) {
+                    fprintf(stderr, "Error: Too many packages (max %d)\n", MAX_PACKAGES);
+                    return 1;
+                }
+                packages[num_packages++] = argv[i + 1];
+                i++;
+            } else if (strcmp(argv[i], "--socket") == 0 && i + 1 < argc) {
+                socket_path = argv[i + 1];
+                i++;
+            } else if (strcmp(argv[i], "--cache") == 0 && i + 1 < argc) {
+                cache_dir = argv[i + 1];
+                i++;
+            } else if (strcmp(argv[i], "--console") == 0 && i + 1 < argc) {
+                console_mode = argv[i + 1];
+                i++;
+            } else if (strcmp(argv[i], "-v") == 0 || strcmp(argv[i], "--verbose") == 0) {
+                verbose = true;
             } else {
                 fprintf(stderr, "Error: Unknown option: %s\n", argv[i]);
                 print_usage(argv[0]);
                 return 1;
             }
         }
+        if (cache_dir && !cache_dir[0]) cache_dir = NULL;
+        if (!configure_console(console_mode)) return 1;
 
-        return cmd_run(ir_path, packages, num_packages, input_files, num_inputs, output_file, verbose);
+        return cmd_serve(packages, num_packages, socket_path, cache_dir, verbose);
 
     } else if (strcmp(command, "version") == 0) {
         /* Parse version arguments */
@@ -0,0 +1,400 @@
+/*
+ * Tests for `east-c serve` in stdio mode.
+ *
+ * Covers: loading, running and unloading a program, the stats request,
+ *         and the error replies for truncated frames and inputs, a wrong
+ *         input count, an unknown program id and an oversized frame.
+ *
+ * Each test starts the east-c binary (EAST_C_BIN) with pipes on stdin
+ * and stdout and speaks the frame protocol described in main.c.
+ */
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/wait.h>
+
+#include <east/types.h>
+#include <east/values.h>
+#include <east/serialization.h>
+
+static int tests_run = 0;
+static int tests_passed = 0;
+static bool test_failed = false;
+
+#define TEST(name) static void test_##name(void)
+#define ASSERT(cond) do { \
+    if (!(cond)) { \
+        fprintf(stderr, "  FAIL: %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+        test_failed = true; \
+        return; \
+    } \
+} while(0)
+#define ASSERT_EQ_INT(a, b) do { \
+    int64_t _a = (a), _b = (b); \
+    if (_a != _b) { \
+        fprintf(stderr, "  FAIL: %s:%d: %lld != %lld\n", __FILE__, __LINE__, (long long)_a, (long long)_b); \
+        test_failed = true; \
+        return; \
+    } \
+} while(0)
+#define ASSERT_CONTAINS(haystack, needle) do { \
+    if (!strstr((haystack), (needle))) { \
+        fprintf(stderr, "  FAIL: %s:%d: \"%s\" does not contain \"%s\"\n", __FILE__, __LINE__, (haystack), (needle)); \
+        test_failed = true; \
+        return; \
+    } \
+} while(0)
+#define RUN_TEST(name) do { \
+    tests_run++; \
+    test_failed = false; \
+    printf("  test_%s...", #name); \
+    fflush(stdout); \
+    test_##name(); \
+    if (!test_failed) { \
+        tests_passed++; \
+        printf(" OK\n"); \
+    } \
+} while(0)
+
+/* fn(x: Integer) -> Integer { x + 1 } as IR text */
+#define LOC "location=[(filename=\"test\", line=1, column=1)]"
+#define VAR_X ".Variable (type=.Integer, " LOC ", name=\"x\", mutable=false, captured=false)"
+static const char *inc_program =
+    ".Function (type=.Function (inputs=[.Integer], output=.Integer), " LOC ", "
+    "captures=[], parameters=[" VAR_X "], "
+    "body=.Builtin (type=.Integer, " LOC ", builtin=\"IntegerAdd\", type_parameters=[], "
+    "arguments=[" VAR_X ", .Value (type=.Integer, " LOC ", value=.Integer 1)]))";
+
+/* ------------------------------------------------------------------ */
+/*  Server process and framing                                         */
+/* ------------------------------------------------------------------ */
+
+typedef struct {
+    pid_t pid;
+    int to;     /* server stdin */
+    int from;   /* server stdout */
+} Server;
+
+static bool server_start(Server *s)
+{
+    int in[2], out[2];
+    if (pipe(in) != 0 || pipe(out) != 0) return false;
+    s->pid = fork();
+    if (s->pid < 0) return false;
+    if (s->pid == 0) {
+        dup2(in[0], STDIN_FILENO);
+        dup2(out[1], STDOUT_FILENO);
+        int devnull = open("/dev/null", O_WRONLY);
+        if (devnull >= 0) dup2(devnull, STDERR_FILENO);
+        close(in[0]); close(in[1]); close(out[0]); close(out[1]);
+        execl(EAST_C_BIN, EAST_C_BIN, "serve", (char *)NULL);
+        _exit(127);
+    }
+    close(in[0]);
+    close(out[1]);
+    s->to = in[1];
+    s->from = out[0];
+    return true;
+}
+
+/* Close the server's stdin and return its exit code (-1 if it crashed). */
+static int server_finish(Server *s)
+{
+    if (s->to >= 0) close(s->to);
+    s->to = -1;
+    int status = 0;
+    waitpid(s->pid, &status, 0);
+    close(s->from);
+    return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+}
+
+static void put_u32(uint8_t *p, uint32_t v)
+{
+    for (int i = 0; i < 4; i++) p[i] = (uint8_t)(v >> (8 * i));
+}
+
+static void put_u64(uint8_t *p, uint64_t v)
+{
+    for (int i = 0; i < 8; i++) p[i] = (uint8_t)(v >> (8 * i));
+}
+
+static uint64_t get_u64(const uint8_t *p)
+{
+    uint64_t v = 0;
+    for (int i = 0; i < 8; i++) v |= (uint64_t)p[i] << (8 * i);
+    return v;
+}
+
+static bool write_all(int fd, const void *buf, size_t n)
+{
+    const uint8_t *p = buf;
+    while (n > 0) {
+        ssize_t w = write(fd, p, n);
+        if (w <= 0) return false;
+        p += w;
+        n -= (size_t)w;
+    }
+    return true;
+}
+
+static bool read_all(int fd, void *buf, size_t n)
+{
+    uint8_t *p = buf;
+    while (n > 0) {
+        ssize_t r = read(fd, p, n);
+        if (r <= 0) return false;
+        p += r;
+        n -= (size_t)r;
+    }
+    return true;
+}
+
+static bool send_frame(Server *s, const uint8_t *payload, size_t len)
+{
+    uint8_t hdr[4];
+    put_u32(hdr, (uint32_t)len);
+    return write_all(s->to, hdr, 4) && write_all(s->to, payload, len);
+}
+
+/* A response: status byte and a malloc'd, NUL-terminated body. */
+typedef struct {
+    int status;     /* 0 ok, 1 error, -1 no response */
+    uint8_t *body;
+    size_t len;
+} Response;
+
+static Response recv_frame(Server *s)
+{
+    Response r = { -1, NULL, 0 };
+    uint8_t hdr[4];
+    if (!read_all(s->from, hdr, 4)) return r;
+    uint32_t len = (uint32_t)hdr[0] | (uint32_t)hdr[1] << 8 |
+                   (uint32_t)hdr[2] << 16 | (uint32_t)hdr[3] << 24;
+    if (len == 0) return r;
+    uint8_t status;
+    if (!read_all(s->from, &status, 1)) return r;
+    r.len = len - 1;
+    r.body = malloc(r.len + 1);
+    if (!read_all(s->from, r.body, r.len)) {
+        free(r.body);
+        r.body = NULL;
+        return r;
+    }
+    r.body[r.len] = '\0';
+    r.status = status;
+    return r;
+}
+
+static Response request(Server *s, const uint8_t *payload, size_t len)
+{
+    if (!send_frame(s, payload, len)) return (Response){ -1, NULL, 0 };
+    return recv_frame(s);
+}
+
+/* Load inc_program; returns its id, or 0 on failure. */
+static uint64_t load_inc(Server *s)
+{
+    size_t n = strlen(inc_program);
+    uint8_t *req = malloc(1 + 5 + n);
+    req[0] = 'L';
+    memcpy(req + 1, "east", 5);
+    memcpy(req + 6, inc_program, n);
+    Response r = request(s, req, 6 + n);
+    free(req);
+    uint64_t id = r.status == 0 && r.len == 16 ? get_u64(r.body) : 0;
+    free(r.body);
+    return id;
+}
+
+/* Build a run request for id with the given inputs, Beast2 full encoded. */
+static uint8_t *run_request(uint64_t id, uint32_t argc, EastValue **args, size_t *out_len)
+{
+    ByteBuffer *enc[4] = { NULL };
+    size_t len = 1 + 8 + 4;
+    for (uint32_t i = 0; i < argc; i++) {
+        enc[i] = east_beast2_encode_full(args[i], &east_integer_type);
+        len += 4 + enc[i]->len;
+    }
+    uint8_t *req = malloc(len);
+    req[0] = 'R';
+    put_u64(req + 1, id);
+    put_u32(req + 9, argc);
+    size_t pos = 13;
+    for (uint32_t i = 0; i < argc; i++) {
+        put_u32(req + pos, (uint32_t)enc[i]->len);
+        memcpy(req + pos + 4, enc[i]->data, enc[i]->len);
+        pos += 4 + enc[i]->len;
+        byte_buffer_free(enc[i]);
+    }
+    *out_len = len;
+    return req;
+}
+
+/* ------------------------------------------------------------------ */
+/*  Tests                                                              */
+/* ------------------------------------------------------------------ */
+
+TEST(load_run_unload_stats) {
+    Server s;
+    ASSERT(server_start(&s));
+
+    uint64_t id = load_inc(&s);
+    ASSERT(id != 0);
+    /* Identical IR maps to the same program */
+    ASSERT_EQ_INT((int64_t)load_inc(&s), (int64_t)id);
+
+    EastValue *x = east_integer(41);
+    size_t len;
+    uint8_t *req = run_request(id, 1, &x, &len);
+    Response r = request(&s, req, len);
+    free(req);
+    east_value_release(x);
+    ASSERT_EQ_INT(r.status, 0);
+    ASSERT(r.len > 24);
+    EastValue *out = east_beast2_decode_full(r.body + 24, r.len - 24, &east_integer_type);
+    free(r.body);
+    ASSERT(out != NULL);
+    ASSERT_EQ_INT(out->data.integer, 42);
+    east_value_release(out);
+
+    uint8_t stats_req = 'T';
+    r = request(&s, &stats_req, 1);
+    ASSERT_EQ_INT(r.status, 0);
+    ASSERT_EQ_INT((int64_t)r.len, 24);
+    ASSERT_EQ_INT((int64_t)get_u64(r.body), 1);       /* programs */
+    ASSERT_EQ_INT((int64_t)get_u64(r.body + 8), 1);   /* runs */
+    ASSERT_EQ_INT((int64_t)get_u64(r.body + 16), 0);  /* failed runs */
+    free(r.body);
+
+    uint8_t unload[9] = { 'U' };
+    put_u64(unload + 1, id);
+    r = request(&s, unload, sizeof(unload));
+    ASSERT_EQ_INT(r.status, 0);
+    free(r.body);
+
+    r = request(&s, &stats_req, 1);
+    ASSERT_EQ_INT(r.status, 0);
+    ASSERT_EQ_INT((int64_t)get_u64(r.body), 0);
+    free(r.body);
+
+    /* An unloaded program can no longer run */
+    x = east_integer(1);
+    req = run_request(id, 1, &x, &len);
+    r = request(&s, req, len);
+    free(req);
+    east_value_release(x);
+    ASSERT_EQ_INT(r.status, 1);
+    ASSERT_CONTAINS((char *)r.body, "unknown program");
+    free(r.body);
+
+    uint8_t stop = 'S';
+    r = request(&s, &stop, 1);
+    ASSERT_EQ_INT(r.status, 0);
+    free(r.body);
+    ASSERT_EQ_INT(server_finish(&s), 0);
+}
+
+TEST(bad_run_requests) {
+    Server s;
+    ASSERT(server_start(&s));
+    uint64_t id = load_inc(&s);
+    ASSERT(id != 0);
+
+    /* Unknown program id */
+    EastValue *x = east_integer(1);
+    size_t len;
+    uint8_t *req = run_request(id ^ 1, 1, &x, &len);
+    Response r = request(&s, req, len);
+    free(req);
+    ASSERT_EQ_INT(r.status, 1);
+    ASSERT_CONTAINS((char *)r.body, "unknown program");
+    free(r.body);
+
+    /* Wrong input count */
+    EastValue *two[] = { x, x };
+    req = run_request(id, 2, two, &len);
+    r = request(&s, req, len);
+    free(req);
+    ASSERT_EQ_INT(r.status, 1);
+    ASSERT_CONTAINS((char *)r.body, "expects 1 inputs, got 2");
+    free(r.body);
+
+    /* Input shorter than its length prefix */
+    req = run_request(id, 1, &x, &len);
+    r = request(&s, req, len - 1);
+    free(req);
+    ASSERT_EQ_INT(r.status, 1);
+    ASSERT_CONTAINS((char *)r.body, "truncated input 0");
+    free(r.body);
+
+    /* Request too short to hold an id and count */
+    uint8_t short_run[5] = { 'R' };
+    r = request(&s, short_run, sizeof(short_run));
+    ASSERT_EQ_INT(r.status, 1);
+    ASSERT_CONTAINS((char *)r.body, "truncated request");
+    free(r.body);
+    east_value_release(x);
+
+    /* The server keeps answering after errors */
+    uint8_t stats_req = 'T';
+    r = request(&s, &stats_req, 1);
+    ASSERT_EQ_INT(r.status, 0);
+    ASSERT_EQ_INT((int64_t)get_u64(r.body + 8), 0);
+    free(r.body);
+    ASSERT_EQ_INT(server_finish(&s), 0);
+}
+
+TEST(truncated_frame) {
+    Server s;
+    ASSERT(server_start(&s));
+
+    /* Header promises 100 bytes; only 10 arrive before EOF */
+    uint8_t hdr[4];
+    put_u32(hdr, 100);
+    uint8_t partial[10] = { 'T' };
+    ASSERT(write_all(s.to, hdr, 4));
+    ASSERT(write_all(s.to, partial, sizeof(partial)));
+    close(s.to);
+    s.to = -1;
+
+    Response r = recv_frame(&s);
+    ASSERT_EQ_INT(r.status, -1);
+    ASSERT_EQ_INT(server_finish(&s), 0);
+}
+
+TEST(oversized_frame) {
+    Server s;
+    ASSERT(server_start(&s));
+
+    uint8_t hdr[4];
+    put_u32(hdr, (1u << 30) + 1);
+    ASSERT(write_all(s.to, hdr, 4));
+
+    Response r = recv_frame(&s);
+    ASSERT_EQ_INT(r.status, 1);
+    ASSERT_CONTAINS((char *)r.body, "exceeds");
+    free(r.body);
+    /* The connection is closed after the error */
+    r = recv_frame(&s);
+    ASSERT_EQ_INT(r.status, -1);
+    ASSERT_EQ_INT(server_finish(&s), 0);
+}
+
+int main(void) {
+    /* A server that exits early must fail a test, not kill the runner */
+    signal(SIGPIPE, SIG_IGN);
+
+    printf("test_serve:\n");
+    RUN_TEST(load_run_unload_stats);
+    RUN_TEST(bad_run_requests);
+    RUN_TEST(truncated_frame);
+    RUN_TEST(oversized_frame);
+
+    printf("\n  %d/%d tests passed\n", tests_passed, tests_run);
+    return (tests_passed == tests_run) ? 0 : 1;
+}
@@ -2,7 +2,9 @@
 #define EAST_STD_H
 
 #include <east/platform.h>
+#include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 
 // Individual module registration
 void east_std_register_console(PlatformRegistry *reg);
@@ -18,4 +20,29 @@ void east_std_register_test(PlatformRegistry *reg);
 // Register all standard platform functions
 void east_std_register_all(PlatformRegistry *reg);
 
+// Console output policy for console_log / console_error / console_write.
+// Unbuffered (the default) flushes after every call; line mode flushes at
+// each newline; block mode flushes once block_size bytes are pending, or
+// on the next call after flush_ms have passed since the oldest pending
+// byte. Buffered output is also flushed at exit and by
+// east_std_console_flush, which hosts should call after a program returns
+// and before writing anything else to stdout or stderr.
+typedef enum {
+    EAST_CONSOLE_UNBUFFERED,
+    EAST_CONSOLE_LINE,
+    EAST_CONSOLE_BLOCK,
+} EastConsoleMode;
+
+typedef struct {
+    EastConsoleMode mode;
+    size_t block_size;      // block mode; 0 = 64 KiB
+    uint32_t flush_ms;      // block mode; 0 = no time limit
+} EastConsoleConfig;
+
+void east_std_console_configure(const EastConsoleConfig *config);
+void east_std_console_flush(void);
+
+// Parse "unbuffered", "line" or "block[:SIZE[:MS]]" (SIZE may end in K/M/G).
+bool east_std_console_parse_mode(const char *spec, EastConsoleConfig *out);
+
 #endif
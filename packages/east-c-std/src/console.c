@@ -2,31 +2,185 @@
  * Console I/O platform functions for East.
  *
  * Provides console output operations for East programs running in C.
+ *
+ * Output goes through a per-stream buffer whose flush policy is set with
+ * east_std_console_configure (see east_std.h). Pending stdout output is
+ * flushed before anything is written to stderr and vice versa, so the two
+ * streams keep their relative order. Buffered modes also flush at exit.
  */
 
 #include "east_std/east_std.h"
 #include <east/values.h>
 #include <east/eval_result.h>
+#include <errno.h>
+#include <pthread.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define CONSOLE_BLOCK_DEFAULT ((size_t)64 * 1024)
+
+typedef struct {
+    FILE *stream;
+    char *data;
+    size_t len;
+    size_t cap;
+    struct timespec since;   // when the oldest pending byte was written
+} ConsoleBuf;
+
+static pthread_mutex_t console_lock = PTHREAD_MUTEX_INITIALIZER;
+static EastConsoleConfig console_config = { EAST_CONSOLE_UNBUFFERED, 0, 0 };
+static ConsoleBuf console_out;
+static ConsoleBuf console_err;
+static bool console_exit_hook = false;
+
+/* Write out the first n pending bytes with as few write(2) calls as
+ * possible, bypassing stdio's own smaller buffer. Caller holds
+ * console_lock. */
+static void buf_flush(ConsoleBuf *b, size_t n) {
+    if (n == 0) return;
+    fflush(b->stream);
+    int fd = fileno(b->stream);
+    for (size_t off = 0; off < n;) {
+        ssize_t w = write(fd, b->data + off, n - off);
+        if (w < 0 && errno == EINTR) continue;
+        if (w <= 0) break;
+        off += (size_t)w;
+    }
+    memmove(b->data, b->data + n, b->len - n);
+    b->len -= n;
+    if (b->len) clock_gettime(CLOCK_MONOTONIC, &b->since);
+}
+
+/* Append s (and a newline) to b; false if it cannot grow. */
+static bool buf_append(ConsoleBuf *b, const char *s, size_t len, bool newline) {
+    size_t need = b->len + len + (newline ? 1 : 0);
+    if (need > b->cap) {
+        size_t cap = b->cap ? b->cap * 2 : 4096;
+        while (cap < need) cap *= 2;
+        char *p = realloc(b->data, cap);
+        if (!p) return false;
+        b->data = p;
+        b->cap = cap;
+    }
+    if (b->len == 0) clock_gettime(CLOCK_MONOTONIC, &b->since);
+    memcpy(b->data + b->len, s, len);
+    b->len += len;
+    if (newline) b->data[b->len++] = '\n';
+    return true;
+}
+
+static bool buf_expired(const ConsoleBuf *b, uint32_t ms) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    int64_t age = (int64_t)(now.tv_sec - b->since.tv_sec) * 1000
+                + (now.tv_nsec - b->since.tv_nsec) / 1000000;
+    return age >= (int64_t)ms;
+}
+
+static void console_emit(FILE *stream, const char *s, size_t len, bool newline) {
+    pthread_mutex_lock(&console_lock);
+    ConsoleBuf *b = stream == stdout ? &console_out : &console_err;
+    ConsoleBuf *other = stream == stdout ? &console_err : &console_out;
+    b->stream = stream;
+    buf_flush(other, other->len);
+
+    if (console_config.mode == EAST_CONSOLE_UNBUFFERED ||
+        !buf_append(b, s, len, newline)) {
+        buf_flush(b, b->len);
+        fwrite(s, 1, len, stream);
+        if (newline) fputc('\n', stream);
+        fflush(stream);
+    } else if (console_config.mode == EAST_CONSOLE_LINE) {
+        size_t end = b->len;
+        while (end > 0 && b->data[end - 1] != '\n') end--;
+        buf_flush(b, end);
+    } else {
+        size_t limit = console_config.block_size ? console_config.block_size
+                                                 : CONSOLE_BLOCK_DEFAULT;
+        if (b->len >= limit ||
+            (console_config.flush_ms && buf_expired(b, console_config.flush_ms)))
+            buf_flush(b, b->len);
+    }
+    pthread_mutex_unlock(&console_lock);
+}
+
+void east_std_console_flush(void) {
+    pthread_mutex_lock(&console_lock);
+    buf_flush(&console_out, console_out.len);
+    buf_flush(&console_err, console_err.len);
+    pthread_mutex_unlock(&console_lock);
+}
+
+void east_std_console_configure(const EastConsoleConfig *config) {
+    pthread_mutex_lock(&console_lock);
+    buf_flush(&console_out, console_out.len);
+    buf_flush(&console_err, console_err.len);
+    console_config = *config;
+    bool hook = config->mode != EAST_CONSOLE_UNBUFFERED && !console_exit_hook;
+    console_exit_hook = console_exit_hook || hook;
+    pthread_mutex_unlock(&console_lock);
+    if (hook) atexit(east_std_console_flush);
+}
+
+static bool parse_count(const char *s, const char **end, uint64_t *out) {
+    char *e;
+    unsigned long long v = strtoull(s, &e, 10);
+    if (e == s) return false;
+    switch (*e) {
+    case 'k': case 'K': v <<= 10; e++; break;
+    case 'm': case 'M': v <<= 20; e++; break;
+    case 'g': case 'G': v <<= 30; e++; break;
+    default: break;
+    }
+    *out = v;
+    *end = e;
+    return true;
+}
+
+bool east_std_console_parse_mode(const char *spec, EastConsoleConfig *out) {
+    EastConsoleConfig c = { EAST_CONSOLE_UNBUFFERED, 0, 0 };
+    if (strcmp(spec, "unbuffered") == 0) {
+        c.mode = EAST_CONSOLE_UNBUFFERED;
+    } else if (strcmp(spec, "line") == 0) {
+        c.mode = EAST_CONSOLE_LINE;
+    } else if (strncmp(spec, "block", 5) == 0) {
+        c.mode = EAST_CONSOLE_BLOCK;
+        const char *p = spec + 5;
+        uint64_t v;
+        if (*p == ':') {
+            if (!parse_count(p + 1, &p, &v) || v == 0) return false;
+            c.block_size = (size_t)v;
+        }
+        if (*p == ':') {
+            if (!parse_count(p + 1, &p, &v) || v > UINT32_MAX) return false;
+            c.flush_ms = (uint32_t)v;
+        }
+        if (*p) return false;
+    } else {
+        return false;
+    }
+    *out = c;
+    return true;
+}
 
 static EvalResult console_log(EastValue **args, size_t num_args) {
     (void)num_args;
-    printf("%s\n", args[0]->data.string.data);
-    fflush(stdout);
+    console_emit(stdout, args[0]->data.string.data, args[0]->data.string.len, true);
     return eval_ok(east_null());
 }
 
 static EvalResult console_error(EastValue **args, size_t num_args) {
     (void)num_args;
-    fprintf(stderr, "%s\n", args[0]->data.string.data);
-    fflush(stderr);
+    console_emit(stderr, args[0]->data.string.data, args[0]->data.string.len, true);
     return eval_ok(east_null());
 }
 
 static EvalResult console_write(EastValue **args, size_t num_args) {
     (void)num_args;
-    printf("%s", args[0]->data.string.data);
-    fflush(stdout);
+    console_emit(stdout, args[0]->data.string.data, args[0]->data.string.len, false);
     return eval_ok(east_null());
 }
 
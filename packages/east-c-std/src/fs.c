@@ -3,6 +3,11 @@
  *
  * Provides filesystem operations for East programs running in C.
  * Uses POSIX APIs for directory and file operations.
+ *
+ * fs_read_file and fs_read_file_bytes read the whole file straight into
+ * the value's buffer, so the value never changes with the file. Files
+ * too large to hold in memory are streamed through an Integer handle
+ * with fs_open / fs_read_chunk / fs_write_chunk / fs_close.
  */
 
 #include "east_std/east_std.h"
@@ -12,12 +17,32 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <pthread.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <unistd.h>
 #include <dirent.h>
 #include <errno.h>
 
+#define FS_CHUNK_MAX ((int64_t)1 << 30)
+
+/* ------------------------------------------------------------------ */
+/*  Open handles                                                       */
+/* ------------------------------------------------------------------ */
+
+typedef struct {
+    FILE *f;            // NULL: free slot
+    bool writable;
+} FileHandle;
+
+static pthread_mutex_t fs_lock = PTHREAD_MUTEX_INITIALIZER;
+static FileHandle *handles;
+static size_t num_handles;
+
+/* ------------------------------------------------------------------ */
+/*  Whole files                                                        */
+/* ------------------------------------------------------------------ */
+
 static EvalResult fs_read_file(EastValue **args, size_t num_args) {
     (void)num_args;
     const char *path = args[0]->data.string.data;
@@ -28,26 +53,25 @@ static EvalResult fs_read_file(EastValue **args, size_t num_args) {
     }
 
     fseek(f, 0, SEEK_END);
-    long size = ftell(f);
+    long end = ftell(f);
     fseek(f, 0, SEEK_SET);
 
-    if (size < 0) {
+    if (end < 0) {
         fclose(f);
         return eval_ok(east_string(""));
     }
 
-    char *buf = malloc((size_t)size + 1);
-    if (!buf) {
+    /* Read straight into the String's buffer */
+    EastValue *result = east_string_len(NULL, (size_t)end);
+    if (!result) {
         fclose(f);
         return eval_ok(east_string(""));
     }
-
-    size_t read_bytes = fread(buf, 1, (size_t)size, f);
+    size_t read_bytes = fread(result->data.string.data, 1, (size_t)end, f);
     fclose(f);
 
-    buf[read_bytes] = '\0';
-    EastValue *result = east_string_len(buf, read_bytes);
-    free(buf);
+    result->data.string.data[read_bytes] = '\0';
+    result->data.string.len = read_bytes;
     return eval_ok(result);
 }
 
@@ -57,6 +81,8 @@ static EvalResult fs_write_file(EastValue **args, size_t num_args) {
     const char *content = args[1]->data.string.data;
     size_t len = args[1]->data.string.len;
 
+    /* The file may be the console's stdout or stderr */
+    east_std_console_flush();
     FILE *f = fopen(path, "w");
     if (f) {
         fwrite(content, 1, len, f);
@@ -71,6 +97,7 @@ static EvalResult fs_append_file(EastValue **args, size_t num_args) {
     const char *content = args[1]->data.string.data;
     size_t len = args[1]->data.string.len;
 
+    east_std_console_flush();
     FILE *f = fopen(path, "a");
     if (f) {
         fwrite(content, 1, len, f);
@@ -173,25 +200,21 @@ static EvalResult fs_read_file_bytes(EastValue **args, size_t num_args) {
     }
 
     fseek(f, 0, SEEK_END);
-    long size = ftell(f);
+    long end = ftell(f);
     fseek(f, 0, SEEK_SET);
 
-    if (size < 0) {
+    if (end < 0) {
         fclose(f);
         return eval_ok(east_blob(NULL, 0));
     }
 
-    uint8_t *buf = malloc((size_t)size);
-    if (!buf) {
+    EastValue *result = east_blob(NULL, (size_t)end);
+    if (!result) {
         fclose(f);
         return eval_ok(east_blob(NULL, 0));
     }
-
-    size_t read_bytes = fread(buf, 1, (size_t)size, f);
+    result->data.blob.len = fread(result->data.blob.data, 1, (size_t)end, f);
     fclose(f);
-
-    EastValue *result = east_blob(buf, read_bytes);
-    free(buf);
     return eval_ok(result);
 }
 
@@ -201,6 +224,7 @@ static EvalResult fs_write_file_bytes(EastValue **args, size_t num_args) {
     const uint8_t *data = args[1]->data.blob.data;
     size_t len = args[1]->data.blob.len;
 
+    east_std_console_flush();
     FILE *f = fopen(path, "wb");
     if (f) {
         fwrite(data, 1, len, f);
@@ -209,6 +233,130 @@ static EvalResult fs_write_file_bytes(EastValue **args, size_t num_args) {
     return eval_ok(east_null());
 }
 
+/* ------------------------------------------------------------------ */
+/*  Streaming handles                                                  */
+/* ------------------------------------------------------------------ */
+
+/* Slot of a valid handle, or NULL. Caller holds fs_lock. */
+static FileHandle *handle_get(int64_t h) {
+    if (h < 1 || (uint64_t)h > num_handles || !handles[h - 1].f) return NULL;
+    return &handles[h - 1];
+}
+
+static EvalResult handle_error(const char *fn, int64_t h) {
+    char msg[96];
+    snprintf(msg, sizeof(msg), "%s: invalid file handle %lld", fn, (long long)h);
+    return eval_error(msg);
+}
+
+// fs_open(path, mode): mode "r" reads, "w" truncates or creates, "a"
+// appends. Returns a handle for the other fs_*_chunk functions.
+static EvalResult fs_open(EastValue **args, size_t num_args) {
+    (void)num_args;
+    const char *path = args[0]->data.string.data;
+    const char *mode = args[1]->data.string.data;
+
+    const char *fmode = strcmp(mode, "r") == 0 ? "rb"
+                      : strcmp(mode, "w") == 0 ? "wb"
+                      : strcmp(mode, "a") == 0 ? "ab" : NULL;
+    if (!fmode) return eval_error("fs_open: mode must be \"r\", \"w\" or \"a\"");
+
+    bool writable = fmode[0] != 'r';
+    if (writable) east_std_console_flush();
+    FILE *f = fopen(path, fmode);
+    if (!f) {
+        char msg[512];
+        snprintf(msg, sizeof(msg), "fs_open: cannot open %s: %s", path, strerror(errno));
+        return eval_error(msg);
+    }
+    pthread_mutex_lock(&fs_lock);
+    size_t slot = 0;
+    while (slot < num_handles && handles[slot].f) slot++;
+    if (slot == num_handles) {
+        FileHandle *p = realloc(handles, (num_handles + 1) * sizeof(FileHandle));
+        if (!p) {
+            pthread_mutex_unlock(&fs_lock);
+            fclose(f);
+            return eval_error("fs_open: out of memory");
+        }
+        handles = p;
+        num_handles++;
+    }
+    handles[slot] = (FileHandle){ f, writable };
+    pthread_mutex_unlock(&fs_lock);
+    return eval_ok(east_integer((int64_t)slot + 1));
+}
+
+// fs_read_chunk(handle, max_bytes): the next bytes of the file, at most
+// max_bytes of them; an empty Blob at end of file.
+static EvalResult fs_read_chunk(EastValue **args, size_t num_args) {
+    (void)num_args;
+    int64_t h = args[0]->data.integer;
+    int64_t max = args[1]->data.integer;
+    if (max <= 0) return eval_error("fs_read_chunk: max_bytes must be positive");
+    if (max > FS_CHUNK_MAX) max = FS_CHUNK_MAX;
+
+    pthread_mutex_lock(&fs_lock);
+    FileHandle *fh = handle_get(h);
+    if (!fh || fh->writable) {
+        pthread_mutex_unlock(&fs_lock);
+        return handle_error("fs_read_chunk", h);
+    }
+    EastValue *result = east_blob(NULL, (size_t)max);
+    size_t n = result ? fread(result->data.blob.data, 1, (size_t)max, fh->f) : 0;
+    bool failed = !result || ferror(fh->f);
+    pthread_mutex_unlock(&fs_lock);
+
+    if (failed) {
+        east_value_release(result);
+        return eval_error("fs_read_chunk: read failed");
+    }
+    if (n < (size_t)max / 2) {
+        /* Short last chunk: don't keep the whole buffer alive */
+        EastValue *small = east_blob(result->data.blob.data, n);
+        east_value_release(result);
+        return eval_ok(small);
+    }
+    result->data.blob.len = n;
+    return eval_ok(result);
+}
+
+// fs_write_chunk(handle, bytes): append bytes at the handle's position.
+static EvalResult fs_write_chunk(EastValue **args, size_t num_args) {
+    (void)num_args;
+    int64_t h = args[0]->data.integer;
+    const uint8_t *data = args[1]->data.blob.data;
+    size_t len = args[1]->data.blob.len;
+
+    pthread_mutex_lock(&fs_lock);
+    FileHandle *fh = handle_get(h);
+    if (!fh || !fh->writable) {
+        pthread_mutex_unlock(&fs_lock);
+        return handle_error("fs_write_chunk", h);
+    }
+    bool failed = len > 0 && fwrite(data, 1, len, fh->f) != len;
+    pthread_mutex_unlock(&fs_lock);
+    if (failed) return eval_error("fs_write_chunk: write failed");
+    return eval_ok(east_null());
+}
+
+static EvalResult fs_close(EastValue **args, size_t num_args) {
+    (void)num_args;
+    int64_t h = args[0]->data.integer;
+
+    pthread_mutex_lock(&fs_lock);
+    FileHandle *fh = handle_get(h);
+    if (!fh) {
+        pthread_mutex_unlock(&fs_lock);
+        return handle_error("fs_close", h);
+    }
+    FILE *f = fh->f;
+    fh->f = NULL;
+    pthread_mutex_unlock(&fs_lock);
+    if (fclose(f) != 0) return eval_error("fs_close: write failed");
+    return eval_ok(east_null());
+}
+
 void east_std_register_fs(PlatformRegistry *reg) {
     platform_registry_add(reg, "fs_read_file", fs_read_file, false);
     platform_registry_add(reg, "fs_write_file", fs_write_file, false);
@@ -221,4 +369,8 @@ void east_std_register_fs(PlatformRegistry *reg) {
     platform_registry_add(reg, "fs_read_directory", fs_read_directory, false);
     platform_registry_add(reg, "fs_read_file_bytes", fs_read_file_bytes, false);
     platform_registry_add(reg, "fs_write_file_bytes", fs_write_file_bytes, false);
+    platform_registry_add(reg, "fs_open", fs_open, false);
+    platform_registry_add(reg, "fs_read_chunk", fs_read_chunk, false);
+    platform_registry_add(reg, "fs_write_chunk", fs_write_chunk, false);
+    platform_registry_add(reg, "fs_close", fs_close, false);
 }
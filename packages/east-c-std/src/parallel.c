@@ -170,8 +170,11 @@ static EvalResult parallel_map_impl(EastValue **args, size_t num_args) {
         return eval_error("Failed to encode function for parallel_map");
     }
 
-    /* Determine number of workers */
+    /* Determine number of workers (EAST_C_PARALLEL_WORKERS overrides the
+     * CPU count, e.g. for scaling measurements) */
     long ncpus = sysconf(_SC_NPROCESSORS_ONLN);
+    const char *workers_env = getenv("EAST_C_PARALLEL_WORKERS");
+    if (workers_env && atol(workers_env) > 0) ncpus = atol(workers_env);
     if (ncpus < 1) ncpus = 1;
     size_t num_workers = (size_t)ncpus;
     if (num_workers > len) num_workers = len;
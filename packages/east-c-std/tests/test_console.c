@@ -1,12 +1,15 @@
 /*
  * Tests for east-c-std console platform functions.
  *
- * Covers: registering console functions and calling console_log.
+ * Covers: registering console functions, calling console_log, and the
+ *         buffered output modes.
  */
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
 
 #include <east/types.h>
 #include <east/values.h>
@@ -124,6 +127,89 @@ TEST(console_write_call) {
     platform_registry_free(reg);
 }
 
+TEST(console_parse_mode) {
+    EastConsoleConfig c;
+    ASSERT(east_std_console_parse_mode("unbuffered", &c));
+    ASSERT_EQ_INT(c.mode, EAST_CONSOLE_UNBUFFERED);
+    ASSERT(east_std_console_parse_mode("line", &c));
+    ASSERT_EQ_INT(c.mode, EAST_CONSOLE_LINE);
+    ASSERT(east_std_console_parse_mode("block", &c));
+    ASSERT_EQ_INT(c.mode, EAST_CONSOLE_BLOCK);
+    ASSERT_EQ_INT(c.block_size, 0);
+    ASSERT(east_std_console_parse_mode("block:256K:50", &c));
+    ASSERT_EQ_INT(c.block_size, 256 * 1024);
+    ASSERT_EQ_INT(c.flush_ms, 50);
+    ASSERT(!east_std_console_parse_mode("block:0", &c));
+    ASSERT(!east_std_console_parse_mode("block:1x", &c));
+    ASSERT(!east_std_console_parse_mode("full", &c));
+}
+
+/* Run console_log / console_write with stdout on a pipe and return what
+ * reached the pipe before and after east_std_console_flush. */
+static void capture_stdout(const EastConsoleConfig *config, const char **lines,
+                           size_t n, char *before, char *after, size_t cap) {
+    PlatformRegistry *reg = platform_registry_new();
+    east_std_register_console(reg);
+    PlatformFn log_fn = platform_registry_get(reg, "console_log", NULL, 0);
+    PlatformFn write_fn = platform_registry_get(reg, "console_write", NULL, 0);
+
+    int fds[2];
+    fflush(stdout);
+    int saved = dup(STDOUT_FILENO);
+    if (pipe(fds) != 0) return;
+    fcntl(fds[0], F_SETFL, O_NONBLOCK);
+    dup2(fds[1], STDOUT_FILENO);
+
+    east_std_console_configure(config);
+    for (size_t i = 0; i < n; i++) {
+        EastValue *msg = east_string(lines[i]);
+        EastValue *args[] = {msg};
+        EvalResult r = (lines[i][0] == '+' ? write_fn : log_fn)(args, 1);
+        east_value_release(r.value);
+        east_value_release(msg);
+    }
+    ssize_t got = read(fds[0], before, cap - 1);
+    before[got > 0 ? got : 0] = '\0';
+    east_std_console_flush();
+    got = read(fds[0], after, cap - 1);
+    after[got > 0 ? got : 0] = '\0';
+
+    EastConsoleConfig unbuffered = { EAST_CONSOLE_UNBUFFERED, 0, 0 };
+    east_std_console_configure(&unbuffered);
+    dup2(saved, STDOUT_FILENO);
+    close(saved);
+    close(fds[0]);
+    close(fds[1]);
+    platform_registry_free(reg);
+}
+
+TEST(console_buffered_modes) {
+    char before[256], after[256];
+    const char *lines[] = {"one", "two", "+three"};
+
+    EastConsoleConfig unbuffered = { EAST_CONSOLE_UNBUFFERED, 0, 0 };
+    capture_stdout(&unbuffered, lines, 3, before, after, sizeof(before));
+    ASSERT_EQ_STR(before, "one\ntwo\n+three");
+    ASSERT_EQ_STR(after, "");
+
+    /* Line mode holds back the unterminated console_write */
+    EastConsoleConfig line = { EAST_CONSOLE_LINE, 0, 0 };
+    capture_stdout(&line, lines, 3, before, after, sizeof(before));
+    ASSERT_EQ_STR(before, "one\ntwo\n");
+    ASSERT_EQ_STR(after, "+three");
+
+    EastConsoleConfig block = { EAST_CONSOLE_BLOCK, 0, 0 };
+    capture_stdout(&block, lines, 3, before, after, sizeof(before));
+    ASSERT_EQ_STR(before, "");
+    ASSERT_EQ_STR(after, "one\ntwo\n+three");
+
+    /* A small block size flushes as soon as it fills */
+    EastConsoleConfig small = { EAST_CONSOLE_BLOCK, 8, 0 };
+    capture_stdout(&small, lines, 3, before, after, sizeof(before));
+    ASSERT_EQ_STR(before, "one\ntwo\n");
+    ASSERT_EQ_STR(after, "+three");
+}
+
 /* ------------------------------------------------------------------ */
 /*  Main                                                               */
 /* ------------------------------------------------------------------ */
@@ -135,6 +221,8 @@ int main(void) {
     RUN_TEST(console_log_call);
     RUN_TEST(console_error_call);
     RUN_TEST(console_write_call);
+    RUN_TEST(console_parse_mode);
+    RUN_TEST(console_buffered_modes);
 
     printf("\n  %d/%d tests passed\n", tests_passed, tests_run);
     return (tests_passed == tests_run) ? 0 : 1;
@@ -2,7 +2,8 @@
  * Tests for east-c-std filesystem platform functions.
  *
  * Covers: writing a temp file, reading it back, checking existence,
- *         deleting, and verifying deletion.
+ *         deleting, and verifying deletion; reads of large files
+ *         and streaming through file handles.
  */
 
 #include <stdio.h>
@@ -226,6 +227,129 @@ TEST(exists_nonexistent) {
     east_value_release(result.value);
 }
 
+/* A page multiple checks the NUL after the contents. */
+static void write_pattern(const char *path, size_t size) {
+    FILE *f = fopen(path, "wb");
+    for (size_t i = 0; i < size; i++) fputc('a' + (int)(i % 26), f);
+    fclose(f);
+}
+
+TEST(read_large_file) {
+    PlatformFn read_fn = platform_registry_get(reg, "fs_read_file", NULL, 0);
+    PlatformFn bytes_fn = platform_registry_get(reg, "fs_read_file_bytes", NULL, 0);
+    PlatformFn write_fn = platform_registry_get(reg, "fs_write_file", NULL, 0);
+    ASSERT(read_fn != NULL);
+    ASSERT(bytes_fn != NULL);
+
+    char path[256];
+    snprintf(path, sizeof(path), "/tmp/east_c_test_large_%d.txt", (int)getpid());
+    size_t sizes[] = { 256 * 1024, 256 * 1024 + 3 };
+    for (size_t t = 0; t < 2; t++) {
+        size_t size = sizes[t];
+        write_pattern(path, size);
+        EastValue *path_val = east_string(path);
+        EastValue *args[] = {path_val};
+
+        EvalResult s = read_fn(args, 1);
+        ASSERT(s.value != NULL);
+        ASSERT_EQ_INT(s.value->kind, EAST_VAL_STRING);
+        ASSERT_EQ_INT((int64_t)s.value->data.string.len, (int64_t)size);
+        ASSERT_EQ_INT(s.value->data.string.data[size], 0);
+        ASSERT_EQ_INT(s.value->data.string.data[size - 1], 'a' + (int)((size - 1) % 26));
+
+        EvalResult b = bytes_fn(args, 1);
+        ASSERT(b.value != NULL);
+        ASSERT_EQ_INT(b.value->kind, EAST_VAL_BLOB);
+        ASSERT_EQ_INT((int64_t)b.value->data.blob.len, (int64_t)size);
+        ASSERT(memcmp(b.value->data.blob.data, s.value->data.string.data, size) == 0);
+
+        /* Overwriting the file leaves values read from it unchanged */
+        EastValue *content = east_string("short");
+        EastValue *write_args[] = {path_val, content};
+        write_fn(write_args, 2);
+        ASSERT_EQ_INT((int64_t)strlen(s.value->data.string.data), (int64_t)size);
+        ASSERT_EQ_INT(b.value->data.blob.data[size - 1], 'a' + (int)((size - 1) % 26));
+
+        east_value_release(content);
+        east_value_release(s.value);
+        east_value_release(b.value);
+        east_value_release(path_val);
+    }
+    unlink(path);
+}
+
+TEST(stream_chunks) {
+    PlatformFn open_fn = platform_registry_get(reg, "fs_open", NULL, 0);
+    PlatformFn read_fn = platform_registry_get(reg, "fs_read_chunk", NULL, 0);
+    PlatformFn write_fn = platform_registry_get(reg, "fs_write_chunk", NULL, 0);
+    PlatformFn close_fn = platform_registry_get(reg, "fs_close", NULL, 0);
+    ASSERT(open_fn && read_fn && write_fn && close_fn);
+
+    char path[256];
+    snprintf(path, sizeof(path), "/tmp/east_c_test_stream_%d.bin", (int)getpid());
+    EastValue *path_val = east_string(path);
+
+    /* Write 10 chunks of 1000 bytes. */
+    EastValue *mode_w = east_string("w");
+    EastValue *open_args[] = {path_val, mode_w};
+    EvalResult h = open_fn(open_args, 2);
+    ASSERT_EQ_INT(h.status, EVAL_OK);
+    uint8_t chunk[1000];
+    for (int c = 0; c < 10; c++) {
+        memset(chunk, c, sizeof(chunk));
+        EastValue *blob = east_blob(chunk, sizeof(chunk));
+        EastValue *args[] = {h.value, blob};
+        EvalResult r = write_fn(args, 2);
+        ASSERT_EQ_INT(r.status, EVAL_OK);
+        east_value_release(blob);
+    }
+    EastValue *close_args[] = {h.value};
+    ASSERT_EQ_INT(close_fn(close_args, 1).status, EVAL_OK);
+    east_value_release(h.value);
+
+    /* Read it back 4096 bytes at a time. */
+    EastValue *mode_r = east_string("r");
+    open_args[1] = mode_r;
+    h = open_fn(open_args, 2);
+    ASSERT_EQ_INT(h.status, EVAL_OK);
+    EastValue *max = east_integer(4096);
+    size_t total = 0;
+    bool ok = true;
+    for (;;) {
+        EastValue *args[] = {h.value, max};
+        EvalResult r = read_fn(args, 2);
+        ASSERT_EQ_INT(r.status, EVAL_OK);
+        size_t n = r.value->data.blob.len;
+        for (size_t i = 0; i < n; i++)
+            ok = ok && r.value->data.blob.data[i] == (uint8_t)((total + i) / 1000);
+        total += n;
+        east_value_release(r.value);
+        if (n == 0) break;
+    }
+    ASSERT(ok);
+    ASSERT_EQ_INT((int64_t)total, 10000);
+    close_args[0] = h.value;
+    ASSERT_EQ_INT(close_fn(close_args, 1).status, EVAL_OK);
+
+    /* The handle is gone once closed. */
+    EvalResult again = close_fn(close_args, 1);
+    ASSERT_EQ_INT(again.status, EVAL_ERROR);
+    eval_result_free(&again);
+    EastValue *bad_mode = east_string("rw");
+    open_args[1] = bad_mode;
+    EvalResult bad = open_fn(open_args, 2);
+    ASSERT_EQ_INT(bad.status, EVAL_ERROR);
+    eval_result_free(&bad);
+
+    east_value_release(bad_mode);
+    east_value_release(h.value);
+    east_value_release(max);
+    east_value_release(mode_r);
+    east_value_release(mode_w);
+    east_value_release(path_val);
+    unlink(path);
+}
+
 /* ------------------------------------------------------------------ */
 /*  Main                                                               */
 /* ------------------------------------------------------------------ */
@@ -248,6 +372,8 @@ int main(void) {
     RUN_TEST(read_nonexistent_file);
     RUN_TEST(append_file);
     RUN_TEST(exists_nonexistent);
+    RUN_TEST(read_large_file);
+    RUN_TEST(stream_chunks);
 
     platform_registry_free(reg);
 
@@ -28,7 +28,7 @@ export interface EastWasmModule extends EmscriptenModule {
     stringToUTF8: (str: string, outPtr: number, maxBytesToRead?: number) => void;
     lengthBytesUTF8: (str: string) => number;
     _east_wasm_init: () => void;
-    _east_wasm_register_platform: (namePtr: number, isGeneric: number, isAsync: number, inputTypesPtr: number, inputTypesLen: number) => void;
+    _east_wasm_register_platform: (namePtr: number, isGeneric: number, isAsync: number, isPure: number, inputTypesPtr: number, inputTypesLen: number) => void;
     _east_wasm_compile: (irPtr: number, irLen: number) => number;
     _east_wasm_call: (handle: number, resultPtr: number, resultLenPtr: number, errorPtr: number, errorLenPtr: number) => number;
     _east_wasm_call_with_args: (handle: number, argsPtr: number, argsLen: number, resultPtr: number, resultLenPtr: number, errorPtr: number, errorLenPtr: number) => number;
@@ -64,6 +64,12 @@ export interface PlatformRegistration {
     name: string;
     isGeneric: boolean;
     isAsync: boolean;
+    /**
+     * The function has no side effects. Synchronous pure functions are
+     * called in batches: an ArrayMap whose callback only calls one crosses
+     * into JS once for the whole array.
+     */
+    isPure?: boolean | undefined;
     fn?: PlatformFn | undefined;
     factory?: GenericPlatformFactory | undefined;
     /** Beast2-full encoded input types array — enables proper encoding of function args in the bridge */
@@ -169,7 +175,7 @@ export function createEastWasmFromModule(
                 typesPtr = writeBytes(reg.inputTypesBytes);
                 typesLen = reg.inputTypesBytes.length;
             }
-            mod._east_wasm_register_platform(namePtr, reg.isGeneric ? 1 : 0, reg.isAsync ? 1 : 0, typesPtr, typesLen);
+            mod._east_wasm_register_platform(namePtr, reg.isGeneric ? 1 : 0, reg.isAsync ? 1 : 0, reg.isPure ? 1 : 0, typesPtr, typesLen);
             mod._free(namePtr);
             if (typesPtr) mod._free(typesPtr);
         },
@@ -233,56 +239,115 @@ export function createEastWasmFromModule(
     };
 }
 
+/**
+ * What the bridge resolved for one C trampoline (a platform function name
+ * plus type params): the implementation and the Beast2 header of each
+ * argument, or null for arguments C sends Beast2-full.
+ */
+interface TrampolineEntry {
+    name: string;
+    reg: PlatformRegistration;
+    impl: PlatformFn;
+    argHeaders: (Uint8Array | null)[];
+}
+
 /**
  * Build the platform call bridge for Emscripten module options.
  * Must be set as `moduleOpts.js_platform_call` before module initialization.
  *
  * All platform functions execute synchronously. Async platform functions
  * are not supported in WASM — use the TypeScript runtime for async operations.
+ *
+ * Args with a declared type arrive as headerless Beast2 value bytes. The
+ * headers come with every call but are only read the first time a
+ * trampoline id is seen; they are put back in front of the value bytes
+ * before decoding.
+ *
+ * A non-zero `batch` is the number of calls carried by one crossing: the
+ * args list holds `batch` argument tuples back to back, and the results go
+ * back as an args list with one entry per call (empty for null). Returns 2
+ * if they do not fit the result buffer; C then calls again one at a time.
  */
 export function createPlatformBridge(
     platformFns: Map<string, PlatformRegistration>,
     genericCache: Map<string, PlatformFn>,
     getMod: () => EastWasmModule,
-): (namePtr: number, tpPtr: number, tpLen: number, argsPtr: number, argsLen: number, outPtr: number, outLenPtr: number) => number {
+): (namePtr: number, tpPtr: number, tpLen: number, trampolineId: number, batch: number, headersPtr: number, headersLen: number, argsPtr: number, argsLen: number, outPtr: number, outLenPtr: number) => number {
+    const trampolines = new Map<number, TrampolineEntry>();
+
+    function resolve(mod: EastWasmModule, name: string, tpPtr: number, tpLen: number): PlatformFn | string {
+        const reg = platformFns.get(name);
+        if (!reg) return `platform function not registered: ${name}`;
+        if (reg.isGeneric && reg.factory) {
+            const tpBytes = tpLen > 0
+                ? new Uint8Array(mod.HEAPU8.buffer, tpPtr, tpLen).slice()
+                : new Uint8Array(0);
+            const cacheKey = `${name}|${bufToHex(tpBytes)}`;
+            let cached = genericCache.get(cacheKey);
+            if (!cached) {
+                cached = reg.factory(tpBytes);
+                genericCache.set(cacheKey, cached);
+            }
+            return cached;
+        }
+        if (reg.fn) return reg.fn;
+        return `platform function ${name} has no implementation`;
+    }
+
     return (
         namePtr: number,
         tpPtr: number, tpLen: number,
+        trampolineId: number, batch: number,
+        headersPtr: number, headersLen: number,
         argsPtr: number, argsLen: number,
         outPtr: number, outLenPtr: number,
     ): number => {
         const mod = getMod();
 
         try {
-            const name = mod.UTF8ToString(namePtr);
-            const reg = platformFns.get(name);
-            if (!reg) {
-                writeErrorToWasmBridge(mod, `platform function not registered: ${name}`, outPtr, outLenPtr);
-                return 1;
+            // Re-resolve if the function was registered again since
+            let entry = trampolines.get(trampolineId);
+            if (!entry || platformFns.get(entry.name) !== entry.reg) {
+                const name = mod.UTF8ToString(namePtr);
+                const impl = resolve(mod, name, tpPtr, tpLen);
+                if (typeof impl === 'string') {
+                    writeErrorToWasmBridge(mod, impl, outPtr, outLenPtr);
+                    return 1;
+                }
+                const headers = decodeArgsList(new Uint8Array(mod.HEAPU8.buffer, headersPtr, headersLen).slice());
+                entry = {
+                    name,
+                    reg: platformFns.get(name)!,
+                    impl,
+                    argHeaders: headers.map(h => h.length > 0 ? h : null),
+                };
+                trampolines.set(trampolineId, entry);
             }
 
-            // Decode args from WASM memory
+            // Decode args from WASM memory, restoring the Beast2 headers
+            // (function handle args never have one)
+            const { argHeaders, impl } = entry;
             const argsData = new Uint8Array(mod.HEAPU8.buffer, argsPtr, argsLen).slice();
-            const args = decodeArgsList(argsData);
-
-            // Get the implementation
-            let impl: PlatformFn;
-            if (reg.isGeneric && reg.factory) {
-                const tpBytes = tpLen > 0
-                    ? new Uint8Array(mod.HEAPU8.buffer, tpPtr, tpLen).slice()
-                    : new Uint8Array(0);
-                const cacheKey = `${name}|${bufToHex(tpBytes)}`;
-                let cached = genericCache.get(cacheKey);
-                if (!cached) {
-                    cached = reg.factory(tpBytes);
-                    genericCache.set(cacheKey, cached);
+            const args = decodeArgsList(argsData).map((arg, i) => {
+                const header = argHeaders[i % argHeaders.length];
+                if (!header) return arg;
+                const full = new Uint8Array(header.length + arg.length);
+                full.set(header, 0);
+                full.set(arg, header.length);
+                return full;
+            });
+
+            if (batch > 0) {
+                const arity = args.length / batch;
+                const results: Uint8Array[] = [];
+                for (let i = 0; i < batch; i++) {
+                    results.push(impl(args.slice(i * arity, (i + 1) * arity)) ?? new Uint8Array(0));
                 }
-                impl = cached;
-            } else if (reg.fn) {
-                impl = reg.fn;
-            } else {
-                writeErrorToWasmBridge(mod, `platform function ${name} has no implementation`, outPtr, outLenPtr);
-                return 1;
+                const packed = encodeArgsList(results);
+                const capacity = new DataView(mod.HEAPU8.buffer, outLenPtr, 4).getUint32(0, true);
+                if (packed.length > capacity) return 2;
+                writeResultToWasm(mod, packed, outPtr, outLenPtr);
+                return 0;
             }
 
             // Call the implementation (always synchronous)
@@ -406,7 +471,7 @@ function extractFnSignature(fnType: EastTypeValue): { inputs: EastTypeValue[]; o
 /**
  * Create a JS wrapper around a WASM function handle.
  * When called, Beast2-encodes args, calls _east_wasm_invoke_fn, Beast2-decodes result.
- * Executes synchronously — no ASYNCIFY needed.
+ * Executes synchronously.
  */
 function createFnHandleWrapper(
     handleId: number,
@@ -491,9 +556,17 @@ export function bufToHex(buf: Uint8Array): string {
  *
  * Bridges between the JS PlatformFunction format (decoded values) and
  * the WASM PlatformRegistration format (Beast2-full encoded bytes).
+ *
+ * @param options.pure - names of functions without side effects, which may
+ *   be called in batches (see {@link PlatformRegistration.isPure})
  */
-export function registerPlatformFunctions(wasm: EastWasm, platform: PlatformFunction[]): void {
-    for (const reg of buildPlatformRegistrations(platform)) {
+export function registerPlatformFunctions(
+    wasm: EastWasm,
+    platform: PlatformFunction[],
+    options?: { pure?: Iterable<string> | undefined },
+): void {
+    const pure = new Set(options?.pure ?? []);
+    for (const reg of buildPlatformRegistrations(platform, pure)) {
         wasm.registerPlatform(reg);
     }
 }
@@ -517,39 +590,70 @@ export function setHandleResolver(mod: EastWasmModule): void {
     };
 }
 
-function buildPlatformRegistrations(allPlatform: PlatformFunction[]): PlatformRegistration[] {
+function buildPlatformRegistrations(allPlatform: PlatformFunction[], pure: ReadonlySet<string>): PlatformRegistration[] {
     return allPlatform.map(pf => {
         const isGeneric = (pf.type_parameters?.length ?? 0) > 0;
         const isAsync = pf.type === 'async';
+        const isPure = pure.has(pf.name);
 
         if (isGeneric) {
             return {
                 name: pf.name,
                 isGeneric: true,
                 isAsync,
+                isPure,
                 factory: (typeParamsBytes: Uint8Array) => {
                     const typeParams = decodeTypeParams(typeParamsBytes);
                     const inputTypes = pf.inputsFn ? pf.inputsFn(...typeParams) : pf.inputs;
                     const outputType = pf.outputsFn ? pf.outputsFn(...typeParams) : pf.output;
                     const jsFn = pf.fn(...typeParams);
-                    return (args: Uint8Array[]) => callJsPlatformFn(jsFn, inputTypes, outputType, args, allPlatform);
+                    const codecs = platformCodecs(inputTypes, outputType, allPlatform);
+                    return (args: Uint8Array[]) => callJsPlatformFn(jsFn, codecs, args);
                 },
             };
         }
 
         // Encode input types as Beast2-full Array(EastTypeType) for C-side bridge
         const inputTypesBytes = encodeBeast2For(ArrayType(EastTypeType))(pf.inputs);
+        const codecs = platformCodecs(pf.inputs, pf.output, allPlatform);
 
         return {
             name: pf.name,
             isGeneric: false,
             isAsync,
-            fn: (args: Uint8Array[]) => callJsPlatformFn(pf.fn, pf.inputs, pf.output, args, allPlatform),
+            isPure,
+            fn: (args: Uint8Array[]) => callJsPlatformFn(pf.fn, codecs, args),
             inputTypesBytes,
         };
     });
 }
 
+/**
+ * Beast2 codecs for one platform function signature. Decoders are built on
+ * first use (function-typed inputs arrive as handles and never need one).
+ */
+interface PlatformCodecs {
+    inputTypes: EastTypeValue[];
+    outputType: EastTypeValue;
+    decodeOptions: { platform: PlatformFunction[] } | undefined;
+    decoders: (ReturnType<typeof decodeBeast2For> | undefined)[];
+    encoder: ReturnType<typeof encodeBeast2For> | undefined;
+}
+
+function platformCodecs(
+    inputTypes: EastTypeValue[],
+    outputType: EastTypeValue,
+    allPlatform?: PlatformFunction[],
+): PlatformCodecs {
+    return {
+        inputTypes,
+        outputType,
+        decodeOptions: allPlatform ? { platform: allPlatform } : undefined,
+        decoders: [],
+        encoder: undefined,
+    };
+}
+
 /**
  * Bridge between WASM Beast2-encoded bytes and JS platform function implementations.
  * All platform functions execute synchronously.
@@ -564,12 +668,10 @@ function buildPlatformRegistrations(allPlatform: PlatformFunction[]): PlatformRe
  */
 function callJsPlatformFn(
     fn: (...args: unknown[]) => unknown,
-    inputTypes: EastTypeValue[],
-    outputType: EastTypeValue,
+    codecs: PlatformCodecs,
     args: Uint8Array[],
-    allPlatform?: PlatformFunction[],
 ): Uint8Array | null {
-    const decodeOptions = allPlatform ? { platform: allPlatform } : undefined;
+    const { outputType } = codecs;
     const decoded = args.map((argBytes, i) => {
         // Check for function handle sentinel
         if (isFnHandleArg(argBytes) && _handleResolver) {
@@ -577,7 +679,7 @@ function callJsPlatformFn(
             const fnType = decodeBeast2For(EastTypeType)(fnTypeBytes) as EastTypeValue;
             return createFnHandleWrapper(handleId, fnType, _handleResolver.mod, _handleResolver.invokeBufs);
         }
-        const decoder = decodeBeast2For(inputTypes[i]!, decodeOptions);
+        const decoder = codecs.decoders[i] ??= decodeBeast2For(codecs.inputTypes[i]!, codecs.decodeOptions);
         return decoder(argBytes);
     });
     const result = fn(...decoded);
@@ -593,7 +695,7 @@ function callJsPlatformFn(
         return null;
     }
     if (result === null || result === undefined) return null;
-    const encoder = encodeBeast2For(outputType);
+    const encoder = codecs.encoder ??= encodeBeast2For(outputType);
     return encoder(result);
 }
 
@@ -57,14 +57,22 @@ static PlatformInputTypes *get_input_types(const char *name) {
     return NULL;
 }
 
+/* Store (or replace) the declared input types of a platform function;
+ * takes ownership of types. */
 static void store_input_types(const char *name, EastType **types, size_t count) {
-    uint32_t h = input_types_hash(name);
-    PlatformInputTypes *e = calloc(1, sizeof(PlatformInputTypes));
-    e->name = strdup(name);
+    PlatformInputTypes *e = get_input_types(name);
+    if (e) {
+        for (size_t i = 0; i < e->num_inputs; i++) east_type_release(e->input_types[i]);
+        free(e->input_types);
+    } else {
+        uint32_t h = input_types_hash(name);
+        e = calloc(1, sizeof(PlatformInputTypes));
+        e->name = strdup(name);
+        e->next = g_input_types[h];
+        g_input_types[h] = e;
+    }
     e->input_types = types;
     e->num_inputs = count;
-    e->next = g_input_types[h];
-    g_input_types[h] = e;
 }
 
 /* ------------------------------------------------------------------ */
@@ -78,11 +86,22 @@ static void store_input_types(const char *name, EastType **types, size_t count)
  *   1. JS calls east_wasm_compile() with Beast2-full IR bytes
  *   2. When execution hits an IR_PLATFORM node, C calls js_platform_call()
  *   3. JS receives: platform function name, type params as Beast2 type values,
- *      and args as Beast2-encoded values
+ *      the trampoline id and its per-argument schemas, and args as
+ *      Beast2-encoded values
  *   4. JS executes the platform function and writes the Beast2-encoded result
  *      back into WASM memory
  *   5. C decodes the result and continues execution
  *
+ * Arguments with a declared type are sent as headerless Beast2 value bytes;
+ * the schema (magic + type header) for each is encoded once per trampoline
+ * and JS, which caches by trampoline id, puts it back in front. Results
+ * whose header matches the trampoline's last result skip the schema decode.
+ *
+ * Functions registered as pure also get a batched entry point: ArrayMap
+ * over a callback that only calls one hands over every element's argument
+ * tuple in a single js_platform_call (batch = number of calls) and gets all
+ * results back in one args-list formatted buffer.
+ *
  * This avoids needing to register each platform function individually in C.
  * All platform dispatch happens through a single bridge function.
  */
@@ -90,18 +109,23 @@ static void store_input_types(const char *name, EastType **types, size_t count)
 /*
  * JS platform call bridge.
  *
- * All platform functions execute synchronously. The actual implementation
+ * All platform functions execute synchronously, so the module is built
+ * without ASYNCIFY and a call costs one plain import call; nothing is
+ * unwound or rewound, async-registered functions included. The actual implementation
  * is overridden at module instantiation time via moduleOpts.js_platform_call
  * from the TypeScript wrapper.
  */
 EM_JS(int, js_platform_call, (
     const char *name,
     const uint8_t *type_params_buf, size_t type_params_len,
+    uint32_t trampoline_id, uint32_t batch,
+    const uint8_t *arg_headers_buf, size_t arg_headers_len,
     const uint8_t *args_buf, size_t args_len,
     uint8_t *out_buf, size_t *out_len
 ), {
     if (Module.js_platform_call) {
         return Module.js_platform_call(name, type_params_buf, type_params_len,
+                                        trampoline_id, batch, arg_headers_buf, arg_headers_len,
                                         args_buf, args_len, out_buf, out_len);
     }
     /* No handler registered — write error */
@@ -114,12 +138,13 @@ EM_JS(int, js_platform_call, (
 /* Shared result buffer to avoid repeated malloc/free */
 static uint8_t *g_platform_result_buf = NULL;
 
-/* Heap-allocated result length for platform calls.
- * MUST be on the heap (not a local variable) because the bridge writes to it
- * AFTER ASYNCIFY unwinds the C stack. A local (on the shadow stack) would be
- * clobbered by intervening WASM calls (e.g. invoke_fn) before the rewind. */
+/* Result length for platform calls, in/out: buffer capacity before the call,
+ * bytes written after. */
 static size_t *g_platform_result_len = NULL;
 
+/* Calls carried by one batched crossing; bounds the argument buffer */
+#define PLATFORM_BATCH_MAX 4096
+
 /* ------------------------------------------------------------------ */
 /*  Generic platform function factory                                  */
 /* ------------------------------------------------------------------ */
@@ -141,11 +166,26 @@ typedef struct PlatformTrampoline {
     /* Beast2-encoded type params (cached for fast JS calls) */
     uint8_t *type_params_encoded;
     size_t type_params_encoded_len;
+    uint32_t id;                  /* names the trampoline to the JS bridge */
+
+    /* Per-argument wire schemas, built on the first call (trampoline_schemas) */
+    bool schemas_ready;
+    size_t num_args;
+    EastType **arg_types;         /* declared input types (retained), NULL: inferred */
+    uint8_t *arg_headers;         /* [count:u32][len:u32][header]...; len 0: sent full */
+    size_t arg_headers_len;
+    ByteBuffer **fn_types;        /* function args: Beast2-full encoded function type */
+
+    /* Header and type of the last result from JS */
+    ByteBuffer *result_header;
+    EastType *result_type;
+
     struct PlatformTrampoline *next;
 } PlatformTrampoline;
 
 #define TRAMPOLINE_BUCKETS 256
 static PlatformTrampoline *g_trampolines[TRAMPOLINE_BUCKETS];
+static uint32_t g_next_trampoline_id = 1;
 /* Currently executing trampoline (set before call, used by the PlatformFn) */
 static __thread PlatformTrampoline *g_current_trampoline = NULL;
 
@@ -185,6 +225,86 @@ static void encode_type_params(PlatformTrampoline *t) {
     byte_buffer_free(buf);
 }
 
+static bool is_function_type(EastType *t) {
+    return t->kind == EAST_TYPE_FUNCTION || t->kind == EAST_TYPE_ASYNC_FUNCTION;
+}
+
+/* Encode, once per trampoline, what every call would otherwise re-encode:
+ * the Beast2 header of each declared argument type, and the type of each
+ * function argument. */
+static void trampoline_schemas(PlatformTrampoline *t, size_t num_args) {
+    if (t->schemas_ready) return;
+    t->schemas_ready = true;
+
+    /* Look up declared input types (set at registration time by JS) */
+    PlatformInputTypes *declared = get_input_types(t->name);
+    t->num_args = num_args;
+    t->arg_types = calloc(num_args ? num_args : 1, sizeof(EastType *));
+    t->fn_types = calloc(num_args ? num_args : 1, sizeof(ByteBuffer *));
+
+    ByteBuffer *hbuf = byte_buffer_new(256);
+    uint32_t count = (uint32_t)num_args;
+    byte_buffer_write_bytes(hbuf, (uint8_t *)&count, 4);
+    for (size_t i = 0; i < num_args; i++) {
+        EastType *type = declared && i < declared->num_inputs ? declared->input_types[i] : NULL;
+        t->arg_types[i] = type;
+        if (type) east_type_retain(type);
+        ByteBuffer *header = NULL;
+        if (type && is_function_type(type)) {
+            EastValue *type_val = east_type_to_value(type);
+            t->fn_types[i] = east_beast2_encode_full(type_val, east_type_type);
+            east_value_release(type_val);
+        } else if (type) {
+            header = east_beast2_encode_header(type);
+        }
+        uint32_t hlen = header ? (uint32_t)header->len : 0;
+        byte_buffer_write_bytes(hbuf, (uint8_t *)&hlen, 4);
+        if (header) byte_buffer_write_bytes(hbuf, header->data, header->len);
+        byte_buffer_free(header);
+    }
+    t->arg_headers = malloc(hbuf->len);
+    memcpy(t->arg_headers, hbuf->data, hbuf->len);
+    t->arg_headers_len = hbuf->len;
+    byte_buffer_free(hbuf);
+}
+
+/* Drop the schemas built by trampoline_schemas; the next call rebuilds
+ * them from the input types registered then. */
+static void trampoline_schemas_clear(PlatformTrampoline *t) {
+    if (!t->schemas_ready) return;
+    for (size_t i = 0; i < t->num_args; i++) {
+        east_type_release(t->arg_types[i]);
+        byte_buffer_free(t->fn_types[i]);
+    }
+    free(t->arg_types);
+    free(t->fn_types);
+    free(t->arg_headers);
+    t->arg_types = NULL;
+    t->fn_types = NULL;
+    t->arg_headers = NULL;
+    t->arg_headers_len = 0;
+    t->num_args = 0;
+    t->schemas_ready = false;
+}
+
+/* Decode a Beast2-full result, reusing the type of the previous result
+ * when the header bytes are the same. */
+static EastValue *decode_result(PlatformTrampoline *t, const uint8_t *data, size_t len) {
+    ByteBuffer *h = t->result_header;
+    if (!h || len < h->len || memcmp(data, h->data, h->len) != 0) {
+        size_t hlen;
+        EastType *type = east_beast2_decode_header(data, len, &hlen);
+        if (!type) return NULL;
+        east_type_release(t->result_type);
+        byte_buffer_free(h);
+        h = byte_buffer_new(hlen);
+        byte_buffer_write_bytes(h, data, hlen);
+        t->result_header = h;
+        t->result_type = type;
+    }
+    return east_beast2_decode(data + h->len, len - h->len, t->result_type);
+}
+
 /* ------------------------------------------------------------------ */
 /*  Temporary handle table for function value args (bridge callbacks)  */
 /* ------------------------------------------------------------------ */
@@ -218,6 +338,16 @@ static void free_temp_handles_to(size_t target) {
     }
 }
 
+/* Error from JS: the result buffer holds the message as UTF-8 */
+static EvalResult bridge_error(size_t len) {
+    char *msg = malloc(len + 1);
+    memcpy(msg, g_platform_result_buf, len);
+    msg[len] = '\0';
+    EvalResult err = eval_error(msg);
+    free(msg);
+    return err;
+}
+
 /* The actual PlatformFn that all trampolines share */
 static EvalResult platform_bridge_fn(EastValue **args, size_t num_args) {
     PlatformTrampoline *t = g_current_trampoline;
@@ -229,8 +359,11 @@ static EvalResult platform_bridge_fn(EastValue **args, size_t num_args) {
     }
     g_bridge_depth++;
 
-    /* Encode args as Beast2-full array */
-    /* Format: [count][len1][beast2_full_1][len2][beast2_full_2]...
+    trampoline_schemas(t, num_args);
+
+    /* Encode args: [count][len1][bytes1][len2][bytes2]...
+     * Args with a declared type are headerless Beast2 (JS restores the
+     * header from the trampoline's schemas), others are Beast2-full.
      * For function-typed args: [0xFFFFFFFF][handle_id][input_count][type_len][type_bytes]
      */
     ByteBuffer *args_buf = byte_buffer_new(1024);
@@ -239,20 +372,13 @@ static EvalResult platform_bridge_fn(EastValue **args, size_t num_args) {
     uint32_t count = (uint32_t)num_args;
     byte_buffer_write_bytes(args_buf, (uint8_t *)&count, 4);
 
-    /* Look up declared input types (set at registration time by JS) */
-    PlatformInputTypes *declared = get_input_types(t->name);
-
     for (size_t i = 0; i < num_args; i++) {
-        EastType *arg_type = NULL;
+        EastType *arg_type = i < t->num_args ? t->arg_types[i] : NULL;
         EastValue *v = args[i];
         bool type_owned = false;  /* true if we constructed a type that needs release */
 
         /* Check if this is a function arg — pass as opaque handle instead of encoding */
-        if (declared && i < declared->num_inputs &&
-            (declared->input_types[i]->kind == EAST_TYPE_FUNCTION ||
-             declared->input_types[i]->kind == EAST_TYPE_ASYNC_FUNCTION) &&
-            v->kind == EAST_VAL_FUNCTION) {
-
+        if (arg_type && is_function_type(arg_type) && v->kind == EAST_VAL_FUNCTION) {
             /* Write sentinel length */
             uint32_t sentinel = 0xFFFFFFFF;
             byte_buffer_write_bytes(args_buf, (uint8_t *)&sentinel, 4);
@@ -262,55 +388,55 @@ static EvalResult platform_bridge_fn(EastValue **args, size_t num_args) {
             byte_buffer_write_bytes(args_buf, (uint8_t *)&handle_id, 4);
 
             /* Write input count from declared type */
-            uint32_t input_count = (uint32_t)declared->input_types[i]->data.function.num_inputs;
+            uint32_t input_count = (uint32_t)arg_type->data.function.num_inputs;
             byte_buffer_write_bytes(args_buf, (uint8_t *)&input_count, 4);
 
-            /* Write function type as Beast2-full encoded type value */
-            EastValue *type_val = east_type_to_value(declared->input_types[i]);
-            ByteBuffer *tbuf = east_beast2_encode_full(type_val, east_type_type);
+            /* Write the cached Beast2-full encoded function type */
+            ByteBuffer *tbuf = t->fn_types[i];
             uint32_t tlen = (uint32_t)tbuf->len;
             byte_buffer_write_bytes(args_buf, (uint8_t *)&tlen, 4);
             byte_buffer_write_bytes(args_buf, tbuf->data, tbuf->len);
-            byte_buffer_free(tbuf);
-            east_value_release(type_val);
 
             continue;  /* skip normal Beast2 encoding */
         }
 
-        /* Use declared type if available, otherwise infer from value */
-        if (declared && i < declared->num_inputs) {
-            arg_type = declared->input_types[i];
+        ByteBuffer *vbuf;
+        if (arg_type && !is_function_type(arg_type)) {
+            /* Declared: value bytes only */
+            vbuf = east_beast2_encode(v, arg_type);
         } else {
-            switch (v->kind) {
-                case EAST_VAL_NULL:     arg_type = &east_null_type; break;
-                case EAST_VAL_BOOLEAN:  arg_type = &east_boolean_type; break;
-                case EAST_VAL_INTEGER:  arg_type = &east_integer_type; break;
-                case EAST_VAL_FLOAT:    arg_type = &east_float_type; break;
-                case EAST_VAL_STRING:   arg_type = &east_string_type; break;
-                case EAST_VAL_DATETIME: arg_type = &east_datetime_type; break;
-                case EAST_VAL_BLOB:     arg_type = &east_blob_type; break;
-                case EAST_VAL_ARRAY:    { east_type_retain(v->data.array.elem_type);
-                                          arg_type = east_array_type(v->data.array.elem_type); type_owned = true; break; }
-                case EAST_VAL_SET:      { east_type_retain(v->data.set.elem_type);
-                                          arg_type = east_set_type(v->data.set.elem_type); type_owned = true; break; }
-                case EAST_VAL_DICT:     { east_type_retain(v->data.dict.key_type);
-                                          east_type_retain(v->data.dict.val_type);
-                                          arg_type = east_dict_type(v->data.dict.key_type, v->data.dict.val_type); type_owned = true; break; }
-                case EAST_VAL_STRUCT:   { east_type_retain(v->data.struct_.type);
-                                          arg_type = v->data.struct_.type; break; }
-                case EAST_VAL_VARIANT:  { east_type_retain(v->data.variant.type);
-                                          arg_type = v->data.variant.type; break; }
-                case EAST_VAL_REF:      arg_type = &east_blob_type; break; /* fallback */
-                case EAST_VAL_VECTOR:   { east_type_retain(v->data.vector.elem_type);
-                                          arg_type = east_vector_type(v->data.vector.elem_type); type_owned = true; break; }
-                case EAST_VAL_MATRIX:   { east_type_retain(v->data.matrix.elem_type);
-                                          arg_type = east_matrix_type(v->data.matrix.elem_type); type_owned = true; break; }
-                case EAST_VAL_FUNCTION: arg_type = &east_blob_type; break; /* unreachable if declared types provided */
+            if (!arg_type) {
+                /* Infer from value */
+                switch (v->kind) {
+                    case EAST_VAL_NULL:     arg_type = &east_null_type; break;
+                    case EAST_VAL_BOOLEAN:  arg_type = &east_boolean_type; break;
+                    case EAST_VAL_INTEGER:  arg_type = &east_integer_type; break;
+                    case EAST_VAL_FLOAT:    arg_type = &east_float_type; break;
+                    case EAST_VAL_STRING:   arg_type = &east_string_type; break;
+                    case EAST_VAL_DATETIME: arg_type = &east_datetime_type; break;
+                    case EAST_VAL_BLOB:     arg_type = &east_blob_type; break;
+                    case EAST_VAL_ARRAY:    { east_type_retain(v->data.array.elem_type);
+                                              arg_type = east_array_type(v->data.array.elem_type); type_owned = true; break; }
+                    case EAST_VAL_SET:      { east_type_retain(v->data.set.elem_type);
+                                              arg_type = east_set_type(v->data.set.elem_type); type_owned = true; break; }
+                    case EAST_VAL_DICT:     { east_type_retain(v->data.dict.key_type);
+                                              east_type_retain(v->data.dict.val_type);
+                                              arg_type = east_dict_type(v->data.dict.key_type, v->data.dict.val_type); type_owned = true; break; }
+                    case EAST_VAL_STRUCT:   { east_type_retain(v->data.struct_.type);
+                                              arg_type = v->data.struct_.type; break; }
+                    case EAST_VAL_VARIANT:  { east_type_retain(v->data.variant.type);
+                                              arg_type = v->data.variant.type; break; }
+                    case EAST_VAL_REF:      arg_type = &east_blob_type; break; /* fallback */
+                    case EAST_VAL_VECTOR:   { east_type_retain(v->data.vector.elem_type);
+                                              arg_type = east_vector_type(v->data.vector.elem_type); type_owned = true; break; }
+                    case EAST_VAL_MATRIX:   { east_type_retain(v->data.matrix.elem_type);
+                                              arg_type = east_matrix_type(v->data.matrix.elem_type); type_owned = true; break; }
+                    case EAST_VAL_FUNCTION: arg_type = &east_blob_type; break; /* unreachable if declared types provided */
+                }
             }
+            vbuf = east_beast2_encode_full(v, arg_type);
         }
 
-        ByteBuffer *vbuf = east_beast2_encode_full(v, arg_type);
-
         /* Write length + data */
         uint32_t vlen = (uint32_t)vbuf->len;
         byte_buffer_write_bytes(args_buf, (uint8_t *)&vlen, 4);
@@ -323,13 +449,12 @@ static EvalResult platform_bridge_fn(EastValue **args, size_t num_args) {
         }
     }
 
-    /* Call JS — use heap-allocated g_platform_result_len (not a stack local)
-     * because async bridge writes happen after ASYNCIFY unwind, and
-     * a stack local would be clobbered by intervening WASM calls. */
+    /* Call JS */
     *g_platform_result_len = PLATFORM_RESULT_BUF_SIZE;
     int rc = js_platform_call(
         t->name,
         t->type_params_encoded, t->type_params_encoded_len,
+        t->id, 0, t->arg_headers, t->arg_headers_len,
         args_buf->data, args_buf->len,
         g_platform_result_buf, g_platform_result_len
     );
@@ -344,15 +469,7 @@ static EvalResult platform_bridge_fn(EastValue **args, size_t num_args) {
         free_temp_handles_to(g_handle_stack[g_bridge_depth]);
     }
 
-    if (rc != 0) {
-        /* Error: out_buf contains error message as UTF-8 */
-        char *msg = malloc(out_len + 1);
-        memcpy(msg, g_platform_result_buf, out_len);
-        msg[out_len] = '\0';
-        EvalResult err = eval_error(msg);
-        free(msg);
-        return err;
-    }
+    if (rc != 0) return bridge_error(out_len);
 
     if (out_len == 0) {
         /* No return value (null) */
@@ -360,7 +477,7 @@ static EvalResult platform_bridge_fn(EastValue **args, size_t num_args) {
     }
 
     /* Decode result from Beast2-full (self-describing — type is embedded) */
-    EastValue *result = east_beast2_decode_auto(g_platform_result_buf, out_len);
+    EastValue *result = decode_result(t, g_platform_result_buf, out_len);
     if (!result) {
         return eval_error("platform bridge: failed to decode result from JS");
     }
@@ -368,6 +485,116 @@ static EvalResult platform_bridge_fn(EastValue **args, size_t num_args) {
     return eval_ok(result);
 }
 
+static void release_results(EastValue **results, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        east_value_release(results[i]);
+        results[i] = NULL;
+    }
+}
+
+/* One crossing per call, for batches the batched wire format cannot carry */
+static EvalResult platform_bridge_each(PlatformTrampoline *t, EastValue **args, size_t num_args,
+                                       size_t count, EastValue **results) {
+    for (size_t i = 0; i < count; i++) {
+        g_current_trampoline = t;  /* a nested call may have replaced it */
+        EvalResult r = platform_bridge_fn(args + i * num_args, num_args);
+        if (r.status != EVAL_OK) {
+            release_results(results, i);
+            return r;
+        }
+        results[i] = r.value;
+    }
+    return eval_ok(NULL);
+}
+
+/* Decode the results of a batched crossing: an args list of Beast2-full
+ * values, one per call, length 0 for null. */
+static EvalResult decode_batch_results(PlatformTrampoline *t, size_t out_len,
+                                       size_t count, EastValue **results) {
+    const uint8_t *p = g_platform_result_buf;
+    size_t left = out_len;
+    uint32_t n = 0;
+    if (left >= 4) memcpy(&n, p, 4);
+    if (n != count) return eval_error("platform bridge: wrong number of batch results from JS");
+    p += 4;
+    left -= 4;
+    for (size_t i = 0; i < count; i++) {
+        uint32_t len = 0;
+        if (left >= 4) memcpy(&len, p, 4);
+        if (left < 4 || left - 4 < len) {
+            release_results(results, i);
+            return eval_error("platform bridge: truncated batch results from JS");
+        }
+        p += 4;
+        left -= 4 + (size_t)len;
+        results[i] = len ? decode_result(t, p, len) : east_null();
+        if (!results[i]) {
+            release_results(results, i);
+            return eval_error("platform bridge: failed to decode result from JS");
+        }
+        p += len;
+    }
+    return eval_ok(NULL);
+}
+
+/* The PlatformBatchFn of functions registered as pure. Argument tuples are
+ * sent headerless, PLATFORM_BATCH_MAX calls per crossing; this needs a
+ * declared, non-function type for every argument. */
+static EvalResult platform_bridge_batch_fn(EastValue **args, size_t num_args,
+                                           size_t count, EastValue **results) {
+    PlatformTrampoline *t = g_current_trampoline;
+    if (!t) return eval_error("platform bridge: no active trampoline");
+    trampoline_schemas(t, num_args);
+
+    bool headerless = t->num_args == num_args;
+    for (size_t i = 0; headerless && i < num_args; i++)
+        headerless = t->arg_types[i] && !is_function_type(t->arg_types[i]);
+    if (!headerless) return platform_bridge_each(t, args, num_args, count, results);
+
+    for (size_t start = 0; start < count; start += PLATFORM_BATCH_MAX) {
+        size_t n = count - start < PLATFORM_BATCH_MAX ? count - start : PLATFORM_BATCH_MAX;
+        EastValue **tuple_args = args + start * num_args;
+
+        /* [count][len][bytes]... with count = n * num_args */
+        ByteBuffer *args_buf = byte_buffer_new(1024);
+        uint32_t total = (uint32_t)(n * num_args);
+        byte_buffer_write_bytes(args_buf, (uint8_t *)&total, 4);
+        for (size_t k = 0; k < total; k++) {
+            ByteBuffer *vbuf = east_beast2_encode(tuple_args[k], t->arg_types[k % num_args]);
+            uint32_t vlen = (uint32_t)vbuf->len;
+            byte_buffer_write_bytes(args_buf, (uint8_t *)&vlen, 4);
+            byte_buffer_write_bytes(args_buf, vbuf->data, vbuf->len);
+            byte_buffer_free(vbuf);
+        }
+
+        *g_platform_result_len = PLATFORM_RESULT_BUF_SIZE;
+        int rc = js_platform_call(
+            t->name,
+            t->type_params_encoded, t->type_params_encoded_len,
+            t->id, (uint32_t)n, t->arg_headers, t->arg_headers_len,
+            args_buf->data, args_buf->len,
+            g_platform_result_buf, g_platform_result_len
+        );
+        byte_buffer_free(args_buf);
+
+        EvalResult r;
+        if (rc == 2) {
+            /* Results did not fit the buffer together; the function is pure,
+             * so calling it again one tuple at a time is safe */
+            r = platform_bridge_each(t, tuple_args, num_args, n, results + start);
+        } else if (rc != 0) {
+            r = bridge_error(*g_platform_result_len);
+        } else {
+            r = decode_batch_results(t, *g_platform_result_len, n, results + start);
+        }
+        if (r.status != EVAL_OK) {
+            release_results(results, start);
+            return r;
+        }
+    }
+    return eval_ok(NULL);
+}
+
 /* Factory function: creates a PlatformFn for a specific (name, type_params) */
 static PlatformFn platform_bridge_factory(EastType **type_params, size_t num_type_params) {
     /* This is called by the compiler when it encounters a generic platform node.
@@ -447,6 +674,7 @@ static PlatformTrampoline *get_or_create_trampoline(
     /* Create new */
     PlatformTrampoline *t = calloc(1, sizeof(PlatformTrampoline));
     t->name = strdup(name);
+    t->id = g_next_trampoline_id++;
     t->num_type_params = num_type_params;
     if (num_type_params > 0) {
         t->type_params = malloc(sizeof(EastType *) * num_type_params);
@@ -462,6 +690,16 @@ static PlatformTrampoline *get_or_create_trampoline(
     return t;
 }
 
+/* Invalidate the schemas of every trampoline of a platform function whose
+ * input types were (re-)registered. */
+static void invalidate_trampolines(const char *name) {
+    for (size_t b = 0; b < TRAMPOLINE_BUCKETS; b++) {
+        for (PlatformTrampoline *t = g_trampolines[b]; t; t = t->next) {
+            if (strcmp(t->name, name) == 0) trampoline_schemas_clear(t);
+        }
+    }
+}
+
 /* ------------------------------------------------------------------ */
 /*  Custom eval wrapper to set up trampolines                          */
 /* ------------------------------------------------------------------ */
@@ -554,11 +792,13 @@ void east_wasm_init(void) {
  * name: null-terminated function name (e.g. "state_read")
  * is_generic: true if the function takes type parameters
  * is_async: true if the function is async
+ * is_pure: true if calls have no side effects; sync pure functions get a
+ *          batched entry point (see platform_bridge_batch_fn)
  * input_types_buf: Beast2-full encoded array of input types (or NULL)
  * input_types_len: length of input_types_buf
  */
 EMSCRIPTEN_KEEPALIVE
-void east_wasm_register_platform(const char *name, int is_generic, int is_async,
+void east_wasm_register_platform(const char *name, int is_generic, int is_async, int is_pure,
                                   const uint8_t *input_types_buf, size_t input_types_len) {
     /* Decode and store input types if provided */
     if (input_types_buf && input_types_len > 0) {
@@ -572,9 +812,10 @@ void east_wasm_register_platform(const char *name, int is_generic, int is_async,
             size_t n = types_arr->data.array.len;
             EastType **types = calloc(n, sizeof(EastType *));
             for (size_t i = 0; i < n; i++) {
-                types[i] = east_type_from_value(types_arr->data.array.items[i]);
+                types[i] = east_type_from_value(east_array_get(types_arr, i));
             }
             store_input_types(name, types, n);
+            invalidate_trampolines(name);
         }
         if (types_arr) east_value_release(types_arr);
     }
@@ -584,6 +825,7 @@ void east_wasm_register_platform(const char *name, int is_generic, int is_async,
     } else {
         platform_registry_add(g_platform, name, platform_bridge_fn, is_async != 0);
     }
+    if (is_pure) platform_registry_set_batch(g_platform, name, platform_bridge_batch_fn);
 }
 
 /*
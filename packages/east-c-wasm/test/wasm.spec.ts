@@ -26,13 +26,53 @@ import {
 } from '@elaraai/east';
 import { IRType, encodeBeast2For } from '@elaraai/east/internal';
 
+import { fileURLToPath } from 'node:url';
+import { dirname, join } from 'node:path';
+
 import { createEastWasm } from '../src/index.js';
 import type { EastWasm } from '../src/index.js';
-import { registerPlatformFunctions, encodeArgsList } from '../src/common.js';
+import {
+    type EastWasmModule,
+    type PlatformFn,
+    type PlatformRegistration,
+    createEastWasmFromModule,
+    createPlatformBridge,
+    registerPlatformFunctions,
+    encodeArgsList,
+} from '../src/common.js';
 
 // Beast2-full encoder for IR
 const encodeIR = encodeBeast2For(IRType);
 
+/**
+ * Helper: load a second module like createEastWasm, recording the `batch`
+ * argument of every js_platform_call crossing. The handle resolver is left
+ * pointing at the shared instance, so platform functions taking function
+ * args must not be used here.
+ */
+async function createRecordingEastWasm(batches: number[]): Promise<EastWasm> {
+    const wasmDir = join(dirname(fileURLToPath(import.meta.url)), '..', 'wasm');
+    const glueModule = await import(join(wasmDir, 'east-c.js'));
+    const createModule = glueModule.default as (opts?: Record<string, unknown>) => Promise<EastWasmModule>;
+
+    const platformFns = new Map<string, PlatformRegistration>();
+    const genericCache = new Map<string, PlatformFn>();
+    let mod: EastWasmModule;
+    const bridge = createPlatformBridge(platformFns, genericCache, () => mod);
+
+    mod = await createModule({
+        locateFile(path: string) {
+            if (path.endsWith('.wasm')) return join(wasmDir, 'east-c.wasm');
+            return path;
+        },
+        js_platform_call: (...args: Parameters<typeof bridge>) => {
+            batches.push(args[4]);
+            return bridge(...args);
+        },
+    });
+    return createEastWasmFromModule(mod, { platformFns, genericCache });
+}
+
 /** Helper: compile an East function to Beast2-full IR bytes */
 function toIRBytes(fn: ReturnType<typeof East.function> | ReturnType<typeof East.asyncFunction>): Uint8Array {
     const ir = fn.toIR().ir;
@@ -292,6 +332,56 @@ describe('east-c-wasm', async () => {
         wasm.free(handle);
     });
 
+    await test('platform function — tight loop', async () => {
+        // test_double is already registered
+        const double = East.platform("test_double", [IntegerType], IntegerType);
+        const calls = 20000n;
+
+        const fn = East.function([], IntegerType, ($) => {
+            const sum = $.let(0n, IntegerType);
+            const i = $.let(0n, IntegerType);
+            $.while(East.less(i, calls), ($) => {
+                $.assign(sum, sum.add(double(i)));
+                $.assign(i, i.add(1n));
+            });
+            return sum;
+        });
+
+        const handle = wasm.compile(toIRBytes(fn));
+        const result = await wasm.call(handle);
+        assert.ok(result);
+
+        const decoded = decodeBeast2(result);
+        assert.equal(decoded.value, calls * (calls - 1n));
+        wasm.free(handle);
+    });
+
+    await test('platform function — batched map over a pure function', async () => {
+        const triple = East.platform("test_triple", [IntegerType], IntegerType);
+        let calls = 0;
+        const batches: number[] = [];
+        const recording = await createRecordingEastWasm(batches);
+        registerPlatformFunctions(recording, [triple.implement((x: bigint) => { calls++; return x * 3n; })], { pure: ["test_triple"] });
+        const count = 20000n;
+
+        const fn = East.function([], IntegerType, ($) => {
+            const arr = $.let(East.Array.generate(count, IntegerType, ($, i) => i));
+            const tripled = $.let(arr.map(($, x) => triple(x)));
+            return tripled.reduce(($, acc, x) => acc.add(x), 0n);
+        });
+
+        const handle = recording.compile(toIRBytes(fn));
+        const result = await recording.call(handle);
+        assert.ok(result);
+
+        const decoded = decodeBeast2(result);
+        assert.equal(decoded.value, 3n * count * (count - 1n) / 2n);
+        assert.equal(calls, Number(count));
+        // 4096 calls per crossing; an unbatched map would cross 20000 times with batch = 0
+        assert.deepEqual(batches, [4096, 4096, 4096, 4096, 3616]);
+        recording.free(handle);
+    });
+
     await test('large IR — stress-test compilation', async () => {
         // Build a function with many operations to stress-test WASM memory
         const fn = East.function([], IntegerType, ($) => {
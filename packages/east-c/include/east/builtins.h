@@ -47,4 +47,8 @@ void east_register_vector_builtins(BuiltinRegistry *reg);
 void east_register_matrix_builtins(BuiltinRegistry *reg);
 void east_register_patch_builtins(BuiltinRegistry *reg);
 
+// Drop the DateTime format plans cached on this thread, with the references
+// they hold. east_call does this when its outermost call returns.
+void east_datetime_plans_clear(void);
+
 #endif
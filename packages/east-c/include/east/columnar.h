@@ -0,0 +1,111 @@
+#ifndef EAST_COLUMNAR_H
+#define EAST_COLUMNAR_H
+
+#include "types.h"
+#include "values.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Columnar storage for Array<Struct> whose fields are all primitive
+ * (Null, Boolean, Integer, Float, String, DateTime, or Option of one).
+ *
+ * Instead of one struct value per row, each field is a typed buffer:
+ * Option fields add a presence bitmap, and String fields hold a code per
+ * row into a dictionary of distinct String values. Such an array has
+ * the columnar flag set and data.array.columns in place of data.array.cap;
+ * data.array.items is then either NULL or a cache of rows_cap rows built
+ * on demand by east_array_get (NULL entries not yet built). The flag and
+ * the union keep EastValue the same size as before columns existed.
+ * The CSV and Beast2 decoders produce columnar arrays, and
+ * ArrayMap, ArrayFilter and ArraySort keep them columnar.
+ *
+ * Columnar arrays are read-only: any code that touches items directly,
+ * including every in-place mutation, first calls east_array_ensure_rows,
+ * which turns the array back into one value per row.
+ */
+
+typedef enum {
+    EAST_COL_NULL,
+    EAST_COL_BOOLEAN,
+    EAST_COL_INTEGER,
+    EAST_COL_FLOAT,
+    EAST_COL_STRING,
+    EAST_COL_DATETIME,
+} EastColumnKind;
+
+typedef struct {
+    EastColumnKind kind;
+    EastType *option_type;  // the Option<T> type for optional fields, else NULL
+    uint8_t *present;       // optional fields: bit i set when row i is some
+    union {
+        bool *boolean;
+        int64_t *integer;   // Integer and DateTime (epoch millis)
+        double *float64;
+        uint32_t *code;     // String: index into strings
+    } data;
+
+    /* String dictionary, in first-seen order, with a hash index */
+    EastValue **strings;
+    size_t num_strings;
+    size_t strings_cap;
+    uint32_t *lookup;       // open addressing: code + 1, 0 = empty slot
+    size_t lookup_cap;
+} EastColumn;
+
+struct EastColumns {
+    EastType *row_type;     // the Struct type
+    size_t num_fields;      // one column per field, in type order
+    size_t len;
+    size_t cap;
+    EastColumn *cols;
+    const char **names;     // field names, borrowed from row_type
+    size_t rows_cap;        // entries in the row cache (data.array.items)
+};
+
+// True if Array<struct_type> can be stored column-wise.
+bool east_columnar_supported(EastType *struct_type);
+
+// Empty columnar Array<struct_type>; struct_type must be supported.
+EastValue *east_columnar_array_new(EastType *struct_type, size_t capacity);
+
+// Append a row with every field zero / none to a columnar array and
+// return its index, for decoders that then fill it with the
+// east_column_set_* functions. Returns SIZE_MAX if out of memory.
+size_t east_columnar_add_row(EastValue *arr);
+
+void east_column_set_boolean(EastColumn *col, size_t row, bool v);
+void east_column_set_integer(EastColumn *col, size_t row, int64_t v);   // also DateTime
+void east_column_set_float(EastColumn *col, size_t row, double v);
+bool east_column_set_string(EastColumn *col, size_t row, const char *s, size_t len);
+void east_column_set_null(EastColumn *col, size_t row);  // Null field or none
+
+// Store a boxed field value (of the column's type, Option included).
+// Returns false if the value does not fit the column.
+bool east_column_set_value(EastColumn *col, size_t row, EastValue *v);
+
+// Append a struct value of the row type as a new row.
+bool east_columnar_push_struct(EastValue *arr, EastValue *row);
+
+// True if the field of row is present (always true for required fields).
+static inline bool east_column_present(const EastColumn *col, size_t row) {
+    return !col->present || (col->present[row >> 3] >> (row & 7)) & 1;
+}
+
+// Boxed field value / struct row (new references).
+EastValue *east_column_value(const EastColumn *col, size_t row);
+EastValue *east_columnar_row(EastValue *arr, size_t row);
+
+// Row i as a borrowed struct, built on first use and kept in items.
+EastValue *east_columnar_get(EastValue *arr, size_t i);
+
+// New columnar array holding rows[0..n) of arr, in that order.
+EastValue *east_columnar_gather(EastValue *arr, const size_t *rows, size_t n);
+
+// Bytes held by the column buffers (dictionary strings are values and
+// are accounted as such).
+size_t east_columns_bytes(const EastColumns *c);
+void east_columns_free(EastColumns *c);
+
+#endif
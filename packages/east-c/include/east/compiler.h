@@ -24,6 +24,16 @@ EastCompiledFn *east_compile(IRNode *ir, PlatformRegistry *platform, BuiltinRegi
 EvalResult east_call(EastCompiledFn *fn, EastValue **args, size_t num_args);
 void east_compiled_fn_free(EastCompiledFn *fn);
 
+// Batched calls: true if fn's body is just a call to a pure platform function
+// with a batched entry point (see platform_registry_set_batch) on arguments
+// built from its parameters, fields and literals.
+bool east_fn_batchable(EastCompiledFn *fn);
+// Call a batchable fn count times with a single platform crossing. args holds
+// count tuples of num_args values back to back; on success results[i]
+// receives call i's result (new reference).
+EvalResult east_call_batch(EastCompiledFn *fn, EastValue **args, size_t num_args,
+                           size_t count, EastValue **results);
+
 // Internal evaluation
 EvalResult eval_ir(IRNode *node, Environment *env, PlatformRegistry *platform, BuiltinRegistry *builtins);
 
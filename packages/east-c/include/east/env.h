@@ -4,12 +4,14 @@
 #include "hashmap.h"
 #include "values.h"
 #include <stdbool.h>
+#include <stdint.h>
 
 typedef struct Environment {
     Hashmap *locals;
     struct Environment *parent;
     int ref_count;
     unsigned gc_gen;  /* generation stamp for GC dedup */
+    uint32_t mem_bytes;  /* bytes counted by memory accounting */
 } Environment;
 
 Environment *env_new(Environment *parent);
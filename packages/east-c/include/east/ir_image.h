@@ -0,0 +1,37 @@
+#ifndef EAST_IR_IMAGE_H
+#define EAST_IR_IMAGE_H
+
+#include "ir.h"
+#include "serialization.h"
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Program images: a compact, position-independent encoding of an already
+ * converted IRNode tree (node kinds, types, literals, locations).
+ *
+ * Loading an image rebuilds the IRNode tree in a single linear pass and
+ * skips both IR value decoding (Beast2/JSON/East) and east_ir_from_value.
+ * Images contain no pointers, so they can be decoded straight out of an
+ * mmap'd cache file.
+ *
+ * Nested function nodes keep their source IR (needed to serialize closures,
+ * e.g. for parallel_map) as Beast2 bytes, decoded back into source_ir when
+ * the image loads.
+ */
+
+// Bumped whenever the image layout changes; old images are rejected.
+#define EAST_IR_IMAGE_VERSION 1
+
+// 64-bit FNV-1a content hash, used to key cached images by IR file bytes.
+uint64_t east_ir_image_hash(const uint8_t *data, size_t len);
+
+// Encode a converted IR tree. source_hash is stored in the header and
+// checked again on decode. Returns NULL if the tree cannot be imaged.
+ByteBuffer *east_ir_image_encode(IRNode *ir, uint64_t source_hash);
+
+// Decode an image. Returns NULL if the data is truncated, corrupt, from a
+// different image version, or was built from a different source_hash.
+IRNode *east_ir_image_decode(const uint8_t *data, size_t len, uint64_t source_hash);
+
+#endif
@@ -0,0 +1,135 @@
+#ifndef EAST_KERNELS_H
+#define EAST_KERNELS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Numeric kernels over unboxed Vector / Matrix buffers.
+ *
+ * The loops are written so the compiler can vectorize them, and on
+ * x86-64 Linux each kernel is also built for AVX2 and picked at load
+ * time. Every variant does the same operations in the same order, so
+ * results do not depend on the CPU.
+ *
+ * Float comparisons, minima and maxima use East's total order: NaN is
+ * greater than everything and equal to itself, and -0 < +0. Integer
+ * arithmetic wraps on overflow. Integer division floors and yields 0 for
+ * a zero divisor, like IntegerDivide.
+ *
+ * Output buffers must not overlap the inputs.
+ */
+
+typedef enum {
+    EAST_ARITH_ADD,
+    EAST_ARITH_SUB,
+    EAST_ARITH_MUL,
+    EAST_ARITH_DIV,
+} EastArithOp;
+
+typedef enum {
+    EAST_CMP_EQ,
+    EAST_CMP_NE,
+    EAST_CMP_LT,
+    EAST_CMP_LE,
+    EAST_CMP_GT,
+    EAST_CMP_GE,
+} EastCmpOp;
+
+// out[i] = a[i] op b[i], or a[i] op scalar when b is NULL.
+void east_kernel_arith_f64(EastArithOp op, double *out, const double *a,
+                           const double *b, double scalar, size_t n);
+void east_kernel_arith_i64(EastArithOp op, int64_t *out, const int64_t *a,
+                           const int64_t *b, int64_t scalar, size_t n);
+
+// out[i] = a[i] cmp b[i], or a[i] cmp scalar when b is NULL.
+void east_kernel_compare_f64(EastCmpOp op, bool *out, const double *a,
+                             const double *b, double scalar, size_t n);
+void east_kernel_compare_i64(EastCmpOp op, bool *out, const int64_t *a,
+                             const int64_t *b, int64_t scalar, size_t n);
+
+// Float sums and dot products accumulate in eight interleaved lanes.
+double east_kernel_sum_f64(const double *a, size_t n);
+int64_t east_kernel_sum_i64(const int64_t *a, size_t n);
+double east_kernel_sum_i64_as_f64(const int64_t *a, size_t n);   // no overflow
+double east_kernel_dot_f64(const double *a, const double *b, size_t n);
+int64_t east_kernel_dot_i64(const int64_t *a, const int64_t *b, size_t n);
+
+// Running sums: out[i] = a[0] + ... + a[i].
+void east_kernel_cumsum_f64(double *out, const double *a, size_t n);
+void east_kernel_cumsum_i64(int64_t *out, const int64_t *a, size_t n);
+
+// Index of the first minimum / maximum; n must be > 0.
+size_t east_kernel_argmin_f64(const double *a, size_t n);
+size_t east_kernel_argmax_f64(const double *a, size_t n);
+size_t east_kernel_argmin_i64(const int64_t *a, size_t n);
+size_t east_kernel_argmax_i64(const int64_t *a, size_t n);
+
+// y[i] += alpha * x[i]
+void east_kernel_axpy_f64(double *y, double alpha, const double *x, size_t n);
+void east_kernel_axpy_i64(int64_t *y, int64_t alpha, const int64_t *x, size_t n);
+
+/* ------------------------------------------------------------------ */
+/*  Calendar                                                           */
+/* ------------------------------------------------------------------ */
+
+// Output columns for east_kernel_datetime_parts, one element per input.
+typedef struct {
+    int64_t *year;
+    int64_t *month;          // 1-12
+    int64_t *day;            // 1-31
+    int64_t *hour;
+    int64_t *minute;
+    int64_t *second;
+    int64_t *millisecond;
+    int64_t *day_of_week;    // ISO 8601: 1 = Monday, 7 = Sunday
+} EastDateTimeColumns;
+
+// Split epoch milliseconds into UTC calendar fields (proleptic Gregorian,
+// as east_datetime_parts) over the whole int64 range, without branches.
+void east_kernel_datetime_parts(const int64_t *ms, size_t n,
+                                const EastDateTimeColumns *out);
+
+/* ------------------------------------------------------------------ */
+/*  Dense linear algebra on row-major buffers                          */
+/* ------------------------------------------------------------------ */
+
+// C (m x n) = A (m x k) * B (k x n). Float products are cache-blocked and
+// split by rows over worker threads once m * n * k reaches
+// EAST_GEMM_THREAD_MIN. The thread count is the online CPU count, lowered
+// by EAST_C_MATRIX_THREADS if that is set and smaller; 1 keeps everything
+// on the calling thread. Each element is summed in the same order whatever
+// the blocking or split.
+#define EAST_GEMM_THREAD_MIN ((size_t)1 << 24)
+void east_kernel_gemm_f64(size_t m, size_t n, size_t k, const double *a,
+                          const double *b, double *c);
+void east_kernel_gemm_i64(size_t m, size_t n, size_t k, const int64_t *a,
+                          const int64_t *b, int64_t *c);
+
+// In-place LU factorization of an n x n matrix with partial pivoting:
+// afterwards a holds U and the unit-diagonal L below it, and row i of the
+// factorization is row perm[i] of the input. Returns false if singular.
+bool east_kernel_lu_f64(size_t n, double *a, size_t *perm);
+
+// Solve A X = B from east_kernel_lu_f64's output. b is n x nrhs and is
+// replaced by X.
+void east_kernel_lu_solve_f64(size_t n, const double *lu, const size_t *perm,
+                              double *b, size_t nrhs);
+
+// In-place Cholesky factorization A = L L^T of a symmetric positive
+// definite n x n matrix, reading only the lower triangle; L is written
+// there and the strict upper triangle is zeroed. Returns false if A is
+// not positive definite.
+bool east_kernel_cholesky_f64(size_t n, double *a);
+
+// Solve A X = B given the Cholesky factor L; b (n x nrhs) becomes X.
+void east_kernel_cholesky_solve_f64(size_t n, const double *l, double *b,
+                                    size_t nrhs);
+
+// dst (cols x rows) = transpose of src (rows x cols), for elements of any
+// size; 8- and 1-byte elements take the cache-oblivious blocked path.
+void east_kernel_transpose(size_t rows, size_t cols, size_t elem_size,
+                           const void *src, void *dst);
+
+#endif
@@ -0,0 +1,100 @@
+#ifndef EAST_MEMORY_H
+#define EAST_MEMORY_H
+
+#include "ir.h"
+#include "values.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/*
+ * Optional memory accounting.
+ *
+ * When enabled, the runtime counts the bytes it holds in values (broken
+ * down by EastValueKind), environments, IR nodes, types and serialization
+ * buffers, and attributes allocations made during builtin calls to the
+ * calling IR node. Counts are of requested sizes, not allocator overhead,
+ * so they track but do not equal the process RSS.
+ *
+ * Enable accounting before creating the objects to be measured. Values
+ * and environments remember what was counted for them and are exact;
+ * IR nodes and types that already existed when accounting was switched
+ * on are not counted, and releasing them later is ignored once their
+ * subsystem reaches zero.
+ *
+ * A soft limit turns "live accounted bytes > limit" into an East error,
+ * raised at the next builtin, platform or function call, so programs
+ * fail with a catchable error instead of being killed by the OS.
+ *
+ * When accounting is off the runtime pays one global load per hook.
+ */
+
+typedef enum {
+    EAST_MEM_VALUES,
+    EAST_MEM_ENV,
+    EAST_MEM_IR,
+    EAST_MEM_TYPES,
+    EAST_MEM_BUFFERS,       // Beast2 / binary ByteBuffers
+    EAST_MEM_NUM_SUBSYSTEMS,
+} EastMemSubsystem;
+
+typedef struct {
+    uint64_t live;          // bytes currently held
+    uint64_t peak;          // high-water mark of live
+    uint64_t objects;       // objects currently held
+} EastMemStats;
+
+// True while accounting is on (checked by the allocation hooks).
+extern bool east_mem_accounting;
+
+void east_mem_enable(void);
+void east_mem_disable(void);
+
+// Soft limit on total live accounted bytes; 0 disables it.
+void east_mem_set_limit(uint64_t bytes);
+uint64_t east_mem_get_limit(void);
+
+EastMemStats east_mem_total(void);
+EastMemStats east_mem_subsystem(EastMemSubsystem s);
+EastMemStats east_mem_value_kind(EastValueKind kind);
+const char *east_mem_subsystem_name(EastMemSubsystem s);
+
+// Peak resident set size of the process in bytes (0 if unavailable).
+uint64_t east_mem_peak_rss(void);
+
+// Human-readable report: per-subsystem and per-kind live/peak bytes, the
+// top builtin call sites by retained bytes (at most max_sites, 0 = all)
+// and peak RSS.
+void east_mem_write_report(FILE *out, size_t max_sites);
+
+// Forget builtin call-site statistics and restart peaks from live.
+void east_mem_reset(void);
+
+/* ------------------------------------------------------------------ */
+/*  Runtime hooks                                                      */
+/* ------------------------------------------------------------------ */
+
+// Record a change in held bytes / objects. value_kind is an EastValueKind
+// for EAST_MEM_VALUES and -1 otherwise.
+void east_mem_account(EastMemSubsystem s, int value_kind, int64_t bytes,
+                      int64_t objects);
+
+// Re-measure a value after its payload changed size outside values.c.
+void east_value_mem_update(EastValue *v);
+
+// Builtin call-site attribution: take a mark before the call and report
+// it with the calling node afterwards.
+typedef struct {
+    int64_t allocated;
+    int64_t net;
+} EastMemMark;
+
+EastMemMark east_mem_mark(void);
+void east_mem_builtin_done(IRNode *node, EastMemMark mark);
+
+// Soft limit check and the error message to raise (caller frees).
+bool east_mem_over_limit(void);
+char *east_mem_limit_message(void);
+
+#endif
@@ -0,0 +1,34 @@
+#ifndef EAST_NUMPARSE_H
+#define EAST_NUMPARSE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Decimal number parsing for the text decoders (JSON, CSV, East text).
+ * Unlike strtod and strtoll these read length-delimited input, ignore the
+ * locale, and never skip leading whitespace.
+ *
+ * Floats take Clinger's exact path when the digits and power of ten are
+ * both small, and otherwise the Eisel-Lemire algorithm: one 64x128-bit
+ * multiply by a truncated power of five. Inputs with more than 19
+ * significant digits whose truncation leaves the result ambiguous fall
+ * back to strtod, on a copy without a decimal point so the locale cannot
+ * matter. Results are always correctly rounded.
+ */
+
+// Parses an optional sign, digits with an optional '.', and an optional
+// exponent ("-12.5e-3", "+.5", "7.") from s[0..len). Hex, "inf" and "nan"
+// are not numbers here. Stores the correctly rounded double in *out and
+// returns the number of bytes read, or 0 (and *out untouched) if s does
+// not start with a number. A trailing 'e' without digits is not read.
+size_t east_parse_double(const char *s, size_t len, double *out);
+
+// Parses an optional sign and decimal digits from s[0..len) into *out,
+// returning the number of bytes read or 0 if there are no digits. Values
+// outside int64_t saturate as strtoll's do and set *overflow, which may
+// be NULL; otherwise *overflow is cleared.
+size_t east_parse_int64(const char *s, size_t len, int64_t *out, bool *overflow);
+
+#endif
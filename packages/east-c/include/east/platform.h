@@ -9,16 +9,26 @@
 typedef EvalResult (*PlatformFn)(EastValue **args, size_t num_args);
 typedef PlatformFn (*GenericPlatformFactory)(EastType **type_params, size_t num_type_params);
 
+/** Batched entry point of a synchronous, pure platform function: performs
+ *  count calls in one invocation. args holds the count argument tuples back
+ *  to back (call i's arguments start at args[i * num_args]). On success
+ *  results[i] receives call i's result as a new reference (NULL for null);
+ *  on error no results are kept. */
+typedef EvalResult (*PlatformBatchFn)(EastValue **args, size_t num_args, size_t count,
+                                      EastValue **results);
+
 typedef struct {
     const char *name;
     PlatformFn fn;
     bool is_async;
+    PlatformBatchFn batch;  // set for pure functions, see platform_registry_set_batch
 } PlatformFunction;
 
 typedef struct {
     const char *name;
     GenericPlatformFactory factory;
     bool is_async;
+    PlatformBatchFn batch;  // shared by all instantiations; pre_call sets the context
 } GenericPlatformFunction;
 
 typedef struct {
@@ -33,6 +43,12 @@ PlatformRegistry *platform_registry_new(void);
 void platform_registry_add(PlatformRegistry *reg, const char *name, PlatformFn fn, bool is_async);
 void platform_registry_add_generic(PlatformRegistry *reg, const char *name, GenericPlatformFactory factory, bool is_async);
 PlatformFn platform_registry_get(PlatformRegistry *reg, const char *name, EastType **type_params, size_t num_tp);
+/** Declare the registered function `name` pure and give it a batched entry
+ *  point. ArrayMap over a callback that is just a call to it then crosses
+ *  into the platform once per array instead of once per element. Ignored
+ *  for unknown and async functions. */
+void platform_registry_set_batch(PlatformRegistry *reg, const char *name, PlatformBatchFn batch);
+PlatformBatchFn platform_registry_get_batch(PlatformRegistry *reg, const char *name);
 void platform_registry_free(PlatformRegistry *reg);
 
 #endif
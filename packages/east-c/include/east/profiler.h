@@ -0,0 +1,65 @@
+#ifndef EAST_PROFILER_H
+#define EAST_PROFILER_H
+
+#include "ir.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+
+/*
+ * Opt-in execution profiler.
+ *
+ * While a profiler is started on a thread, the evaluator reports entry and
+ * exit of function bodies, loops, builtin calls, platform calls and cycle
+ * collections. Timings are aggregated into a calling-context tree, so both
+ * per-site totals and full stacks are available afterwards.
+ *
+ * Sites are keyed by IR location (file:line:column) for functions and
+ * loops and by name for builtins and platform functions. Only the thread
+ * that started the profiler is measured; work done on worker threads (e.g.
+ * by parallel platform functions) is attributed to the platform call.
+ *
+ * When no profiler is active the evaluator pays one thread-local load per
+ * hook.
+ */
+
+typedef enum {
+    EAST_PROFILE_ROOT,
+    EAST_PROFILE_FUNCTION,
+    EAST_PROFILE_LOOP,
+    EAST_PROFILE_BUILTIN,
+    EAST_PROFILE_PLATFORM,
+    EAST_PROFILE_GC,
+} EastProfileKind;
+
+typedef struct EastProfiler EastProfiler;
+
+// Profiler running on the current thread (NULL when profiling is off).
+extern _Thread_local EastProfiler *east_profiler_active;
+
+EastProfiler *east_profiler_new(void);
+void east_profiler_free(EastProfiler *p);
+
+// Start / stop measuring on the calling thread. A profiler can be started
+// and stopped repeatedly; results accumulate.
+void east_profiler_start(EastProfiler *p);
+void east_profiler_stop(EastProfiler *p);
+
+// Evaluator hooks. Every enter must be matched by an exit on the same
+// thread; node may be NULL for GC.
+void east_profiler_enter(EastProfileKind kind, IRNode *node);
+void east_profiler_exit(void);
+
+// Flame-graph folded stacks ("frame;frame;frame self_ns" per line),
+// suitable for flamegraph.pl / speedscope / inferno.
+bool east_profiler_write_folded(EastProfiler *p, FILE *out);
+
+// Human-readable summary: per-site self/total time and call counts,
+// sorted by self time, at most max_rows rows (0 = all).
+void east_profiler_write_summary(EastProfiler *p, FILE *out, size_t max_rows);
+
+// Total measured time and time spent in the cycle collector, in ns.
+uint64_t east_profiler_total_ns(EastProfiler *p);
+uint64_t east_profiler_gc_ns(EastProfiler *p);
+
+#endif
@@ -0,0 +1,40 @@
+#ifndef EAST_SEARCH_H
+#define EAST_SEARCH_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Byte searches over length-delimited text, for the String builtins and
+ * the text codecs. Unlike strstr these never stop at a NUL byte.
+ *
+ * Short needles are found by comparing the needle's first and last bytes
+ * against 16 or 32 haystack positions at a time (SSE2, or AVX2 where the
+ * CPU has it) and checking only the positions where both match; other
+ * targets use memchr on the first byte. Needles of EAST_FIND_LONG bytes
+ * or more use Horspool's skip table.
+ */
+
+#define EAST_FIND_LONG 32
+
+// First occurrence of needle[0..nlen) in hay[0..hlen), or NULL. An empty
+// needle matches at hay.
+const char *east_find(const char *hay, size_t hlen,
+                      const char *needle, size_t nlen);
+
+// A needle prepared for repeated searches (StringSplit, StringReplace).
+// It points at the caller's bytes, which must outlive it.
+typedef struct {
+    const char *needle;
+    size_t len;
+    uint32_t shift[256];   // Horspool skips, long needles only
+} EastFinder;
+
+void east_finder_init(EastFinder *f, const char *needle, size_t len);
+const char *east_finder_next(const EastFinder *f, const char *hay, size_t hlen);
+
+// Offset of the first byte of p[0..n) that equals one of set[0..nset),
+// or n if there is none. nset is 1 to 4.
+size_t east_find_any(const char *p, size_t n, const char *set, size_t nset);
+
+#endif
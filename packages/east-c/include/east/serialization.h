@@ -33,6 +33,12 @@ ByteBuffer *east_beast2_encode_full(EastValue *value, EastType *type);
 EastValue *east_beast2_decode_full(const uint8_t *data, size_t len, EastType *type);
 // BEAST2-full decode using the embedded type schema (self-describing)
 EastValue *east_beast2_decode_auto(const uint8_t *data, size_t len);
+// Just the header (magic bytes + type schema) of east_beast2_encode_full:
+// a full encoding is this followed by east_beast2_encode's bytes.
+ByteBuffer *east_beast2_encode_header(EastType *type);
+// Type from the header at the start of BEAST2-full data (new reference);
+// *header_len is set to the header's size. NULL if there is no valid header.
+EastType *east_beast2_decode_header(const uint8_t *data, size_t len, size_t *header_len);
 
 // Beast v1 binary serialization (magic + type schema + twiddled values)
 ByteBuffer *east_beast_encode(EastValue *value, EastType *type);
@@ -51,6 +57,12 @@ char *east_print_value(EastValue *value, EastType *type);
 EastValue *east_parse_value(const char *text, EastType *type);
 // East parse with detailed error message (caller frees *error_out on failure)
 EastValue *east_parse_value_with_error(const char *text, EastType *type, char **error_out);
+// Source of East text: copies up to cap bytes into buf and returns how
+// many, or 0 at the end of the input
+typedef size_t (*EastReadFn)(void *ctx, char *buf, size_t cap);
+// East parse of text pulled in chunks from read; errors as east_parse_value_with_error
+EastValue *east_parse_value_stream(EastReadFn read, void *ctx, EastType *type,
+                                   char **error_out);
 char *east_print_type(EastType *type);
 EastType *east_parse_type(const char *text);
 
@@ -27,6 +27,37 @@ typedef enum {
 
 typedef struct EastValue EastValue;
 typedef struct EastCompiledFn EastCompiledFn;
+typedef struct EastColumns EastColumns;   // see columnar.h
+typedef struct EastStringIndex EastStringIndex;   // see east_string_cp_len
+
+/*
+ * Cached structural hash of a container (see east_value_hash). Valid while
+ * epoch == east_mutation_epoch; any in-place mutation on the thread bumps
+ * the epoch, which also covers containers whose descendants changed.
+ */
+typedef struct {
+    uint64_t hash;
+    uint64_t epoch;
+} EastHashCache;
+
+extern _Thread_local uint64_t east_mutation_epoch;
+
+/*
+ * Vector / Matrix element buffer shared by several values, e.g. a Matrix
+ * and Vector views of its rows (see east_vector_view). Values that own
+ * their buffer outright have shared == NULL.
+ */
+typedef struct {
+    size_t refcount;
+    void *base;             // allocation freed when the last user goes
+} EastSharedBuffer;
+
+/* Strings up to EAST_STRING_SMALL - 1 bytes are stored inside the value.
+ * The inline buffer must fit the union without making it larger: every
+ * value pays for EastValue growth, so it stays at 88 bytes on 64-bit
+ * targets (asserted below). Longer strings share one allocation with
+ * their value instead. */
+#define EAST_STRING_SMALL 16
 
 struct EastValue {
     EastValueKind kind;
@@ -37,26 +68,46 @@ struct EastValue {
     struct EastValue *gc_prev;
     int gc_refs;           /* temporary refcount during collection */
     bool gc_tracked;       /* true if in GC tracking list */
+    bool payload_inline;   /* String bytes live in or right after the value */
+    bool columnar;         /* Array stored column-wise (see columnar.h) */
     int iter_lock;         /* iteration lock count (>0 = locked, mutation forbidden) */
+    uint32_t mem_bytes;    /* bytes counted by memory accounting (see memory.h) */
 
     union {
         bool boolean;
         int64_t integer;
         double float64;
-        struct { char *data; size_t len; } string;
+        /* data points into small for strings shorter than EAST_STRING_SMALL,
+         * just past the value for longer ones (one allocation for both),
+         * or at a malloc'd buffer of its own (see east_string_adopt and
+         * east_string_append). */
+        struct {
+            char *data;
+            size_t len;
+            EastStringIndex *index;   // codepoint index, built on first use
+            union {
+                char small[EAST_STRING_SMALL];
+                size_t cap;   // size of an east_string_append buffer, else 0
+            };
+        } string;
         int64_t datetime;  // epoch millis
         struct { uint8_t *data; size_t len; } blob;
         struct {
             EastValue **items;
             size_t len;
-            size_t cap;
+            union {
+                size_t cap;
+                EastColumns *columns;   // when columnar (see columnar.h)
+            };
             EastType *elem_type;
+            EastHashCache hc;
         } array;
         struct {
             EastValue **items;
             size_t len;
             size_t cap;
             EastType *elem_type;
+            EastHashCache hc;
         } set;
         struct {
             EastValue **keys;
@@ -71,25 +122,30 @@ struct EastValue {
             EastValue **field_values;
             size_t num_fields;
             EastType *type;
+            EastHashCache hc;
         } struct_;
         struct {
             char *case_name;
             EastValue *value;
             EastType *type;
+            EastHashCache hc;
         } variant;
         struct {
             EastValue *value;
+            EastHashCache hc;
         } ref;
         struct {
             void *data;   // float64*, int64_t*, or bool*
             size_t len;
             EastType *elem_type;
+            EastSharedBuffer *shared;
         } vector;
         struct {
             void *data;   // float64*, int64_t*, or bool*
             size_t rows;
             size_t cols;
             EastType *elem_type;
+            EastSharedBuffer *shared;
         } matrix;
         struct {
             EastCompiledFn *compiled;
@@ -97,6 +153,11 @@ struct EastValue {
     } data;
 };
 
+_Static_assert(sizeof(((EastValue *)0)->data.string) <= sizeof(((EastValue *)0)->data.array),
+               "the inline string buffer must not grow EastValue");
+_Static_assert(sizeof(void *) != 8 || sizeof(EastValue) == 88,
+               "every value pays for EastValue growth; keep it at 88 bytes");
+
 // Global null singleton
 extern EastValue east_null_value;
 
@@ -109,6 +170,45 @@ EastValue *east_string(const char *str);
 EastValue *east_string_len(const char *str, size_t len);
 EastValue *east_datetime(int64_t millis);
 EastValue *east_blob(const uint8_t *data, size_t len);
+// With str / data NULL, east_string_len and east_blob leave the len bytes
+// uninitialized for the caller to fill.
+
+// String that takes ownership of data, a malloc'd buffer holding at least
+// len + 1 bytes with a NUL at data[len]; builders hand over their buffer
+// this way instead of copying it (freed on failure).
+EastValue *east_string_adopt(char *data, size_t len);
+
+// Append len bytes to String s in place, growing its buffer geometrically;
+// false if out of memory (s is unchanged). The caller must hold the only
+// use of s, since anyone else holding it would see it change, and data
+// must not point into s.
+bool east_string_append(EastValue *s, const char *data, size_t len);
+
+// UTC calendar fields of a DateTime, in the proleptic Gregorian calendar
+// with milliseconds rounded down (as JavaScript's getUTC* methods).
+typedef struct {
+    int64_t year;
+    int month;         // 1-12
+    int day;           // 1-31
+    int hour, minute, second, millisecond;
+    int weekday;       // 0 = Sunday
+} EastDateTimeParts;
+
+void east_datetime_parts(int64_t millis, EastDateTimeParts *out);
+// Days from 1970-01-01 to the given date (month 1-12, day 1-31).
+int64_t east_days_from_civil(int64_t year, int month, int day);
+
+// Codepoint view of a String (JavaScript for...of semantics). The first
+// call scans the bytes once, checking for ASCII and counting codepoints, and
+// caches the result on the value: ASCII strings then index bytes directly
+// and long non-ASCII ones get a sparse codepoint -> byte index. A string's
+// bytes must not change once these have been used.
+bool east_string_is_ascii(EastValue *s);
+size_t east_string_cp_len(EastValue *s);
+// Byte offset of codepoint cp; the byte length if cp >= east_string_cp_len.
+size_t east_string_cp_to_byte(EastValue *s, size_t cp);
+// Number of codepoints starting before byte offset byte.
+size_t east_string_byte_to_cp(EastValue *s, size_t byte);
 
 // Collection constructors
 EastValue *east_array_new(EastType *elem_type);
@@ -116,6 +216,17 @@ void east_array_push(EastValue *arr, EastValue *val);
 EastValue *east_array_get(EastValue *arr, size_t index);
 size_t east_array_len(EastValue *arr);
 
+// Switch a columnar array to one value per row. Call east_array_ensure_rows
+// before reading or writing data.array.items directly.
+void east_array_materialize(EastValue *arr);
+static inline void east_array_ensure_rows(EastValue *arr) {
+    if (arr->columnar) east_array_materialize(arr);
+}
+// Column storage of a columnar array, else NULL.
+static inline EastColumns *east_array_columns(const EastValue *arr) {
+    return arr->columnar ? arr->data.array.columns : NULL;
+}
+
 EastValue *east_set_new(EastType *elem_type);
 void east_set_insert(EastValue *set, EastValue *val);
 bool east_set_has(EastValue *set, EastValue *val);
@@ -142,6 +253,16 @@ void east_ref_set(EastValue *ref, EastValue *value);
 EastValue *east_vector_new(EastType *elem_type, size_t len);
 EastValue *east_matrix_new(EastType *elem_type, size_t rows, size_t cols);
 
+// Vector of len elements starting at element offset of a Vector's or
+// Matrix's buffer, sharing it rather than copying. Writes through either
+// value go through east_value_make_writable, so sharing is never visible.
+EastValue *east_vector_view(EastValue *src, size_t offset, size_t len);
+
+// Copy-on-write: call before writing a Vector or Matrix buffer in place.
+// If the buffer is shared with other values, v gets a private copy.
+// Returns false if that copy cannot be allocated.
+bool east_value_make_writable(EastValue *v);
+
 EastValue *east_function_value(EastCompiledFn *fn);
 
 // Ref counting
@@ -154,6 +275,15 @@ void east_compiled_fn_free(EastCompiledFn *fn);
 // Comparison
 bool east_value_equal(EastValue *a, EastValue *b);
 int east_value_compare(EastValue *a, EastValue *b);
+// Structural hash consistent with east_value_equal (equal values hash equal).
+// Arrays, sets, structs, variants and refs cache it; east_value_equal uses
+// cached hashes to reject unequal containers without descending.
+uint64_t east_value_hash(EastValue *v);
+
+// Call after writing container payloads directly (outside the east_array_*,
+// east_set_*, east_dict_* and east_ref_set mutators) so cached hashes are
+// not reused.
+static inline void east_value_invalidate_hashes(void) { east_mutation_epoch++; }
 
 // Printing
 int east_value_print(EastValue *v, char *buf, size_t buf_size);
@@ -5,6 +5,7 @@
  * These call through east_call() from compiler.h.
  */
 #include "east/builtins.h"
+#include "east/columnar.h"
 #include "east/compiler.h"
 #include "east/serialization.h"
 #include "east/values.h"
@@ -35,6 +36,15 @@ static EastValue *call_fn(EastValue *fn, EastValue **call_args, size_t nargs) {
     return NULL;
 }
 
+/* Element i for a callback. Rows of a columnar array are built for the
+ * call only instead of being cached on the array. Returns a new reference. */
+static EastValue *callback_elem(EastValue *arr, size_t i) {
+    if (arr->columnar) return east_columnar_row(arr, i);
+    EastValue *v = east_array_get(arr, i);
+    east_value_retain(v);
+    return v;
+}
+
 /* ================================================================== */
 /* ArraySize                                                          */
 /* ================================================================== */
@@ -116,10 +126,12 @@ static EastValue *array_update_impl(EastValue **args, size_t n) {
         return NULL;
     }
     /* Direct mutation of the array items */
+    east_array_ensure_rows(arr);
     east_value_retain(args[2]);
     EastValue *old = arr->data.array.items[(size_t)index];
     arr->data.array.items[(size_t)index] = args[2];
     east_value_release(old);
+    east_value_invalidate_hashes();
     return east_null();
 }
 
@@ -146,9 +158,11 @@ static EastValue *array_pop_last_impl(EastValue **args, size_t n) {
         return NULL;
     }
     /* Transfer ownership from array to caller (no extra retain needed) */
+    east_array_ensure_rows(arr);
     EastValue *val = arr->data.array.items[len - 1];
     arr->data.array.items[len - 1] = NULL;
     arr->data.array.len--;
+    east_value_invalidate_hashes();
     return val;
 }
 
@@ -185,12 +199,14 @@ static EastValue *array_pop_first_impl(EastValue **args, size_t n) {
         return NULL;
     }
     /* Transfer ownership from array to caller (no extra retain needed) */
+    east_array_ensure_rows(arr);
     EastValue *val = arr->data.array.items[0];
     for (size_t i = 0; i + 1 < len; i++) {
         arr->data.array.items[i] = arr->data.array.items[i + 1];
     }
     arr->data.array.items[len - 1] = NULL;
     arr->data.array.len--;
+    east_value_invalidate_hashes();
     return val;
 }
 
@@ -250,11 +266,13 @@ static EastValue *array_clear_impl(EastValue **args, size_t n) {
     (void)n;
     EastValue *arr = args[0];
     ITER_GUARD_ARRAY(arr);
+    east_array_ensure_rows(arr);
     /* Release all elements */
     for (size_t i = 0; i < east_array_len(arr); i++) {
         east_value_release(arr->data.array.items[i]);
     }
     arr->data.array.len = 0;
+    east_value_invalidate_hashes();
     return east_null();
 }
 
@@ -278,11 +296,13 @@ static EastValue *array_reverse_in_place_impl(EastValue **args, size_t n) {
     EastValue *arr = args[0];
     ITER_GUARD_ARRAY(arr);
     size_t len = east_array_len(arr);
+    east_array_ensure_rows(arr);
     for (size_t i = 0; i < len / 2; i++) {
         EastValue *tmp = arr->data.array.items[i];
         arr->data.array.items[i] = arr->data.array.items[len - 1 - i];
         arr->data.array.items[len - 1 - i] = tmp;
     }
+    east_value_invalidate_hashes();
     return east_null();
 }
 
@@ -339,20 +359,74 @@ static EastValue *array_linspace_impl(EastValue **args, size_t n_args) {
 /* ================================================================== */
 /* ArrayMap (arr, fn) -> new array                                    */
 /* ================================================================== */
+/* Append one mapped element. Structs of primitives are stored column-wise,
+ * decided by the first element. */
+static void map_push(EastValue **result, EastValue *mapped, size_t i, size_t len) {
+    if (i == 0 && mapped->kind == EAST_VAL_STRUCT &&
+        east_columnar_supported(mapped->data.struct_.type)) {
+        EastValue *cols = east_columnar_array_new(mapped->data.struct_.type, len);
+        if (cols) {
+            east_value_release(*result);
+            *result = cols;
+        }
+    }
+    if (!(*result)->columnar || !east_columnar_push_struct(*result, mapped))
+        east_array_push(*result, mapped);
+}
+
+/* ArrayMap whose callback is a single call to a pure, batched platform
+ * function: one platform crossing for the whole array. */
+static EastValue *array_map_batched(EastValue *arr, EastValue *fn, size_t len) {
+    EastValue **call_args = malloc(2 * len * sizeof(EastValue *));
+    EastValue **mapped = malloc(len * sizeof(EastValue *));
+    if (!call_args || !mapped) {
+        free(call_args);
+        free(mapped);
+        east_builtin_error("ArrayMap: out of memory");
+        return NULL;
+    }
+    for (size_t i = 0; i < len; i++) {
+        call_args[2 * i] = callback_elem(arr, i);
+        call_args[2 * i + 1] = east_integer((int64_t)i);
+    }
+    EvalResult r = east_call_batch(fn->data.function.compiled, call_args, 2, len, mapped);
+    for (size_t i = 0; i < 2 * len; i++)
+        east_value_release(call_args[i]);
+    free(call_args);
+
+    EastValue *result = NULL;
+    if (r.status == EVAL_OK) {
+        result = east_array_new(arr->data.array.elem_type);
+        for (size_t i = 0; i < len; i++) {
+            map_push(&result, mapped[i], i, len);
+            east_value_release(mapped[i]);
+        }
+    } else {
+        if (r.error_message) east_builtin_error(r.error_message);
+        eval_result_free(&r);
+    }
+    free(mapped);
+    return result;
+}
+
 static EastValue *array_map_impl(EastValue **args, size_t n) {
     (void)n;
     EastValue *arr = args[0];
     EastValue *fn = args[1];
     size_t len = east_array_len(arr);
+    if (len > 1 && east_fn_batchable(fn->data.function.compiled))
+        return array_map_batched(arr, fn, len);
     /* We use type_params[1] as elem_type for the result if available,
        otherwise fall back to the source array's elem type */
     EastValue *result = east_array_new(arr->data.array.elem_type);
     for (size_t i = 0; i < len; i++) {
         EastValue *idx = east_integer((int64_t)i);
-        EastValue *call_args[] = { east_array_get(arr, i), idx };
+        EastValue *item = callback_elem(arr, i);
+        EastValue *call_args[] = { item, idx };
         EastValue *mapped = call_fn(fn, call_args, 2);
+        east_value_release(item);
         if (!mapped) { east_value_release(idx); east_value_release(result); return NULL; }
-        east_array_push(result, mapped);
+        map_push(&result, mapped, i, len);
         east_value_release(mapped);
         east_value_release(idx);
     }
@@ -362,11 +436,40 @@ static EastValue *array_map_impl(EastValue **args, size_t n) {
 /* ================================================================== */
 /* ArrayFilter (arr, fn) -> new array                                 */
 /* ================================================================== */
+static EastValue *array_filter_columnar(EastValue *arr, EastValue *fn, size_t len) {
+    size_t *kept = malloc((len ? len : 1) * sizeof(size_t));
+    if (!kept) { east_builtin_error("ArrayFilter: out of memory"); return NULL; }
+    size_t nkept = 0;
+    for (size_t i = 0; i < len; i++) {
+        EastValue *item = callback_elem(arr, i);
+        EastValue *idx = east_integer((int64_t)i);
+        EastValue *call_args[] = { item, idx };
+        EastValue *pred = call_fn(fn, call_args, 2);
+        east_value_release(item);
+        east_value_release(idx);
+        if (!pred) { free(kept); return NULL; }
+        if (pred->data.boolean) kept[nkept++] = i;
+        east_value_release(pred);
+    }
+    EastValue *result;
+    if (arr->columnar) {
+        result = east_columnar_gather(arr, kept, nkept);
+    } else {
+        /* The callback turned arr back into rows */
+        result = east_array_new(arr->data.array.elem_type);
+        for (size_t i = 0; i < nkept; i++)
+            east_array_push(result, east_array_get(arr, kept[i]));
+    }
+    free(kept);
+    return result;
+}
+
 static EastValue *array_filter_impl(EastValue **args, size_t n) {
     (void)n;
     EastValue *arr = args[0];
     EastValue *fn = args[1];
     size_t len = east_array_len(arr);
+    if (arr->columnar) return array_filter_columnar(arr, fn, len);
     EastValue *result = east_array_new(arr->data.array.elem_type);
     for (size_t i = 0; i < len; i++) {
         EastValue *item = east_array_get(arr, i);
@@ -464,8 +567,10 @@ static EastValue *array_sort_impl(EastValue **args, size_t n) {
     size_t *indices = malloc(len * sizeof(size_t));
     for (size_t i = 0; i < len; i++) {
         indices[i] = i;
-        EastValue *call_args[] = { east_array_get(arr, i) };
+        EastValue *item = callback_elem(arr, i);
+        EastValue *call_args[] = { item };
         keys[i] = call_fn(key_fn, call_args, 1);
+        east_value_release(item);
         if (!keys[i]) {
             for (size_t j = 0; j < i; j++) east_value_release(keys[j]);
             free(keys); free(indices); return NULL;
@@ -477,9 +582,14 @@ static EastValue *array_sort_impl(EastValue **args, size_t n) {
     qsort(indices, len, sizeof(size_t), sort_compare_global);
     g_sort_ctx = NULL;
 
-    EastValue *result = east_array_new(arr->data.array.elem_type);
-    for (size_t i = 0; i < len; i++)
-        east_array_push(result, east_array_get(arr, indices[i]));
+    EastValue *result;
+    if (arr->columnar) {
+        result = east_columnar_gather(arr, indices, len);
+    } else {
+        result = east_array_new(arr->data.array.elem_type);
+        for (size_t i = 0; i < len; i++)
+            east_array_push(result, east_array_get(arr, indices[i]));
+    }
 
     for (size_t i = 0; i < len; i++) east_value_release(keys[i]);
     free(keys);
@@ -516,10 +626,12 @@ static EastValue *array_sort_in_place_impl(EastValue **args, size_t n) {
     g_sort_ctx = NULL;
 
     /* Reorder in-place */
+    east_array_ensure_rows(arr);
     EastValue **tmp = malloc(len * sizeof(EastValue *));
     for (size_t i = 0; i < len; i++)
         tmp[i] = arr->data.array.items[indices[i]];
     memcpy(arr->data.array.items, tmp, len * sizeof(EastValue *));
+    east_value_invalidate_hashes();
 
     for (size_t i = 0; i < len; i++) east_value_release(keys[i]);
     free(keys);
@@ -805,9 +917,11 @@ static EastValue *array_merge_impl(EastValue **args, size_t n) {
     EastValue *merged = call_fn(fn, call_args, 3);
     if (!merged) { east_value_release(idx); return NULL; }
     /* call_fn returns owned; store directly in slot (transfers ownership) */
+    east_array_ensure_rows(arr);
     EastValue *prev = arr->data.array.items[(size_t)index];
     arr->data.array.items[(size_t)index] = merged;
     east_value_release(prev);
+    east_value_invalidate_hashes();
     east_value_release(idx);
     return east_null();
 }
@@ -865,9 +979,11 @@ static EastValue *array_merge_all_impl(EastValue **args, size_t n) {
         EastValue *merged = call_fn(fn, call_args, 3);
         if (!merged) { east_value_release(idx); return NULL; }
         /* call_fn returns owned; store directly in slot (transfers ownership) */
+        east_array_ensure_rows(arr);
         EastValue *prev = arr->data.array.items[i];
         arr->data.array.items[i] = merged;
         east_value_release(prev);
+        east_value_invalidate_hashes();
         east_value_release(idx);
     }
     return east_null();
@@ -890,18 +1006,15 @@ static EastValue *array_string_join_impl(EastValue **args, size_t n) {
         total += east_array_get(arr, i)->data.string.len;
         if (i > 0) total += dlen;
     }
-    char *buf = malloc(total + 1);
-    if (!buf) return east_string("");
-    char *dst = buf;
+    EastValue *result = east_string_len(NULL, total);
+    if (!result) return east_string("");
+    char *dst = result->data.string.data;
     for (size_t i = 0; i < len; i++) {
         if (i > 0) { memcpy(dst, delim, dlen); dst += dlen; }
         EastValue *s = east_array_get(arr, i);
         memcpy(dst, s->data.string.data, s->data.string.len);
         dst += s->data.string.len;
     }
-    *dst = '\0';
-    EastValue *result = east_string_len(buf, total);
-    free(buf);
     return result;
 }
 
@@ -1,26 +1,38 @@
 /*
  * DateTime builtin functions.
  *
- * DateTime is stored as epoch milliseconds (int64_t).
- * Date component extraction uses gmtime() for UTC.
+ * DateTime is stored as epoch milliseconds (int64_t). Calendar fields
+ * come from east_datetime_parts (UTC, proleptic Gregorian). Format token
+ * arrays are compiled once into a DtPlan and reused while the same array
+ * is passed in, until the outermost east_call returns.
  */
 #include "east/builtins.h"
+#include "east/kernels.h"
 #include "east/values.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
 
-/* Helper: get struct tm from epoch millis (UTC) */
-static struct tm millis_to_tm(int64_t millis) {
-    time_t secs = (time_t)(millis / 1000);
-    struct tm result;
-    gmtime_r(&secs, &result);
-    return result;
-}
-
 /* --- static implementations --- */
 
+/* Getters are usually called in a row on one timestamp (year, then month,
+ * then day), so the last conversion on each thread is kept. */
+static _Thread_local struct {
+    bool valid;
+    int64_t millis;
+    EastDateTimeParts parts;
+} dt_last;
+
+static const EastDateTimeParts *dt_parts(int64_t millis) {
+    if (!dt_last.valid || dt_last.millis != millis) {
+        east_datetime_parts(millis, &dt_last.parts);
+        dt_last.millis = millis;
+        dt_last.valid = true;
+    }
+    return &dt_last.parts;
+}
+
 static EastValue *datetime_add_milliseconds(EastValue **args, size_t n) {
     (void)n;
     int64_t dt = args[0]->data.datetime;
@@ -37,38 +49,38 @@ static EastValue *datetime_duration_milliseconds(EastValue **args, size_t n) {
 
 static EastValue *datetime_get_year(EastValue **args, size_t n) {
     (void)n;
-    struct tm t = millis_to_tm(args[0]->data.datetime);
-    return east_integer(t.tm_year + 1900);
+    const EastDateTimeParts *t = dt_parts(args[0]->data.datetime);
+    return east_integer(t->year);
 }
 
 static EastValue *datetime_get_month(EastValue **args, size_t n) {
     (void)n;
-    struct tm t = millis_to_tm(args[0]->data.datetime);
-    return east_integer(t.tm_mon + 1); /* 1-12 */
+    const EastDateTimeParts *t = dt_parts(args[0]->data.datetime);
+    return east_integer(t->month); /* 1-12 */
 }
 
 static EastValue *datetime_get_day_of_month(EastValue **args, size_t n) {
     (void)n;
-    struct tm t = millis_to_tm(args[0]->data.datetime);
-    return east_integer(t.tm_mday);
+    const EastDateTimeParts *t = dt_parts(args[0]->data.datetime);
+    return east_integer(t->day);
 }
 
 static EastValue *datetime_get_hour(EastValue **args, size_t n) {
     (void)n;
-    struct tm t = millis_to_tm(args[0]->data.datetime);
-    return east_integer(t.tm_hour);
+    const EastDateTimeParts *t = dt_parts(args[0]->data.datetime);
+    return east_integer(t->hour);
 }
 
 static EastValue *datetime_get_minute(EastValue **args, size_t n) {
     (void)n;
-    struct tm t = millis_to_tm(args[0]->data.datetime);
-    return east_integer(t.tm_min);
+    const EastDateTimeParts *t = dt_parts(args[0]->data.datetime);
+    return east_integer(t->minute);
 }
 
 static EastValue *datetime_get_second(EastValue **args, size_t n) {
     (void)n;
-    struct tm t = millis_to_tm(args[0]->data.datetime);
-    return east_integer(t.tm_sec);
+    const EastDateTimeParts *t = dt_parts(args[0]->data.datetime);
+    return east_integer(t->second);
 }
 
 static EastValue *datetime_get_millisecond(EastValue **args, size_t n) {
@@ -81,9 +93,9 @@ static EastValue *datetime_get_millisecond(EastValue **args, size_t n) {
 
 static EastValue *datetime_get_day_of_week(EastValue **args, size_t n) {
     (void)n;
-    struct tm t = millis_to_tm(args[0]->data.datetime);
-    /* ISO 8601: 1=Monday, 7=Sunday.  tm_wday: 0=Sunday, 6=Saturday */
-    int iso_day = t.tm_wday == 0 ? 7 : t.tm_wday;
+    const EastDateTimeParts *t = dt_parts(args[0]->data.datetime);
+    /* ISO 8601: 1=Monday, 7=Sunday.  weekday: 0=Sunday, 6=Saturday */
+    int iso_day = t->weekday == 0 ? 7 : t->weekday;
     return east_integer(iso_day);
 }
 
@@ -111,6 +123,73 @@ static EastValue *datetime_from_components(EastValue **args, size_t n) {
     return east_datetime((int64_t)secs * 1000 + ms);
 }
 
+/* ---- DateTimeComponents ---- */
+
+/* Array<DateTime>, or a Vector<Integer> of epoch milliseconds, split in
+ * one pass into a struct of Vector<Integer> columns named after the
+ * getters: year, month, day, hour, minute, second, millisecond and
+ * dayOfWeek (ISO, 1 = Monday). */
+static EastValue *datetime_components(EastValue **args, size_t n) {
+    (void)n;
+    EastValue *src = args[0];
+    size_t len;
+    int64_t *millis = NULL;
+    const int64_t *in;
+    if (src->kind == EAST_VAL_VECTOR &&
+        src->data.vector.elem_type->kind == EAST_TYPE_INTEGER) {
+        len = src->data.vector.len;
+        in = src->data.vector.data;
+    } else if (src->kind == EAST_VAL_ARRAY) {
+        len = east_array_len(src);
+        millis = malloc((len ? len : 1) * sizeof(int64_t));
+        if (!millis) {
+            east_builtin_error("DateTimeComponents: out of memory");
+            return NULL;
+        }
+        for (size_t i = 0; i < len; i++) {
+            EastValue *v = east_array_get(src, i);
+            if (v->kind != EAST_VAL_DATETIME) {
+                free(millis);
+                east_builtin_error("DateTimeComponents requires an Array of DateTime");
+                return NULL;
+            }
+            millis[i] = v->data.datetime;
+        }
+        in = millis;
+    } else {
+        east_builtin_error("DateTimeComponents requires an Array of DateTime or a Vector of Integer");
+        return NULL;
+    }
+
+    static const char *names[] = {
+        "year", "month", "day", "hour", "minute", "second", "millisecond", "dayOfWeek",
+    };
+    EastValue *cols[8];
+    bool ok = true;
+    for (int k = 0; k < 8; k++) {
+        cols[k] = east_vector_new(&east_integer_type, len);
+        ok = ok && cols[k];
+    }
+    if (!ok) {
+        for (int k = 0; k < 8; k++) if (cols[k]) east_value_release(cols[k]);
+        free(millis);
+        east_builtin_error("DateTimeComponents: out of memory");
+        return NULL;
+    }
+    EastDateTimeColumns out = {
+        cols[0]->data.vector.data, cols[1]->data.vector.data,
+        cols[2]->data.vector.data, cols[3]->data.vector.data,
+        cols[4]->data.vector.data, cols[5]->data.vector.data,
+        cols[6]->data.vector.data, cols[7]->data.vector.data,
+    };
+    east_kernel_datetime_parts(in, len, &out);
+    free(millis);
+
+    EastValue *result = east_struct_new(names, cols, 8, NULL);
+    for (int k = 0; k < 8; k++) east_value_release(cols[k]);
+    return result;
+}
+
 /* ---- Month/weekday name tables ---- */
 
 static const char *MONTH_FULL[] = {
@@ -131,113 +210,223 @@ static const char *WDAY_MIN[] = {
     "Su","Mo","Tu","We","Th","Fr","Sa"
 };
 
-/* ---- Helper: append to dynamic buffer ---- */
-typedef struct { char *data; size_t len; size_t cap; } DtBuf;
-static void dtbuf_init(DtBuf *b) { b->cap = 128; b->data = malloc(b->cap); b->len = 0; b->data[0] = '\0'; }
-static void dtbuf_append(DtBuf *b, const char *s, size_t slen) {
-    while (b->len + slen + 1 > b->cap) { b->cap *= 2; b->data = realloc(b->data, b->cap); }
-    memcpy(b->data + b->len, s, slen);
-    b->len += slen;
-    b->data[b->len] = '\0';
+/* ---- Format plans ---- */
+
+typedef enum {
+    DT_YEAR4, DT_YEAR2,
+    DT_MONTH1, DT_MONTH2, DT_MONTH_SHORT, DT_MONTH_FULL,
+    DT_DAY1, DT_DAY2,
+    DT_WEEKDAY_MIN, DT_WEEKDAY_SHORT, DT_WEEKDAY_FULL,
+    DT_HOUR24_1, DT_HOUR24_2, DT_HOUR12_1, DT_HOUR12_2,
+    DT_MINUTE1, DT_MINUTE2, DT_SECOND1, DT_SECOND2, DT_MILLISECOND3,
+    DT_AMPM_UPPER, DT_AMPM_LOWER,
+    DT_LITERAL,
+    DT_IGNORED,   /* unknown token: printed as nothing, parses nothing */
+} DtOp;
+
+static const struct { const char *name; DtOp op; } DT_TOKENS[] = {
+    {"year4", DT_YEAR4}, {"year2", DT_YEAR2},
+    {"month1", DT_MONTH1}, {"month2", DT_MONTH2},
+    {"monthNameShort", DT_MONTH_SHORT}, {"monthNameFull", DT_MONTH_FULL},
+    {"day1", DT_DAY1}, {"day2", DT_DAY2},
+    {"weekdayNameMin", DT_WEEKDAY_MIN}, {"weekdayNameShort", DT_WEEKDAY_SHORT},
+    {"weekdayNameFull", DT_WEEKDAY_FULL},
+    {"hour24_1", DT_HOUR24_1}, {"hour24_2", DT_HOUR24_2},
+    {"hour12_1", DT_HOUR12_1}, {"hour12_2", DT_HOUR12_2},
+    {"minute1", DT_MINUTE1}, {"minute2", DT_MINUTE2},
+    {"second1", DT_SECOND1}, {"second2", DT_SECOND2},
+    {"millisecond3", DT_MILLISECOND3},
+    {"ampmUpper", DT_AMPM_UPPER}, {"ampmLower", DT_AMPM_LOWER},
+    {"literal", DT_LITERAL},
+};
+
+typedef struct {
+    DtOp op;
+    const char *lit;    /* DT_LITERAL: the token's String bytes */
+    size_t lit_len;
+} DtStep;
+
+/* A compiled DateTimeFormatToken array. The plan holds references to the
+ * array and its tokens, so neither address can be reused by another
+ * value while it is cached; a changed element means a different plan. */
+typedef struct {
+    EastValue *tokens;
+    EastValue **items;
+    DtStep *steps;
+    size_t len;
+    size_t max_out;     /* most bytes a print can produce */
+} DtPlan;
+
+#define DT_PLAN_CACHE 4
+static _Thread_local DtPlan dt_plans[DT_PLAN_CACHE];
+static _Thread_local unsigned dt_plan_next;
+
+static void dt_plan_clear(DtPlan *p) {
+    if (!p->tokens) return;
+    for (size_t i = 0; i < p->len; i++) east_value_release(p->items[i]);
+    east_value_release(p->tokens);
+    free(p->items);
+    free(p->steps);
+    memset(p, 0, sizeof(*p));
 }
-static void dtbuf_append_str(DtBuf *b, const char *s) { dtbuf_append(b, s, strlen(s)); }
 
-/* ---- DateTimePrintFormat ---- */
+void east_datetime_plans_clear(void) {
+    for (int k = 0; k < DT_PLAN_CACHE; k++) dt_plan_clear(&dt_plans[k]);
+}
 
-static EastValue *datetime_print_format_impl(EastValue **args, size_t n) {
-    (void)n;
-    int64_t millis = args[0]->data.datetime;
-    EastValue *tokens = args[1]; /* Array of DateTimeFormatToken variants */
+static bool dt_plan_matches(const DtPlan *p, EastValue *tokens) {
+    if (p->tokens != tokens || p->len != tokens->data.array.len) return false;
+    for (size_t i = 0; i < p->len; i++) {
+        if (east_array_get(tokens, i) != p->items[i]) return false;
+    }
+    return true;
+}
 
-    struct tm t = millis_to_tm(millis);
-    int64_t ms = millis % 1000;
-    if (ms < 0) ms += 1000;
-    int year  = t.tm_year + 1900;
-    int month = t.tm_mon + 1;
-    int day   = t.tm_mday;
-    int hour  = t.tm_hour;
-    int min   = t.tm_min;
-    int sec   = t.tm_sec;
-    int wday  = t.tm_wday; /* 0=Sunday */
-
-    DtBuf buf;
-    dtbuf_init(&buf);
-
-    for (size_t i = 0; i < tokens->data.array.len; i++) {
-        EastValue *tok = tokens->data.array.items[i];
-        const char *ttype = tok->data.variant.case_name;
-        char tmp[32];
-
-        if (strcmp(ttype, "year4") == 0) {
-            snprintf(tmp, sizeof(tmp), "%d", year);
-            dtbuf_append_str(&buf, tmp);
-        } else if (strcmp(ttype, "year2") == 0) {
-            snprintf(tmp, sizeof(tmp), "%02d", year % 100);
-            dtbuf_append_str(&buf, tmp);
-        } else if (strcmp(ttype, "month1") == 0) {
-            snprintf(tmp, sizeof(tmp), "%d", month);
-            dtbuf_append_str(&buf, tmp);
-        } else if (strcmp(ttype, "month2") == 0) {
-            snprintf(tmp, sizeof(tmp), "%02d", month);
-            dtbuf_append_str(&buf, tmp);
-        } else if (strcmp(ttype, "monthNameShort") == 0) {
-            dtbuf_append_str(&buf, MONTH_SHORT[month - 1]);
-        } else if (strcmp(ttype, "monthNameFull") == 0) {
-            dtbuf_append_str(&buf, MONTH_FULL[month - 1]);
-        } else if (strcmp(ttype, "day1") == 0) {
-            snprintf(tmp, sizeof(tmp), "%d", day);
-            dtbuf_append_str(&buf, tmp);
-        } else if (strcmp(ttype, "day2") == 0) {
-            snprintf(tmp, sizeof(tmp), "%02d", day);
-            dtbuf_append_str(&buf, tmp);
-        } else if (strcmp(ttype, "weekdayNameMin") == 0) {
-            dtbuf_append_str(&buf, WDAY_MIN[wday]);
-        } else if (strcmp(ttype, "weekdayNameShort") == 0) {
-            dtbuf_append_str(&buf, WDAY_SHORT[wday]);
-        } else if (strcmp(ttype, "weekdayNameFull") == 0) {
-            dtbuf_append_str(&buf, WDAY_FULL[wday]);
-        } else if (strcmp(ttype, "hour24_1") == 0) {
-            snprintf(tmp, sizeof(tmp), "%d", hour);
-            dtbuf_append_str(&buf, tmp);
-        } else if (strcmp(ttype, "hour24_2") == 0) {
-            snprintf(tmp, sizeof(tmp), "%02d", hour);
-            dtbuf_append_str(&buf, tmp);
-        } else if (strcmp(ttype, "hour12_1") == 0) {
-            int h12 = hour % 12; if (h12 == 0) h12 = 12;
-            snprintf(tmp, sizeof(tmp), "%d", h12);
-            dtbuf_append_str(&buf, tmp);
-        } else if (strcmp(ttype, "hour12_2") == 0) {
-            int h12 = hour % 12; if (h12 == 0) h12 = 12;
-            snprintf(tmp, sizeof(tmp), "%02d", h12);
-            dtbuf_append_str(&buf, tmp);
-        } else if (strcmp(ttype, "minute1") == 0) {
-            snprintf(tmp, sizeof(tmp), "%d", min);
-            dtbuf_append_str(&buf, tmp);
-        } else if (strcmp(ttype, "minute2") == 0) {
-            snprintf(tmp, sizeof(tmp), "%02d", min);
-            dtbuf_append_str(&buf, tmp);
-        } else if (strcmp(ttype, "second1") == 0) {
-            snprintf(tmp, sizeof(tmp), "%d", sec);
-            dtbuf_append_str(&buf, tmp);
-        } else if (strcmp(ttype, "second2") == 0) {
-            snprintf(tmp, sizeof(tmp), "%02d", sec);
-            dtbuf_append_str(&buf, tmp);
-        } else if (strcmp(ttype, "millisecond3") == 0) {
-            snprintf(tmp, sizeof(tmp), "%03d", (int)ms);
-            dtbuf_append_str(&buf, tmp);
-        } else if (strcmp(ttype, "ampmUpper") == 0) {
-            dtbuf_append_str(&buf, hour < 12 ? "AM" : "PM");
-        } else if (strcmp(ttype, "ampmLower") == 0) {
-            dtbuf_append_str(&buf, hour < 12 ? "am" : "pm");
-        } else if (strcmp(ttype, "literal") == 0) {
+/* The plan for tokens, compiled on first use; NULL if out of memory. */
+static const DtPlan *dt_plan_get(EastValue *tokens) {
+    for (int k = 0; k < DT_PLAN_CACHE; k++) {
+        if (dt_plan_matches(&dt_plans[k], tokens)) return &dt_plans[k];
+    }
+
+    size_t len = tokens->data.array.len;
+    DtPlan *p = &dt_plans[dt_plan_next++ % DT_PLAN_CACHE];
+    dt_plan_clear(p);
+    p->items = malloc((len ? len : 1) * sizeof(EastValue *));
+    p->steps = malloc((len ? len : 1) * sizeof(DtStep));
+    if (!p->items || !p->steps) {
+        free(p->items);
+        free(p->steps);
+        memset(p, 0, sizeof(*p));
+        return NULL;
+    }
+    for (size_t i = 0; i < len; i++) {
+        EastValue *tok = east_array_get(tokens, i);
+        DtStep *st = &p->steps[i];
+        st->op = DT_IGNORED;
+        st->lit = NULL;
+        st->lit_len = 0;
+        for (size_t k = 0; k < sizeof(DT_TOKENS) / sizeof(DT_TOKENS[0]); k++) {
+            if (strcmp(tok->data.variant.case_name, DT_TOKENS[k].name) == 0) {
+                st->op = DT_TOKENS[k].op;
+                break;
+            }
+        }
+        if (st->op == DT_LITERAL) {
             EastValue *val = tok->data.variant.value;
-            if (val && val->kind == EAST_VAL_STRING)
-                dtbuf_append(&buf, val->data.string.data, val->data.string.len);
+            if (val && val->kind == EAST_VAL_STRING) {
+                st->lit = val->data.string.data;
+                st->lit_len = val->data.string.len;
+            } else {
+                st->op = DT_IGNORED;
+            }
         }
+        /* Names are at most 9 bytes; numbers at most 20 */
+        p->max_out += st->op == DT_LITERAL ? st->lit_len : 20;
+        east_value_retain(tok);
+        p->items[i] = tok;
     }
+    east_value_retain(tokens);
+    p->tokens = tokens;
+    p->len = len;
+    return p;
+}
 
-    EastValue *result = east_string(buf.data);
-    free(buf.data);
+/* ---- DateTimePrintFormat ---- */
+
+static const char DIGIT_PAIRS[] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+/* v (0-99) as two digits, or without the leading zero when pad is false */
+static inline char *put2(char *out, int v, bool pad) {
+    if (v < 10 && !pad) {
+        *out++ = (char)('0' + v);
+        return out;
+    }
+    memcpy(out, DIGIT_PAIRS + 2 * v, 2);
+    return out + 2;
+}
+
+/* v in decimal with at least width digits, as printf("%0*d") */
+static char *put_int(char *out, int64_t v, int width) {
+    char tmp[24];
+    int n = 0;
+    uint64_t u = v < 0 ? 0 - (uint64_t)v : (uint64_t)v;
+    if (v < 0) {
+        *out++ = '-';
+        width--;
+    }
+    do {
+        tmp[n++] = (char)('0' + u % 10);
+        u /= 10;
+    } while (u);
+    while (n < width) tmp[n++] = '0';
+    while (n) *out++ = tmp[--n];
+    return out;
+}
+
+static size_t dt_print(const DtPlan *p, int64_t millis, char *out) {
+    EastDateTimeParts t;
+    east_datetime_parts(millis, &t);
+    int h12 = t.hour % 12 ? t.hour % 12 : 12;
+    char *o = out;
+    for (size_t i = 0; i < p->len; i++) {
+        const DtStep *st = &p->steps[i];
+        const char *name = NULL;
+        switch (st->op) {
+        case DT_YEAR4:          o = put_int(o, t.year, 1); break;
+        case DT_YEAR2:          o = put_int(o, t.year % 100, 2); break;
+        case DT_MONTH1:         o = put2(o, t.month, false); break;
+        case DT_MONTH2:         o = put2(o, t.month, true); break;
+        case DT_MONTH_SHORT:    name = MONTH_SHORT[t.month - 1]; break;
+        case DT_MONTH_FULL:     name = MONTH_FULL[t.month - 1]; break;
+        case DT_DAY1:           o = put2(o, t.day, false); break;
+        case DT_DAY2:           o = put2(o, t.day, true); break;
+        case DT_WEEKDAY_MIN:    name = WDAY_MIN[t.weekday]; break;
+        case DT_WEEKDAY_SHORT:  name = WDAY_SHORT[t.weekday]; break;
+        case DT_WEEKDAY_FULL:   name = WDAY_FULL[t.weekday]; break;
+        case DT_HOUR24_1:       o = put2(o, t.hour, false); break;
+        case DT_HOUR24_2:       o = put2(o, t.hour, true); break;
+        case DT_HOUR12_1:       o = put2(o, h12, false); break;
+        case DT_HOUR12_2:       o = put2(o, h12, true); break;
+        case DT_MINUTE1:        o = put2(o, t.minute, false); break;
+        case DT_MINUTE2:        o = put2(o, t.minute, true); break;
+        case DT_SECOND1:        o = put2(o, t.second, false); break;
+        case DT_SECOND2:        o = put2(o, t.second, true); break;
+        case DT_MILLISECOND3:
+            *o++ = (char)('0' + t.millisecond / 100);
+            o = put2(o, t.millisecond % 100, true);
+            break;
+        case DT_AMPM_UPPER:     name = t.hour < 12 ? "AM" : "PM"; break;
+        case DT_AMPM_LOWER:     name = t.hour < 12 ? "am" : "pm"; break;
+        case DT_LITERAL:
+            memcpy(o, st->lit, st->lit_len);
+            o += st->lit_len;
+            break;
+        case DT_IGNORED:
+            break;
+        }
+        if (name) {
+            size_t nl = strlen(name);
+            memcpy(o, name, nl);
+            o += nl;
+        }
+    }
+    return (size_t)(o - out);
+}
+
+static EastValue *datetime_print_format_impl(EastValue **args, size_t n) {
+    (void)n;
+    const DtPlan *p = dt_plan_get(args[1]); /* Array of DateTimeFormatToken variants */
+    if (!p) return east_string("");
+
+    char local[256];
+    char *buf = p->max_out <= sizeof(local) ? local : malloc(p->max_out);
+    if (!buf) return east_string("");
+    size_t len = dt_print(p, args[0]->data.datetime, buf);
+    EastValue *result = east_string_len(buf, len);
+    if (buf != local) free(buf);
     return result;
 }
 
@@ -256,6 +445,16 @@ static size_t ci_prefix(const char *input, size_t ilen, const char *pattern) {
     return plen;
 }
 
+/* Helper: index of the first name in names that prefixes the input, or -1 */
+static int ci_match_name(const char *input, size_t ilen, const char **names,
+                         int count, size_t *matched) {
+    for (int k = 0; k < count; k++) {
+        size_t ml = ci_prefix(input, ilen, names[k]);
+        if (ml > 0) { *matched = ml; return k; }
+    }
+    return -1;
+}
+
 /* Helper: parse exactly N digits at position */
 static int parse_digits(const char *s, size_t slen, size_t pos, int count, int *out) {
     if (pos + (size_t)count > slen) return 0;
@@ -283,6 +482,15 @@ static int parse_1or2_digits(const char *s, size_t slen, size_t pos, int *out, i
     return 1;
 }
 
+static bool is_leap_year(int64_t y) {
+    return (y % 4 == 0 && y % 100 != 0) || y % 400 == 0;
+}
+
+static int days_in_month(int64_t y, int m) {
+    static const int DAYS[12] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    return m == 2 && is_leap_year(y) ? 29 : DAYS[m - 1];
+}
+
 /* Helper: set parse error and return NULL */
 #define PARSE_ERR(pos, ...) do { \
     char _buf[512]; \
@@ -292,11 +500,27 @@ static int parse_1or2_digits(const char *s, size_t slen, size_t pos, int *out, i
     return NULL; \
 } while(0)
 
+/* A two-digit field: exactly two digits when pad, else one or two */
+#define PARSE_FIELD(pad, lo, hi, what, What, range, dest) do { \
+    int v, c = 2; \
+    if (pad ? !parse_digits(input, ilen, pos, 2, &v) \
+            : !parse_1or2_digits(input, ilen, pos, &v, &c)) \
+        PARSE_ERR(pos, pad ? "Expected 2-digit " what " (" range ")" \
+                           : "Expected 1 or 2-digit " what); \
+    if (v < (lo) || v > (hi)) \
+        PARSE_ERR(pos, What " out of range (got %d, expected " range ")", v); \
+    dest = v; pos += (size_t)c; \
+} while (0)
+
 static EastValue *datetime_parse_format_impl(EastValue **args, size_t n) {
     (void)n;
     const char *input = args[0]->data.string.data;
     size_t ilen = args[0]->data.string.len;
-    EastValue *tokens = args[1];
+    const DtPlan *p = dt_plan_get(args[1]);
+    if (!p) {
+        east_builtin_error("DateTimeParseFormat: out of memory");
+        return NULL;
+    }
 
     int year = -1, month = -1, day = -1;
     int hour = -1, minute = -1, second = -1, millisecond = -1;
@@ -304,130 +528,93 @@ static EastValue *datetime_parse_format_impl(EastValue **args, size_t n) {
     int parsed_weekday = -1;
     size_t pos = 0;
 
-    for (size_t i = 0; i < tokens->data.array.len; i++) {
-        EastValue *tok = tokens->data.array.items[i];
-        const char *ttype = tok->data.variant.case_name;
+    for (size_t i = 0; i < p->len; i++) {
+        const DtStep *st = &p->steps[i];
+        size_t ml = 0;
+        int k;
 
-        if (strcmp(ttype, "year4") == 0) {
+        switch (st->op) {
+        case DT_YEAR4: {
             int v; if (!parse_digits(input, ilen, pos, 4, &v))
                 PARSE_ERR(pos, "Expected 4-digit year");
             year = v; pos += 4;
-        } else if (strcmp(ttype, "year2") == 0) {
+            break;
+        }
+        case DT_YEAR2: {
             int v; if (!parse_digits(input, ilen, pos, 2, &v))
                 PARSE_ERR(pos, "Expected 2-digit year");
             year = 2000 + v; pos += 2;
-        } else if (strcmp(ttype, "month2") == 0) {
-            int v; if (!parse_digits(input, ilen, pos, 2, &v))
-                PARSE_ERR(pos, "Expected 2-digit month (01-12)");
-            if (v < 1 || v > 12)
-                PARSE_ERR(pos, "Month out of range (got %d, expected 01-12)", v);
-            month = v; pos += 2;
-        } else if (strcmp(ttype, "month1") == 0) {
-            int v, c; if (!parse_1or2_digits(input, ilen, pos, &v, &c))
-                PARSE_ERR(pos, "Expected 1 or 2-digit month");
-            if (v < 1 || v > 12)
-                PARSE_ERR(pos, "Month out of range (got %d, expected 1-12)", v);
-            month = v; pos += c;
-        } else if (strcmp(ttype, "monthNameFull") == 0) {
-            int found = 0;
-            for (int m = 0; m < 12; m++) {
-                size_t ml = ci_prefix(input + pos, ilen - pos, MONTH_FULL[m]);
-                if (ml > 0) { month = m + 1; pos += ml; found = 1; break; }
-            }
-            if (!found) PARSE_ERR(pos, "Expected full month name (e.g., \"January\")");
-        } else if (strcmp(ttype, "monthNameShort") == 0) {
-            int found = 0;
-            for (int m = 0; m < 12; m++) {
-                size_t ml = ci_prefix(input + pos, ilen - pos, MONTH_SHORT[m]);
-                if (ml > 0) { month = m + 1; pos += ml; found = 1; break; }
-            }
-            if (!found) PARSE_ERR(pos, "Expected short month name (e.g., \"Jan\")");
-        } else if (strcmp(ttype, "day2") == 0) {
-            int v; if (!parse_digits(input, ilen, pos, 2, &v))
-                PARSE_ERR(pos, "Expected 2-digit day (01-31)");
-            if (v < 1 || v > 31)
-                PARSE_ERR(pos, "Day out of range (got %d, expected 01-31)", v);
-            day = v; pos += 2;
-        } else if (strcmp(ttype, "day1") == 0) {
-            int v, c; if (!parse_1or2_digits(input, ilen, pos, &v, &c))
-                PARSE_ERR(pos, "Expected 1 or 2-digit day");
-            if (v < 1 || v > 31)
-                PARSE_ERR(pos, "Day out of range (got %d, expected 1-31)", v);
-            day = v; pos += c;
-        } else if (strcmp(ttype, "weekdayNameFull") == 0) {
-            int found = 0;
-            for (int w = 0; w < 7; w++) {
-                size_t wl = ci_prefix(input + pos, ilen - pos, WDAY_FULL[w]);
-                if (wl > 0) { parsed_weekday = w; pos += wl; found = 1; break; }
-            }
-            if (!found) PARSE_ERR(pos, "Expected full weekday name (e.g., \"Monday\")");
-        } else if (strcmp(ttype, "weekdayNameShort") == 0) {
-            int found = 0;
-            for (int w = 0; w < 7; w++) {
-                size_t wl = ci_prefix(input + pos, ilen - pos, WDAY_SHORT[w]);
-                if (wl > 0) { parsed_weekday = w; pos += wl; found = 1; break; }
-            }
-            if (!found) PARSE_ERR(pos, "Expected short weekday name (e.g., \"Mon\")");
-        } else if (strcmp(ttype, "weekdayNameMin") == 0) {
-            int found = 0;
-            for (int w = 0; w < 7; w++) {
-                size_t wl = ci_prefix(input + pos, ilen - pos, WDAY_MIN[w]);
-                if (wl > 0) { parsed_weekday = w; pos += wl; found = 1; break; }
-            }
-            if (!found) PARSE_ERR(pos, "Expected minimal weekday name (e.g., \"Mo\")");
-        } else if (strcmp(ttype, "hour24_2") == 0) {
-            int v; if (!parse_digits(input, ilen, pos, 2, &v))
-                PARSE_ERR(pos, "Expected 2-digit hour (00-23)");
-            if (v > 23)
-                PARSE_ERR(pos, "Hour out of range (got %d, expected 00-23)", v);
-            hour = v; pos += 2;
-        } else if (strcmp(ttype, "hour24_1") == 0) {
-            int v, c; if (!parse_1or2_digits(input, ilen, pos, &v, &c))
-                PARSE_ERR(pos, "Expected 1 or 2-digit hour");
-            if (v > 23)
-                PARSE_ERR(pos, "Hour out of range (got %d, expected 0-23)", v);
-            hour = v; pos += c;
-        } else if (strcmp(ttype, "hour12_2") == 0) {
-            int v; if (!parse_digits(input, ilen, pos, 2, &v))
-                PARSE_ERR(pos, "Expected 2-digit hour (01-12)");
-            if (v < 1 || v > 12)
-                PARSE_ERR(pos, "Hour out of range (got %d, expected 01-12)", v);
-            hour12 = v; pos += 2;
-        } else if (strcmp(ttype, "hour12_1") == 0) {
-            int v, c; if (!parse_1or2_digits(input, ilen, pos, &v, &c))
-                PARSE_ERR(pos, "Expected 1 or 2-digit hour");
-            if (v < 1 || v > 12)
-                PARSE_ERR(pos, "Hour out of range (got %d, expected 1-12)", v);
-            hour12 = v; pos += c;
-        } else if (strcmp(ttype, "minute2") == 0) {
-            int v; if (!parse_digits(input, ilen, pos, 2, &v))
-                PARSE_ERR(pos, "Expected 2-digit minute (00-59)");
-            if (v > 59)
-                PARSE_ERR(pos, "Minute out of range (got %d, expected 00-59)", v);
-            minute = v; pos += 2;
-        } else if (strcmp(ttype, "minute1") == 0) {
-            int v, c; if (!parse_1or2_digits(input, ilen, pos, &v, &c))
-                PARSE_ERR(pos, "Expected 1 or 2-digit minute");
-            if (v > 59)
-                PARSE_ERR(pos, "Minute out of range (got %d, expected 0-59)", v);
-            minute = v; pos += c;
-        } else if (strcmp(ttype, "second2") == 0) {
-            int v; if (!parse_digits(input, ilen, pos, 2, &v))
-                PARSE_ERR(pos, "Expected 2-digit second (00-59)");
-            if (v > 59)
-                PARSE_ERR(pos, "Second out of range (got %d, expected 00-59)", v);
-            second = v; pos += 2;
-        } else if (strcmp(ttype, "second1") == 0) {
-            int v, c; if (!parse_1or2_digits(input, ilen, pos, &v, &c))
-                PARSE_ERR(pos, "Expected 1 or 2-digit second");
-            if (v > 59)
-                PARSE_ERR(pos, "Second out of range (got %d, expected 0-59)", v);
-            second = v; pos += c;
-        } else if (strcmp(ttype, "millisecond3") == 0) {
+            break;
+        }
+        case DT_MONTH2:
+            PARSE_FIELD(true, 1, 12, "month", "Month", "01-12", month);
+            break;
+        case DT_MONTH1:
+            PARSE_FIELD(false, 1, 12, "month", "Month", "1-12", month);
+            break;
+        case DT_MONTH_FULL:
+            k = ci_match_name(input + pos, ilen - pos, MONTH_FULL, 12, &ml);
+            if (k < 0) PARSE_ERR(pos, "Expected full month name (e.g., \"January\")");
+            month = k + 1; pos += ml;
+            break;
+        case DT_MONTH_SHORT:
+            k = ci_match_name(input + pos, ilen - pos, MONTH_SHORT, 12, &ml);
+            if (k < 0) PARSE_ERR(pos, "Expected short month name (e.g., \"Jan\")");
+            month = k + 1; pos += ml;
+            break;
+        case DT_DAY2:
+            PARSE_FIELD(true, 1, 31, "day", "Day", "01-31", day);
+            break;
+        case DT_DAY1:
+            PARSE_FIELD(false, 1, 31, "day", "Day", "1-31", day);
+            break;
+        case DT_WEEKDAY_FULL:
+            k = ci_match_name(input + pos, ilen - pos, WDAY_FULL, 7, &ml);
+            if (k < 0) PARSE_ERR(pos, "Expected full weekday name (e.g., \"Monday\")");
+            parsed_weekday = k; pos += ml;
+            break;
+        case DT_WEEKDAY_SHORT:
+            k = ci_match_name(input + pos, ilen - pos, WDAY_SHORT, 7, &ml);
+            if (k < 0) PARSE_ERR(pos, "Expected short weekday name (e.g., \"Mon\")");
+            parsed_weekday = k; pos += ml;
+            break;
+        case DT_WEEKDAY_MIN:
+            k = ci_match_name(input + pos, ilen - pos, WDAY_MIN, 7, &ml);
+            if (k < 0) PARSE_ERR(pos, "Expected minimal weekday name (e.g., \"Mo\")");
+            parsed_weekday = k; pos += ml;
+            break;
+        case DT_HOUR24_2:
+            PARSE_FIELD(true, 0, 23, "hour", "Hour", "00-23", hour);
+            break;
+        case DT_HOUR24_1:
+            PARSE_FIELD(false, 0, 23, "hour", "Hour", "0-23", hour);
+            break;
+        case DT_HOUR12_2:
+            PARSE_FIELD(true, 1, 12, "hour", "Hour", "01-12", hour12);
+            break;
+        case DT_HOUR12_1:
+            PARSE_FIELD(false, 1, 12, "hour", "Hour", "1-12", hour12);
+            break;
+        case DT_MINUTE2:
+            PARSE_FIELD(true, 0, 59, "minute", "Minute", "00-59", minute);
+            break;
+        case DT_MINUTE1:
+            PARSE_FIELD(false, 0, 59, "minute", "Minute", "0-59", minute);
+            break;
+        case DT_SECOND2:
+            PARSE_FIELD(true, 0, 59, "second", "Second", "00-59", second);
+            break;
+        case DT_SECOND1:
+            PARSE_FIELD(false, 0, 59, "second", "Second", "0-59", second);
+            break;
+        case DT_MILLISECOND3: {
             int v; if (!parse_digits(input, ilen, pos, 3, &v))
                 PARSE_ERR(pos, "Expected 3-digit millisecond (000-999)");
             millisecond = v; pos += 3;
-        } else if (strcmp(ttype, "ampmUpper") == 0 || strcmp(ttype, "ampmLower") == 0) {
+            break;
+        }
+        case DT_AMPM_UPPER:
+        case DT_AMPM_LOWER: {
             if (pos + 2 > ilen)
                 PARSE_ERR(pos, "Expected \"AM\" or \"PM\"");
             char a = input[pos], b = input[pos + 1];
@@ -436,14 +623,15 @@ static EastValue *datetime_parse_format_impl(EastValue **args, size_t n) {
             if (a == 'a' && b == 'm') { is_pm = 0; pos += 2; }
             else if (a == 'p' && b == 'm') { is_pm = 1; pos += 2; }
             else PARSE_ERR(pos, "Expected \"AM\" or \"PM\"");
-        } else if (strcmp(ttype, "literal") == 0) {
-            EastValue *val = tok->data.variant.value;
-            if (val && val->kind == EAST_VAL_STRING) {
-                size_t llen = val->data.string.len;
-                if (pos + llen > ilen || memcmp(input + pos, val->data.string.data, llen) != 0)
-                    PARSE_ERR(pos, "Expected literal \"%.*s\"", (int)llen, val->data.string.data);
-                pos += llen;
-            }
+            break;
+        }
+        case DT_LITERAL:
+            if (pos + st->lit_len > ilen || memcmp(input + pos, st->lit, st->lit_len) != 0)
+                PARSE_ERR(pos, "Expected literal \"%.*s\"", (int)st->lit_len, st->lit);
+            pos += st->lit_len;
+            break;
+        case DT_IGNORED:
+            break;
         }
     }
 
@@ -468,30 +656,22 @@ static EastValue *datetime_parse_format_impl(EastValue **args, size_t n) {
     if (second == -1) second = 0;
     if (millisecond == -1) millisecond = 0;
 
-    /* Build datetime via timegm */
-    struct tm t = {0};
-    t.tm_year = year - 1900;
-    t.tm_mon = month - 1;
-    t.tm_mday = day;
-    t.tm_hour = hour;
-    t.tm_min = minute;
-    t.tm_sec = second;
-    time_t secs = timegm(&t);
-
-    /* Validate date (e.g., Feb 31 would roll over) */
-    struct tm check;
-    gmtime_r(&secs, &check);
-    if (check.tm_year + 1900 != year || check.tm_mon + 1 != month || check.tm_mday != day)
+    /* Validate date (e.g., Feb 31) */
+    if (day > days_in_month(year, month))
         PARSE_ERR(0, "Invalid date: %04d-%02d-%02d", year, month, day);
+    int64_t days = east_days_from_civil(year, month, day);
 
-    /* Validate weekday if parsed */
-    if (parsed_weekday >= 0 && check.tm_wday != parsed_weekday)
+    /* Validate weekday if parsed (1970-01-01 was a Thursday) */
+    int weekday = (int)(((days + 4) % 7 + 7) % 7);
+    if (parsed_weekday >= 0 && weekday != parsed_weekday)
         PARSE_ERR(0, "Weekday mismatch: parsed \"%s\" but date is actually \"%s\"",
-                  WDAY_FULL[parsed_weekday], WDAY_FULL[check.tm_wday]);
+                  WDAY_FULL[parsed_weekday], WDAY_FULL[weekday]);
 
-    return east_datetime((int64_t)secs * 1000 + millisecond);
+    int64_t secs = days * 86400 + hour * 3600 + minute * 60 + second;
+    return east_datetime(secs * 1000 + millisecond);
 }
 
+#undef PARSE_FIELD
 #undef PARSE_ERR
 
 /* --- factory functions --- */
@@ -509,6 +689,7 @@ static BuiltinImpl datetime_dow_factory(EastType **tp, size_t ntp) { (void)tp; (
 static BuiltinImpl datetime_to_epoch_factory(EastType **tp, size_t ntp) { (void)tp; (void)ntp; return datetime_to_epoch_milliseconds; }
 static BuiltinImpl datetime_from_epoch_factory(EastType **tp, size_t ntp) { (void)tp; (void)ntp; return datetime_from_epoch_milliseconds; }
 static BuiltinImpl datetime_from_comp_factory(EastType **tp, size_t ntp) { (void)tp; (void)ntp; return datetime_from_components; }
+static BuiltinImpl datetime_components_factory(EastType **tp, size_t ntp) { (void)tp; (void)ntp; return datetime_components; }
 static BuiltinImpl datetime_print_fmt_factory(EastType **tp, size_t ntp) { (void)tp; (void)ntp; return datetime_print_format_impl; }
 static BuiltinImpl datetime_parse_fmt_factory(EastType **tp, size_t ntp) { (void)tp; (void)ntp; return datetime_parse_format_impl; }
 
@@ -528,6 +709,7 @@ void east_register_datetime_builtins(BuiltinRegistry *reg) {
     builtin_registry_register(reg, "DateTimeToEpochMilliseconds", datetime_to_epoch_factory);
     builtin_registry_register(reg, "DateTimeFromEpochMilliseconds", datetime_from_epoch_factory);
     builtin_registry_register(reg, "DateTimeFromComponents", datetime_from_comp_factory);
+    builtin_registry_register(reg, "DateTimeComponents", datetime_components_factory);
     builtin_registry_register(reg, "DateTimePrintFormat", datetime_print_fmt_factory);
     builtin_registry_register(reg, "DateTimeParseFormat", datetime_parse_fmt_factory);
 }
@@ -231,6 +231,7 @@ static EastValue *dict_clear_impl(EastValue **args, size_t n) {
         east_value_release(d->data.dict.values[i]);
     }
     d->data.dict.len = 0;
+    east_value_invalidate_hashes();
     return east_null();
 }
 
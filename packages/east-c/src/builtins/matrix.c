@@ -3,9 +3,12 @@
  *
  * Matrices store homogeneous numeric data in row-major order.
  * data.matrix.data points to a contiguous buffer of (rows * cols) elements.
+ * Rows handed out as Vectors share that buffer (east_vector_view), so
+ * in-place writes must go through east_value_make_writable first.
  */
 #include "east/builtins.h"
 #include "east/compiler.h"
+#include "east/kernels.h"
 #include "east/values.h"
 #include <stdio.h>
 #include <stdlib.h>
@@ -119,7 +122,12 @@ static EastValue *matrix_set_impl(EastValue **args, size_t n) {
         east_builtin_error(msg);
         return NULL;
     }
+    if (!east_value_make_writable(mat)) {
+        east_builtin_error("MatrixSet: out of memory");
+        return NULL;
+    }
     mat_set_elem(mat, (size_t)row, (size_t)col, args[3]);
+    east_value_invalidate_hashes();
     return east_null();
 }
 
@@ -136,10 +144,7 @@ static EastValue *matrix_get_row_impl(EastValue **args, size_t n) {
         return NULL;
     }
     size_t cols = mat->data.matrix.cols;
-    EastValue *vec = east_vector_new(mat->data.matrix.elem_type, cols);
-    size_t es = elem_size(mat->data.matrix.elem_type);
-    memcpy(vec->data.vector.data, (char *)mat->data.matrix.data + (size_t)row * cols * es, cols * es);
-    return vec;
+    return east_vector_view(mat, (size_t)row * cols, cols);
 }
 
 static EastValue *matrix_get_col_impl(EastValue **args, size_t n) {
@@ -158,14 +163,15 @@ static EastValue *matrix_get_col_impl(EastValue **args, size_t n) {
     size_t cols = mat->data.matrix.cols;
     EastValue *vec = east_vector_new(mat->data.matrix.elem_type, rows);
     EastType *et = mat->data.matrix.elem_type;
-    for (size_t r = 0; r < rows; r++) {
-        size_t src_idx = r * cols + (size_t)col;
-        if (et->kind == EAST_TYPE_FLOAT)
-            ((double *)vec->data.vector.data)[r] = ((double *)mat->data.matrix.data)[src_idx];
-        else if (et->kind == EAST_TYPE_INTEGER)
-            ((int64_t *)vec->data.vector.data)[r] = ((int64_t *)mat->data.matrix.data)[src_idx];
-        else if (et->kind == EAST_TYPE_BOOLEAN)
-            ((bool *)vec->data.vector.data)[r] = ((bool *)mat->data.matrix.data)[src_idx];
+    if (et->kind == EAST_TYPE_BOOLEAN) {
+        const bool *src = (const bool *)mat->data.matrix.data + col;
+        bool *dst = vec->data.vector.data;
+        for (size_t r = 0; r < rows; r++) dst[r] = src[r * cols];
+    } else {
+        /* Float and Integer are both 8 bytes; copy the bits */
+        const uint64_t *src = (const uint64_t *)mat->data.matrix.data + col;
+        uint64_t *dst = vec->data.vector.data;
+        for (size_t r = 0; r < rows; r++) dst[r] = src[r * cols];
     }
     return vec;
 }
@@ -174,10 +180,7 @@ static EastValue *matrix_to_vector_impl(EastValue **args, size_t n) {
     (void)n;
     EastValue *mat = args[0];
     size_t total = mat->data.matrix.rows * mat->data.matrix.cols;
-    EastValue *vec = east_vector_new(mat->data.matrix.elem_type, total);
-    size_t es = elem_size(mat->data.matrix.elem_type);
-    memcpy(vec->data.vector.data, mat->data.matrix.data, total * es);
-    return vec;
+    return east_vector_view(mat, 0, total);
 }
 
 static EastValue *matrix_from_array_impl(EastValue **args, size_t n) {
@@ -232,15 +235,9 @@ static EastValue *matrix_transpose_impl(EastValue **args, size_t n) {
     size_t rows = mat->data.matrix.rows;
     size_t cols = mat->data.matrix.cols;
     EastValue *result = east_matrix_new(mat->data.matrix.elem_type, cols, rows);
-    EastType *et = mat->data.matrix.elem_type;
-    size_t es = elem_size(et);
-    for (size_t r = 0; r < rows; r++) {
-        for (size_t c = 0; c < cols; c++) {
-            size_t src = r * cols + c;
-            size_t dst = c * rows + r;
-            memcpy((char *)result->data.matrix.data + dst * es,
-                   (char *)mat->data.matrix.data + src * es, es);
-        }
+    if (rows && cols) {
+        east_kernel_transpose(rows, cols, elem_size(mat->data.matrix.elem_type),
+                              mat->data.matrix.data, result->data.matrix.data);
     }
     return result;
 }
@@ -311,14 +308,12 @@ static EastValue *matrix_map_rows_impl(EastValue **args, size_t n) {
     size_t rows = mat->data.matrix.rows;
     size_t cols = mat->data.matrix.cols;
     EastType *et = mat->data.matrix.elem_type;
-    size_t es = elem_size(et);
 
     /* Collect result row vectors */
     EastValue **row_vecs = malloc(rows * sizeof(EastValue *));
     size_t result_cols = 0;
     for (size_t r = 0; r < rows; r++) {
-        EastValue *row_vec = east_vector_new(et, cols);
-        memcpy(row_vec->data.vector.data, (char *)mat->data.matrix.data + r * cols * es, cols * es);
+        EastValue *row_vec = east_vector_view(mat, r * cols, cols);
         EastValue *ri = east_integer((int64_t)r);
         EastValue *call_args[] = { row_vec, ri };
         EastValue *result_vec = call_fn(fn, call_args, 2);
@@ -351,12 +346,10 @@ static EastValue *matrix_to_rows_impl(EastValue **args, size_t n) {
     size_t rows = mat->data.matrix.rows;
     size_t cols = mat->data.matrix.cols;
     EastType *et = mat->data.matrix.elem_type;
-    size_t es = elem_size(et);
     EastType *vec_t = east_vector_type(et);
     EastValue *result = east_array_new(vec_t);
     for (size_t r = 0; r < rows; r++) {
-        EastValue *row_vec = east_vector_new(et, cols);
-        memcpy(row_vec->data.vector.data, (char *)mat->data.matrix.data + r * cols * es, cols * es);
+        EastValue *row_vec = east_vector_view(mat, r * cols, cols);
         east_array_push(result, row_vec);
         east_value_release(row_vec);
     }
@@ -381,6 +374,239 @@ static EastValue *matrix_from_rows_impl(EastValue **args, size_t n) {
     return mat;
 }
 
+/* ------------------------------------------------------------------ */
+/* Linear algebra (see east/kernels.h)                                 */
+/*                                                                     */
+/* These work on the row-major buffer directly. Products, element-wise */
+/* ops and reductions take Float or Integer matrices; the solvers are  */
+/* Float only.                                                         */
+/* ------------------------------------------------------------------ */
+
+static bool check_numeric(const char *builtin, EastValue *mat) {
+    EastTypeKind k = mat->data.matrix.elem_type->kind;
+    if (k == EAST_TYPE_FLOAT || k == EAST_TYPE_INTEGER) return true;
+    char msg[128];
+    snprintf(msg, sizeof(msg), "%s requires a Float or Integer matrix", builtin);
+    east_builtin_error(msg);
+    return false;
+}
+
+static bool check_elem_types(const char *builtin, EastType *a, EastType *b) {
+    if (a->kind == b->kind) return true;
+    char msg[128];
+    snprintf(msg, sizeof(msg), "%s: element types differ", builtin);
+    east_builtin_error(msg);
+    return false;
+}
+
+static bool shape_error(const char *builtin, size_t r1, size_t c1, size_t r2, size_t c2) {
+    char msg[160];
+    snprintf(msg, sizeof(msg), "%s: incompatible shapes %zux%zu and %zux%zu",
+             builtin, r1, c1, r2, c2);
+    east_builtin_error(msg);
+    return false;
+}
+
+static EastValue *matrix_multiply_impl(EastValue **args, size_t n) {
+    (void)n;
+    EastValue *a = args[0], *b = args[1];
+    if (!check_numeric("MatrixMultiply", a) ||
+        !check_elem_types("MatrixMultiply", a->data.matrix.elem_type, b->data.matrix.elem_type))
+        return NULL;
+    size_t m = a->data.matrix.rows, k = a->data.matrix.cols, cols = b->data.matrix.cols;
+    if (b->data.matrix.rows != k) {
+        shape_error("MatrixMultiply", m, k, b->data.matrix.rows, cols);
+        return NULL;
+    }
+    EastType *et = a->data.matrix.elem_type;
+    EastValue *result = east_matrix_new(et, m, cols);
+    if (et->kind == EAST_TYPE_FLOAT)
+        east_kernel_gemm_f64(m, cols, k, a->data.matrix.data, b->data.matrix.data,
+                             result->data.matrix.data);
+    else
+        east_kernel_gemm_i64(m, cols, k, a->data.matrix.data, b->data.matrix.data,
+                             result->data.matrix.data);
+    return result;
+}
+
+/* Each output element is a row dot product, summed like VectorDot. */
+static EastValue *matrix_vector_multiply_impl(EastValue **args, size_t n) {
+    (void)n;
+    EastValue *a = args[0], *v = args[1];
+    if (!check_numeric("MatrixVectorMultiply", a) ||
+        !check_elem_types("MatrixVectorMultiply", a->data.matrix.elem_type, v->data.vector.elem_type))
+        return NULL;
+    size_t rows = a->data.matrix.rows, cols = a->data.matrix.cols;
+    if (v->data.vector.len != cols) {
+        shape_error("MatrixVectorMultiply", rows, cols, v->data.vector.len, 1);
+        return NULL;
+    }
+    EastType *et = a->data.matrix.elem_type;
+    EastValue *result = east_vector_new(et, rows);
+    if (et->kind == EAST_TYPE_FLOAT) {
+        const double *ad = a->data.matrix.data;
+        double *out = result->data.vector.data;
+        for (size_t r = 0; r < rows; r++)
+            out[r] = east_kernel_dot_f64(ad + r * cols, v->data.vector.data, cols);
+    } else {
+        const int64_t *ad = a->data.matrix.data;
+        int64_t *out = result->data.vector.data;
+        for (size_t r = 0; r < rows; r++)
+            out[r] = east_kernel_dot_i64(ad + r * cols, v->data.vector.data, cols);
+    }
+    return result;
+}
+
+/* Element-wise with a same-shaped matrix, or a broadcast scalar. */
+static EastValue *matrix_elementwise(EastValue **args, EastArithOp op, const char *builtin) {
+    EastValue *a = args[0], *b = args[1];
+    if (!check_numeric(builtin, a)) return NULL;
+    EastType *et = a->data.matrix.elem_type;
+    bool mm = b->kind == EAST_VAL_MATRIX;
+    if (mm) {
+        if (!check_elem_types(builtin, et, b->data.matrix.elem_type)) return NULL;
+        if (b->data.matrix.rows != a->data.matrix.rows ||
+            b->data.matrix.cols != a->data.matrix.cols) {
+            shape_error(builtin, a->data.matrix.rows, a->data.matrix.cols,
+                        b->data.matrix.rows, b->data.matrix.cols);
+            return NULL;
+        }
+    } else if (!(b->kind == EAST_VAL_INTEGER ||
+                 (b->kind == EAST_VAL_FLOAT && et->kind == EAST_TYPE_FLOAT))) {
+        char msg[128];
+        snprintf(msg, sizeof(msg), "%s: operand does not match the matrix element type", builtin);
+        east_builtin_error(msg);
+        return NULL;
+    }
+    size_t rows = a->data.matrix.rows, cols = a->data.matrix.cols;
+    EastValue *result = east_matrix_new(et, rows, cols);
+    if (et->kind == EAST_TYPE_FLOAT) {
+        double s = b->kind == EAST_VAL_INTEGER ? (double)b->data.integer
+                 : b->kind == EAST_VAL_FLOAT ? b->data.float64 : 0;
+        east_kernel_arith_f64(op, result->data.matrix.data, a->data.matrix.data,
+                              mm ? b->data.matrix.data : NULL, s, rows * cols);
+    } else {
+        east_kernel_arith_i64(op, result->data.matrix.data, a->data.matrix.data,
+                              mm ? b->data.matrix.data : NULL,
+                              mm ? 0 : b->data.integer, rows * cols);
+    }
+    return result;
+}
+
+static EastValue *matrix_add_impl(EastValue **args, size_t n) { (void)n; return matrix_elementwise(args, EAST_ARITH_ADD, "MatrixAdd"); }
+static EastValue *matrix_subtract_impl(EastValue **args, size_t n) { (void)n; return matrix_elementwise(args, EAST_ARITH_SUB, "MatrixSubtract"); }
+static EastValue *matrix_element_multiply_impl(EastValue **args, size_t n) { (void)n; return matrix_elementwise(args, EAST_ARITH_MUL, "MatrixElementMultiply"); }
+static EastValue *matrix_element_divide_impl(EastValue **args, size_t n) { (void)n; return matrix_elementwise(args, EAST_ARITH_DIV, "MatrixElementDivide"); }
+
+/*
+ * Row and column reductions. Sums keep the element type; means are Float.
+ * Column sums add whole rows into an accumulator, so each column is
+ * summed top to bottom.
+ */
+static EastValue *matrix_reduce(EastValue *mat, bool by_row, bool mean, const char *builtin) {
+    if (!check_numeric(builtin, mat)) return NULL;
+    size_t rows = mat->data.matrix.rows, cols = mat->data.matrix.cols;
+    size_t len = by_row ? rows : cols;
+    size_t count = by_row ? cols : rows;
+    bool is_float = mat->data.matrix.elem_type->kind == EAST_TYPE_FLOAT;
+    EastType *out_type = (mean || is_float) ? &east_float_type : &east_integer_type;
+    EastValue *result = east_vector_new(out_type, len);
+
+    if (!is_float && !mean) {
+        const int64_t *d = mat->data.matrix.data;
+        int64_t *out = result->data.vector.data;
+        if (by_row) {
+            for (size_t r = 0; r < rows; r++) out[r] = east_kernel_sum_i64(d + r * cols, cols);
+        } else {
+            memset(out, 0, cols * sizeof(int64_t));
+            for (size_t r = 0; r < rows; r++) east_kernel_axpy_i64(out, 1, d + r * cols, cols);
+        }
+        return result;
+    }
+
+    double *out = result->data.vector.data;
+    if (is_float) {
+        const double *d = mat->data.matrix.data;
+        if (by_row) {
+            for (size_t r = 0; r < rows; r++) out[r] = east_kernel_sum_f64(d + r * cols, cols);
+        } else {
+            memset(out, 0, cols * sizeof(double));
+            for (size_t r = 0; r < rows; r++) east_kernel_axpy_f64(out, 1.0, d + r * cols, cols);
+        }
+    } else {
+        const int64_t *d = mat->data.matrix.data;
+        if (by_row) {
+            for (size_t r = 0; r < rows; r++) out[r] = east_kernel_sum_i64_as_f64(d + r * cols, cols);
+        } else {
+            memset(out, 0, cols * sizeof(double));
+            for (size_t r = 0; r < rows; r++)
+                for (size_t c = 0; c < cols; c++) out[c] += (double)d[r * cols + c];
+        }
+    }
+    if (mean)
+        for (size_t i = 0; i < len; i++) out[i] /= (double)count;
+    return result;
+}
+
+static EastValue *matrix_row_sums_impl(EastValue **args, size_t n) { (void)n; return matrix_reduce(args[0], true, false, "MatrixRowSums"); }
+static EastValue *matrix_col_sums_impl(EastValue **args, size_t n) { (void)n; return matrix_reduce(args[0], false, false, "MatrixColSums"); }
+static EastValue *matrix_row_means_impl(EastValue **args, size_t n) { (void)n; return matrix_reduce(args[0], true, true, "MatrixRowMeans"); }
+static EastValue *matrix_col_means_impl(EastValue **args, size_t n) { (void)n; return matrix_reduce(args[0], false, true, "MatrixColMeans"); }
+
+/*
+ * Solve A X = B for square Float A. B is a Vector (one right-hand side,
+ * returns a Vector) or a Matrix with A's row count (returns a Matrix).
+ */
+static EastValue *matrix_solve(EastValue **args, bool cholesky, const char *builtin) {
+    EastValue *a = args[0], *b = args[1];
+    size_t n = a->data.matrix.rows;
+    bool b_vec = b->kind == EAST_VAL_VECTOR;
+    EastType *bt = b_vec ? b->data.vector.elem_type : b->data.matrix.elem_type;
+    size_t b_rows = b_vec ? b->data.vector.len : b->data.matrix.rows;
+    size_t nrhs = b_vec ? 1 : b->data.matrix.cols;
+    if (a->data.matrix.elem_type->kind != EAST_TYPE_FLOAT || bt->kind != EAST_TYPE_FLOAT) {
+        char msg[128];
+        snprintf(msg, sizeof(msg), "%s requires Float operands", builtin);
+        east_builtin_error(msg);
+        return NULL;
+    }
+    if (a->data.matrix.cols != n || b_rows != n) {
+        shape_error(builtin, n, a->data.matrix.cols, b_rows, nrhs);
+        return NULL;
+    }
+
+    double *work = malloc((n ? n * n : 1) * sizeof(double));
+    memcpy(work, a->data.matrix.data, n * n * sizeof(double));
+    EastValue *result = b_vec ? east_vector_new(&east_float_type, n)
+                              : east_matrix_new(&east_float_type, n, nrhs);
+    double *x = b_vec ? result->data.vector.data : result->data.matrix.data;
+    memcpy(x, b_vec ? b->data.vector.data : b->data.matrix.data, n * nrhs * sizeof(double));
+
+    bool ok;
+    if (cholesky) {
+        ok = east_kernel_cholesky_f64(n, work);
+        if (ok) east_kernel_cholesky_solve_f64(n, work, x, nrhs);
+    } else {
+        size_t *perm = malloc((n ? n : 1) * sizeof(size_t));
+        ok = east_kernel_lu_f64(n, work, perm);
+        if (ok) east_kernel_lu_solve_f64(n, work, perm, x, nrhs);
+        free(perm);
+    }
+    free(work);
+    if (!ok) {
+        east_value_release(result);
+        char msg[128];
+        snprintf(msg, sizeof(msg), cholesky ? "%s: matrix is not positive definite"
+                                            : "%s: matrix is singular", builtin);
+        east_builtin_error(msg);
+        return NULL;
+    }
+    return result;
+}
+
+static EastValue *matrix_solve_impl(EastValue **args, size_t n) { (void)n; return matrix_solve(args, false, "MatrixSolve"); }
+static EastValue *matrix_cholesky_solve_impl(EastValue **args, size_t n) { (void)n; return matrix_solve(args, true, "MatrixCholeskySolve"); }
+
 /* --- factory functions --- */
 
 static BuiltinImpl matrix_rows_factory(EastType **tp, size_t ntp) { (void)tp; (void)ntp; return matrix_rows_impl; }
@@ -401,6 +627,22 @@ static BuiltinImpl matrix_map_rows_factory(EastType **tp, size_t ntp) { (void)tp
 static BuiltinImpl matrix_to_rows_factory(EastType **tp, size_t ntp) { (void)tp; (void)ntp; return matrix_to_rows_impl; }
 static BuiltinImpl matrix_from_rows_factory(EastType **tp, size_t ntp) { (void)tp; (void)ntp; return matrix_from_rows_impl; }
 
+/* The linear algebra builtins dispatch on the element type at run time. */
+#define MATRIX_FACTORY(name) \
+    static BuiltinImpl name##_factory(EastType **tp, size_t ntp) { (void)tp; (void)ntp; return name##_impl; }
+MATRIX_FACTORY(matrix_multiply)
+MATRIX_FACTORY(matrix_vector_multiply)
+MATRIX_FACTORY(matrix_add)
+MATRIX_FACTORY(matrix_subtract)
+MATRIX_FACTORY(matrix_element_multiply)
+MATRIX_FACTORY(matrix_element_divide)
+MATRIX_FACTORY(matrix_row_sums)
+MATRIX_FACTORY(matrix_col_sums)
+MATRIX_FACTORY(matrix_row_means)
+MATRIX_FACTORY(matrix_col_means)
+MATRIX_FACTORY(matrix_solve)
+MATRIX_FACTORY(matrix_cholesky_solve)
+
 /* --- registration --- */
 
 void east_register_matrix_builtins(BuiltinRegistry *reg) {
@@ -421,4 +663,16 @@ void east_register_matrix_builtins(BuiltinRegistry *reg) {
     builtin_registry_register(reg, "MatrixMapRows", matrix_map_rows_factory);
     builtin_registry_register(reg, "MatrixToRows", matrix_to_rows_factory);
     builtin_registry_register(reg, "MatrixFromRows", matrix_from_rows_factory);
+    builtin_registry_register(reg, "MatrixMultiply", matrix_multiply_factory);
+    builtin_registry_register(reg, "MatrixVectorMultiply", matrix_vector_multiply_factory);
+    builtin_registry_register(reg, "MatrixAdd", matrix_add_factory);
+    builtin_registry_register(reg, "MatrixSubtract", matrix_subtract_factory);
+    builtin_registry_register(reg, "MatrixElementMultiply", matrix_element_multiply_factory);
+    builtin_registry_register(reg, "MatrixElementDivide", matrix_element_divide_factory);
+    builtin_registry_register(reg, "MatrixRowSums", matrix_row_sums_factory);
+    builtin_registry_register(reg, "MatrixColSums", matrix_col_sums_factory);
+    builtin_registry_register(reg, "MatrixRowMeans", matrix_row_means_factory);
+    builtin_registry_register(reg, "MatrixColMeans", matrix_col_means_factory);
+    builtin_registry_register(reg, "MatrixSolve", matrix_solve_factory);
+    builtin_registry_register(reg, "MatrixCholeskySolve", matrix_cholesky_solve_factory);
 }
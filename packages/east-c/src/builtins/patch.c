@@ -8,9 +8,12 @@
  *   patch: <type-specific structural patch>  (containers only)
  */
 #include "east/builtins.h"
+#include "east/memory.h"
 #include "east/types.h"
 #include "east/values.h"
 
+#include <stddef.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -110,48 +113,265 @@ static EastValue *do_invert(EastValue *patch, EastType *type);
 /*  DIFF: Array (LCS-based)                                            */
 /* ================================================================== */
 
-/* Simple LCS for element indices. Returns length of LCS and fills
- * lcs_a[0..ret-1] with indices from a, lcs_b[0..ret-1] from b. */
+/*
+ * LCS over element indices, returning the same alignment as the classic
+ * DP backtrack (walk back from the end, take a match whenever the elements
+ * are equal, otherwise drop an element of b if that keeps the LCS maximal,
+ * else an element of a) so patches are unchanged -- but in O((N+M)*D)
+ * time and near-linear space, D being the edit distance.
+ *
+ * Elements are first mapped to integer ids (equal elements share an id)
+ * so each element is hashed and deep-compared about once, and the common
+ * suffix is matched up front. Myers' forward pass then gives, per edit
+ * count d, V_d[k]: the furthest x on diagonal k = x - y reachable with at
+ * most d edits. Walking back through level d, "dropping b[j-1] keeps the
+ * LCS maximal" is exactly V_{d-1}[k+1] >= x. The walk needs every level,
+ * so levels are recomputed from checkpoints by halving, keeping
+ * O(D log D) of them live instead of the O(N*M) DP table.
+ */
+
+typedef struct {
+    const uint32_t *a, *b;      // element ids
+    ptrdiff_t n, m;
+    size_t *la, *lb;            // matches, filled back to front
+    size_t pos;
+} LcsCtx;
+
+#define LCS_LEAF_LEVELS 16
+
+/* Map elements of a and b to ids; returns the number of ids shared by
+ * both sides (0 means there is nothing to match). */
+static size_t intern_elements(EastValue **a, size_t na, EastValue **b, size_t nb,
+                              uint32_t *ida, uint32_t *idb)
+{
+    typedef struct { uint64_t hash; EastValue *rep; uint32_t id; uint8_t sides; } Slot;
+    size_t cap = 16;
+    while (cap < (na + nb) * 2) cap <<= 1;
+    Slot *slots = calloc(cap, sizeof(Slot));
+    if (!slots) return SIZE_MAX;
+
+    uint32_t next_id = 0;
+    size_t shared = 0;
+    for (int side = 0; side < 2; side++) {
+        EastValue **v = side ? b : a;
+        size_t n = side ? nb : na;
+        uint32_t *ids = side ? idb : ida;
+        for (size_t i = 0; i < n; i++) {
+            uint64_t h = east_value_hash(v[i]);
+            size_t j = (size_t)h & (cap - 1);
+            while (slots[j].rep &&
+                   (slots[j].hash != h || !east_value_equal(slots[j].rep, v[i])))
+                j = (j + 1) & (cap - 1);
+            if (!slots[j].rep) {
+                slots[j].hash = h;
+                slots[j].rep = v[i];
+                slots[j].id = next_id++;
+            }
+            if (!(slots[j].sides & (1u << side))) {
+                slots[j].sides |= (uint8_t)(1u << side);
+                if (slots[j].sides == 3) shared++;
+            }
+            ids[i] = slots[j].id;
+        }
+    }
+    free(slots);
+    return shared;
+}
+
+/* Compute level d of V from level d-1 (prev, indexed (k + d - 1) / 2);
+ * level d is indexed (k + d) / 2. -1 marks a diagonal outside the grid. */
+static void lcs_step(const LcsCtx *c, const ptrdiff_t *prev, ptrdiff_t *cur, ptrdiff_t d)
+{
+    for (ptrdiff_t t = 0; t <= d; t++) {
+        ptrdiff_t k = 2 * t - d;
+        if (k > c->n || k < -c->m) { cur[t] = -1; continue; }
+        ptrdiff_t end = c->n < c->m + k ? c->n : c->m + k;
+        ptrdiff_t x = -1;
+        if (d == 0) {
+            x = 0;
+        } else {
+            /* Moves that would leave the grid clamp to the end of the
+             * diagonal, which is then within d edits as well. */
+            if (k + 1 <= d - 1 && prev[t] >= 0)
+                x = prev[t] < end ? prev[t] : end;
+            if (k - 1 >= 1 - d && prev[t - 1] >= 0) {
+                ptrdiff_t xr = prev[t - 1] + 1 < end ? prev[t - 1] + 1 : end;
+                if (xr > x) x = xr;
+            }
+        }
+        if (x >= 0) {
+            ptrdiff_t y = x - k;
+            while (x < c->n && y < c->m && c->a[x] == c->b[y]) { x++; y++; }
+        }
+        cur[t] = x;
+    }
+}
+
+/* Walk back through level d from (*x, *y), recording matches, and take
+ * the one edit step down to level d - 1. prev is V_{d-1}. */
+static void lcs_walk_level(LcsCtx *c, const ptrdiff_t *prev, ptrdiff_t d,
+                           ptrdiff_t *x, ptrdiff_t *y)
+{
+    while (*x > 0 && *y > 0 && c->a[*x - 1] == c->b[*y - 1]) {
+        (*x)--; (*y)--;
+        c->pos--;
+        c->la[c->pos] = (size_t)*x;
+        c->lb[c->pos] = (size_t)*y;
+    }
+    ptrdiff_t k = *x - *y;
+    if (*y > 0 && k + 1 <= d - 1 && prev[(k + d) / 2] >= *x)
+        (*y)--;
+    else
+        (*x)--;
+}
+
+/* Walk from level hi down to level lo, given V_lo. */
+static bool lcs_walk_range(LcsCtx *c, const ptrdiff_t *v_lo, ptrdiff_t lo, ptrdiff_t hi,
+                           ptrdiff_t *x, ptrdiff_t *y)
+{
+    if (hi - lo <= LCS_LEAF_LEVELS) {
+        /* Materialize V_lo+1 .. V_hi-1, level L at offset base[L - lo] */
+        size_t total = 0;
+        for (ptrdiff_t L = lo + 1; L < hi; L++) total += (size_t)L + 1;
+        ptrdiff_t *buf = total ? malloc(total * sizeof(ptrdiff_t)) : NULL;
+        if (total && !buf) return false;
+        const ptrdiff_t *level[LCS_LEAF_LEVELS + 1];
+        level[0] = v_lo;
+        size_t off = 0;
+        for (ptrdiff_t L = lo + 1; L < hi; L++) {
+            lcs_step(c, level[L - 1 - lo], buf + off, L);
+            level[L - lo] = buf + off;
+            off += (size_t)L + 1;
+        }
+        for (ptrdiff_t d = hi; d > lo; d--)
+            lcs_walk_level(c, level[d - 1 - lo], d, x, y);
+        free(buf);
+        return true;
+    }
+
+    ptrdiff_t mid = lo + (hi - lo) / 2;
+    ptrdiff_t *v0 = malloc(((size_t)mid + 1) * sizeof(ptrdiff_t));
+    ptrdiff_t *v1 = malloc(((size_t)mid + 1) * sizeof(ptrdiff_t));
+    if (!v0 || !v1) { free(v0); free(v1); return false; }
+    const ptrdiff_t *prev = v_lo;
+    for (ptrdiff_t L = lo + 1; L <= mid; L++) {
+        ptrdiff_t *cur = (prev == v0) ? v1 : v0;
+        lcs_step(c, prev, cur, L);
+        prev = cur;
+    }
+    ptrdiff_t *v_mid = (ptrdiff_t *)prev;
+    free(v_mid == v0 ? v1 : v0);
+
+    bool ok = lcs_walk_range(c, v_mid, mid, hi, x, y);
+    free(v_mid);
+    return ok && lcs_walk_range(c, v_lo, lo, mid, x, y);
+}
+
+/* Returns length of the LCS and fills lcs_a[0..ret-1] with indices from a,
+ * lcs_b[0..ret-1] from b. */
 static size_t compute_lcs(EastValue **a, size_t na, EastValue **b, size_t nb,
                            size_t **out_a, size_t **out_b)
 {
-    /* DP table */
-    int *dp = calloc((na + 1) * (nb + 1), sizeof(int));
-    if (!dp) { *out_a = NULL; *out_b = NULL; return 0; }
-
-    for (size_t i = 1; i <= na; i++)
-        for (size_t j = 1; j <= nb; j++) {
-            if (east_value_equal(a[i-1], b[j-1]))
-                dp[i * (nb+1) + j] = dp[(i-1) * (nb+1) + (j-1)] + 1;
-            else
-                dp[i * (nb+1) + j] = dp[(i-1) * (nb+1) + j] > dp[i * (nb+1) + (j-1)]
-                    ? dp[(i-1) * (nb+1) + j] : dp[i * (nb+1) + (j-1)];
+    *out_a = NULL;
+    *out_b = NULL;
+
+    /* Common suffix: the backtrack matches it first */
+    size_t suffix = 0;
+    while (suffix < na && suffix < nb &&
+           east_value_equal(a[na - 1 - suffix], b[nb - 1 - suffix]))
+        suffix++;
+    size_t n = na - suffix, m = nb - suffix;
+
+    uint32_t *ida = malloc((n ? n : 1) * sizeof(uint32_t));
+    uint32_t *idb = malloc((m ? m : 1) * sizeof(uint32_t));
+    ptrdiff_t *v0 = NULL, *v1 = NULL, *v_start = NULL;
+    size_t *la = NULL, *lb = NULL;
+    size_t lcs_len = 0;
+    if (!ida || !idb) goto fail;
+
+    size_t shared = (n && m) ? intern_elements(a, n, b, m, ida, idb) : 0;
+    if (shared == SIZE_MAX) goto fail;
+
+    LcsCtx c = { ida, idb, (ptrdiff_t)n, (ptrdiff_t)m, NULL, NULL, 0 };
+    ptrdiff_t dtot = (ptrdiff_t)(n + m);
+    if (shared > 0) {
+        /* Forward pass to find the edit distance */
+        v0 = malloc((n + m + 1) * sizeof(ptrdiff_t));
+        v1 = malloc((n + m + 1) * sizeof(ptrdiff_t));
+        v_start = malloc(sizeof(ptrdiff_t));
+        if (!v0 || !v1 || !v_start) goto fail;
+        lcs_step(&c, NULL, v_start, 0);
+        const ptrdiff_t *prev = v_start;
+        for (ptrdiff_t d = 0; ; d++) {
+            ptrdiff_t k = c.n - c.m;
+            if (d >= (k < 0 ? -k : k) && ((d - k) & 1) == 0 &&
+                prev[(k + d) / 2] >= c.n) {
+                dtot = d;
+                break;
+            }
+            ptrdiff_t *cur = (prev == v0) ? v1 : v0;
+            lcs_step(&c, prev, cur, d + 1);
+            prev = cur;
         }
+        free(v0); v0 = NULL;
+        free(v1); v1 = NULL;
+    }
 
-    size_t lcs_len = (size_t)dp[na * (nb+1) + nb];
-    size_t *la = lcs_len > 0 ? malloc(lcs_len * sizeof(size_t)) : NULL;
-    size_t *lb = lcs_len > 0 ? malloc(lcs_len * sizeof(size_t)) : NULL;
-
-    /* Backtrack */
-    size_t pos = lcs_len;
-    size_t i = na, j = nb;
-    while (i > 0 && j > 0 && pos > 0) {
-        if (east_value_equal(a[i-1], b[j-1])) {
-            pos--;
-            la[pos] = i - 1;
-            lb[pos] = j - 1;
-            i--; j--;
-        } else if (dp[(i-1) * (nb+1) + j] > dp[i * (nb+1) + (j-1)]) {
-            i--;
-        } else {
-            j--;
+    size_t core = (n + m - (size_t)dtot) / 2;
+    lcs_len = core + suffix;
+    if (lcs_len > 0) {
+        la = malloc(lcs_len * sizeof(size_t));
+        lb = malloc(lcs_len * sizeof(size_t));
+        if (!la || !lb) goto fail;
+    }
+    for (size_t i = 0; i < suffix; i++) {
+        la[core + i] = n + i;
+        lb[core + i] = m + i;
+    }
+
+    if (core > 0) {
+        c.la = la;
+        c.lb = lb;
+        c.pos = core;
+        ptrdiff_t x = c.n, y = c.m;
+        if (!lcs_walk_range(&c, v_start, 0, dtot, &x, &y)) goto fail;
+        while (x > 0 && y > 0) {
+            x--; y--;
+            c.pos--;
+            la[c.pos] = (size_t)x;
+            lb[c.pos] = (size_t)y;
         }
     }
 
-    free(dp);
+    free(v_start);
+    free(ida);
+    free(idb);
     *out_a = la;
     *out_b = lb;
     return lcs_len;
+
+fail:
+    free(v0);
+    free(v1);
+    free(v_start);
+    free(ida);
+    free(idb);
+    free(la);
+    free(lb);
+    return 0;
+}
+
+/* The elements of arr as borrowed pointers. A columnar array keeps its
+ * column storage; its rows go in a new array that the caller frees. */
+static EastValue **array_rows(EastValue *arr, EastValue ***owned) {
+    *owned = NULL;
+    if (!arr->columnar) return arr->data.array.items;
+    size_t n = arr->data.array.len;
+    EastValue **rows = malloc((n ? n : 1) * sizeof(EastValue *));
+    if (!rows) return NULL;
+    for (size_t i = 0; i < n; i++) rows[i] = east_array_get(arr, i);
+    *owned = rows;
+    return rows;
 }
 
 static EastValue *diff_array(EastValue *before, EastValue *after, EastType *type) {
@@ -160,8 +380,14 @@ static EastValue *diff_array(EastValue *before, EastValue *after, EastType *type
     EastType *elem_type = type->data.element;
     size_t na = before->data.array.len;
     size_t nb = after->data.array.len;
-    EastValue **a = before->data.array.items;
-    EastValue **b = after->data.array.items;
+    EastValue **owned_a, **owned_b;
+    EastValue **a = array_rows(before, &owned_a);
+    EastValue **b = array_rows(after, &owned_b);
+    if (!a || !b) {
+        free(owned_a);
+        free(owned_b);
+        return NULL;
+    }
 
     size_t *lcs_a, *lcs_b;
     size_t lcs_len = compute_lcs(a, na, b, nb, &lcs_a, &lcs_b);
@@ -223,6 +449,8 @@ static EastValue *diff_array(EastValue *before, EastValue *after, EastType *type
 
     free(lcs_a);
     free(lcs_b);
+    free(owned_a);
+    free(owned_b);
 
     if (east_array_len(ops) == 0) {
         east_value_release(ops);
@@ -481,11 +709,11 @@ static EastValue *apply_array(EastValue *base, EastValue *patch_val, EastType *t
     /* Deep copy base into a mutable array */
     EastValue *result = east_array_new(base->data.array.elem_type);
     for (size_t i = 0; i < base->data.array.len; i++)
-        east_array_push(result, base->data.array.items[i]);
+        east_array_push(result, east_array_get(base, i));
 
     size_t nops = patch_val->data.array.len;
     for (size_t i = 0; i < nops; i++) {
-        EastValue *entry = patch_val->data.array.items[i];
+        EastValue *entry = east_array_get(patch_val, i);
         EastValue *key_v = east_struct_get_field(entry, "key");
         EastValue *offset_v = east_struct_get_field(entry, "offset");
         EastValue *op = east_struct_get_field(entry, "operation");
@@ -511,6 +739,7 @@ static EastValue *apply_array(EastValue *base, EastValue *patch_val, EastType *t
                 result->data.array.items = realloc(result->data.array.items,
                     new_cap * sizeof(EastValue *));
                 result->data.array.cap = new_cap;
+                east_value_mem_update(result);
             }
             size_t p = (size_t)pos;
             if (p > result->data.array.len) p = result->data.array.len;
@@ -553,17 +782,7 @@ static EastValue *apply_set(EastValue *base, EastValue *patch_val, EastType *typ
         EastValue *op = patch_val->data.dict.values[i];
         const char *tag = op->data.variant.case_name;
         if (strcmp(tag, "delete") == 0) {
-            /* Remove key from result set */
-            for (size_t j = 0; j < result->data.set.len; j++) {
-                if (east_value_equal(result->data.set.items[j], key)) {
-                    east_value_release(result->data.set.items[j]);
-                    memmove(&result->data.set.items[j],
-                            &result->data.set.items[j + 1],
-                            (result->data.set.len - j - 1) * sizeof(EastValue *));
-                    result->data.set.len--;
-                    break;
-                }
-            }
+            east_set_delete(result, key);
         } else if (strcmp(tag, "insert") == 0) {
             east_set_insert(result, key);
         }
@@ -591,16 +810,7 @@ static EastValue *apply_dict(EastValue *base, EastValue *patch_val, EastType *ty
         const char *tag = op->data.variant.case_name;
 
         if (strcmp(tag, "delete") == 0) {
-            /* Remove key — rebuild without it */
-            EastValue *new_result = east_dict_new(result->data.dict.key_type,
-                                                   result->data.dict.val_type);
-            for (size_t j = 0; j < result->data.dict.len; j++) {
-                if (!east_value_equal(result->data.dict.keys[j], key))
-                    east_dict_set(new_result, result->data.dict.keys[j],
-                                  result->data.dict.values[j]);
-            }
-            east_value_release(result);
-            result = new_result;
+            east_dict_delete(result, key);
         } else if (strcmp(tag, "insert") == 0) {
             EastValue *val = op->data.variant.value;
             east_dict_set(result, key, val);
@@ -905,9 +1115,9 @@ static EastValue *compose_array(EastValue *first, EastValue *second, EastType *t
     /* Concatenate operations */
     EastValue *result = east_array_new(NULL);
     for (size_t i = 0; i < first->data.array.len; i++)
-        east_array_push(result, first->data.array.items[i]);
+        east_array_push(result, east_array_get(first, i));
     for (size_t i = 0; i < second->data.array.len; i++)
-        east_array_push(result, second->data.array.items[i]);
+        east_array_push(result, east_array_get(second, i));
 
     if (east_array_len(result) == 0) {
         east_value_release(result);
@@ -1004,7 +1214,7 @@ static EastValue *invert_array(EastValue *patch_val, EastType *type) {
 
     /* Reverse order and invert each operation */
     for (size_t i = n; i > 0; i--) {
-        EastValue *entry = patch_val->data.array.items[i - 1];
+        EastValue *entry = east_array_get(patch_val, i - 1);
         EastValue *key_v = east_struct_get_field(entry, "key");
         EastValue *offset_v = east_struct_get_field(entry, "offset");
         EastValue *op = east_struct_get_field(entry, "operation");
@@ -1202,6 +1412,11 @@ static EastValue *do_invert(EastValue *patch, EastType *type) {
 static EastValue *patch_diff_impl(EastValue **args, size_t n) {
     (void)n;
     rec_depth = 0;
+    /* Hash both sides once up front: every container then carries its
+     * structural hash, and the equality checks at each level of the diff
+     * reject differing subtrees without descending into them. */
+    east_value_hash(args[0]);
+    east_value_hash(args[1]);
     return do_diff(args[0], args[1], s_patch_type);
 }
 
@@ -98,6 +98,7 @@ static EastValue *set_clear_impl(EastValue **args, size_t n) {
     for (size_t i = 0; i < s->data.set.len; i++)
         east_value_release(s->data.set.items[i]);
     s->data.set.len = 0;
+    east_value_invalidate_hashes();
     return east_null();
 }
 
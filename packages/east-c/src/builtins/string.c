@@ -10,6 +10,7 @@
  */
 #include "east/builtins.h"
 #include "east/values.h"
+#include "east/search.h"
 #include "east/serialization.h"
 #include <ctype.h>
 #include <locale.h>
@@ -32,43 +33,6 @@ static inline size_t utf8_char_len(const unsigned char *p) {
     return 1; /* invalid byte — advance 1 */
 }
 
-/* Count the number of Unicode codepoints in a UTF-8 string. */
-static size_t utf8_codepoint_count(const char *s, size_t byte_len) {
-    size_t count = 0;
-    const unsigned char *p = (const unsigned char *)s;
-    const unsigned char *end = p + byte_len;
-    while (p < end) {
-        p += utf8_char_len(p);
-        count++;
-    }
-    return count;
-}
-
-/* Convert a codepoint index to a byte offset.
- * Returns byte_len if cp_index >= total codepoints. */
-static size_t utf8_cp_to_byte(const char *s, size_t byte_len, size_t cp_index) {
-    const unsigned char *p = (const unsigned char *)s;
-    const unsigned char *end = p + byte_len;
-    size_t cp = 0;
-    while (p < end && cp < cp_index) {
-        p += utf8_char_len(p);
-        cp++;
-    }
-    return (size_t)(p - (const unsigned char *)s);
-}
-
-/* Convert a byte offset to a codepoint index. */
-static size_t utf8_byte_to_cp(const char *s, size_t byte_offset) {
-    const unsigned char *p = (const unsigned char *)s;
-    const unsigned char *target = p + byte_offset;
-    size_t cp = 0;
-    while (p < target) {
-        p += utf8_char_len(p);
-        cp++;
-    }
-    return cp;
-}
-
 /* ------------------------------------------------------------------ */
 /*  Basic string operations                                            */
 /* ------------------------------------------------------------------ */
@@ -79,14 +43,10 @@ static EastValue *string_concat(EastValue **args, size_t n) {
     size_t alen = args[0]->data.string.len;
     const char *b = args[1]->data.string.data;
     size_t blen = args[1]->data.string.len;
-    size_t total = alen + blen;
-    char *buf = malloc(total + 1);
-    if (!buf) return east_string("");
-    memcpy(buf, a, alen);
-    memcpy(buf + alen, b, blen);
-    buf[total] = '\0';
-    EastValue *result = east_string_len(buf, total);
-    free(buf);
+    EastValue *result = east_string_len(NULL, alen + blen);
+    if (!result) return east_string("");
+    memcpy(result->data.string.data, a, alen);
+    memcpy(result->data.string.data + alen, b, blen);
     return result;
 }
 
@@ -96,31 +56,28 @@ static EastValue *string_repeat(EastValue **args, size_t n) {
     size_t slen = args[0]->data.string.len;
     int64_t count = args[1]->data.integer;
     if (count <= 0 || slen == 0) return east_string("");
+    EastValue *result = east_string_len(NULL, slen * (size_t)count);
+    if (!result) return east_string("");
+    /* Copy the bytes written so far onto the end, doubling each time */
+    char *buf = result->data.string.data;
     size_t total = slen * (size_t)count;
-    char *buf = malloc(total + 1);
-    if (!buf) return east_string("");
-    for (int64_t i = 0; i < count; i++) {
-        memcpy(buf + i * slen, s, slen);
+    memcpy(buf, s, slen);
+    for (size_t done = slen; done < total; done *= 2) {
+        memcpy(buf + done, buf, done < total - done ? done : total - done);
     }
-    buf[total] = '\0';
-    EastValue *result = east_string_len(buf, total);
-    free(buf);
     return result;
 }
 
 /* StringLength — returns Unicode codepoint count (like JS for...of) */
 static EastValue *string_length(EastValue **args, size_t n) {
     (void)n;
-    size_t cp_count = utf8_codepoint_count(args[0]->data.string.data,
-                                            args[0]->data.string.len);
-    return east_integer((int64_t)cp_count);
+    return east_integer((int64_t)east_string_cp_len(args[0]));
 }
 
 /* StringSubstring — takes codepoint indices (like JS) */
 static EastValue *string_substring(EastValue **args, size_t n) {
     (void)n;
     const char *s = args[0]->data.string.data;
-    size_t byte_len = args[0]->data.string.len;
     int64_t from = args[1]->data.integer;
     int64_t to = args[2]->data.integer;
 
@@ -129,12 +86,12 @@ static EastValue *string_substring(EastValue **args, size_t n) {
     if (to < 0) to = 0;
     if (from > to) to = from;
 
-    size_t total_cp = utf8_codepoint_count(s, byte_len);
+    size_t total_cp = east_string_cp_len(args[0]);
     if ((size_t)from >= total_cp) return east_string("");
     if ((size_t)to > total_cp) to = (int64_t)total_cp;
 
-    size_t byte_from = utf8_cp_to_byte(s, byte_len, (size_t)from);
-    size_t byte_to = utf8_cp_to_byte(s, byte_len, (size_t)to);
+    size_t byte_from = east_string_cp_to_byte(args[0], (size_t)from);
+    size_t byte_to = east_string_cp_to_byte(args[0], (size_t)to);
     return east_string_len(s + byte_from, byte_to - byte_from);
 }
 
@@ -142,12 +99,11 @@ static EastValue *string_substring(EastValue **args, size_t n) {
 static EastValue *string_index_of(EastValue **args, size_t n) {
     (void)n;
     const char *s = args[0]->data.string.data;
-    const char *sub = args[1]->data.string.data;
-    const char *found = strstr(s, sub);
+    const char *found = east_find(s, args[0]->data.string.len,
+                                  args[1]->data.string.data, args[1]->data.string.len);
     if (!found) return east_integer(-1);
     /* Convert byte offset to codepoint index */
-    size_t byte_offset = (size_t)(found - s);
-    size_t cp_index = utf8_byte_to_cp(s, byte_offset);
+    size_t cp_index = east_string_byte_to_cp(args[0], (size_t)(found - s));
     return east_integer((int64_t)cp_index);
 }
 
@@ -179,11 +135,13 @@ static EastValue *string_split(EastValue **args, size_t n) {
             }
         }
     } else {
+        EastFinder finder;
+        east_finder_init(&finder, delim, dlen);
         const char *pos = s;
         const char *end = s + slen;
         while (pos <= end) {
-            const char *found = strstr(pos, delim);
-            if (!found || found > end) {
+            const char *found = east_finder_next(&finder, pos, (size_t)(end - pos));
+            if (!found) {
                 EastValue *part = east_string_len(pos, (size_t)(end - pos));
                 east_array_push(arr, part);
                 east_value_release(part);
@@ -308,11 +266,11 @@ static EastValue *string_replace(EastValue **args, size_t n) {
 
     if (old_len == 0) {
         /* JS replaceAll("", x) inserts x before each char and at the end */
-        size_t cp_count = utf8_codepoint_count(s, slen);
+        size_t cp_count = east_string_cp_len(args[0]);
         size_t result_len = slen + new_len * (cp_count + 1);
-        char *buf = malloc(result_len + 1);
-        if (!buf) return east_string("");
-        char *dst = buf;
+        EastValue *result = east_string_len(NULL, result_len);
+        if (!result) return east_string("");
+        char *dst = result->data.string.data;
         const unsigned char *p = (const unsigned char *)s;
         const unsigned char *end = p + slen;
         /* Insert replacement before each codepoint */
@@ -326,29 +284,28 @@ static EastValue *string_replace(EastValue **args, size_t n) {
         }
         /* Insert replacement at end */
         memcpy(dst, new_str, new_len);
-        dst += new_len;
-        *dst = '\0';
-        EastValue *result = east_string_len(buf, (size_t)(dst - buf));
-        free(buf);
         return result;
     }
 
     /* Count occurrences */
+    EastFinder finder;
+    east_finder_init(&finder, old_str, old_len);
+    const char *end = s + slen;
     size_t count = 0;
     const char *p = s;
-    while ((p = strstr(p, old_str)) != NULL) {
+    while ((p = east_finder_next(&finder, p, (size_t)(end - p))) != NULL) {
         count++;
         p += old_len;
     }
     if (count == 0) return east_string_len(s, slen);
 
     size_t result_len = slen + count * new_len - count * old_len;
-    char *buf = malloc(result_len + 1);
-    if (!buf) return east_string("");
+    EastValue *result = east_string_len(NULL, result_len);
+    if (!result) return east_string("");
 
-    char *dst = buf;
+    char *dst = result->data.string.data;
     const char *src = s;
-    while ((p = strstr(src, old_str)) != NULL) {
+    while ((p = east_finder_next(&finder, src, (size_t)(end - src))) != NULL) {
         size_t prefix = (size_t)(p - src);
         memcpy(dst, src, prefix);
         dst += prefix;
@@ -358,11 +315,6 @@ static EastValue *string_replace(EastValue **args, size_t n) {
     }
     size_t remaining = slen - (size_t)(src - s);
     memcpy(dst, src, remaining);
-    dst += remaining;
-    *dst = '\0';
-
-    EastValue *result = east_string_len(buf, result_len);
-    free(buf);
     return result;
 }
 
@@ -388,9 +340,8 @@ static EastValue *string_ends_with(EastValue **args, size_t n) {
 
 static EastValue *string_contains(EastValue **args, size_t n) {
     (void)n;
-    const char *s = args[0]->data.string.data;
-    const char *sub = args[1]->data.string.data;
-    return east_boolean(strstr(s, sub) != NULL);
+    return east_boolean(east_find(args[0]->data.string.data, args[0]->data.string.len,
+                                  args[1]->data.string.data, args[1]->data.string.len) != NULL);
 }
 
 /* ------------------------------------------------------------------ */
@@ -468,9 +419,7 @@ static EastValue *regex_index_of(EastValue **args, size_t n) {
     int64_t result = -1;
     if (rc >= 0) {
         PCRE2_SIZE *ovector = pcre2_get_ovector_pointer(md);
-        size_t byte_offset = ovector[0];
-        /* Convert byte offset to codepoint index */
-        result = (int64_t)utf8_byte_to_cp(text, byte_offset);
+        result = (int64_t)east_string_byte_to_cp(args[0], ovector[0]);
     }
 
     pcre2_match_data_free(md);
@@ -675,14 +624,8 @@ static EastValue *regex_replace(EastValue **args, size_t n) {
     pcre2_match_data_free(md);
     pcre2_code_free(re);
 
-    EastValue *result;
-    if (buf.data) {
-        result = east_string_len(buf.data, buf.len);
-        free(buf.data);
-    } else {
-        result = east_string("");
-    }
-    return result;
+    if (!buf.data) return east_string("");
+    return east_string_adopt(buf.data, buf.len);
 }
 
 /* ------------------------------------------------------------------ */
@@ -695,9 +638,7 @@ static EastValue *string_print_east_impl(EastValue **args, size_t n) {
     (void)n;
     char *text = east_print_value(args[0], s_print_east_type);
     if (!text) return east_string("");
-    EastValue *result = east_string(text);
-    free(text);
-    return result;
+    return east_string_adopt(text, strlen(text));
 }
 
 /* Parse: East text format string -> value (type-parameterized) */
@@ -727,9 +668,7 @@ static EastValue *string_print_json_impl(EastValue **args, size_t n) {
     (void)n;
     char *json = east_json_encode(args[0], s_print_json_type);
     if (!json) return east_string("null");
-    EastValue *result = east_string(json);
-    free(json);
-    return result;
+    return east_string_adopt(json, strlen(json));
 }
 
 /* StringParseJSON: JSON string -> value */
@@ -7,6 +7,7 @@
  */
 #include "east/builtins.h"
 #include "east/compiler.h"
+#include "east/kernels.h"
 #include "east/values.h"
 #include <stdio.h>
 #include <stdlib.h>
@@ -95,7 +96,12 @@ static EastValue *vector_set_impl(EastValue **args, size_t n) {
         east_builtin_error(msg);
         return NULL;
     }
+    if (!east_value_make_writable(args[0])) {
+        east_builtin_error("VectorSet: out of memory");
+        return NULL;
+    }
     vec_set_elem(args[0], (size_t)idx, args[2]);
+    east_value_invalidate_hashes();
     return east_null();
 }
 
@@ -253,6 +259,189 @@ static EastValue *vector_fold_impl(EastValue **args, size_t n) {
     return acc;
 }
 
+/* ------------------------------------------------------------------ */
+/* Native numeric builtins (see east/kernels.h)                        */
+/*                                                                     */
+/* The second operand of arithmetic and comparisons is either a vector */
+/* of the same element type and length, or a scalar that is broadcast. */
+/* ------------------------------------------------------------------ */
+
+static bool check_numeric(const char *builtin, EastValue *vec) {
+    EastTypeKind k = vec->data.vector.elem_type->kind;
+    if (k == EAST_TYPE_FLOAT || k == EAST_TYPE_INTEGER) return true;
+    char msg[128];
+    snprintf(msg, sizeof(msg), "%s requires a Float or Integer vector", builtin);
+    east_builtin_error(msg);
+    return false;
+}
+
+static bool check_same_length(const char *builtin, EastValue *a, EastValue *b) {
+    if (a->data.vector.len == b->data.vector.len) return true;
+    char msg[128];
+    snprintf(msg, sizeof(msg), "%s: vector lengths differ (%zu vs %zu)",
+             builtin, a->data.vector.len, b->data.vector.len);
+    east_builtin_error(msg);
+    return false;
+}
+
+/* Validates the second operand; *vv is set when it is a vector. */
+static bool check_operand(const char *builtin, EastValue *a, EastValue *b, bool *vv) {
+    EastTypeKind k = a->data.vector.elem_type->kind;
+    *vv = b->kind == EAST_VAL_VECTOR;
+    if (*vv) {
+        if (b->data.vector.elem_type->kind == k) return check_same_length(builtin, a, b);
+    } else if (b->kind == EAST_VAL_INTEGER ||
+               (b->kind == EAST_VAL_FLOAT && k == EAST_TYPE_FLOAT)) {
+        return true;
+    }
+    char msg[128];
+    snprintf(msg, sizeof(msg), "%s: operand does not match the vector element type", builtin);
+    east_builtin_error(msg);
+    return false;
+}
+
+static double scalar_f64(EastValue *v) {
+    return v->kind == EAST_VAL_INTEGER ? (double)v->data.integer : v->data.float64;
+}
+
+static EastValue *vector_arith(EastValue **args, EastArithOp op, const char *builtin) {
+    EastValue *a = args[0], *b = args[1];
+    bool vv;
+    if (!check_numeric(builtin, a) || !check_operand(builtin, a, b, &vv)) return NULL;
+    EastType *et = a->data.vector.elem_type;
+    size_t len = a->data.vector.len;
+    EastValue *result = east_vector_new(et, len);
+    if (et->kind == EAST_TYPE_FLOAT)
+        east_kernel_arith_f64(op, result->data.vector.data, a->data.vector.data,
+                              vv ? b->data.vector.data : NULL,
+                              vv ? 0 : scalar_f64(b), len);
+    else
+        east_kernel_arith_i64(op, result->data.vector.data, a->data.vector.data,
+                              vv ? b->data.vector.data : NULL,
+                              vv ? 0 : b->data.integer, len);
+    return result;
+}
+
+static EastValue *vector_compare(EastValue **args, EastCmpOp op, const char *builtin) {
+    EastValue *a = args[0], *b = args[1];
+    bool vv;
+    if (!check_numeric(builtin, a) || !check_operand(builtin, a, b, &vv)) return NULL;
+    size_t len = a->data.vector.len;
+    EastValue *result = east_vector_new(&east_boolean_type, len);
+    if (a->data.vector.elem_type->kind == EAST_TYPE_FLOAT)
+        east_kernel_compare_f64(op, result->data.vector.data, a->data.vector.data,
+                                vv ? b->data.vector.data : NULL,
+                                vv ? 0 : scalar_f64(b), len);
+    else
+        east_kernel_compare_i64(op, result->data.vector.data, a->data.vector.data,
+                                vv ? b->data.vector.data : NULL,
+                                vv ? 0 : b->data.integer, len);
+    return result;
+}
+
+static EastValue *vector_add_impl(EastValue **args, size_t n) { (void)n; return vector_arith(args, EAST_ARITH_ADD, "VectorAdd"); }
+static EastValue *vector_subtract_impl(EastValue **args, size_t n) { (void)n; return vector_arith(args, EAST_ARITH_SUB, "VectorSubtract"); }
+static EastValue *vector_multiply_impl(EastValue **args, size_t n) { (void)n; return vector_arith(args, EAST_ARITH_MUL, "VectorMultiply"); }
+static EastValue *vector_divide_impl(EastValue **args, size_t n) { (void)n; return vector_arith(args, EAST_ARITH_DIV, "VectorDivide"); }
+
+static EastValue *vector_equal_impl(EastValue **args, size_t n) { (void)n; return vector_compare(args, EAST_CMP_EQ, "VectorEqual"); }
+static EastValue *vector_not_equal_impl(EastValue **args, size_t n) { (void)n; return vector_compare(args, EAST_CMP_NE, "VectorNotEqual"); }
+static EastValue *vector_less_impl(EastValue **args, size_t n) { (void)n; return vector_compare(args, EAST_CMP_LT, "VectorLess"); }
+static EastValue *vector_less_equal_impl(EastValue **args, size_t n) { (void)n; return vector_compare(args, EAST_CMP_LE, "VectorLessEqual"); }
+static EastValue *vector_greater_impl(EastValue **args, size_t n) { (void)n; return vector_compare(args, EAST_CMP_GT, "VectorGreater"); }
+static EastValue *vector_greater_equal_impl(EastValue **args, size_t n) { (void)n; return vector_compare(args, EAST_CMP_GE, "VectorGreaterEqual"); }
+
+static EastValue *vector_dot_impl(EastValue **args, size_t n) {
+    (void)n;
+    EastValue *a = args[0], *b = args[1];
+    bool vv;
+    if (!check_numeric("VectorDot", a) || !check_operand("VectorDot", a, b, &vv)) return NULL;
+    if (!vv) {
+        east_builtin_error("VectorDot requires two vectors");
+        return NULL;
+    }
+    size_t len = a->data.vector.len;
+    if (a->data.vector.elem_type->kind == EAST_TYPE_FLOAT)
+        return east_float(east_kernel_dot_f64(a->data.vector.data, b->data.vector.data, len));
+    return east_integer(east_kernel_dot_i64(a->data.vector.data, b->data.vector.data, len));
+}
+
+static EastValue *vector_sum_impl(EastValue **args, size_t n) {
+    (void)n;
+    EastValue *vec = args[0];
+    if (!check_numeric("VectorSum", vec)) return NULL;
+    if (vec->data.vector.elem_type->kind == EAST_TYPE_FLOAT)
+        return east_float(east_kernel_sum_f64(vec->data.vector.data, vec->data.vector.len));
+    return east_integer(east_kernel_sum_i64(vec->data.vector.data, vec->data.vector.len));
+}
+
+/* Mean is always a Float (NaN for an empty vector). */
+static EastValue *vector_mean_impl(EastValue **args, size_t n) {
+    (void)n;
+    EastValue *vec = args[0];
+    if (!check_numeric("VectorMean", vec)) return NULL;
+    size_t len = vec->data.vector.len;
+    double sum = vec->data.vector.elem_type->kind == EAST_TYPE_FLOAT
+        ? east_kernel_sum_f64(vec->data.vector.data, len)
+        : east_kernel_sum_i64_as_f64(vec->data.vector.data, len);
+    return east_float(sum / (double)len);
+}
+
+static EastValue *vector_cumulative_sum_impl(EastValue **args, size_t n) {
+    (void)n;
+    EastValue *vec = args[0];
+    if (!check_numeric("VectorCumulativeSum", vec)) return NULL;
+    size_t len = vec->data.vector.len;
+    EastValue *result = east_vector_new(vec->data.vector.elem_type, len);
+    if (vec->data.vector.elem_type->kind == EAST_TYPE_FLOAT)
+        east_kernel_cumsum_f64(result->data.vector.data, vec->data.vector.data, len);
+    else
+        east_kernel_cumsum_i64(result->data.vector.data, vec->data.vector.data, len);
+    return result;
+}
+
+/* Index of the first minimum (want_max false) or maximum, or -1 on error. */
+static int64_t vector_extremum(EastValue *vec, bool want_max, const char *builtin) {
+    if (!check_numeric(builtin, vec)) return -1;
+    size_t len = vec->data.vector.len;
+    if (len == 0) {
+        char msg[128];
+        snprintf(msg, sizeof(msg), "%s of an empty Vector", builtin);
+        east_builtin_error(msg);
+        return -1;
+    }
+    const void *data = vec->data.vector.data;
+    if (vec->data.vector.elem_type->kind == EAST_TYPE_FLOAT)
+        return (int64_t)(want_max ? east_kernel_argmax_f64(data, len)
+                                  : east_kernel_argmin_f64(data, len));
+    return (int64_t)(want_max ? east_kernel_argmax_i64(data, len)
+                              : east_kernel_argmin_i64(data, len));
+}
+
+static EastValue *vector_min_impl(EastValue **args, size_t n) {
+    (void)n;
+    int64_t i = vector_extremum(args[0], false, "VectorMin");
+    return i < 0 ? NULL : vec_get_elem(args[0], (size_t)i);
+}
+
+static EastValue *vector_max_impl(EastValue **args, size_t n) {
+    (void)n;
+    int64_t i = vector_extremum(args[0], true, "VectorMax");
+    return i < 0 ? NULL : vec_get_elem(args[0], (size_t)i);
+}
+
+static EastValue *vector_arg_min_impl(EastValue **args, size_t n) {
+    (void)n;
+    int64_t i = vector_extremum(args[0], false, "VectorArgMin");
+    return i < 0 ? NULL : east_integer(i);
+}
+
+static EastValue *vector_arg_max_impl(EastValue **args, size_t n) {
+    (void)n;
+    int64_t i = vector_extremum(args[0], true, "VectorArgMax");
+    return i < 0 ? NULL : east_integer(i);
+}
+
 /* --- typed factory functions that use type params for zeros/ones/fill --- */
 
 static BuiltinImpl vector_zeros_typed_factory(EastType **tp, size_t ntp) {
@@ -295,6 +484,28 @@ static BuiltinImpl vector_map_factory(EastType **tp, size_t ntp) {
 }
 static BuiltinImpl vector_fold_factory(EastType **tp, size_t ntp) { (void)tp; (void)ntp; return vector_fold_impl; }
 
+/* The numeric builtins dispatch on the vector's element type at run time. */
+#define VECTOR_FACTORY(name) \
+    static BuiltinImpl name##_factory(EastType **tp, size_t ntp) { (void)tp; (void)ntp; return name##_impl; }
+VECTOR_FACTORY(vector_add)
+VECTOR_FACTORY(vector_subtract)
+VECTOR_FACTORY(vector_multiply)
+VECTOR_FACTORY(vector_divide)
+VECTOR_FACTORY(vector_equal)
+VECTOR_FACTORY(vector_not_equal)
+VECTOR_FACTORY(vector_less)
+VECTOR_FACTORY(vector_less_equal)
+VECTOR_FACTORY(vector_greater)
+VECTOR_FACTORY(vector_greater_equal)
+VECTOR_FACTORY(vector_dot)
+VECTOR_FACTORY(vector_sum)
+VECTOR_FACTORY(vector_mean)
+VECTOR_FACTORY(vector_cumulative_sum)
+VECTOR_FACTORY(vector_min)
+VECTOR_FACTORY(vector_max)
+VECTOR_FACTORY(vector_arg_min)
+VECTOR_FACTORY(vector_arg_max)
+
 /* --- registration --- */
 
 void east_register_vector_builtins(BuiltinRegistry *reg) {
@@ -311,4 +522,22 @@ void east_register_vector_builtins(BuiltinRegistry *reg) {
     builtin_registry_register(reg, "VectorFill", vector_fill_typed_factory);
     builtin_registry_register(reg, "VectorMap", vector_map_factory);
     builtin_registry_register(reg, "VectorFold", vector_fold_factory);
+    builtin_registry_register(reg, "VectorAdd", vector_add_factory);
+    builtin_registry_register(reg, "VectorSubtract", vector_subtract_factory);
+    builtin_registry_register(reg, "VectorMultiply", vector_multiply_factory);
+    builtin_registry_register(reg, "VectorDivide", vector_divide_factory);
+    builtin_registry_register(reg, "VectorEqual", vector_equal_factory);
+    builtin_registry_register(reg, "VectorNotEqual", vector_not_equal_factory);
+    builtin_registry_register(reg, "VectorLess", vector_less_factory);
+    builtin_registry_register(reg, "VectorLessEqual", vector_less_equal_factory);
+    builtin_registry_register(reg, "VectorGreater", vector_greater_factory);
+    builtin_registry_register(reg, "VectorGreaterEqual", vector_greater_equal_factory);
+    builtin_registry_register(reg, "VectorDot", vector_dot_factory);
+    builtin_registry_register(reg, "VectorSum", vector_sum_factory);
+    builtin_registry_register(reg, "VectorMean", vector_mean_factory);
+    builtin_registry_register(reg, "VectorCumulativeSum", vector_cumulative_sum_factory);
+    builtin_registry_register(reg, "VectorMin", vector_min_factory);
+    builtin_registry_register(reg, "VectorMax", vector_max_factory);
+    builtin_registry_register(reg, "VectorArgMin", vector_arg_min_factory);
+    builtin_registry_register(reg, "VectorArgMax", vector_arg_max_factory);
 }
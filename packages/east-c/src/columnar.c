@@ -0,0 +1,460 @@
+/*
+ * Columnar Array<Struct> storage (see east/columnar.h).
+ */
+#include "east/columnar.h"
+#include "east/arena.h"
+#include "east/memory.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* ------------------------------------------------------------------ */
+/*  Schema                                                             */
+/* ------------------------------------------------------------------ */
+
+/* Option<T> = Variant { none: Null, some: T }, cases sorted by name */
+static bool is_option_type(EastType *t) {
+    return t->kind == EAST_TYPE_VARIANT && t->data.variant.num_cases == 2 &&
+           strcmp(t->data.variant.cases[0].name, "none") == 0 &&
+           strcmp(t->data.variant.cases[1].name, "some") == 0;
+}
+
+static bool column_kind(EastType *t, EastColumnKind *out) {
+    switch (t->kind) {
+    case EAST_TYPE_NULL:     *out = EAST_COL_NULL; return true;
+    case EAST_TYPE_BOOLEAN:  *out = EAST_COL_BOOLEAN; return true;
+    case EAST_TYPE_INTEGER:  *out = EAST_COL_INTEGER; return true;
+    case EAST_TYPE_FLOAT:    *out = EAST_COL_FLOAT; return true;
+    case EAST_TYPE_STRING:   *out = EAST_COL_STRING; return true;
+    case EAST_TYPE_DATETIME: *out = EAST_COL_DATETIME; return true;
+    default:                 return false;
+    }
+}
+
+static bool field_kind(EastType *ft, EastColumnKind *out, bool *optional) {
+    *optional = is_option_type(ft);
+    return column_kind(*optional ? ft->data.variant.cases[1].type : ft, out);
+}
+
+bool east_columnar_supported(EastType *struct_type) {
+    if (!struct_type || struct_type->kind != EAST_TYPE_STRUCT) return false;
+    size_t nf = struct_type->data.struct_.num_fields;
+    if (nf == 0) return false;
+    for (size_t f = 0; f < nf; f++) {
+        EastColumnKind kind;
+        bool optional;
+        if (!field_kind(struct_type->data.struct_.fields[f].type, &kind, &optional))
+            return false;
+    }
+    return true;
+}
+
+static size_t value_size(EastColumnKind kind) {
+    switch (kind) {
+    case EAST_COL_BOOLEAN:  return sizeof(bool);
+    case EAST_COL_INTEGER:
+    case EAST_COL_DATETIME: return sizeof(int64_t);
+    case EAST_COL_FLOAT:    return sizeof(double);
+    case EAST_COL_STRING:   return sizeof(uint32_t);
+    default:                return 0;
+    }
+}
+
+/* ------------------------------------------------------------------ */
+/*  Construction                                                       */
+/* ------------------------------------------------------------------ */
+
+static bool columns_reserve(EastColumns *c, size_t need) {
+    if (need <= c->cap) return true;
+    size_t cap = c->cap ? c->cap * 2 : 16;
+    if (cap < need) cap = need;
+    for (size_t f = 0; f < c->num_fields; f++) {
+        EastColumn *col = &c->cols[f];
+        size_t es = value_size(col->kind);
+        if (es) {
+            void *d = realloc(col->data.integer, cap * es);
+            if (!d) return false;
+            col->data.integer = d;
+        }
+        if (col->option_type) {
+            size_t old_bytes = (c->cap + 7) / 8, bytes = (cap + 7) / 8;
+            uint8_t *p = realloc(col->present, bytes);
+            if (!p) return false;
+            memset(p + old_bytes, 0, bytes - old_bytes);
+            col->present = p;
+        }
+    }
+    c->cap = cap;
+    return true;
+}
+
+static EastColumns *columns_new(EastType *struct_type) {
+    EastColumns *c = east_calloc(1, sizeof(EastColumns));
+    if (!c) return NULL;
+    size_t nf = struct_type->data.struct_.num_fields;
+    c->cols = east_calloc(nf, sizeof(EastColumn));
+    c->names = east_alloc(nf * sizeof(char *));
+    if (!c->cols || !c->names) {
+        east_free(c->cols);
+        east_free(c->names);
+        east_free(c);
+        return NULL;
+    }
+    c->row_type = struct_type;
+    east_type_retain(struct_type);
+    c->num_fields = nf;
+    for (size_t f = 0; f < nf; f++) {
+        EastTypeField *field = &struct_type->data.struct_.fields[f];
+        bool optional;
+        field_kind(field->type, &c->cols[f].kind, &optional);
+        c->cols[f].option_type = optional ? field->type : NULL;
+        c->names[f] = field->name;
+    }
+    return c;
+}
+
+EastValue *east_columnar_array_new(EastType *struct_type, size_t capacity) {
+    EastColumns *c = columns_new(struct_type);
+    if (!c) return NULL;
+    if (!columns_reserve(c, capacity)) {
+        east_columns_free(c);
+        return NULL;
+    }
+    EastValue *arr = east_array_new(struct_type);
+    if (!arr) {
+        east_columns_free(c);
+        return NULL;
+    }
+    east_free(arr->data.array.items);
+    arr->data.array.items = NULL;
+    arr->data.array.columns = c;
+    arr->columnar = true;
+    east_value_mem_update(arr);
+    return arr;
+}
+
+size_t east_columnar_add_row(EastValue *arr) {
+    EastColumns *c = arr->data.array.columns;
+    bool grown = c->len == c->cap;
+    if (!columns_reserve(c, c->len + 1)) return SIZE_MAX;
+    /* Keep the row cache as long as the columns */
+    if (arr->data.array.items && c->rows_cap <= c->len) {
+        size_t cap = c->rows_cap * 2;
+        EastValue **items = east_realloc(arr->data.array.items,
+                                         c->rows_cap * sizeof(EastValue *),
+                                         cap * sizeof(EastValue *));
+        if (!items) return SIZE_MAX;
+        memset(items + c->rows_cap, 0, (cap - c->rows_cap) * sizeof(EastValue *));
+        arr->data.array.items = items;
+        c->rows_cap = cap;
+        grown = true;
+    }
+    size_t row = c->len++;
+    arr->data.array.len = c->len;
+    for (size_t f = 0; f < c->num_fields; f++) {
+        EastColumn *col = &c->cols[f];
+        size_t es = value_size(col->kind);
+        if (es) memset((char *)col->data.integer + row * es, 0, es);
+        if (col->present) col->present[row >> 3] &= (uint8_t)~(1u << (row & 7));
+    }
+    if (grown) east_value_mem_update(arr);
+    east_value_invalidate_hashes();
+    return row;
+}
+
+static inline void mark_present(EastColumn *col, size_t row) {
+    if (col->present) col->present[row >> 3] |= (uint8_t)(1u << (row & 7));
+}
+
+void east_column_set_boolean(EastColumn *col, size_t row, bool v) {
+    col->data.boolean[row] = v;
+    mark_present(col, row);
+}
+
+void east_column_set_integer(EastColumn *col, size_t row, int64_t v) {
+    col->data.integer[row] = v;
+    mark_present(col, row);
+}
+
+void east_column_set_float(EastColumn *col, size_t row, double v) {
+    col->data.float64[row] = v;
+    mark_present(col, row);
+}
+
+void east_column_set_null(EastColumn *col, size_t row) {
+    if (col->present) col->present[row >> 3] &= (uint8_t)~(1u << (row & 7));
+}
+
+/* ------------------------------------------------------------------ */
+/*  String dictionary                                                  */
+/* ------------------------------------------------------------------ */
+
+static uint64_t hash_str(const char *s, size_t len) {
+    uint64_t h = 0xcbf29ce484222325ull;
+    for (size_t i = 0; i < len; i++) {
+        h ^= (unsigned char)s[i];
+        h *= 0x100000001b3ull;
+    }
+    return h;
+}
+
+static bool lookup_grow(EastColumn *col) {
+    size_t cap = col->lookup_cap ? col->lookup_cap * 2 : 64;
+    uint32_t *slots = east_calloc(cap, sizeof(uint32_t));
+    if (!slots) return false;
+    for (size_t i = 0; i < col->num_strings; i++) {
+        EastValue *s = col->strings[i];
+        size_t j = hash_str(s->data.string.data, s->data.string.len) & (cap - 1);
+        while (slots[j]) j = (j + 1) & (cap - 1);
+        slots[j] = (uint32_t)i + 1;
+    }
+    east_free(col->lookup);
+    col->lookup = slots;
+    col->lookup_cap = cap;
+    return true;
+}
+
+/* Code of the dictionary entry equal to s, adding it if new. */
+static bool intern(EastColumn *col, const char *s, size_t len, uint32_t *code) {
+    if ((col->num_strings + 1) * 2 > col->lookup_cap && !lookup_grow(col)) return false;
+    size_t mask = col->lookup_cap - 1;
+    size_t j = hash_str(s, len) & mask;
+    for (; col->lookup[j]; j = (j + 1) & mask) {
+        EastValue *e = col->strings[col->lookup[j] - 1];
+        if (e->data.string.len == len && memcmp(e->data.string.data, s, len) == 0) {
+            *code = col->lookup[j] - 1;
+            return true;
+        }
+    }
+    if (col->num_strings == UINT32_MAX) return false;
+    if (col->num_strings == col->strings_cap) {
+        size_t cap = col->strings_cap ? col->strings_cap * 2 : 16;
+        EastValue **p = realloc(col->strings, cap * sizeof(EastValue *));
+        if (!p) return false;
+        col->strings = p;
+        col->strings_cap = cap;
+    }
+    EastValue *v = east_string_len(s, len);
+    if (!v) return false;
+    *code = (uint32_t)col->num_strings;
+    col->strings[col->num_strings++] = v;
+    col->lookup[j] = *code + 1;
+    return true;
+}
+
+bool east_column_set_string(EastColumn *col, size_t row, const char *s, size_t len) {
+    uint32_t code;
+    if (!intern(col, s, len, &code)) return false;
+    col->data.code[row] = code;
+    mark_present(col, row);
+    return true;
+}
+
+/* ------------------------------------------------------------------ */
+/*  Boxed values                                                       */
+/* ------------------------------------------------------------------ */
+
+bool east_column_set_value(EastColumn *col, size_t row, EastValue *v) {
+    if (!v) return false;
+    if (col->option_type) {
+        if (v->kind != EAST_VAL_VARIANT) return false;
+        if (strcmp(v->data.variant.case_name, "none") == 0) {
+            east_column_set_null(col, row);
+            return true;
+        }
+        v = v->data.variant.value;
+    }
+    switch (col->kind) {
+    case EAST_COL_NULL:
+        if (v->kind != EAST_VAL_NULL) return false;
+        mark_present(col, row);
+        return true;
+    case EAST_COL_BOOLEAN:
+        if (v->kind != EAST_VAL_BOOLEAN) return false;
+        east_column_set_boolean(col, row, v->data.boolean);
+        return true;
+    case EAST_COL_INTEGER:
+        if (v->kind != EAST_VAL_INTEGER) return false;
+        east_column_set_integer(col, row, v->data.integer);
+        return true;
+    case EAST_COL_FLOAT:
+        if (v->kind != EAST_VAL_FLOAT) return false;
+        east_column_set_float(col, row, v->data.float64);
+        return true;
+    case EAST_COL_DATETIME:
+        if (v->kind != EAST_VAL_DATETIME) return false;
+        east_column_set_integer(col, row, v->data.datetime);
+        return true;
+    case EAST_COL_STRING:
+        if (v->kind != EAST_VAL_STRING) return false;
+        return east_column_set_string(col, row, v->data.string.data, v->data.string.len);
+    }
+    return false;
+}
+
+bool east_columnar_push_struct(EastValue *arr, EastValue *row) {
+    EastColumns *c = arr->data.array.columns;
+    if (!row || row->kind != EAST_VAL_STRUCT || row->data.struct_.num_fields != c->num_fields)
+        return false;
+    size_t r = east_columnar_add_row(arr);
+    if (r == SIZE_MAX) return false;
+    for (size_t f = 0; f < c->num_fields; f++) {
+        /* Rows are normally in schema order; fall back to a name lookup */
+        EastValue *v = strcmp(row->data.struct_.field_names[f], c->names[f]) == 0
+                     ? row->data.struct_.field_values[f]
+                     : east_struct_get_field(row, c->names[f]);
+        if (!east_column_set_value(&c->cols[f], r, v)) {
+            arr->data.array.len = --c->len;
+            return false;
+        }
+    }
+    return true;
+}
+
+EastValue *east_column_value(const EastColumn *col, size_t row) {
+    if (!east_column_present(col, row))
+        return east_variant_new("none", east_null(), col->option_type);
+    EastValue *v = NULL;
+    switch (col->kind) {
+    case EAST_COL_NULL:     v = east_null(); break;
+    case EAST_COL_BOOLEAN:  v = east_boolean(col->data.boolean[row]); break;
+    case EAST_COL_INTEGER:  v = east_integer(col->data.integer[row]); break;
+    case EAST_COL_FLOAT:    v = east_float(col->data.float64[row]); break;
+    case EAST_COL_DATETIME: v = east_datetime(col->data.integer[row]); break;
+    case EAST_COL_STRING:
+        v = col->strings[col->data.code[row]];
+        east_value_retain(v);
+        break;
+    }
+    if (!col->option_type) return v;
+    EastValue *some = east_variant_new("some", v, col->option_type);
+    east_value_release(v);
+    return some;
+}
+
+EastValue *east_columnar_row(EastValue *arr, size_t row) {
+    EastColumns *c = arr->data.array.columns;
+    EastValue *stack_vals[16];
+    EastValue **vals = c->num_fields <= 16 ? stack_vals
+                     : east_alloc(c->num_fields * sizeof(EastValue *));
+    if (!vals) return NULL;
+    for (size_t f = 0; f < c->num_fields; f++)
+        vals[f] = east_column_value(&c->cols[f], row);
+    EastValue *s = east_struct_new(c->names, vals, c->num_fields, c->row_type);
+    for (size_t f = 0; f < c->num_fields; f++) east_value_release(vals[f]);
+    if (vals != stack_vals) east_free(vals);
+    return s;
+}
+
+/* ------------------------------------------------------------------ */
+/*  Row access                                                         */
+/* ------------------------------------------------------------------ */
+
+/* Rows built so far are kept in items so references stay borrowed. */
+static bool row_cache(EastValue *arr) {
+    if (arr->data.array.items) return true;
+    size_t cap = arr->data.array.len > 4 ? arr->data.array.len : 4;
+    arr->data.array.items = east_calloc(cap, sizeof(EastValue *));
+    if (!arr->data.array.items) return false;
+    arr->data.array.columns->rows_cap = cap;
+    east_value_mem_update(arr);
+    return true;
+}
+
+EastValue *east_columnar_get(EastValue *arr, size_t row) {
+    if (!row_cache(arr)) return NULL;
+    EastValue **slot = &arr->data.array.items[row];
+    if (!*slot) *slot = east_columnar_row(arr, row);
+    return *slot;
+}
+
+void east_array_materialize(EastValue *arr) {
+    EastColumns *c = east_array_columns(arr);
+    if (!c || !row_cache(arr)) return;
+    for (size_t i = 0; i < c->len; i++) east_columnar_get(arr, i);
+    arr->columnar = false;
+    arr->data.array.cap = c->rows_cap;
+    east_columns_free(c);
+    east_value_mem_update(arr);
+}
+
+EastValue *east_columnar_gather(EastValue *arr, const size_t *rows, size_t n) {
+    EastColumns *src = arr->data.array.columns;
+    EastValue *out = east_columnar_array_new(src->row_type, n);
+    if (!out) return NULL;
+    EastColumns *dst = out->data.array.columns;
+    for (size_t f = 0; f < src->num_fields; f++) {
+        const EastColumn *s = &src->cols[f];
+        EastColumn *d = &dst->cols[f];
+        switch (s->kind) {
+        case EAST_COL_BOOLEAN:
+            for (size_t i = 0; i < n; i++) d->data.boolean[i] = s->data.boolean[rows[i]];
+            break;
+        case EAST_COL_INTEGER:
+        case EAST_COL_DATETIME:
+            for (size_t i = 0; i < n; i++) d->data.integer[i] = s->data.integer[rows[i]];
+            break;
+        case EAST_COL_FLOAT:
+            for (size_t i = 0; i < n; i++) d->data.float64[i] = s->data.float64[rows[i]];
+            break;
+        case EAST_COL_STRING:
+            for (size_t i = 0; i < n; i++) d->data.code[i] = s->data.code[rows[i]];
+            break;
+        case EAST_COL_NULL:
+            break;
+        }
+        if (s->present) {
+            for (size_t i = 0; i < n; i++)
+                if (east_column_present(s, rows[i])) mark_present(d, i);
+        }
+        if (s->num_strings) {
+            /* Share the whole dictionary; codes stay valid */
+            d->strings = east_alloc(s->strings_cap * sizeof(EastValue *));
+            d->lookup = east_alloc(s->lookup_cap * sizeof(uint32_t));
+            if (!d->strings || !d->lookup) {
+                east_value_release(out);
+                return NULL;
+            }
+            memcpy(d->strings, s->strings, s->num_strings * sizeof(EastValue *));
+            memcpy(d->lookup, s->lookup, s->lookup_cap * sizeof(uint32_t));
+            for (size_t i = 0; i < s->num_strings; i++) east_value_retain(d->strings[i]);
+            d->num_strings = s->num_strings;
+            d->strings_cap = s->strings_cap;
+            d->lookup_cap = s->lookup_cap;
+        }
+    }
+    dst->len = n;
+    out->data.array.len = n;
+    east_value_mem_update(out);
+    return out;
+}
+
+/* ------------------------------------------------------------------ */
+/*  Lifetime                                                           */
+/* ------------------------------------------------------------------ */
+
+size_t east_columns_bytes(const EastColumns *c) {
+    size_t n = sizeof(EastColumns) + c->num_fields * (sizeof(EastColumn) + sizeof(char *));
+    for (size_t f = 0; f < c->num_fields; f++) {
+        const EastColumn *col = &c->cols[f];
+        n += c->cap * value_size(col->kind);
+        if (col->present) n += (c->cap + 7) / 8;
+        n += col->strings_cap * sizeof(EastValue *) + col->lookup_cap * sizeof(uint32_t);
+    }
+    return n;
+}
+
+void east_columns_free(EastColumns *c) {
+    if (!c) return;
+    for (size_t f = 0; f < c->num_fields; f++) {
+        EastColumn *col = &c->cols[f];
+        free(col->data.integer);
+        free(col->present);
+        for (size_t i = 0; i < col->num_strings; i++) east_value_release(col->strings[i]);
+        free(col->strings);
+        east_free(col->lookup);
+    }
+    east_free(c->cols);
+    east_free(c->names);
+    east_type_release(c->row_type);
+    east_free(c);
+}
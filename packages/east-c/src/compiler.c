@@ -1,6 +1,8 @@
 #include "east/compiler.h"
 #include "east/arena.h"
 #include "east/gc.h"
+#include "east/memory.h"
+#include "east/profiler.h"
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -116,11 +118,131 @@ static bool is_truthy(EastValue *v)
 /*  Main eval dispatch                                                 */
 /* ------------------------------------------------------------------ */
 
+static EvalResult eval_node(IRNode *node, Environment *env,
+                            PlatformRegistry *platform, BuiltinRegistry *builtins);
+
 EvalResult eval_ir(IRNode *node, Environment *env,
                    PlatformRegistry *platform, BuiltinRegistry *builtins)
 {
     if (!node) return eval_ok(east_null());
 
+    /* Loops are profiled as a whole; calls, builtins and platform
+     * functions report themselves from eval_node. */
+    if (east_profiler_active &&
+        (node->kind == IR_WHILE || node->kind == IR_FOR_ARRAY ||
+         node->kind == IR_FOR_SET || node->kind == IR_FOR_DICT)) {
+        east_profiler_enter(EAST_PROFILE_LOOP, node);
+        EvalResult r = eval_node(node, env, platform, builtins);
+        east_profiler_exit();
+        return r;
+    }
+    return eval_node(node, env, platform, builtins);
+}
+
+/* `x = StringConcat(x, s)`: the assignment overwrites x, so when the
+ * variable holds the only other reference to its String, s can be
+ * appended to it in place. Building a string piece by piece then costs
+ * amortized O(len(s)) per step instead of copying x every time. */
+static bool is_self_append(IRNode *node)
+{
+    IRNode *value = node->data.assign.value;
+    if (value->kind != IR_BUILTIN || value->data.builtin.num_args != 2 ||
+        strcmp(value->data.builtin.name, "StringConcat") != 0)
+        return false;
+    IRNode *lhs = value->data.builtin.args[0];
+    return lhs->kind == IR_VARIABLE &&
+           strcmp(lhs->data.variable.name, node->data.assign.name) == 0;
+}
+
+static bool append_in_place(Environment *env, const char *name, EastValue **args)
+{
+    EastValue *acc = args[0];
+    if (acc->kind != EAST_VAL_STRING || acc->ref_count != 2 ||
+        args[1] == acc || env_get(env, name) != acc)
+        return false;
+    return east_string_append(acc, args[1]->data.string.data,
+                              args[1]->data.string.len);
+}
+
+/* IR_BUILTIN; append_to names the variable being assigned when the call
+ * matches is_self_append. */
+static EvalResult eval_builtin(IRNode *node, Environment *env,
+                               PlatformRegistry *platform, BuiltinRegistry *builtins,
+                               const char *append_to)
+{
+    /* Evaluate arguments FIRST, before calling the factory.
+     * This ensures that the factory call and the impl call are adjacent,
+     * which allows factories to set static type context safely. */
+    size_t nargs = node->data.builtin.num_args;
+    EastValue **args = NULL;
+    if (nargs > 0) {
+        args = calloc(nargs, sizeof(EastValue *));
+        if (!args) return eval_error("out of memory");
+        for (size_t i = 0; i < nargs; i++) {
+            EvalResult arg_res = eval_ir(node->data.builtin.args[i],
+                                         env, platform, builtins);
+            if (arg_res.status != EVAL_OK) {
+                for (size_t j = 0; j < i; j++)
+                    east_value_release(args[j]);
+                free(args);
+                return arg_res;
+            }
+            args[i] = arg_res.value;
+        }
+    }
+
+    /* Now call factory + impl back-to-back (no IR eval in between) */
+    BuiltinImpl bfn = builtin_registry_get(
+        builtins,
+        node->data.builtin.name,
+        node->data.builtin.type_params,
+        node->data.builtin.num_type_params);
+    if (!bfn) {
+        for (size_t i = 0; i < nargs; i++)
+            east_value_release(args[i]);
+        free(args);
+        char buf[256];
+        snprintf(buf, sizeof(buf),
+                 "Unknown builtin function: %s",
+                 node->data.builtin.name);
+        return eval_error_at_owned(strdup(buf), node);
+    }
+
+    EastMemMark mark = {0, 0};
+    if (east_mem_accounting) mark = east_mem_mark();
+    if (east_profiler_active) east_profiler_enter(EAST_PROFILE_BUILTIN, node);
+    EastValue *result;
+    if (append_to && append_in_place(env, append_to, args)) {
+        east_value_retain(args[0]);
+        result = args[0];
+    } else {
+        result = bfn(args, nargs);
+    }
+    if (east_profiler_active) east_profiler_exit();
+    if (east_mem_accounting) east_mem_builtin_done(node, mark);
+
+    for (size_t i = 0; i < nargs; i++)
+        east_value_release(args[i]);
+    free(args);
+
+    if (result && east_mem_accounting && east_mem_over_limit()) {
+        east_value_release(result);
+        return eval_error_at_owned(east_mem_limit_message(), node);
+    }
+
+    if (!result) {
+        char *err = east_builtin_get_error();
+        if (err) {
+            return eval_error_at_owned(err, node);
+        }
+        return eval_ok(east_null());
+    }
+    return eval_ok(result);
+}
+
+static EvalResult eval_node(IRNode *node, Environment *env,
+                            PlatformRegistry *platform, BuiltinRegistry *builtins)
+{
     switch (node->kind) {
 
     /* ----- IR_VALUE ------------------------------------------------ */
@@ -156,8 +278,10 @@ EvalResult eval_ir(IRNode *node, Environment *env,
 
     /* ----- IR_ASSIGN ----------------------------------------------- */
     case IR_ASSIGN: {
-        EvalResult val_res = eval_ir(node->data.assign.value, env,
-                                     platform, builtins);
+        EvalResult val_res = is_self_append(node)
+            ? eval_builtin(node->data.assign.value, env, platform, builtins,
+                           node->data.assign.name)
+            : eval_ir(node->data.assign.value, env, platform, builtins);
         if (val_res.status != EVAL_OK) return val_res;
 
         env_update(env, node->data.assign.name, val_res.value);
@@ -546,6 +670,14 @@ EvalResult eval_ir(IRNode *node, Environment *env,
             }
         }
 
+        if (east_mem_accounting && east_mem_over_limit()) {
+            for (size_t i = 0; i < nargs; i++)
+                east_value_release(args[i]);
+            free(args);
+            east_value_release(func_val);
+            return eval_error_at_owned(east_mem_limit_message(), node);
+        }
+
         /* Create call environment: captures as parent, then params */
         Environment *call_env = env_new(cfn->captures);
         for (size_t i = 0; i < cfn->num_params && i < nargs; i++) {
@@ -553,8 +685,10 @@ EvalResult eval_ir(IRNode *node, Environment *env,
         }
 
         /* Evaluate body */
+        if (east_profiler_active) east_profiler_enter(EAST_PROFILE_FUNCTION, cfn->ir);
         EvalResult body_res = eval_ir(cfn->ir, call_env,
                                       cfn->platform, cfn->builtins);
+        if (east_profiler_active) east_profiler_exit();
 
         env_release(call_env);
 
@@ -627,7 +761,9 @@ EvalResult eval_ir(IRNode *node, Environment *env,
                                node->data.platform.num_type_params);
         }
 
+        if (east_profiler_active) east_profiler_enter(EAST_PROFILE_PLATFORM, node);
         EvalResult result = pfn(args, nargs);
+        if (east_profiler_active) east_profiler_exit();
 
         for (size_t i = 0; i < nargs; i++)
             east_value_release(args[i]);
@@ -640,64 +776,16 @@ EvalResult eval_ir(IRNode *node, Environment *env,
             return result;
         }
         if (!result.value) result.value = east_null();
+        if (east_mem_accounting && east_mem_over_limit()) {
+            east_value_release(result.value);
+            return eval_error_at_owned(east_mem_limit_message(), node);
+        }
         return result;
     }
 
     /* ----- IR_BUILTIN ---------------------------------------------- */
-    case IR_BUILTIN: {
-        /* Evaluate arguments FIRST, before calling the factory.
-         * This ensures that the factory call and the impl call are adjacent,
-         * which allows factories to set static type context safely. */
-        size_t nargs = node->data.builtin.num_args;
-        EastValue **args = NULL;
-        if (nargs > 0) {
-            args = calloc(nargs, sizeof(EastValue *));
-            if (!args) return eval_error("out of memory");
-            for (size_t i = 0; i < nargs; i++) {
-                EvalResult arg_res = eval_ir(node->data.builtin.args[i],
-                                             env, platform, builtins);
-                if (arg_res.status != EVAL_OK) {
-                    for (size_t j = 0; j < i; j++)
-                        east_value_release(args[j]);
-                    free(args);
-                    return arg_res;
-                }
-                args[i] = arg_res.value;
-            }
-        }
-
-        /* Now call factory + impl back-to-back (no IR eval in between) */
-        BuiltinImpl bfn = builtin_registry_get(
-            builtins,
-            node->data.builtin.name,
-            node->data.builtin.type_params,
-            node->data.builtin.num_type_params);
-        if (!bfn) {
-            for (size_t i = 0; i < nargs; i++)
-                east_value_release(args[i]);
-            free(args);
-            char buf[256];
-            snprintf(buf, sizeof(buf),
-                     "Unknown builtin function: %s",
-                     node->data.builtin.name);
-            return eval_error_at_owned(strdup(buf), node);
-        }
-
-        EastValue *result = bfn(args, nargs);
-
-        for (size_t i = 0; i < nargs; i++)
-            east_value_release(args[i]);
-        free(args);
-
-        if (!result) {
-            char *err = east_builtin_get_error();
-            if (err) {
-                return eval_error_at_owned(err, node);
-            }
-            return eval_ok(east_null());
-        }
-        return eval_ok(result);
-    }
+    case IR_BUILTIN:
+        return eval_builtin(node, env, platform, builtins, NULL);
 
     /* ----- IR_RETURN ----------------------------------------------- */
     case IR_RETURN: {
@@ -1129,8 +1217,10 @@ EvalResult east_call(EastCompiledFn *fn, EastValue **args,
         env_set(call_env, fn->param_names[i], args[i]);
     }
 
+    if (east_profiler_active) east_profiler_enter(EAST_PROFILE_FUNCTION, fn->ir);
     EvalResult result = eval_ir(fn->ir, call_env,
                                 fn->platform, fn->builtins);
+    if (east_profiler_active) east_profiler_exit();
     env_release(call_env);
 
     /* If body returned via IR_RETURN, unwrap to EVAL_OK */
@@ -1147,7 +1237,10 @@ EvalResult east_call(EastCompiledFn *fn, EastValue **args,
      * freed immediately by refcounting at every level. */
     east_call_depth--;
     if (east_call_depth == 0) {
+        east_datetime_plans_clear();
+        if (east_profiler_active) east_profiler_enter(EAST_PROFILE_GC, NULL);
         east_gc_collect();
+        if (east_profiler_active) east_profiler_exit();
     }
 
     /* Restore saved platform/builtins */
@@ -1157,6 +1250,128 @@ EvalResult east_call(EastCompiledFn *fn, EastValue **args,
     return result;
 }
 
+/* Arguments that can be evaluated for every element up front without
+ * changing what the program observes: no calls, no assignments. */
+static bool batch_arg_plain(IRNode *n)
+{
+    switch (n->kind) {
+    case IR_VALUE:
+    case IR_VARIABLE:
+        return true;
+    case IR_GET_FIELD:
+        return batch_arg_plain(n->data.get_field.expr);
+    case IR_STRUCT:
+        for (size_t i = 0; i < n->data.struct_.num_fields; i++)
+            if (!batch_arg_plain(n->data.struct_.field_values[i])) return false;
+        return true;
+    default:
+        return false;
+    }
+}
+
+/* fn's body when it is nothing but a call to a batched platform function
+ * on plain arguments, else NULL. */
+static IRNode *batch_call_node(EastCompiledFn *fn)
+{
+    IRNode *n = fn->ir;
+    while (n) {
+        if (n->kind == IR_BLOCK && n->data.block.num_stmts == 1)
+            n = n->data.block.stmts[0];
+        else if (n->kind == IR_RETURN)
+            n = n->data.return_.value;
+        else
+            break;
+    }
+    if (!n || n->kind != IR_PLATFORM || n->data.platform.is_async) return NULL;
+    for (size_t i = 0; i < n->data.platform.num_args; i++)
+        if (!batch_arg_plain(n->data.platform.args[i])) return NULL;
+    if (!platform_registry_get_batch(fn->platform, n->data.platform.name)) return NULL;
+    return n;
+}
+
+bool east_fn_batchable(EastCompiledFn *fn)
+{
+    return fn && batch_call_node(fn) != NULL;
+}
+
+EvalResult east_call_batch(EastCompiledFn *fn, EastValue **args,
+                           size_t num_args, size_t count,
+                           EastValue **results)
+{
+    IRNode *node = fn ? batch_call_node(fn) : NULL;
+    if (!node) return eval_error("function cannot be batched");
+
+    PlatformRegistry *saved_platform = current_platform;
+    BuiltinRegistry *saved_builtins = current_builtins;
+    current_platform = fn->platform;
+    current_builtins = fn->builtins;
+    east_call_depth++;
+
+    /* Evaluate the platform arguments of every call, then cross once */
+    size_t nargs = node->data.platform.num_args;
+    size_t total = count * nargs;
+    EastValue **pargs = calloc(total ? total : 1, sizeof(EastValue *));
+    EvalResult result = eval_ok(NULL);
+    size_t done = 0;
+    if (!pargs) result = eval_error("out of memory");
+    for (size_t i = 0; pargs && i < count && result.status == EVAL_OK; i++) {
+        Environment *call_env = env_new(fn->captures);
+        for (size_t p = 0; p < fn->num_params && p < num_args; p++)
+            env_set(call_env, fn->param_names[p], args[i * num_args + p]);
+        for (size_t j = 0; j < nargs; j++) {
+            EvalResult arg_res = eval_ir(node->data.platform.args[j], call_env,
+                                         fn->platform, fn->builtins);
+            if (arg_res.status != EVAL_OK) {
+                result = arg_res;
+                break;
+            }
+            pargs[done++] = arg_res.value;
+        }
+        env_release(call_env);
+    }
+
+    if (result.status == EVAL_OK) {
+        if (fn->platform->pre_call) {
+            fn->platform->pre_call(node->data.platform.name,
+                                   node->data.platform.type_params,
+                                   node->data.platform.num_type_params);
+        }
+        PlatformBatchFn batch = platform_registry_get_batch(fn->platform,
+                                                            node->data.platform.name);
+        memset(results, 0, count * sizeof(EastValue *));
+        if (east_profiler_active) east_profiler_enter(EAST_PROFILE_PLATFORM, node);
+        result = batch(pargs, nargs, count, results);
+        if (east_profiler_active) east_profiler_exit();
+        if (result.status != EVAL_OK) {
+            eval_result_extend_location(&result, node->locations,
+                                        node->num_locations);
+        } else {
+            for (size_t i = 0; i < count; i++)
+                if (!results[i]) results[i] = east_null();
+            if (east_mem_accounting && east_mem_over_limit()) {
+                for (size_t i = 0; i < count; i++)
+                    east_value_release(results[i]);
+                result = eval_error_at_owned(east_mem_limit_message(), node);
+            }
+        }
+    }
+
+    for (size_t i = 0; i < done; i++)
+        east_value_release(pargs[i]);
+    free(pargs);
+
+    east_call_depth--;
+    if (east_call_depth == 0) {
+        east_datetime_plans_clear();
+        if (east_profiler_active) east_profiler_enter(EAST_PROFILE_GC, NULL);
+        east_gc_collect();
+        if (east_profiler_active) east_profiler_exit();
+    }
+    current_platform = saved_platform;
+    current_builtins = saved_builtins;
+    return result;
+}
+
 void east_compiled_fn_free(EastCompiledFn *fn)
 {
     if (!fn) return;
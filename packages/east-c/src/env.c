@@ -1,5 +1,6 @@
 #include "east/env.h"
 #include "east/arena.h"
+#include "east/memory.h"
 
 #include <stdlib.h>
 
@@ -8,6 +9,17 @@ static void release_value_cb(void *v) {
     if (v) east_value_release((EastValue *)v);
 }
 
+/* Re-measure the environment and its locals table (keys not included). */
+static void env_mem_update(Environment *env) {
+    if (!east_mem_accounting) return;
+    size_t now = sizeof(Environment) + sizeof(Hashmap)
+                 + env->locals->capacity * sizeof(HashmapEntry);
+    int64_t delta = (int64_t)now - (int64_t)env->mem_bytes;
+    if (delta == 0) return;
+    east_mem_account(EAST_MEM_ENV, -1, delta, env->mem_bytes ? 0 : 1);
+    env->mem_bytes = (uint32_t)now;
+}
+
 Environment *env_new(Environment *parent) {
     Environment *env = east_alloc(sizeof(Environment));
     if (!env) return NULL;
@@ -20,6 +32,8 @@ Environment *env_new(Environment *parent) {
     if (parent) env_retain(parent);
     env->ref_count = 1;
     env->gc_gen = 0;
+    env->mem_bytes = 0;
+    env_mem_update(env);
     return env;
 }
 
@@ -34,6 +48,7 @@ void env_set(Environment *env, const char *name, EastValue *value) {
 
     if (value) east_value_retain(value);
     hashmap_set(env->locals, name, value);
+    env_mem_update(env);
 }
 
 void env_update(Environment *env, const char *name, EastValue *value) {
@@ -46,6 +61,7 @@ void env_update(Environment *env, const char *name, EastValue *value) {
             if (old) east_value_release(old);
             if (value) east_value_retain(value);
             hashmap_set(cur->locals, name, value);
+            env_mem_update(cur);
             return;
         }
     }
@@ -53,6 +69,7 @@ void env_update(Environment *env, const char *name, EastValue *value) {
     /* Fallback: create new binding in current scope. */
     if (value) east_value_retain(value);
     hashmap_set(env->locals, name, value);
+    env_mem_update(env);
 }
 
 EastValue *env_get(Environment *env, const char *name) {
@@ -88,5 +105,7 @@ void env_release(Environment *env) {
     /* Release the parent environment. */
     if (env->parent) env_release(env->parent);
 
+    if (env->mem_bytes)
+        east_mem_account(EAST_MEM_ENV, -1, -(int64_t)env->mem_bytes, -1);
     free(env);
 }
@@ -1,8 +1,10 @@
 #include "east/gc.h"
 #include "east/values.h"
+#include "east/columnar.h"
 #include "east/compiler.h"
 #include "east/env.h"
 #include "east/hashmap.h"
+#include "east/memory.h"
 #include "east/types.h"
 
 #include <limits.h>
@@ -79,6 +81,8 @@ static void env_visit_cb(const char *key, void *value, void *ctx) {
 static void gc_traverse(EastValue *v, gc_visit_fn visit, void *ctx) {
     switch (v->kind) {
     case EAST_VAL_ARRAY:
+        /* Columnar rows hold only primitives; cached ones are still visited */
+        if (!v->data.array.items) break;
         for (size_t i = 0; i < v->data.array.len; i++) {
             if (v->data.array.items[i])
                 visit(v->data.array.items[i], ctx);
@@ -173,9 +177,14 @@ static void rescue_visit(EastValue *child, void *ctx) {
 static void gc_destroy_contents(EastValue *v) {
     switch (v->kind) {
     case EAST_VAL_ARRAY:
-        for (size_t i = 0; i < v->data.array.len; i++)
-            east_value_release(v->data.array.items[i]);
-        free(v->data.array.items);
+        if (v->data.array.items) {
+            for (size_t i = 0; i < v->data.array.len; i++)
+                east_value_release(v->data.array.items[i]);
+            free(v->data.array.items);
+        }
+        if (v->columnar) east_columns_free(v->data.array.columns);
+        v->columnar = false;
+        v->data.array.cap = 0;
         if (v->data.array.elem_type)
             east_type_release(v->data.array.elem_type);
         v->data.array.items = NULL;
@@ -319,7 +328,10 @@ void east_gc_collect(void) {
 
     /* 4c: Free the garbage objects themselves */
     for (size_t i = 0; i < garbage_len; i++) {
-        free(garbage[i]);
+        EastValue *g = garbage[i];
+        if (g->mem_bytes)
+            east_mem_account(EAST_MEM_VALUES, g->kind, -(int64_t)g->mem_bytes, -1);
+        free(g);
     }
 
     free(garbage);
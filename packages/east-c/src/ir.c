@@ -1,4 +1,5 @@
 #include "east/ir.h"
+#include "east/memory.h"
 
 #include <stdlib.h>
 #include <string.h>
@@ -14,6 +15,8 @@ static IRNode *ir_alloc(IRNodeKind kind, EastType *type) {
     node->ref_count = 1;
     node->type = type;
     if (type) east_type_retain(type);
+    if (east_mem_accounting)
+        east_mem_account(EAST_MEM_IR, -1, (int64_t)sizeof(IRNode), 1);
     return node;
 }
 
@@ -662,5 +665,7 @@ void ir_node_release(IRNode *node) {
     }
 
     east_locations_free(node->locations, node->num_locations);
+    if (east_mem_accounting)
+        east_mem_account(EAST_MEM_IR, -1, -(int64_t)sizeof(IRNode), -1);
     free(node);
 }
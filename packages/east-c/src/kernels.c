@@ -0,0 +1,714 @@
+#include "east/kernels.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if !defined(__EMSCRIPTEN__) && !defined(_WIN32)
+#define KERNEL_THREADS 1
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+/*
+ * Each exported kernel is cloned for AVX2 where the toolchain can
+ * dispatch on the running CPU (GNU ifuncs); elsewhere the portable
+ * build is all there is. This file is compiled with -O3 so the loops
+ * vectorize whatever the build type.
+ */
+#if defined(__x86_64__) && defined(__linux__) && defined(__GNUC__) && \
+    (!defined(__clang__) || __clang_major__ >= 14)
+#define KERNEL __attribute__((target_clones("avx2", "default")))
+#else
+#define KERNEL
+#endif
+
+#define LANES 8
+
+/* ------------------------------------------------------------------ */
+/*  Scalar helpers                                                     */
+/* ------------------------------------------------------------------ */
+
+/*
+ * Map a double to an integer with the same total order as
+ * east_value_compare: NaNs collapse to one value above +inf, and the
+ * magnitude bits of negatives are flipped so -0 sorts just below +0.
+ */
+static inline int64_t f64_key(double d)
+{
+    uint64_t bits;
+    memcpy(&bits, &d, sizeof(bits));
+    if (d != d) bits = 0x7ff8000000000000ull;
+    return (int64_t)(bits ^ ((uint64_t)((int64_t)bits >> 63) >> 1));
+}
+
+static inline int64_t wrap_add(int64_t a, int64_t b) { return (int64_t)((uint64_t)a + (uint64_t)b); }
+static inline int64_t wrap_sub(int64_t a, int64_t b) { return (int64_t)((uint64_t)a - (uint64_t)b); }
+static inline int64_t wrap_mul(int64_t a, int64_t b) { return (int64_t)((uint64_t)a * (uint64_t)b); }
+
+static inline int64_t floor_div(int64_t a, int64_t b)
+{
+    if (b == 0) return 0;
+    if (b == -1) return wrap_sub(0, a);
+    int64_t q = a / b;
+    int64_t r = a % b;
+    if (r != 0 && ((r ^ b) < 0)) q -= 1;
+    return q;
+}
+
+#define F_ADD(x, y) ((x) + (y))
+#define F_SUB(x, y) ((x) - (y))
+#define F_MUL(x, y) ((x) * (y))
+#define F_DIV(x, y) ((x) / (y))
+
+/* out[i] = OP(a[i], b[i]) or OP(a[i], s) */
+#define ELEMENTWISE(OP, out, a, b, s, n) do {                        \
+    if (b) { for (size_t i = 0; i < (n); i++) (out)[i] = OP((a)[i], (b)[i]); } \
+    else   { for (size_t i = 0; i < (n); i++) (out)[i] = OP((a)[i], (s)); }    \
+} while (0)
+
+/* ------------------------------------------------------------------ */
+/*  Arithmetic                                                         */
+/* ------------------------------------------------------------------ */
+
+KERNEL
+void east_kernel_arith_f64(EastArithOp op, double *restrict out,
+                           const double *restrict a, const double *restrict b,
+                           double scalar, size_t n)
+{
+    switch (op) {
+    case EAST_ARITH_ADD: ELEMENTWISE(F_ADD, out, a, b, scalar, n); break;
+    case EAST_ARITH_SUB: ELEMENTWISE(F_SUB, out, a, b, scalar, n); break;
+    case EAST_ARITH_MUL: ELEMENTWISE(F_MUL, out, a, b, scalar, n); break;
+    case EAST_ARITH_DIV: ELEMENTWISE(F_DIV, out, a, b, scalar, n); break;
+    }
+}
+
+KERNEL
+void east_kernel_arith_i64(EastArithOp op, int64_t *restrict out,
+                           const int64_t *restrict a, const int64_t *restrict b,
+                           int64_t scalar, size_t n)
+{
+    switch (op) {
+    case EAST_ARITH_ADD: ELEMENTWISE(wrap_add, out, a, b, scalar, n); break;
+    case EAST_ARITH_SUB: ELEMENTWISE(wrap_sub, out, a, b, scalar, n); break;
+    case EAST_ARITH_MUL: ELEMENTWISE(wrap_mul, out, a, b, scalar, n); break;
+    case EAST_ARITH_DIV: ELEMENTWISE(floor_div, out, a, b, scalar, n); break;
+    }
+}
+
+/* ------------------------------------------------------------------ */
+/*  Comparisons                                                        */
+/* ------------------------------------------------------------------ */
+
+#define C_EQ(x, y) ((x) == (y))
+#define C_NE(x, y) ((x) != (y))
+#define C_LT(x, y) ((x) < (y))
+#define C_LE(x, y) ((x) <= (y))
+#define C_GT(x, y) ((x) > (y))
+#define C_GE(x, y) ((x) >= (y))
+
+#define K_EQ(x, y) (f64_key(x) == f64_key(y))
+#define K_NE(x, y) (f64_key(x) != f64_key(y))
+#define K_LT(x, y) (f64_key(x) < f64_key(y))
+#define K_LE(x, y) (f64_key(x) <= f64_key(y))
+#define K_GT(x, y) (f64_key(x) > f64_key(y))
+#define K_GE(x, y) (f64_key(x) >= f64_key(y))
+
+KERNEL
+void east_kernel_compare_f64(EastCmpOp op, bool *restrict out,
+                             const double *restrict a, const double *restrict b,
+                             double scalar, size_t n)
+{
+    switch (op) {
+    case EAST_CMP_EQ: ELEMENTWISE(K_EQ, out, a, b, scalar, n); break;
+    case EAST_CMP_NE: ELEMENTWISE(K_NE, out, a, b, scalar, n); break;
+    case EAST_CMP_LT: ELEMENTWISE(K_LT, out, a, b, scalar, n); break;
+    case EAST_CMP_LE: ELEMENTWISE(K_LE, out, a, b, scalar, n); break;
+    case EAST_CMP_GT: ELEMENTWISE(K_GT, out, a, b, scalar, n); break;
+    case EAST_CMP_GE: ELEMENTWISE(K_GE, out, a, b, scalar, n); break;
+    }
+}
+
+KERNEL
+void east_kernel_compare_i64(EastCmpOp op, bool *restrict out,
+                             const int64_t *restrict a, const int64_t *restrict b,
+                             int64_t scalar, size_t n)
+{
+    switch (op) {
+    case EAST_CMP_EQ: ELEMENTWISE(C_EQ, out, a, b, scalar, n); break;
+    case EAST_CMP_NE: ELEMENTWISE(C_NE, out, a, b, scalar, n); break;
+    case EAST_CMP_LT: ELEMENTWISE(C_LT, out, a, b, scalar, n); break;
+    case EAST_CMP_LE: ELEMENTWISE(C_LE, out, a, b, scalar, n); break;
+    case EAST_CMP_GT: ELEMENTWISE(C_GT, out, a, b, scalar, n); break;
+    case EAST_CMP_GE: ELEMENTWISE(C_GE, out, a, b, scalar, n); break;
+    }
+}
+
+/* ------------------------------------------------------------------ */
+/*  Reductions                                                         */
+/*                                                                     */
+/*  Float accumulation is split over LANES partial sums combined in a  */
+/*  fixed tree, which the compiler may keep in vector registers        */
+/*  without -ffast-math. Integer sums wrap, so their order is free.    */
+/* ------------------------------------------------------------------ */
+
+static inline double combine_lanes(const double *acc, double tail)
+{
+    return ((acc[0] + acc[4]) + (acc[1] + acc[5])) +
+           ((acc[2] + acc[6]) + (acc[3] + acc[7])) + tail;
+}
+
+KERNEL
+double east_kernel_sum_f64(const double *restrict a, size_t n)
+{
+    double acc[LANES] = {0};
+    size_t i = 0;
+    for (; i + LANES <= n; i += LANES)
+        for (size_t j = 0; j < LANES; j++) acc[j] += a[i + j];
+    double tail = 0;
+    for (; i < n; i++) tail += a[i];
+    return combine_lanes(acc, tail);
+}
+
+KERNEL
+int64_t east_kernel_sum_i64(const int64_t *restrict a, size_t n)
+{
+    uint64_t s = 0;
+    for (size_t i = 0; i < n; i++) s += (uint64_t)a[i];
+    return (int64_t)s;
+}
+
+KERNEL
+double east_kernel_sum_i64_as_f64(const int64_t *restrict a, size_t n)
+{
+    double acc[LANES] = {0};
+    size_t i = 0;
+    for (; i + LANES <= n; i += LANES)
+        for (size_t j = 0; j < LANES; j++) acc[j] += (double)a[i + j];
+    double tail = 0;
+    for (; i < n; i++) tail += (double)a[i];
+    return combine_lanes(acc, tail);
+}
+
+KERNEL
+double east_kernel_dot_f64(const double *restrict a, const double *restrict b, size_t n)
+{
+    double acc[LANES] = {0};
+    size_t i = 0;
+    for (; i + LANES <= n; i += LANES)
+        for (size_t j = 0; j < LANES; j++) acc[j] += a[i + j] * b[i + j];
+    double tail = 0;
+    for (; i < n; i++) tail += a[i] * b[i];
+    return combine_lanes(acc, tail);
+}
+
+KERNEL
+int64_t east_kernel_dot_i64(const int64_t *restrict a, const int64_t *restrict b, size_t n)
+{
+    uint64_t s = 0;
+    for (size_t i = 0; i < n; i++) s += (uint64_t)a[i] * (uint64_t)b[i];
+    return (int64_t)s;
+}
+
+/* A running sum is a serial dependency chain; nothing to vectorize. */
+void east_kernel_cumsum_f64(double *restrict out, const double *restrict a, size_t n)
+{
+    double s = 0;
+    for (size_t i = 0; i < n; i++) out[i] = s += a[i];
+}
+
+void east_kernel_cumsum_i64(int64_t *restrict out, const int64_t *restrict a, size_t n)
+{
+    uint64_t s = 0;
+    for (size_t i = 0; i < n; i++) {
+        s += (uint64_t)a[i];
+        out[i] = (int64_t)s;
+    }
+}
+
+/*
+ * Arg-extrema in two passes: a min/max reduction the compiler can
+ * vectorize, then a scan for the first element that attains it.
+ */
+
+KERNEL
+size_t east_kernel_argmin_f64(const double *restrict a, size_t n)
+{
+    int64_t m = f64_key(a[0]);
+    for (size_t i = 1; i < n; i++) {
+        int64_t k = f64_key(a[i]);
+        m = k < m ? k : m;
+    }
+    size_t i = 0;
+    while (f64_key(a[i]) != m) i++;
+    return i;
+}
+
+KERNEL
+size_t east_kernel_argmax_f64(const double *restrict a, size_t n)
+{
+    int64_t m = f64_key(a[0]);
+    for (size_t i = 1; i < n; i++) {
+        int64_t k = f64_key(a[i]);
+        m = k > m ? k : m;
+    }
+    size_t i = 0;
+    while (f64_key(a[i]) != m) i++;
+    return i;
+}
+
+KERNEL
+size_t east_kernel_argmin_i64(const int64_t *restrict a, size_t n)
+{
+    int64_t m = a[0];
+    for (size_t i = 1; i < n; i++) m = a[i] < m ? a[i] : m;
+    size_t i = 0;
+    while (a[i] != m) i++;
+    return i;
+}
+
+KERNEL
+size_t east_kernel_argmax_i64(const int64_t *restrict a, size_t n)
+{
+    int64_t m = a[0];
+    for (size_t i = 1; i < n; i++) m = a[i] > m ? a[i] : m;
+    size_t i = 0;
+    while (a[i] != m) i++;
+    return i;
+}
+
+KERNEL
+void east_kernel_axpy_f64(double *restrict y, double alpha, const double *restrict x, size_t n)
+{
+    for (size_t i = 0; i < n; i++) y[i] += alpha * x[i];
+}
+
+KERNEL
+void east_kernel_axpy_i64(int64_t *restrict y, int64_t alpha, const int64_t *restrict x, size_t n)
+{
+    for (size_t i = 0; i < n; i++) y[i] = wrap_add(y[i], wrap_mul(alpha, x[i]));
+}
+
+/* ------------------------------------------------------------------ */
+/*  Calendar                                                           */
+/*                                                                     */
+/*  Neri and Schneider's Euclidean affine form of the civil-from-days  */
+/*  conversion: divisions by constants and shifts, no tables or        */
+/*  branches. Days are counted from 0000-03-01 shifted back by         */
+/*  DT_ERAS 400-year eras, which keeps every int64 millisecond count   */
+/*  non-negative and the years exact.                                  */
+/* ------------------------------------------------------------------ */
+
+#define DT_MS_PER_DAY 86400000
+#define DT_ERAS 780000
+#define DT_SHIFT_DAYS (719468 + (int64_t)146097 * DT_ERAS)
+
+KERNEL
+void east_kernel_datetime_parts(const int64_t *restrict ms, size_t n,
+                                const EastDateTimeColumns *out)
+{
+    int64_t *restrict year = out->year, *restrict month = out->month;
+    int64_t *restrict day = out->day, *restrict hour = out->hour;
+    int64_t *restrict minute = out->minute, *restrict second = out->second;
+    int64_t *restrict milli = out->millisecond, *restrict dow = out->day_of_week;
+    for (size_t i = 0; i < n; i++) {
+        /* Floor division, so times before 1970 land on the earlier day */
+        int64_t q = ms[i] / DT_MS_PER_DAY, r = ms[i] % DT_MS_PER_DAY;
+        int64_t neg = r < 0;
+        q -= neg;
+        uint32_t t = (uint32_t)(r + neg * DT_MS_PER_DAY);
+        hour[i] = t / 3600000;
+        minute[i] = t / 60000 % 60;
+        second[i] = t / 1000 % 60;
+        milli[i] = t % 1000;
+
+        uint64_t nu = (uint64_t)(q + DT_SHIFT_DAYS);
+        /* 1970-01-01 (q = 0) was a Thursday */
+        dow[i] = (int64_t)((nu + 10 - DT_SHIFT_DAYS % 7) % 7) + 1;
+        uint64_t n1 = 4 * nu + 3;
+        uint64_t century = n1 / 146097;
+        uint32_t n2 = (uint32_t)(n1 % 146097) | 3;
+        uint64_t p2 = (uint64_t)2939745 * n2;
+        uint32_t yoc = (uint32_t)(p2 >> 32);
+        uint32_t doy = (uint32_t)p2 / 2939745 / 4;   /* from March 1 */
+        uint32_t n3 = 2141 * doy + 197913;
+        uint32_t jan = doy >= 306;
+        year[i] = (int64_t)(100 * century + yoc) - 400 * (int64_t)DT_ERAS + jan;
+        month[i] = (n3 >> 16) - 12 * jan;
+        day[i] = (n3 & 65535) / 2141 + 1;
+    }
+}
+
+/* ------------------------------------------------------------------ */
+/*  Matrix multiply                                                    */
+/*                                                                     */
+/*  C is computed in MR x NR register tiles. For each KC-deep slice of */
+/*  the shared dimension, an NC-wide block of B is packed into panels  */
+/*  of NR columns (zero-padded at the right edge) so the micro-kernel  */
+/*  streams it contiguously; the panel stays in L1/L2 while every row  */
+/*  tile of A passes over it. Each C element accumulates its products  */
+/*  in ascending k, so blocking and threading do not change results.   */
+/* ------------------------------------------------------------------ */
+
+#define GEMM_MR 4
+#define GEMM_NR 8
+#define GEMM_KC 256
+#define GEMM_NC 512
+
+static void gemm_pack_b(const double *b, size_t n, size_t pc, size_t kb,
+                        size_t jc, size_t nb, double *packed)
+{
+    for (size_t jp = 0; jp * GEMM_NR < nb; jp++) {
+        double *panel = packed + jp * kb * GEMM_NR;
+        size_t j0 = jc + jp * GEMM_NR;
+        size_t w = nb - jp * GEMM_NR < GEMM_NR ? nb - jp * GEMM_NR : GEMM_NR;
+        for (size_t p = 0; p < kb; p++) {
+            const double *src = b + (pc + p) * n + j0;
+            double *dst = panel + p * GEMM_NR;
+            for (size_t j = 0; j < GEMM_NR; j++) dst[j] = j < w ? src[j] : 0.0;
+        }
+    }
+}
+
+/*
+ * C[0..mr, 0..nr] += A[0..mr, 0..kb] * panel. Rows past mr use zero
+ * coefficients and columns past nr are computed but not stored.
+ */
+static inline void gemm_micro(size_t mr, size_t nr, size_t kb,
+                              const double *restrict a, size_t lda,
+                              const double *restrict panel,
+                              double *restrict c, size_t ldc)
+{
+    double acc[GEMM_MR][GEMM_NR];
+    for (size_t r = 0; r < GEMM_MR; r++)
+        for (size_t j = 0; j < GEMM_NR; j++)
+            acc[r][j] = (r < mr && j < nr) ? c[r * ldc + j] : 0.0;
+
+    for (size_t p = 0; p < kb; p++) {
+        const double *bp = panel + p * GEMM_NR;
+        for (size_t r = 0; r < GEMM_MR; r++) {
+            double ar = r < mr ? a[r * lda + p] : 0.0;
+            for (size_t j = 0; j < GEMM_NR; j++) acc[r][j] += ar * bp[j];
+        }
+    }
+
+    for (size_t r = 0; r < mr; r++)
+        for (size_t j = 0; j < nr; j++) c[r * ldc + j] = acc[r][j];
+}
+
+#if defined(__GNUC__)
+/*
+ * Full MR x NR tile with the accumulators held in vector registers; the
+ * generic version above is spilled to the stack by GCC. Same arithmetic.
+ */
+typedef double gemm_v4 __attribute__((vector_size(32), aligned(8)));
+
+static inline void gemm_micro_full(size_t kb, const double *restrict a,
+                                   size_t lda, const double *restrict panel,
+                                   double *restrict c, size_t ldc)
+{
+    gemm_v4 acc[GEMM_MR][2];
+    for (size_t r = 0; r < GEMM_MR; r++) {
+        memcpy(&acc[r][0], c + r * ldc, sizeof(gemm_v4));
+        memcpy(&acc[r][1], c + r * ldc + 4, sizeof(gemm_v4));
+    }
+
+    for (size_t p = 0; p < kb; p++) {
+        gemm_v4 b0, b1;
+        memcpy(&b0, panel + p * GEMM_NR, sizeof(gemm_v4));
+        memcpy(&b1, panel + p * GEMM_NR + 4, sizeof(gemm_v4));
+        for (size_t r = 0; r < GEMM_MR; r++) {
+            double ar = a[r * lda + p];
+            acc[r][0] += ar * b0;
+            acc[r][1] += ar * b1;
+        }
+    }
+
+    for (size_t r = 0; r < GEMM_MR; r++) {
+        memcpy(c + r * ldc, &acc[r][0], sizeof(gemm_v4));
+        memcpy(c + r * ldc + 4, &acc[r][1], sizeof(gemm_v4));
+    }
+}
+#else
+#define gemm_micro_full(kb, a, lda, panel, c, ldc) \
+    gemm_micro(GEMM_MR, GEMM_NR, kb, a, lda, panel, c, ldc)
+#endif
+
+/* Rows [i0, i1) of C; packed holds GEMM_KC * GEMM_NC doubles. */
+KERNEL
+static void gemm_rows_f64(size_t i0, size_t i1, size_t n, size_t k,
+                          const double *a, const double *b, double *c,
+                          double *packed)
+{
+    memset(c + i0 * n, 0, (i1 - i0) * n * sizeof(double));
+    for (size_t jc = 0; jc < n; jc += GEMM_NC) {
+        size_t nb = n - jc < GEMM_NC ? n - jc : GEMM_NC;
+        for (size_t pc = 0; pc < k; pc += GEMM_KC) {
+            size_t kb = k - pc < GEMM_KC ? k - pc : GEMM_KC;
+            gemm_pack_b(b, n, pc, kb, jc, nb, packed);
+            for (size_t i = i0; i < i1; i += GEMM_MR) {
+                size_t mr = i1 - i < GEMM_MR ? i1 - i : GEMM_MR;
+                const double *ai = a + i * k + pc;
+                for (size_t jp = 0; jp * GEMM_NR < nb; jp++) {
+                    size_t nr = nb - jp * GEMM_NR < GEMM_NR ? nb - jp * GEMM_NR : GEMM_NR;
+                    double *cij = c + i * n + jc + jp * GEMM_NR;
+                    const double *panel = packed + jp * kb * GEMM_NR;
+                    if (mr == GEMM_MR && nr == GEMM_NR)
+                        gemm_micro_full(kb, ai, k, panel, cij, n);
+                    else
+                        gemm_micro(mr, nr, kb, ai, k, panel, cij, n);
+                }
+            }
+        }
+    }
+}
+
+typedef struct {
+    size_t i0, i1, n, k;
+    const double *a, *b;
+    double *c;
+} GemmJob;
+
+static void gemm_job_run(GemmJob *job)
+{
+    double *packed = malloc(GEMM_KC * GEMM_NC * sizeof(double));
+    gemm_rows_f64(job->i0, job->i1, job->n, job->k, job->a, job->b, job->c, packed);
+    free(packed);
+}
+
+#ifdef KERNEL_THREADS
+static void *gemm_thread(void *arg)
+{
+    gemm_job_run(arg);
+    return NULL;
+}
+
+static size_t gemm_threads(size_t m, size_t n, size_t k)
+{
+    /* m * n * k, saturating: a product that overflows is large enough */
+    size_t work = m;
+    if (work > SIZE_MAX / n) work = SIZE_MAX; else work *= n;
+    if (work > SIZE_MAX / k) work = SIZE_MAX; else work *= k;
+    if (work < EAST_GEMM_THREAD_MIN) return 1;
+    long t = sysconf(_SC_NPROCESSORS_ONLN);
+    if (t < 1) t = 1;
+    const char *env = getenv("EAST_C_MATRIX_THREADS");
+    if (env && atol(env) > 0 && atol(env) < t) t = atol(env);
+    /* keep at least a few row tiles per thread */
+    size_t max_by_rows = m / (4 * GEMM_MR);
+    if (max_by_rows < 1) max_by_rows = 1;
+    return (size_t)t < max_by_rows ? (size_t)t : max_by_rows;
+}
+#endif
+
+void east_kernel_gemm_f64(size_t m, size_t n, size_t k, const double *a,
+                          const double *b, double *c)
+{
+    if (m == 0 || n == 0) return;
+    if (k == 0) {
+        memset(c, 0, m * n * sizeof(double));
+        return;
+    }
+    size_t nt = 1;
+#ifdef KERNEL_THREADS
+    nt = gemm_threads(m, n, k);
+#endif
+    if (nt <= 1) {
+        GemmJob job = { 0, m, n, k, a, b, c };
+        gemm_job_run(&job);
+        return;
+    }
+#ifdef KERNEL_THREADS
+    /* Row chunks rounded to whole tiles; the caller's thread takes the
+     * first chunk, and any chunk whose thread fails to start runs here. */
+    GemmJob *jobs = calloc(nt, sizeof(GemmJob));
+    pthread_t *threads = calloc(nt, sizeof(pthread_t));
+    bool *started = calloc(nt, sizeof(bool));
+    size_t chunk = (m + nt - 1) / nt;
+    chunk = (chunk + GEMM_MR - 1) / GEMM_MR * GEMM_MR;
+    size_t used = 0;
+    for (size_t t = 0; t < nt && t * chunk < m; t++) {
+        size_t i1 = (t + 1) * chunk < m ? (t + 1) * chunk : m;
+        jobs[t] = (GemmJob){ t * chunk, i1, n, k, a, b, c };
+        used = t + 1;
+    }
+    for (size_t t = 1; t < used; t++)
+        started[t] = pthread_create(&threads[t], NULL, gemm_thread, &jobs[t]) == 0;
+    gemm_job_run(&jobs[0]);
+    for (size_t t = 1; t < used; t++) {
+        if (started[t]) pthread_join(threads[t], NULL);
+        else gemm_job_run(&jobs[t]);
+    }
+    free(started);
+    free(threads);
+    free(jobs);
+#endif
+}
+
+/* Integer products wrap, so plain i-k-j order is exact and vectorizes. */
+KERNEL
+void east_kernel_gemm_i64(size_t m, size_t n, size_t k, const int64_t *a,
+                          const int64_t *b, int64_t *c)
+{
+    memset(c, 0, m * n * sizeof(int64_t));
+    for (size_t i = 0; i < m; i++) {
+        int64_t *restrict ci = c + i * n;
+        for (size_t p = 0; p < k; p++) {
+            const int64_t *restrict bp = b + p * n;
+            int64_t aip = a[i * k + p];
+            for (size_t j = 0; j < n; j++) ci[j] = wrap_add(ci[j], wrap_mul(aip, bp[j]));
+        }
+    }
+}
+
+/* ------------------------------------------------------------------ */
+/*  Factorizations and solves                                          */
+/* ------------------------------------------------------------------ */
+
+static void swap_rows(double *a, size_t cols, size_t i, size_t j)
+{
+    double *ri = a + i * cols, *rj = a + j * cols;
+    for (size_t c = 0; c < cols; c++) {
+        double t = ri[c];
+        ri[c] = rj[c];
+        rj[c] = t;
+    }
+}
+
+bool east_kernel_lu_f64(size_t n, double *a, size_t *perm)
+{
+    for (size_t i = 0; i < n; i++) perm[i] = i;
+    for (size_t col = 0; col < n; col++) {
+        size_t piv = col;
+        double best = fabs(a[col * n + col]);
+        for (size_t r = col + 1; r < n; r++) {
+            double v = fabs(a[r * n + col]);
+            if (v > best) { best = v; piv = r; }
+        }
+        if (best == 0.0 || isnan(best)) return false;
+        if (piv != col) {
+            swap_rows(a, n, piv, col);
+            size_t t = perm[piv]; perm[piv] = perm[col]; perm[col] = t;
+        }
+        const double *prow = a + col * n;
+        double d = prow[col];
+        /* Row updates are contiguous tails: axpy over the trailing block */
+        for (size_t r = col + 1; r < n; r++) {
+            double *row = a + r * n;
+            double l = row[col] / d;
+            row[col] = l;
+            if (l != 0.0)
+                east_kernel_axpy_f64(row + col + 1, -l, prow + col + 1, n - col - 1);
+        }
+    }
+    return true;
+}
+
+void east_kernel_lu_solve_f64(size_t n, const double *lu, const size_t *perm,
+                              double *b, size_t nrhs)
+{
+    double *x = malloc(n * nrhs * sizeof(double));
+    for (size_t i = 0; i < n; i++)
+        memcpy(x + i * nrhs, b + perm[i] * nrhs, nrhs * sizeof(double));
+    /* L y = P b (unit diagonal) */
+    for (size_t i = 1; i < n; i++)
+        for (size_t k = 0; k < i; k++)
+            east_kernel_axpy_f64(x + i * nrhs, -lu[i * n + k], x + k * nrhs, nrhs);
+    /* U x = y */
+    for (size_t i = n; i-- > 0;) {
+        double *xi = x + i * nrhs;
+        for (size_t k = i + 1; k < n; k++)
+            east_kernel_axpy_f64(xi, -lu[i * n + k], x + k * nrhs, nrhs);
+        double d = lu[i * n + i];
+        for (size_t c = 0; c < nrhs; c++) xi[c] /= d;
+    }
+    memcpy(b, x, n * nrhs * sizeof(double));
+    free(x);
+}
+
+bool east_kernel_cholesky_f64(size_t n, double *a)
+{
+    for (size_t j = 0; j < n; j++) {
+        double *rj = a + j * n;
+        double d = rj[j] - east_kernel_dot_f64(rj, rj, j);
+        if (!(d > 0.0)) return false;
+        d = sqrt(d);
+        rj[j] = d;
+        for (size_t c = j + 1; c < n; c++) rj[c] = 0.0;
+        for (size_t i = j + 1; i < n; i++) {
+            double *ri = a + i * n;
+            ri[j] = (ri[j] - east_kernel_dot_f64(ri, rj, j)) / d;
+        }
+    }
+    return true;
+}
+
+void east_kernel_cholesky_solve_f64(size_t n, const double *l, double *b,
+                                    size_t nrhs)
+{
+    /* L y = b */
+    for (size_t i = 0; i < n; i++) {
+        double *bi = b + i * nrhs;
+        for (size_t k = 0; k < i; k++)
+            east_kernel_axpy_f64(bi, -l[i * n + k], b + k * nrhs, nrhs);
+        double d = l[i * n + i];
+        for (size_t c = 0; c < nrhs; c++) bi[c] /= d;
+    }
+    /* L^T x = y */
+    for (size_t i = n; i-- > 0;) {
+        double *bi = b + i * nrhs;
+        for (size_t k = i + 1; k < n; k++)
+            east_kernel_axpy_f64(bi, -l[k * n + i], b + k * nrhs, nrhs);
+        double d = l[i * n + i];
+        for (size_t c = 0; c < nrhs; c++) bi[c] /= d;
+    }
+}
+
+/* ------------------------------------------------------------------ */
+/*  Transpose                                                          */
+/*                                                                     */
+/*  Cache-oblivious: halve the longer side until the block is at most  */
+/*  TRANSPOSE_LEAF square, so at some level of the recursion both the  */
+/*  source rows and destination rows being touched fit in each cache   */
+/*  level, whatever its size.                                          */
+/* ------------------------------------------------------------------ */
+
+#define TRANSPOSE_LEAF 16
+
+#define DEFINE_TRANSPOSE(name, ES)                                          \
+static void name(size_t r0, size_t r1, size_t c0, size_t c1, size_t rows,   \
+                 size_t cols, const char *restrict src, char *restrict dst) \
+{                                                                           \
+    while (r1 - r0 > TRANSPOSE_LEAF || c1 - c0 > TRANSPOSE_LEAF) {          \
+        if (r1 - r0 >= c1 - c0) {                                           \
+            size_t rm = r0 + (r1 - r0) / 2;                                 \
+            name(r0, rm, c0, c1, rows, cols, src, dst);                     \
+            r0 = rm;                                                        \
+        } else {                                                            \
+            size_t cm = c0 + (c1 - c0) / 2;                                 \
+            name(r0, r1, c0, cm, rows, cols, src, dst);                     \
+            c0 = cm;                                                        \
+        }                                                                   \
+    }                                                                       \
+    for (size_t r = r0; r < r1; r++)                                        \
+        for (size_t c = c0; c < c1; c++)                                    \
+            memcpy(dst + (c * rows + r) * ES, src + (r * cols + c) * ES, ES); \
+}
+
+DEFINE_TRANSPOSE(transpose_8, 8)
+DEFINE_TRANSPOSE(transpose_1, 1)
+
+void east_kernel_transpose(size_t rows, size_t cols, size_t elem_size,
+                           const void *src, void *dst)
+{
+    if (elem_size == 8)
+        transpose_8(0, rows, 0, cols, rows, cols, src, dst);
+    else if (elem_size == 1)
+        transpose_1(0, rows, 0, cols, rows, cols, src, dst);
+    else
+        for (size_t r = 0; r < rows; r++)
+            for (size_t c = 0; c < cols; c++)
+                memcpy((char *)dst + (c * rows + r) * elem_size,
+                       (const char *)src + (r * cols + c) * elem_size, elem_size);
+}
@@ -0,0 +1,357 @@
+#include "east/memory.h"
+
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if !defined(__EMSCRIPTEN__)
+#include <sys/resource.h>
+#endif
+
+#define NUM_VALUE_KINDS (EAST_VAL_FUNCTION + 1)
+
+bool east_mem_accounting = false;
+
+/* ------------------------------------------------------------------ */
+/*  Counters                                                           */
+/* ------------------------------------------------------------------ */
+
+typedef struct {
+    _Atomic int64_t live;
+    _Atomic int64_t peak;
+    _Atomic int64_t objects;
+} Counter;
+
+static Counter total_counter;
+static Counter subsystem_counters[EAST_MEM_NUM_SUBSYSTEMS];
+static Counter kind_counters[NUM_VALUE_KINDS];
+static _Atomic uint64_t mem_limit = 0;
+
+/* Per-thread running totals, used to attribute bytes to builtin calls. */
+static _Thread_local int64_t thread_allocated = 0;
+static _Thread_local int64_t thread_net = 0;
+
+static void counter_add(Counter *c, int64_t bytes, int64_t objects)
+{
+    int64_t live = atomic_load_explicit(&c->live, memory_order_relaxed);
+    int64_t now;
+    do {
+        now = live + bytes;
+        if (now < 0) now = 0;
+    } while (!atomic_compare_exchange_weak_explicit(
+                 &c->live, &live, now,
+                 memory_order_relaxed, memory_order_relaxed));
+
+    if (objects) {
+        int64_t n = atomic_fetch_add_explicit(&c->objects, objects,
+                                              memory_order_relaxed) + objects;
+        if (n < 0) atomic_store_explicit(&c->objects, 0, memory_order_relaxed);
+    }
+
+    int64_t peak = atomic_load_explicit(&c->peak, memory_order_relaxed);
+    while (now > peak &&
+           !atomic_compare_exchange_weak_explicit(
+               &c->peak, &peak, now,
+               memory_order_relaxed, memory_order_relaxed)) {
+    }
+}
+
+static EastMemStats counter_stats(Counter *c)
+{
+    EastMemStats s;
+    s.live = (uint64_t)atomic_load_explicit(&c->live, memory_order_relaxed);
+    s.peak = (uint64_t)atomic_load_explicit(&c->peak, memory_order_relaxed);
+    s.objects = (uint64_t)atomic_load_explicit(&c->objects, memory_order_relaxed);
+    return s;
+}
+
+void east_mem_account(EastMemSubsystem s, int value_kind, int64_t bytes,
+                      int64_t objects)
+{
+    if (bytes > 0) thread_allocated += bytes;
+    thread_net += bytes;
+
+    counter_add(&total_counter, bytes, objects);
+    counter_add(&subsystem_counters[s], bytes, objects);
+    if (value_kind >= 0 && value_kind < NUM_VALUE_KINDS) {
+        counter_add(&kind_counters[value_kind], bytes, objects);
+    }
+}
+
+/* ------------------------------------------------------------------ */
+/*  Builtin call sites                                                 */
+/*                                                                     */
+/*  Open-addressed table keyed by IR node. Sites are named when first  */
+/*  seen, so the report stays valid after the IR has been released.    */
+/*  Worker threads share the table, guarded by a spinlock.             */
+/* ------------------------------------------------------------------ */
+
+typedef struct {
+    IRNode *node;
+    char *name;
+    uint64_t calls;
+    int64_t allocated;
+    int64_t retained;
+} MemSite;
+
+static MemSite *sites = NULL;
+static size_t sites_mask = 0;
+static size_t sites_count = 0;
+static atomic_flag sites_lock = ATOMIC_FLAG_INIT;
+
+static inline size_t site_slot(IRNode *node, size_t mask)
+{
+    return (size_t)((uint64_t)(uintptr_t)node * 0x9E3779B97F4A7C15ULL >> 40) & mask;
+}
+
+static char *site_name(IRNode *node)
+{
+    char buf[512];
+    const char *name = node->kind == IR_BUILTIN ? node->data.builtin.name : "?";
+    if (node->num_locations > 0) {
+        const EastLocation *loc = &node->locations[0];
+        snprintf(buf, sizeof(buf), "%s %s:%lld:%lld", name,
+                 loc->filename ? loc->filename : "?",
+                 (long long)loc->line, (long long)loc->column);
+    } else {
+        snprintf(buf, sizeof(buf), "%s <unknown>", name);
+    }
+    return strdup(buf);
+}
+
+static MemSite *site_lookup(IRNode *node)
+{
+    if (sites_count * 2 >= sites_mask) {
+        size_t cap = sites ? (sites_mask + 1) * 2 : 256;
+        MemSite *grown = calloc(cap, sizeof(MemSite));
+        if (!grown) return NULL;
+        for (size_t i = 0; sites && i <= sites_mask; i++) {
+            if (!sites[i].node) continue;
+            size_t j = site_slot(sites[i].node, cap - 1);
+            while (grown[j].node) j = (j + 1) & (cap - 1);
+            grown[j] = sites[i];
+        }
+        free(sites);
+        sites = grown;
+        sites_mask = cap - 1;
+    }
+
+    size_t i = site_slot(node, sites_mask);
+    while (sites[i].node && sites[i].node != node) i = (i + 1) & sites_mask;
+    if (!sites[i].node) {
+        sites[i].node = node;
+        sites[i].name = site_name(node);
+        sites_count++;
+    }
+    return &sites[i];
+}
+
+EastMemMark east_mem_mark(void)
+{
+    EastMemMark m = { thread_allocated, thread_net };
+    return m;
+}
+
+void east_mem_builtin_done(IRNode *node, EastMemMark mark)
+{
+    int64_t allocated = thread_allocated - mark.allocated;
+    int64_t retained = thread_net - mark.net;
+
+    while (atomic_flag_test_and_set_explicit(&sites_lock, memory_order_acquire)) {
+    }
+    MemSite *s = site_lookup(node);
+    if (s) {
+        s->calls++;
+        s->allocated += allocated;
+        s->retained += retained;
+    }
+    atomic_flag_clear_explicit(&sites_lock, memory_order_release);
+}
+
+static void sites_clear(void)
+{
+    for (size_t i = 0; sites && i <= sites_mask; i++) free(sites[i].name);
+    free(sites);
+    sites = NULL;
+    sites_mask = 0;
+    sites_count = 0;
+}
+
+/* ------------------------------------------------------------------ */
+/*  Control                                                            */
+/* ------------------------------------------------------------------ */
+
+void east_mem_enable(void) { east_mem_accounting = true; }
+void east_mem_disable(void) { east_mem_accounting = false; }
+
+void east_mem_set_limit(uint64_t bytes)
+{
+    atomic_store_explicit(&mem_limit, bytes, memory_order_relaxed);
+}
+
+uint64_t east_mem_get_limit(void)
+{
+    return atomic_load_explicit(&mem_limit, memory_order_relaxed);
+}
+
+static void counter_reset_peak(Counter *c)
+{
+    atomic_store_explicit(&c->peak,
+                          atomic_load_explicit(&c->live, memory_order_relaxed),
+                          memory_order_relaxed);
+}
+
+void east_mem_reset(void)
+{
+    while (atomic_flag_test_and_set_explicit(&sites_lock, memory_order_acquire)) {
+    }
+    sites_clear();
+    atomic_flag_clear_explicit(&sites_lock, memory_order_release);
+
+    counter_reset_peak(&total_counter);
+    for (int i = 0; i < EAST_MEM_NUM_SUBSYSTEMS; i++) counter_reset_peak(&subsystem_counters[i]);
+    for (int i = 0; i < NUM_VALUE_KINDS; i++) counter_reset_peak(&kind_counters[i]);
+}
+
+EastMemStats east_mem_total(void) { return counter_stats(&total_counter); }
+
+EastMemStats east_mem_subsystem(EastMemSubsystem s)
+{
+    return counter_stats(&subsystem_counters[s]);
+}
+
+EastMemStats east_mem_value_kind(EastValueKind kind)
+{
+    return counter_stats(&kind_counters[kind]);
+}
+
+const char *east_mem_subsystem_name(EastMemSubsystem s)
+{
+    switch (s) {
+    case EAST_MEM_VALUES:  return "values";
+    case EAST_MEM_ENV:     return "environments";
+    case EAST_MEM_IR:      return "ir";
+    case EAST_MEM_TYPES:   return "types";
+    case EAST_MEM_BUFFERS: return "buffers";
+    default:               return "?";
+    }
+}
+
+uint64_t east_mem_peak_rss(void)
+{
+#if defined(__EMSCRIPTEN__)
+    return 0;
+#else
+    struct rusage ru;
+    if (getrusage(RUSAGE_SELF, &ru) != 0) return 0;
+#if defined(__APPLE__)
+    return (uint64_t)ru.ru_maxrss;          /* bytes */
+#else
+    return (uint64_t)ru.ru_maxrss * 1024;   /* kilobytes */
+#endif
+#endif
+}
+
+/* ------------------------------------------------------------------ */
+/*  Soft limit                                                         */
+/* ------------------------------------------------------------------ */
+
+bool east_mem_over_limit(void)
+{
+    uint64_t limit = atomic_load_explicit(&mem_limit, memory_order_relaxed);
+    if (limit == 0) return false;
+    return (uint64_t)atomic_load_explicit(&total_counter.live,
+                                          memory_order_relaxed) > limit;
+}
+
+static void format_bytes(char *buf, size_t size, double bytes)
+{
+    if (bytes < 1024) snprintf(buf, size, "%.0f B", bytes);
+    else if (bytes < 1024.0 * 1024) snprintf(buf, size, "%.1f KiB", bytes / 1024);
+    else if (bytes < 1024.0 * 1024 * 1024) snprintf(buf, size, "%.1f MiB", bytes / (1024.0 * 1024));
+    else snprintf(buf, size, "%.2f GiB", bytes / (1024.0 * 1024 * 1024));
+}
+
+char *east_mem_limit_message(void)
+{
+    char live[32], limit[32], msg[128];
+    format_bytes(live, sizeof(live), (double)east_mem_total().live);
+    format_bytes(limit, sizeof(limit), (double)east_mem_get_limit());
+    snprintf(msg, sizeof(msg), "Memory limit exceeded: %s live, limit %s",
+             live, limit);
+    return strdup(msg);
+}
+
+/* ------------------------------------------------------------------ */
+/*  Report                                                             */
+/* ------------------------------------------------------------------ */
+
+static void write_row(FILE *out, const char *name, EastMemStats s)
+{
+    char live[32], peak[32];
+    format_bytes(live, sizeof(live), (double)s.live);
+    format_bytes(peak, sizeof(peak), (double)s.peak);
+    fprintf(out, "  %-16s %12s %12s %12llu\n", name, live, peak,
+            (unsigned long long)s.objects);
+}
+
+static int site_cmp(const void *a, const void *b)
+{
+    const MemSite *x = a, *y = b;
+    if (x->retained != y->retained) return x->retained < y->retained ? 1 : -1;
+    if (x->allocated != y->allocated) return x->allocated < y->allocated ? 1 : -1;
+    return strcmp(x->name, y->name);
+}
+
+void east_mem_write_report(FILE *out, size_t max_sites)
+{
+    fprintf(out, "  %-16s %12s %12s %12s\n", "subsystem", "live", "peak", "objects");
+    for (int i = 0; i < EAST_MEM_NUM_SUBSYSTEMS; i++) {
+        write_row(out, east_mem_subsystem_name((EastMemSubsystem)i),
+                  east_mem_subsystem((EastMemSubsystem)i));
+    }
+    write_row(out, "total", east_mem_total());
+
+    fprintf(out, "\n  %-16s %12s %12s %12s\n", "value kind", "live", "peak", "objects");
+    for (int k = 0; k < NUM_VALUE_KINDS; k++) {
+        EastMemStats s = east_mem_value_kind((EastValueKind)k);
+        if (s.peak == 0) continue;
+        write_row(out, east_value_kind_name((EastValueKind)k), s);
+    }
+
+    while (atomic_flag_test_and_set_explicit(&sites_lock, memory_order_acquire)) {
+    }
+    MemSite *sorted = sites_count ? calloc(sites_count, sizeof(MemSite)) : NULL;
+    size_t n = 0;
+    for (size_t i = 0; sorted && i <= sites_mask; i++) {
+        if (sites[i].node) sorted[n++] = sites[i];
+    }
+    if (sorted) qsort(sorted, n, sizeof(MemSite), site_cmp);
+    if (n > 0) {
+        size_t rows = (max_sites && max_sites < n) ? max_sites : n;
+        fprintf(out, "\n  %-40s %10s %12s %12s\n", "builtin call site", "calls",
+                "allocated", "retained");
+        for (size_t i = 0; i < rows; i++) {
+            char alloc[32], kept[32];
+            format_bytes(alloc, sizeof(alloc), (double)sorted[i].allocated);
+            if (sorted[i].retained < 0) {
+                format_bytes(kept + 1, sizeof(kept) - 1, (double)-sorted[i].retained);
+                kept[0] = '-';
+            } else {
+                format_bytes(kept, sizeof(kept), (double)sorted[i].retained);
+            }
+            fprintf(out, "  %-40s %10llu %12s %12s\n", sorted[i].name,
+                    (unsigned long long)sorted[i].calls, alloc, kept);
+        }
+        if (rows < n) fprintf(out, "  ... %zu more sites\n", n - rows);
+    }
+    free(sorted);
+    atomic_flag_clear_explicit(&sites_lock, memory_order_release);
+
+    char rss[32];
+    uint64_t peak_rss = east_mem_peak_rss();
+    if (peak_rss) {
+        format_bytes(rss, sizeof(rss), (double)peak_rss);
+        fprintf(out, "\n  peak RSS: %s\n", rss);
+    }
+}
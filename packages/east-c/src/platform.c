@@ -2,7 +2,8 @@
  * Platform function registry implementation.
  *
  * Maps function names to PlatformFn pointers (concrete) or
- * GenericPlatformFactory functions (type-parameterised).
+ * GenericPlatformFactory functions (type-parameterised). Pure synchronous
+ * functions may also carry a PlatformBatchFn.
  */
 #include "east/platform.h"
 #include "east/hashmap.h"
@@ -58,6 +59,28 @@ PlatformFn platform_registry_get(PlatformRegistry *reg, const char *name,
     return NULL;
 }
 
+void platform_registry_set_batch(PlatformRegistry *reg, const char *name,
+                                 PlatformBatchFn batch)
+{
+    if (!reg || !name) return;
+    PlatformFunction *pf = hashmap_get(reg->functions, name);
+    if (pf) {
+        if (!pf->is_async) pf->batch = batch;
+        return;
+    }
+    GenericPlatformFunction *gf = hashmap_get(reg->generic_functions, name);
+    if (gf && !gf->is_async) gf->batch = batch;
+}
+
+PlatformBatchFn platform_registry_get_batch(PlatformRegistry *reg, const char *name)
+{
+    if (!reg || !name) return NULL;
+    PlatformFunction *pf = hashmap_get(reg->functions, name);
+    if (pf) return pf->batch;
+    GenericPlatformFunction *gf = hashmap_get(reg->generic_functions, name);
+    return gf ? gf->batch : NULL;
+}
+
 static void free_pf(void *v) { free(v); }
 
 void platform_registry_free(PlatformRegistry *reg)
@@ -0,0 +1,469 @@
+/*
+ * Execution profiler: calling-context tree of function, loop, builtin,
+ * platform and GC frames with inclusive/exclusive wall-clock time.
+ */
+
+#include "east/profiler.h"
+#include "east/hashmap.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+_Thread_local EastProfiler *east_profiler_active = NULL;
+
+#define NO_NODE SIZE_MAX
+
+typedef struct {
+    EastProfileKind kind;
+    char *name;
+} ProfSite;
+
+/* One node per distinct stack of sites. */
+typedef struct {
+    size_t site;
+    size_t parent;
+    size_t first_child;
+    size_t next_sibling;
+    uint64_t total_ns;
+    uint64_t child_ns;
+    uint64_t calls;
+} ProfNode;
+
+typedef struct {
+    size_t node;
+    uint64_t start;
+} ProfFrame;
+
+/* IRNode pointer (tagged with the frame kind) -> site index. */
+typedef struct {
+    uintptr_t key;
+    size_t site;
+} SiteSlot;
+
+struct EastProfiler {
+    ProfSite *sites;
+    size_t num_sites;
+    size_t cap_sites;
+
+    ProfNode *nodes;
+    size_t num_nodes;
+    size_t cap_nodes;
+
+    ProfFrame *stack;
+    size_t depth;
+    size_t cap_stack;
+
+    SiteSlot *slots;
+    size_t slot_mask;
+    size_t slot_count;
+
+    Hashmap *by_name;       /* site name -> (void *)(site index + 1) */
+    size_t gc_site;
+};
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+/* ------------------------------------------------------------------ */
+/*  Sites                                                              */
+/* ------------------------------------------------------------------ */
+
+static size_t site_intern(EastProfiler *p, EastProfileKind kind, const char *name)
+{
+    void *found = hashmap_get(p->by_name, name);
+    if (found) return (size_t)(uintptr_t)found - 1;
+
+    if (p->num_sites == p->cap_sites) {
+        size_t cap = p->cap_sites ? p->cap_sites * 2 : 64;
+        ProfSite *s = realloc(p->sites, cap * sizeof(ProfSite));
+        if (!s) return 0;
+        p->sites = s;
+        p->cap_sites = cap;
+    }
+    size_t idx = p->num_sites++;
+    p->sites[idx].kind = kind;
+    p->sites[idx].name = strdup(name);
+    /* ';' separates frames in folded output */
+    for (char *c = p->sites[idx].name; c && *c; c++) {
+        if (*c == ';') *c = ',';
+    }
+    hashmap_set(p->by_name, name, (void *)(uintptr_t)(idx + 1));
+    return idx;
+}
+
+static void site_name(EastProfileKind kind, IRNode *node, char *buf, size_t size)
+{
+    const char *what = "fn";
+    switch (kind) {
+    case EAST_PROFILE_BUILTIN:
+        snprintf(buf, size, "%s", node->data.builtin.name);
+        return;
+    case EAST_PROFILE_PLATFORM:
+        snprintf(buf, size, "platform:%s", node->data.platform.name);
+        return;
+    case EAST_PROFILE_GC:
+        snprintf(buf, size, "[gc]");
+        return;
+    case EAST_PROFILE_ROOT:
+        snprintf(buf, size, "[east]");
+        return;
+    case EAST_PROFILE_LOOP:
+        what = node->kind == IR_WHILE ? "while" : "for";
+        break;
+    case EAST_PROFILE_FUNCTION:
+        break;
+    }
+
+    if (node && node->num_locations > 0) {
+        const EastLocation *loc = &node->locations[0];
+        snprintf(buf, size, "%s %s:%lld:%lld", what,
+                 loc->filename ? loc->filename : "?",
+                 (long long)loc->line, (long long)loc->column);
+    } else {
+        snprintf(buf, size, "%s <unknown>", what);
+    }
+}
+
+static inline size_t slot_of(uintptr_t key, size_t mask)
+{
+    return (size_t)((uint64_t)key * 0x9E3779B97F4A7C15ULL >> 40) & mask;
+}
+
+static size_t site_for(EastProfiler *p, EastProfileKind kind, IRNode *node)
+{
+    if (kind == EAST_PROFILE_GC) return p->gc_site;
+
+    uintptr_t key = (uintptr_t)node | (uintptr_t)kind;
+    if (p->slots) {
+        size_t i = slot_of(key, p->slot_mask);
+        while (p->slots[i].key) {
+            if (p->slots[i].key == key) return p->slots[i].site;
+            i = (i + 1) & p->slot_mask;
+        }
+    }
+
+    char name[512];
+    site_name(kind, node, name, sizeof(name));
+    size_t site = site_intern(p, kind, name);
+
+    if (!p->slots || (p->slot_count + 1) * 2 > p->slot_mask + 1) {
+        size_t cap = p->slots ? (p->slot_mask + 1) * 2 : 256;
+        SiteSlot *slots = calloc(cap, sizeof(SiteSlot));
+        if (!slots) return site;
+        for (size_t i = 0; p->slots && i <= p->slot_mask; i++) {
+            if (!p->slots[i].key) continue;
+            size_t j = slot_of(p->slots[i].key, cap - 1);
+            while (slots[j].key) j = (j + 1) & (cap - 1);
+            slots[j] = p->slots[i];
+        }
+        free(p->slots);
+        p->slots = slots;
+        p->slot_mask = cap - 1;
+    }
+    size_t i = slot_of(key, p->slot_mask);
+    while (p->slots[i].key) i = (i + 1) & p->slot_mask;
+    p->slots[i].key = key;
+    p->slots[i].site = site;
+    p->slot_count++;
+    return site;
+}
+
+/* ------------------------------------------------------------------ */
+/*  Calling-context tree                                               */
+/* ------------------------------------------------------------------ */
+
+static size_t node_child(EastProfiler *p, size_t parent, size_t site)
+{
+    size_t prev = NO_NODE;
+    size_t first = parent == NO_NODE ? NO_NODE : p->nodes[parent].first_child;
+    for (size_t c = first; c != NO_NODE;
+         prev = c, c = p->nodes[c].next_sibling) {
+        if (p->nodes[c].site != site) continue;
+        if (prev != NO_NODE) {
+            /* Move to front: hot children are found first next time */
+            p->nodes[prev].next_sibling = p->nodes[c].next_sibling;
+            p->nodes[c].next_sibling = p->nodes[parent].first_child;
+            p->nodes[parent].first_child = c;
+        }
+        return c;
+    }
+
+    if (p->num_nodes == p->cap_nodes) {
+        size_t cap = p->cap_nodes ? p->cap_nodes * 2 : 256;
+        ProfNode *n = realloc(p->nodes, cap * sizeof(ProfNode));
+        if (!n) return NO_NODE;
+        p->nodes = n;
+        p->cap_nodes = cap;
+    }
+    size_t idx = p->num_nodes++;
+    p->nodes[idx] = (ProfNode){
+        .site = site,
+        .parent = parent,
+        .first_child = NO_NODE,
+        .next_sibling = first,
+    };
+    if (parent != NO_NODE) p->nodes[parent].first_child = idx;
+    return idx;
+}
+
+static void push_frame(EastProfiler *p, size_t node)
+{
+    if (p->depth == p->cap_stack) {
+        size_t cap = p->cap_stack ? p->cap_stack * 2 : 64;
+        ProfFrame *s = realloc(p->stack, cap * sizeof(ProfFrame));
+        if (!s) return;
+        p->stack = s;
+        p->cap_stack = cap;
+    }
+    p->stack[p->depth].node = node;
+    p->stack[p->depth].start = now_ns();
+    p->depth++;
+}
+
+static void pop_frame(EastProfiler *p)
+{
+    if (p->depth == 0) return;
+    p->depth--;
+    ProfFrame *f = &p->stack[p->depth];
+    uint64_t dt = now_ns() - f->start;
+    ProfNode *n = &p->nodes[f->node];
+    n->total_ns += dt;
+    n->calls++;
+    if (n->parent != NO_NODE) p->nodes[n->parent].child_ns += dt;
+}
+
+void east_profiler_enter(EastProfileKind kind, IRNode *node)
+{
+    EastProfiler *p = east_profiler_active;
+    if (!p || p->depth == 0) return;
+    size_t site = site_for(p, kind, node);
+    size_t child = node_child(p, p->stack[p->depth - 1].node, site);
+    if (child == NO_NODE) {
+        /* Out of memory: charge this frame to the parent */
+        child = p->stack[p->depth - 1].node;
+    }
+    push_frame(p, child);
+}
+
+void east_profiler_exit(void)
+{
+    EastProfiler *p = east_profiler_active;
+    /* The root frame is only closed by east_profiler_stop */
+    if (!p || p->depth <= 1) return;
+    pop_frame(p);
+}
+
+/* ------------------------------------------------------------------ */
+/*  Lifecycle                                                          */
+/* ------------------------------------------------------------------ */
+
+EastProfiler *east_profiler_new(void)
+{
+    EastProfiler *p = calloc(1, sizeof(EastProfiler));
+    if (!p) return NULL;
+    p->by_name = hashmap_new();
+    size_t root_site = site_intern(p, EAST_PROFILE_ROOT, "[east]");
+    p->gc_site = site_intern(p, EAST_PROFILE_GC, "[gc]");
+    node_child(p, NO_NODE, root_site);
+    return p;
+}
+
+void east_profiler_free(EastProfiler *p)
+{
+    if (!p) return;
+    if (east_profiler_active == p) east_profiler_active = NULL;
+    for (size_t i = 0; i < p->num_sites; i++) free(p->sites[i].name);
+    free(p->sites);
+    free(p->nodes);
+    free(p->stack);
+    free(p->slots);
+    hashmap_free(p->by_name, NULL);
+    free(p);
+}
+
+void east_profiler_start(EastProfiler *p)
+{
+    if (!p || p->depth > 0) return;
+    east_profiler_active = p;
+    push_frame(p, 0);
+}
+
+void east_profiler_stop(EastProfiler *p)
+{
+    if (!p) return;
+    while (p->depth > 0) pop_frame(p);
+    if (east_profiler_active == p) east_profiler_active = NULL;
+}
+
+uint64_t east_profiler_total_ns(EastProfiler *p)
+{
+    return p && p->num_nodes > 0 ? p->nodes[0].total_ns : 0;
+}
+
+uint64_t east_profiler_gc_ns(EastProfiler *p)
+{
+    if (!p) return 0;
+    uint64_t ns = 0;
+    for (size_t i = 0; i < p->num_nodes; i++) {
+        if (p->nodes[i].site == p->gc_site) ns += p->nodes[i].total_ns;
+    }
+    return ns;
+}
+
+/* ------------------------------------------------------------------ */
+/*  Output                                                             */
+/* ------------------------------------------------------------------ */
+
+static uint64_t node_self_ns(const ProfNode *n)
+{
+    return n->total_ns > n->child_ns ? n->total_ns - n->child_ns : 0;
+}
+
+/* Pre-order walk without recursion (stacks can be very deep). */
+static size_t next_preorder(EastProfiler *p, size_t n)
+{
+    if (p->nodes[n].first_child != NO_NODE) return p->nodes[n].first_child;
+    while (n != NO_NODE) {
+        if (p->nodes[n].next_sibling != NO_NODE) return p->nodes[n].next_sibling;
+        n = p->nodes[n].parent;
+    }
+    return NO_NODE;
+}
+
+bool east_profiler_write_folded(EastProfiler *p, FILE *out)
+{
+    if (!p || !out || p->num_nodes == 0) return false;
+
+    /* path_len[n] = length of the folded path up to and including n */
+    size_t *path_len = calloc(p->num_nodes, sizeof(size_t));
+    size_t cap = 1024;
+    char *path = malloc(cap);
+    if (!path_len || !path) {
+        free(path_len);
+        free(path);
+        return false;
+    }
+
+    for (size_t n = 0; n != NO_NODE; n = next_preorder(p, n)) {
+        const ProfNode *node = &p->nodes[n];
+        size_t base = node->parent == NO_NODE ? 0 : path_len[node->parent];
+        const char *name = p->sites[node->site].name;
+        size_t name_len = strlen(name);
+        size_t need = base + 1 + name_len + 1;
+        if (need > cap) {
+            while (cap < need) cap *= 2;
+            char *np = realloc(path, cap);
+            if (!np) break;
+            path = np;
+        }
+        size_t off = base;
+        if (base > 0) path[off++] = ';';
+        memcpy(path + off, name, name_len);
+        path_len[n] = off + name_len;
+
+        uint64_t self = node_self_ns(node);
+        if (self > 0) {
+            fprintf(out, "%.*s %llu\n", (int)path_len[n], path, (unsigned long long)self);
+        }
+    }
+
+    free(path_len);
+    free(path);
+    return !ferror(out);
+}
+
+typedef struct {
+    size_t site;
+    uint64_t self_ns;
+    uint64_t total_ns;
+    uint64_t calls;
+} SiteTotals;
+
+static int cmp_self_desc(const void *a, const void *b)
+{
+    const SiteTotals *x = a, *y = b;
+    if (x->self_ns != y->self_ns) return x->self_ns < y->self_ns ? 1 : -1;
+    return x->total_ns < y->total_ns ? 1 : (x->total_ns > y->total_ns ? -1 : 0);
+}
+
+static const char *kind_label(EastProfileKind kind)
+{
+    switch (kind) {
+    case EAST_PROFILE_ROOT:     return "root";
+    case EAST_PROFILE_FUNCTION: return "function";
+    case EAST_PROFILE_LOOP:     return "loop";
+    case EAST_PROFILE_BUILTIN:  return "builtin";
+    case EAST_PROFILE_PLATFORM: return "platform";
+    case EAST_PROFILE_GC:       return "gc";
+    }
+    return "?";
+}
+
+void east_profiler_write_summary(EastProfiler *p, FILE *out, size_t max_rows)
+{
+    if (!p || !out || p->num_nodes == 0) return;
+
+    SiteTotals *totals = calloc(p->num_sites, sizeof(SiteTotals));
+    /* Number of open frames per site on the current walk path, so a
+     * recursive site's inclusive time is only counted at its outermost
+     * activation. */
+    size_t *open = calloc(p->num_sites, sizeof(size_t));
+    if (!totals || !open) {
+        free(totals);
+        free(open);
+        return;
+    }
+    for (size_t i = 0; i < p->num_sites; i++) totals[i].site = i;
+
+    for (size_t n = 0; n != NO_NODE;) {
+        const ProfNode *node = &p->nodes[n];
+        SiteTotals *t = &totals[node->site];
+        t->self_ns += node_self_ns(node);
+        t->calls += node->calls;
+        if (open[node->site] == 0) t->total_ns += node->total_ns;
+
+        if (node->first_child != NO_NODE) {
+            open[node->site]++;
+            n = node->first_child;
+            continue;
+        }
+        /* Leave finished subtrees, closing their sites */
+        while (n != NO_NODE && p->nodes[n].next_sibling == NO_NODE) {
+            n = p->nodes[n].parent;
+            if (n != NO_NODE) open[p->nodes[n].site]--;
+        }
+        if (n != NO_NODE) n = p->nodes[n].next_sibling;
+    }
+
+    uint64_t total = p->nodes[0].total_ns;
+    uint64_t gc_ns = totals[p->gc_site].total_ns;
+    fprintf(out, "Profile: %.3f ms total, GC %.3f ms in %llu collections\n\n",
+            (double)total / 1e6, (double)gc_ns / 1e6,
+            (unsigned long long)totals[p->gc_site].calls);
+
+    qsort(totals, p->num_sites, sizeof(SiteTotals), cmp_self_desc);
+    fprintf(out, "  %10s %6s %10s %10s  %-8s  %s\n",
+            "self ms", "self%", "total ms", "calls", "kind", "site");
+    size_t rows = 0;
+    for (size_t i = 0; i < p->num_sites; i++) {
+        const SiteTotals *t = &totals[i];
+        if (t->calls == 0) continue;
+        if (max_rows && rows++ >= max_rows) break;
+        const ProfSite *s = &p->sites[t->site];
+        fprintf(out, "  %10.3f %5.1f%% %10.3f %10llu  %-8s  %s\n",
+                (double)t->self_ns / 1e6,
+                total ? 100.0 * (double)t->self_ns / (double)total : 0.0,
+                (double)t->total_ns / 1e6,
+                (unsigned long long)t->calls,
+                kind_label(s->kind), s->name);
+    }
+
+    free(totals);
+    free(open);
+}
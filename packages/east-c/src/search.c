@@ -0,0 +1,213 @@
+#include "east/search.h"
+
+#include <stdbool.h>
+#include <string.h>
+
+/*
+ * SSE2 is part of x86-64, so it is used unconditionally there. The AVX2
+ * variants are compiled with a target attribute and chosen per call when
+ * the running CPU supports them.
+ */
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <immintrin.h>
+#define SEARCH_SSE2 1
+#if !defined(__clang__) || __clang_major__ >= 14
+#define SEARCH_AVX2 1
+#define AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+/* ------------------------------------------------------------------ */
+/*  Short needles                                                      */
+/* ------------------------------------------------------------------ */
+
+/* memchr for the first byte, then the last byte, then the rest */
+static const char *find_scalar(const char *hay, size_t hlen,
+                               const char *needle, size_t nlen)
+{
+    if (hlen < nlen) return NULL;
+    const char *end = hay + (hlen - nlen) + 1;   /* last start + 1 */
+    for (const char *p = hay; p < end; p++) {
+        p = memchr(p, needle[0], (size_t)(end - p));
+        if (!p) return NULL;
+        if (p[nlen - 1] == needle[nlen - 1] && memcmp(p, needle, nlen) == 0)
+            return p;
+    }
+    return NULL;
+}
+
+#ifdef SEARCH_SSE2
+/* Bit k of each mask marks a start i + k whose first and last bytes match */
+static const char *find_short_sse2(const char *hay, size_t hlen,
+                                   const char *needle, size_t nlen)
+{
+    const __m128i first = _mm_set1_epi8(needle[0]);
+    const __m128i last = _mm_set1_epi8(needle[nlen - 1]);
+    size_t i = 0;
+    for (; hlen >= nlen + 15 && i <= hlen - nlen - 15; i += 16) {
+        __m128i a = _mm_loadu_si128((const __m128i *)(hay + i));
+        __m128i b = _mm_loadu_si128((const __m128i *)(hay + i + nlen - 1));
+        unsigned m = (unsigned)_mm_movemask_epi8(
+            _mm_and_si128(_mm_cmpeq_epi8(a, first), _mm_cmpeq_epi8(b, last)));
+        for (; m; m &= m - 1) {
+            const char *p = hay + i + __builtin_ctz(m);
+            if (memcmp(p + 1, needle + 1, nlen - 2) == 0) return p;
+        }
+    }
+    return find_scalar(hay + i, hlen - i, needle, nlen);
+}
+#endif
+
+#ifdef SEARCH_AVX2
+AVX2 static const char *find_short_avx2(const char *hay, size_t hlen,
+                                        const char *needle, size_t nlen)
+{
+    const __m256i first = _mm256_set1_epi8(needle[0]);
+    const __m256i last = _mm256_set1_epi8(needle[nlen - 1]);
+    size_t i = 0;
+    for (; hlen >= nlen + 31 && i <= hlen - nlen - 31; i += 32) {
+        __m256i a = _mm256_loadu_si256((const __m256i *)(hay + i));
+        __m256i b = _mm256_loadu_si256((const __m256i *)(hay + i + nlen - 1));
+        unsigned m = (unsigned)_mm256_movemask_epi8(
+            _mm256_and_si256(_mm256_cmpeq_epi8(a, first), _mm256_cmpeq_epi8(b, last)));
+        for (; m; m &= m - 1) {
+            const char *p = hay + i + __builtin_ctz(m);
+            if (memcmp(p + 1, needle + 1, nlen - 2) == 0) return p;
+        }
+    }
+    return find_short_sse2(hay + i, hlen - i, needle, nlen);
+}
+#endif
+
+/* 2 <= nlen < EAST_FIND_LONG */
+static const char *find_short(const char *hay, size_t hlen,
+                              const char *needle, size_t nlen)
+{
+#ifdef SEARCH_AVX2
+    if (hlen >= 64 && __builtin_cpu_supports("avx2"))
+        return find_short_avx2(hay, hlen, needle, nlen);
+#endif
+#ifdef SEARCH_SSE2
+    return find_short_sse2(hay, hlen, needle, nlen);
+#else
+    return find_scalar(hay, hlen, needle, nlen);
+#endif
+}
+
+/* ------------------------------------------------------------------ */
+/*  Long needles                                                       */
+/* ------------------------------------------------------------------ */
+
+/* Horspool: on a mismatch, shift by how far the haystack byte under the
+ * needle's last position is from that byte's last occurrence in the
+ * needle (its first len - 1 bytes). */
+static const char *find_long(const EastFinder *f, const char *hay, size_t hlen)
+{
+    size_t m = f->len;
+    const unsigned char *h = (const unsigned char *)hay;
+    unsigned char last = (unsigned char)f->needle[m - 1];
+    for (size_t i = 0; hlen >= m && i <= hlen - m;) {
+        unsigned char c = h[i + m - 1];
+        if (c == last && memcmp(hay + i, f->needle, m - 1) == 0) return hay + i;
+        i += f->shift[c];
+    }
+    return NULL;
+}
+
+/* ------------------------------------------------------------------ */
+/*  Public API                                                         */
+/* ------------------------------------------------------------------ */
+
+void east_finder_init(EastFinder *f, const char *needle, size_t len)
+{
+    f->needle = needle;
+    f->len = len;
+    if (len < EAST_FIND_LONG) return;
+    /* Shorter shifts stay correct, so huge needles just clamp */
+    for (size_t c = 0; c < 256; c++)
+        f->shift[c] = len > UINT32_MAX ? UINT32_MAX : (uint32_t)len;
+    for (size_t j = 0; j + 1 < len; j++) {
+        size_t d = len - 1 - j;
+        f->shift[(unsigned char)needle[j]] = d > UINT32_MAX ? UINT32_MAX : (uint32_t)d;
+    }
+}
+
+const char *east_finder_next(const EastFinder *f, const char *hay, size_t hlen)
+{
+    size_t n = f->len;
+    if (n == 0) return hay;
+    if (n > hlen) return NULL;
+    if (n == 1) return memchr(hay, f->needle[0], hlen);
+    if (n < EAST_FIND_LONG) return find_short(hay, hlen, f->needle, n);
+    return find_long(f, hay, hlen);
+}
+
+const char *east_find(const char *hay, size_t hlen,
+                      const char *needle, size_t nlen)
+{
+    if (nlen < EAST_FIND_LONG) {
+        if (nlen == 0) return hay;
+        if (nlen > hlen) return NULL;
+        if (nlen == 1) return memchr(hay, needle[0], hlen);
+        return find_short(hay, hlen, needle, nlen);
+    }
+    EastFinder f;
+    east_finder_init(&f, needle, nlen);
+    return east_finder_next(&f, hay, hlen);
+}
+
+/* ------------------------------------------------------------------ */
+/*  Byte sets                                                          */
+/* ------------------------------------------------------------------ */
+
+#ifdef SEARCH_AVX2
+/* Sets *at to the first match, or to where the 32-byte blocks ended */
+AVX2 static bool find_any_avx2(const char *p, size_t n, const char s[4], size_t *at)
+{
+    const __m256i s0 = _mm256_set1_epi8(s[0]), s1 = _mm256_set1_epi8(s[1]);
+    const __m256i s2 = _mm256_set1_epi8(s[2]), s3 = _mm256_set1_epi8(s[3]);
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i *)(p + i));
+        __m256i eq = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(v, s0), _mm256_cmpeq_epi8(v, s1)),
+            _mm256_or_si256(_mm256_cmpeq_epi8(v, s2), _mm256_cmpeq_epi8(v, s3)));
+        unsigned m = (unsigned)_mm256_movemask_epi8(eq);
+        if (m) {
+            *at = i + (size_t)__builtin_ctz(m);
+            return true;
+        }
+    }
+    *at = i;
+    return false;
+}
+#endif
+
+size_t east_find_any(const char *p, size_t n, const char *set, size_t nset)
+{
+    /* Pad the set to four bytes by repeating its first one */
+    char s[4];
+    for (size_t k = 0; k < 4; k++) s[k] = set[k < nset ? k : 0];
+    size_t i = 0;
+#ifdef SEARCH_AVX2
+    if (n >= 64 && __builtin_cpu_supports("avx2") && find_any_avx2(p, n, s, &i))
+        return i;
+#endif
+#ifdef SEARCH_SSE2
+    const __m128i s0 = _mm_set1_epi8(s[0]), s1 = _mm_set1_epi8(s[1]);
+    const __m128i s2 = _mm_set1_epi8(s[2]), s3 = _mm_set1_epi8(s[3]);
+    for (; i + 16 <= n; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(p + i));
+        __m128i eq = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(v, s0), _mm_cmpeq_epi8(v, s1)),
+            _mm_or_si128(_mm_cmpeq_epi8(v, s2), _mm_cmpeq_epi8(v, s3)));
+        unsigned m = (unsigned)_mm_movemask_epi8(eq);
+        if (m) return i + (size_t)__builtin_ctz(m);
+    }
+#endif
+    for (; i < n; i++) {
+        char c = p[i];
+        if (c == s[0] || c == s[1] || c == s[2] || c == s[3]) return i;
+    }
+    return n;
+}
@@ -627,7 +627,7 @@ static void beast_encode_value(ByteBuffer *buf, EastValue *value,
         size_t count = value->data.array.len;
         for (size_t i = 0; i < count; i++) {
             byte_buffer_write_u8(buf, 0x01);
-            beast_encode_value(buf, value->data.array.items[i], elem_type);
+            beast_encode_value(buf, east_array_get(value, i), elem_type);
         }
         byte_buffer_write_u8(buf, 0x00);
         break;
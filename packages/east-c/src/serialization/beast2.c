@@ -23,6 +23,7 @@
  */
 
 #include "east/serialization.h"
+#include "east/columnar.h"
 #include "east/types.h"
 #include "east/values.h"
 #include "east/compiler.h"
@@ -385,6 +386,44 @@ static void beast2_dedup_add(Beast2DecodeCtx *ctx, uint64_t hash,
 static void beast2_encode_value(ByteBuffer *buf, EastValue *value,
                                 EastType *type, Beast2EncodeCtx *ctx);
 
+/* Rows of a columnar array, written field by field from the column
+ * buffers in the same layout as the boxed struct encoding. Option
+ * fields are Variant {none, some}, so "some" is case 1. */
+static void beast2_encode_columns(ByteBuffer *buf, EastColumns *c)
+{
+    for (size_t r = 0; r < c->len; r++) {
+        for (size_t f = 0; f < c->num_fields; f++) {
+            const EastColumn *col = &c->cols[f];
+            if (col->option_type) {
+                bool some = east_column_present(col, r);
+                write_varint(buf, some ? 1 : 0);
+                if (!some) continue;
+            }
+            switch (col->kind) {
+            case EAST_COL_NULL:
+                break;
+            case EAST_COL_BOOLEAN:
+                byte_buffer_write_u8(buf, col->data.boolean[r] ? 1 : 0);
+                break;
+            case EAST_COL_INTEGER:
+            case EAST_COL_DATETIME:
+                write_zigzag(buf, col->data.integer[r]);
+                break;
+            case EAST_COL_FLOAT:
+                write_float64_le(buf, col->data.float64[r]);
+                break;
+            case EAST_COL_STRING: {
+                EastValue *str = col->strings[col->data.code[r]];
+                write_varint(buf, (uint64_t)str->data.string.len);
+                byte_buffer_write_bytes(buf, (const uint8_t *)str->data.string.data,
+                                        str->data.string.len);
+                break;
+            }
+            }
+        }
+    }
+}
+
 static void beast2_encode_value(ByteBuffer *buf, EastValue *value,
                                 EastType *type, Beast2EncodeCtx *ctx)
 {
@@ -443,8 +482,13 @@ static void beast2_encode_value(ByteBuffer *buf, EastValue *value,
         EastType *elem_type = type->data.element;
         size_t count = value->data.array.len;
         write_varint(buf, (uint64_t)count);
+        EastColumns *cols = east_array_columns(value);
+        if (cols && east_type_equal(cols->row_type, elem_type)) {
+            beast2_encode_columns(buf, cols);
+            break;
+        }
         for (size_t i = 0; i < count; i++) {
-            beast2_encode_value(buf, value->data.array.items[i], elem_type, ctx);
+            beast2_encode_value(buf, east_array_get(value, i), elem_type, ctx);
         }
         break;
     }
@@ -604,7 +648,7 @@ static void beast2_encode_value(ByteBuffer *buf, EastValue *value,
 
         /* 4. For each capture, encode its value from the environment */
         for (size_t i = 0; i < ncaps; i++) {
-            EastValue *cap_var = caps_arr->data.array.items[i];
+            EastValue *cap_var = east_array_get(caps_arr, i);
             EastValue *cap_s = cap_var->data.variant.value;
             EastValue *name_v = east_struct_get_field(cap_s, "name");
             EastValue *type_v = east_struct_get_field(cap_s, "type");
@@ -650,6 +694,53 @@ static EastValue *beast2_decode_value(const uint8_t *data, size_t len,
                                       size_t *offset, EastType *type,
                                       Beast2DecodeCtx *ctx);
 
+/* Decode count rows of a supported struct type straight into the columns
+ * of arr. Returns false on malformed input. */
+static bool beast2_decode_columns(const uint8_t *data, size_t len, size_t *offset,
+                                  EastValue *arr, uint64_t count)
+{
+    EastColumns *c = arr->data.array.columns;
+    for (uint64_t i = 0; i < count; i++) {
+        size_t r = east_columnar_add_row(arr);
+        if (r == SIZE_MAX) return false;
+        for (size_t f = 0; f < c->num_fields; f++) {
+            EastColumn *col = &c->cols[f];
+            if (col->option_type) {
+                uint64_t case_idx = read_varint(data, offset);
+                if (case_idx > 1) return false;
+                if (case_idx == 0) continue;    // none
+            }
+            switch (col->kind) {
+            case EAST_COL_NULL:
+                east_column_set_value(col, r, east_null());
+                break;
+            case EAST_COL_BOOLEAN:
+                if (*offset >= len) return false;
+                east_column_set_boolean(col, r, data[(*offset)++] != 0);
+                break;
+            case EAST_COL_INTEGER:
+            case EAST_COL_DATETIME:
+                east_column_set_integer(col, r, read_zigzag(data, offset));
+                break;
+            case EAST_COL_FLOAT:
+                if (*offset + 8 > len) return false;
+                east_column_set_float(col, r, read_float64_le(data, offset));
+                break;
+            case EAST_COL_STRING: {
+                uint64_t slen = read_varint(data, offset);
+                if (*offset + slen > len) return false;
+                if (!east_column_set_string(col, r, (const char *)data + *offset, (size_t)slen))
+                    return false;
+                *offset += (size_t)slen;
+                break;
+            }
+            }
+        }
+        if (*offset > len) return false;
+    }
+    return true;
+}
+
 static EastValue *beast2_decode_value(const uint8_t *data, size_t len,
                                       size_t *offset, EastType *type,
                                       Beast2DecodeCtx *ctx)
@@ -724,6 +815,17 @@ static EastValue *beast2_decode_value(const uint8_t *data, size_t len,
 
         EastType *elem_type = type->data.element;
         uint64_t count = read_varint(data, offset);
+        if (east_columnar_supported(elem_type)) {
+            /* Structs of primitives: no per-row values at all */
+            EastValue *arr = east_columnar_array_new(elem_type, count < len ? count : len);
+            if (!arr) return NULL;
+            beast2_dec_ctx_add(ctx, arr, content_off);
+            if (!beast2_decode_columns(data, len, offset, arr, count)) {
+                east_value_release(arr);
+                return NULL;
+            }
+            return arr;
+        }
         EastValue *arr = east_array_new(elem_type);
         if (!arr) return NULL;
 
@@ -991,7 +1093,7 @@ static EastValue *beast2_decode_value(const uint8_t *data, size_t len,
         Environment *captures_env = env_new(NULL);
 
         for (uint64_t i = 0; i < ncaps; i++) {
-            EastValue *cap_var = caps_arr->data.array.items[i];
+            EastValue *cap_var = east_array_get(caps_arr, i);
             EastValue *cap_s = cap_var->data.variant.value;
             EastValue *name_v = east_struct_get_field(cap_s, "name");
             EastValue *type_v = east_struct_get_field(cap_s, "type");
@@ -1086,20 +1188,10 @@ static const uint8_t BEAST2_MAGIC[8] = {
     0x89, 0x45, 0x61, 0x73, 0x74, 0x0D, 0x0A, 0x01
 };
 
-ByteBuffer *east_beast2_encode_full(EastValue *value, EastType *type)
+/* Magic bytes, then the type schema as a beast2-encoded EastTypeType value */
+static void beast2_write_header(ByteBuffer *buf, EastType *type)
 {
-    if (!value || !type) return NULL;
-
-    /* Ensure type system is initialized */
-    if (!east_type_type) east_type_of_type_init();
-
-    ByteBuffer *buf = byte_buffer_new(256);
-    if (!buf) return NULL;
-
-    /* 1. Write magic bytes */
     byte_buffer_write_bytes(buf, BEAST2_MAGIC, 8);
-
-    /* 2. Write type schema as a beast2-encoded EastTypeType value */
     EastValue *type_val = east_type_to_value(type);
     if (type_val) {
         Beast2EncodeCtx schema_ctx;
@@ -1108,8 +1200,32 @@ ByteBuffer *east_beast2_encode_full(EastValue *value, EastType *type)
         beast2_enc_ctx_free(&schema_ctx);
         east_value_release(type_val);
     }
+}
 
-    /* 3. Write value data */
+ByteBuffer *east_beast2_encode_header(EastType *type)
+{
+    if (!type) return NULL;
+    if (!east_type_type) east_type_of_type_init();
+    ByteBuffer *buf = byte_buffer_new(64);
+    if (!buf) return NULL;
+    beast2_write_header(buf, type);
+    return buf;
+}
+
+ByteBuffer *east_beast2_encode_full(EastValue *value, EastType *type)
+{
+    if (!value || !type) return NULL;
+
+    /* Ensure type system is initialized */
+    if (!east_type_type) east_type_of_type_init();
+
+    ByteBuffer *buf = byte_buffer_new(256);
+    if (!buf) return NULL;
+
+    /* 1. Write magic bytes and type schema */
+    beast2_write_header(buf, type);
+
+    /* 2. Write value data */
     Beast2EncodeCtx ctx;
     beast2_enc_ctx_init(&ctx);
     beast2_encode_value(buf, value, type, &ctx);
@@ -1157,7 +1273,8 @@ EastValue *east_beast2_decode_full(const uint8_t *data, size_t len,
     return result;
 }
 
-EastValue *east_beast2_decode_auto(const uint8_t *data, size_t len)
+EastType *east_beast2_decode_header(const uint8_t *data, size_t len,
+                                    size_t *header_len)
 {
     if (!data) return NULL;
     if (len < 8) return NULL;
@@ -1180,6 +1297,14 @@ EastValue *east_beast2_decode_auto(const uint8_t *data, size_t len)
 
     EastType *type = east_type_from_value(schema_val);
     east_value_release(schema_val);
+    if (type) *header_len = offset;
+    return type;
+}
+
+EastValue *east_beast2_decode_auto(const uint8_t *data, size_t len)
+{
+    size_t offset;
+    EastType *type = east_beast2_decode_header(data, len, &offset);
     if (!type) return NULL;
 
     /* 3. Decode value using the extracted type */
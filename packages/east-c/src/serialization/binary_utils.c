@@ -6,6 +6,7 @@
  */
 
 #include "east/serialization.h"
+#include "east/memory.h"
 
 #include <stdlib.h>
 #include <string.h>
@@ -28,12 +29,18 @@ ByteBuffer *byte_buffer_new(size_t initial_cap)
     }
     buf->len = 0;
     buf->cap = initial_cap;
+    if (east_mem_accounting)
+        east_mem_account(EAST_MEM_BUFFERS, -1,
+                         (int64_t)(sizeof(ByteBuffer) + initial_cap), 1);
     return buf;
 }
 
 void byte_buffer_free(ByteBuffer *buf)
 {
     if (!buf) return;
+    if (east_mem_accounting)
+        east_mem_account(EAST_MEM_BUFFERS, -1,
+                         -(int64_t)(sizeof(ByteBuffer) + buf->cap), -1);
     free(buf->data);
     free(buf);
 }
@@ -58,6 +65,8 @@ static void byte_buffer_ensure_capacity(ByteBuffer *buf, size_t needed)
         /* Allocation failure -- best effort, caller should check */
         return;
     }
+    if (east_mem_accounting)
+        east_mem_account(EAST_MEM_BUFFERS, -1, (int64_t)(new_cap - buf->cap), 0);
     buf->data = new_data;
     buf->cap = new_cap;
 }
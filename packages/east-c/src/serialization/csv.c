@@ -13,8 +13,11 @@
  */
 
 #include "east/serialization.h"
+#include "east/columnar.h"
 #include "east/types.h"
 #include "east/values.h"
+#include "east/search.h"
+#include "east/numparse.h"
 
 #include <ctype.h>
 #include <math.h>
@@ -203,7 +206,7 @@ static int config_get_null_strings(EastValue *config, const char ***out)
     const char **strs = malloc(n * sizeof(char *));
     if (!strs) return -1;
     for (size_t i = 0; i < n; i++) {
-        EastValue *s = arr->data.array.items[i];
+        EastValue *s = east_array_get(arr, i);
         strs[i] = (s && s->kind == EAST_VAL_STRING) ? s->data.string.data : "";
     }
     *out = strs;
@@ -349,6 +352,54 @@ static void csvbuf_append_field(CsvBuf *sb, const char *val, size_t len,
 /*  Encode a single value to its CSV string representation             */
 /* ================================================================== */
 
+static void csv_encode_float(CsvBuf *sb, double f)
+{
+    char numbuf[64];
+    if (f != f) {
+        csvbuf_append_str(sb, "NaN");
+    } else if (isinf(f)) {
+        csvbuf_append_str(sb, f > 0 ? "Infinity" : "-Infinity");
+    } else if (f == 0.0 && signbit(f)) {
+        csvbuf_append_str(sb, "-0");
+    } else {
+        east_fmt_double(numbuf, sizeof(numbuf), f);
+        csvbuf_append_str(sb, numbuf);
+    }
+}
+
+static void csv_encode_datetime(CsvBuf *sb, int64_t millis)
+{
+    char numbuf[64];
+    int64_t secs = millis / 1000;
+    int64_t ms = millis % 1000;
+    if (ms < 0) { ms += 1000; secs--; }
+
+    int64_t days = secs / 86400;
+    int64_t rem = secs % 86400;
+    if (rem < 0) { rem += 86400; days--; }
+
+    int hour = (int)(rem / 3600);
+    rem %= 3600;
+    int min = (int)(rem / 60);
+    int sec = (int)(rem % 60);
+
+    int64_t z = days + 719468;
+    int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+    int64_t doe = z - era * 146097;
+    int64_t yoe = (doe - doe/1460 + doe/36524 - doe/146096) / 365;
+    int64_t y = yoe + era * 400;
+    int64_t doy = doe - (365*yoe + yoe/4 - yoe/100);
+    int64_t mp = (5*doy + 2) / 153;
+    int64_t d = doy - (153*mp + 2)/5 + 1;
+    int64_t m = mp + (mp < 10 ? 3 : -9);
+    y += (m <= 2) ? 1 : 0;
+
+    snprintf(numbuf, sizeof(numbuf),
+             "%04d-%02d-%02dT%02d:%02d:%02d.%03d",
+             (int)y, (int)m, (int)d, hour, min, sec, (int)ms);
+    csvbuf_append_str(sb, numbuf);
+}
+
 static void csv_encode_field(CsvBuf *sb, EastValue *value, EastType *type,
                               const CsvEncodeOpts *opts)
 {
@@ -381,57 +432,17 @@ static void csv_encode_field(CsvBuf *sb, EastValue *value, EastType *type,
         csvbuf_append_str(sb, numbuf);
         break;
 
-    case EAST_TYPE_FLOAT: {
-        double f = value->data.float64;
-        if (f != f) {
-            csvbuf_append_str(sb, "NaN");
-        } else if (isinf(f)) {
-            csvbuf_append_str(sb, f > 0 ? "Infinity" : "-Infinity");
-        } else if (f == 0.0 && signbit(f)) {
-            csvbuf_append_str(sb, "-0");
-        } else {
-            east_fmt_double(numbuf, sizeof(numbuf), f);
-            csvbuf_append_str(sb, numbuf);
-        }
+    case EAST_TYPE_FLOAT:
+        csv_encode_float(sb, value->data.float64);
         break;
-    }
 
     case EAST_TYPE_STRING:
         csvbuf_append(sb, value->data.string.data, value->data.string.len);
         break;
 
-    case EAST_TYPE_DATETIME: {
-        int64_t millis = value->data.datetime;
-        int64_t secs = millis / 1000;
-        int64_t ms = millis % 1000;
-        if (ms < 0) { ms += 1000; secs--; }
-
-        int64_t days = secs / 86400;
-        int64_t rem = secs % 86400;
-        if (rem < 0) { rem += 86400; days--; }
-
-        int hour = (int)(rem / 3600);
-        rem %= 3600;
-        int min = (int)(rem / 60);
-        int sec = (int)(rem % 60);
-
-        int64_t z = days + 719468;
-        int64_t era = (z >= 0 ? z : z - 146096) / 146097;
-        int64_t doe = z - era * 146097;
-        int64_t yoe = (doe - doe/1460 + doe/36524 - doe/146096) / 365;
-        int64_t y = yoe + era * 400;
-        int64_t doy = doe - (365*yoe + yoe/4 - yoe/100);
-        int64_t mp = (5*doy + 2) / 153;
-        int64_t d = doy - (153*mp + 2)/5 + 1;
-        int64_t m = mp + (mp < 10 ? 3 : -9);
-        y += (m <= 2) ? 1 : 0;
-
-        snprintf(numbuf, sizeof(numbuf),
-                 "%04d-%02d-%02dT%02d:%02d:%02d.%03d",
-                 (int)y, (int)m, (int)d, hour, min, sec, (int)ms);
-        csvbuf_append_str(sb, numbuf);
+    case EAST_TYPE_DATETIME:
+        csv_encode_datetime(sb, value->data.datetime);
         break;
-    }
 
     case EAST_TYPE_BLOB: {
         csvbuf_append_str(sb, "0x");
@@ -448,6 +459,79 @@ static void csv_encode_field(CsvBuf *sb, EastValue *value, EastType *type,
     }
 }
 
+/* Encode row of a column straight from its buffer */
+static void csv_encode_column(CsvBuf *sb, const EastColumn *col, size_t row,
+                              const CsvEncodeOpts *opts)
+{
+    char numbuf[32];
+
+    if (!east_column_present(col, row)) {
+        csvbuf_append_str(sb, opts->null_string);
+        return;
+    }
+    switch (col->kind) {
+    case EAST_COL_NULL:
+        csvbuf_append_str(sb, opts->null_string);
+        break;
+    case EAST_COL_BOOLEAN:
+        csvbuf_append_str(sb, col->data.boolean[row] ? "true" : "false");
+        break;
+    case EAST_COL_INTEGER:
+        snprintf(numbuf, sizeof(numbuf), "%lld", (long long)col->data.integer[row]);
+        csvbuf_append_str(sb, numbuf);
+        break;
+    case EAST_COL_FLOAT:
+        csv_encode_float(sb, col->data.float64[row]);
+        break;
+    case EAST_COL_STRING: {
+        EastValue *str = col->strings[col->data.code[row]];
+        csvbuf_append(sb, str->data.string.data, str->data.string.len);
+        break;
+    }
+    case EAST_COL_DATETIME:
+        csv_encode_datetime(sb, col->data.integer[row]);
+        break;
+    }
+}
+
+/* Data rows of a columnar array, one column at a time per row without
+ * building any struct values. */
+static void csv_encode_columns(CsvBuf *sb, EastValue *array, EastType *elem_type,
+                               const CsvEncodeOpts *opts)
+{
+    EastColumns *c = array->data.array.columns;
+    size_t nf = elem_type->data.struct_.num_fields;
+    const EastColumn **cols = malloc((nf ? nf : 1) * sizeof(EastColumn *));
+    if (!cols) return;
+    for (size_t f = 0; f < nf; f++) {
+        cols[f] = NULL;
+        for (size_t j = 0; j < c->num_fields; j++) {
+            if (strcmp(c->names[j], elem_type->data.struct_.fields[f].name) == 0) {
+                cols[f] = &c->cols[j];
+                break;
+            }
+        }
+    }
+
+    CsvBuf tmp = csvbuf_new(64);
+    for (size_t r = 0; r < c->len; r++) {
+        if (r > 0 || opts->include_header)
+            csvbuf_append_str(sb, opts->newline);
+        for (size_t f = 0; f < nf; f++) {
+            if (f > 0) csvbuf_append_char(sb, opts->delimiter);
+            if (!cols[f]) {
+                csvbuf_append_str(sb, opts->null_string);
+                continue;
+            }
+            tmp.len = 0;
+            csv_encode_column(&tmp, cols[f], r, opts);
+            csvbuf_append_field(sb, tmp.data, tmp.len, opts);
+        }
+    }
+    free(tmp.data);
+    free(cols);
+}
+
 /* ================================================================== */
 /*  CSV Encoder: Array<Struct> -> CSV string                           */
 /* ================================================================== */
@@ -477,12 +561,17 @@ char *east_csv_encode(EastValue *array, EastType *type, EastValue *config)
         }
     }
 
+    if (array->columnar) {
+        csv_encode_columns(&sb, array, elem_type, &opts);
+        return sb.data;
+    }
+
     /* Write data rows */
     for (size_t r = 0; r < nrows; r++) {
         if (r > 0 || opts.include_header)
             csvbuf_append_str(&sb, opts.newline);
 
-        EastValue *row = array->data.array.items[r];
+        EastValue *row = east_array_get(array, r);
         if (row->kind != EAST_VAL_STRUCT) continue;
 
         for (size_t f = 0; f < nf; f++) {
@@ -565,8 +654,19 @@ static FieldArray csv_parse_row(const char *data, size_t data_len,
     CsvBuf field = csvbuf_new(64);
     bool in_quote = false;
     size_t i = *offset;
+    const char plain_stops[4] = { delim, quote, '\r', '\n' };
+    const char quoted_stops[2] = { escape, quote };
 
     while (i < data_len) {
+        /* Copy the run of bytes that need no handling in one go */
+        size_t run = in_quote
+            ? east_find_any(data + i, data_len - i, quoted_stops, 2)
+            : east_find_any(data + i, data_len - i, plain_stops, 4);
+        if (run > 0) {
+            csvbuf_append(&field, data + i, run);
+            i += run;
+            continue;
+        }
         char c = data[i];
 
         if (in_quote) {
@@ -719,8 +819,15 @@ static EastValue *csv_parse_field(const char *str, EastType *type,
                 *error_out = format_csv_error("expected integer, got '%s'", str);
             break;
         }
-        long long val = strtoll(start, NULL, 10);
-        parsed = east_integer((int64_t)val);
+        int64_t val;
+        bool overflow;
+        east_parse_int64(start, (size_t)(p - start), &val, &overflow);
+        if (overflow) {
+            if (error_out)
+                *error_out = format_csv_error("integer out of range (must be 64-bit signed), got '%s'", str);
+            break;
+        }
+        parsed = east_integer(val);
         break;
     }
 
@@ -745,9 +852,9 @@ static EastValue *csv_parse_field(const char *str, EastType *type,
                 *error_out = format_csv_error("expected float, got '%s'", str);
             break;
         }
-        char *endp;
-        double val = strtod(str, &endp);
-        if (*endp != '\0') {
+        size_t slen = strlen(str);
+        double val;
+        if (east_parse_double(str, slen, &val) != slen) {
             if (error_out)
                 *error_out = format_csv_error("expected float, got '%s'", str);
             break;
@@ -1015,8 +1122,10 @@ EastValue *east_csv_decode_with_error(const char *csv, EastType *type,
         }
     }
 
-    /* Parse data rows */
-    EastValue *result = east_array_new(elem_type);
+    /* Parse data rows; rows of primitive fields are stored column-wise */
+    bool columnar = east_columnar_supported(elem_type);
+    EastValue *result = columnar ? east_columnar_array_new(elem_type, 0)
+                                 : east_array_new(elem_type);
     if (!result) {
         free(col_indices);
         decode_opts_free(&opts);
@@ -1102,7 +1211,14 @@ EastValue *east_csv_decode_with_error(const char *csv, EastType *type,
             }
         }
 
-        if (row_ok) {
+        if (row_ok && columnar) {
+            size_t r = east_columnar_add_row(result);
+            for (size_t f = 0; f < nf && r != SIZE_MAX; f++)
+                east_column_set_value(&result->data.array.columns->cols[f], r, values[f]);
+            for (size_t f = 0; f < nf; f++) {
+                east_value_release(values[f]);
+            }
+        } else if (row_ok) {
             EastValue *struct_val = east_struct_new(names, values, nf, elem_type);
             if (struct_val) {
                 east_array_push(result, struct_val);
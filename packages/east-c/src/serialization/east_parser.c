@@ -2,15 +2,19 @@
  * Parser for East text format.
  *
  * Type-directed parser: the target type guides how text is parsed.
- * Uses the tokenizer defined in east_tokenizer.c.
+ * Tokens are read lazily as the parser asks for them, from a string or
+ * from chunks of a stream (see TokStream2).
  *
  * east_parse_value(text, type) -> EastValue*
+ * east_parse_value_stream(read, ctx, type, &error) -> EastValue*
  * east_parse_type(text) -> EastType*
  */
 
 #include "east/serialization.h"
 #include "east/types.h"
 #include "east/values.h"
+#include "east/numparse.h"
+#include "east/search.h"
 
 #include <ctype.h>
 #include <math.h>
@@ -52,368 +56,503 @@ typedef enum {
 
 typedef struct {
     EastTokenType2 type;
-    char *text;
+    const char *text;   /* see TokStream2 for when this is NUL-terminated */
     size_t text_len;
     int64_t int_val;
     double float_val;
     int line;
     int column;
+    char first;         /* input byte at line:column, '\0' past the end */
+    char *buf;          /* this ring slot's text storage, reused */
+    size_t buf_cap;
 } Token2;
 
-typedef struct {
-    Token2 *tokens;
-    size_t count;
-    size_t cap;
-} TokenArr2;
+/*
+ * Tokens are read on demand from a window of the input: the whole text,
+ * or chunks pulled from an EastReadFn. Only the last TS_RING tokens
+ * exist, so a token stays valid for TS_RING - 1 further advances; names
+ * needed across a nested parse are taken from the type instead.
+ *
+ * Token text is NUL-terminated, except for TOK_STRING when parsing from
+ * text: strings without escapes then point straight into the input.
+ */
+#define TS_RING 4
+#define TS_CHUNK 65536
 
 typedef struct {
-    TokenArr2 ta;
+    Token2 ring[TS_RING];
+    size_t cur;            /* ring index of the current token */
+    const char *text;      /* window: text[pos..len) is not yet read */
+    size_t len;
     size_t pos;
+    int line, col;
+    EastReadFn read;       /* NULL: text is the whole input */
+    void *read_ctx;
+    char *window;          /* streaming: the buffer behind text */
+    bool at_end;
+    Token2 *pending;       /* error token; its string comes next */
+    size_t pending_len;
+    int pending_line, pending_col;
+    char pending_quote;
 } TokStream2;
 
 /* ================================================================== */
-/*  Inline tokenizer (self-contained for this compilation unit)        */
+/*  Input window                                                       */
 /* ================================================================== */
 
-static TokenArr2 ta2_new(void)
+/* Makes n unread bytes available, if the input has that many */
+static bool src_fill(TokStream2 *ts, size_t n)
+{
+    if (ts->len - ts->pos >= n) return true;
+    if (!ts->read || ts->at_end) return false;
+    if (!ts->window) {
+        ts->window = malloc(TS_CHUNK);
+        if (!ts->window) {
+            ts->at_end = true;
+            return false;
+        }
+    }
+    /* Tokens never point into a streamed window, so it can slide */
+    size_t keep = ts->len - ts->pos;
+    if (keep) memmove(ts->window, ts->text + ts->pos, keep);
+    ts->text = ts->window;
+    ts->pos = 0;
+    ts->len = keep;
+    while (ts->len < n && !ts->at_end) {
+        size_t got = ts->read(ts->read_ctx, ts->window + ts->len, TS_CHUNK - ts->len);
+        if (got == 0) ts->at_end = true;
+        ts->len += got;
+    }
+    return ts->len >= n;
+}
+
+static inline bool src_more(TokStream2 *ts)
+{
+    return ts->pos < ts->len || src_fill(ts, 1);
+}
+
+static inline char src_cur(TokStream2 *ts)
+{
+    return src_more(ts) ? ts->text[ts->pos] : '\0';
+}
+
+static inline char src_peek(TokStream2 *ts, size_t off)
+{
+    return src_fill(ts, off + 1) ? ts->text[ts->pos + off] : '\0';
+}
+
+static inline void src_adv(TokStream2 *ts)
 {
-    TokenArr2 ta;
-    ta.cap = 64;
-    ta.tokens = calloc(ta.cap, sizeof(Token2));
-    ta.count = 0;
-    return ta;
+    if (!src_more(ts)) return;
+    if (ts->text[ts->pos] == '\n') { ts->line++; ts->col = 1; } else { ts->col++; }
+    ts->pos++;
 }
 
-static void ta2_push(TokenArr2 *ta, Token2 tok)
+/* ================================================================== */
+/*  Lexer                                                              */
+/* ================================================================== */
+
+static void tok_put(Token2 *t, const char *s, size_t n)
 {
-    if (ta->count >= ta->cap) {
-        ta->cap *= 2;
-        ta->tokens = realloc(ta->tokens, ta->cap * sizeof(Token2));
+    if (t->text_len + n + 1 > t->buf_cap) {
+        size_t cap = t->buf_cap ? t->buf_cap : 64;
+        while (cap < t->text_len + n + 1) cap *= 2;
+        char *nb = realloc(t->buf, cap);
+        if (!nb) return;
+        t->buf = nb;
+        t->buf_cap = cap;
     }
-    ta->tokens[ta->count++] = tok;
+    if (n) memcpy(t->buf + t->text_len, s, n);
+    t->text_len += n;
+    t->buf[t->text_len] = '\0';
+    t->text = t->buf;
 }
 
-static void ta2_free(TokenArr2 *ta)
+static inline void tok_putc(Token2 *t, char c)
 {
-    for (size_t i = 0; i < ta->count; i++) {
-        free(ta->tokens[i].text);
+    if (t->text_len + 2 <= t->buf_cap) {
+        t->buf[t->text_len++] = c;
+        t->buf[t->text_len] = '\0';
+    } else {
+        tok_put(t, &c, 1);
     }
-    free(ta->tokens);
 }
 
-/* Simplified re-implementation of tokenizer for parser self-containment */
-static TokenArr2 tokenize2(const char *text)
+/* A malloc'd, NUL-terminated copy of a token's text */
+static char *tok_dup(const Token2 *t)
 {
-    TokenArr2 result = ta2_new();
-    size_t len = strlen(text);
-    size_t pos = 0;
-    int line = 1, col = 1;
-
-    #define ADV2() do { \
-        if (pos < len) { \
-            if (text[pos] == '\n') { line++; col = 1; } else { col++; } \
-            pos++; \
-        } \
-    } while(0)
-
-    #define CUR2() (pos < len ? text[pos] : '\0')
-    #define PEEK2(off) ((pos + (off)) < len ? text[pos + (off)] : '\0')
-
-    while (1) {
-        /* Skip whitespace and comments */
-        while (pos < len) {
-            char c = text[pos];
-            if (c == ' ' || c == '\t' || c == '\n' || c == '\r') {
-                ADV2();
-                continue;
-            }
-            if (c == '#') {
-                while (pos < len && text[pos] != '\n') ADV2();
-                continue;
+    char *p = malloc(t->text_len + 1);
+    if (!p) return NULL;
+    memcpy(p, t->text, t->text_len);
+    p[t->text_len] = '\0';
+    return p;
+}
+
+/* Moves past n bytes of the window that contain no newline */
+static inline void src_skip(TokStream2 *ts, size_t n)
+{
+    ts->pos += n;
+    ts->col += (int)n;
+}
+
+/* Appends the run of identifier characters at the cursor to t */
+static void take_ident(TokStream2 *ts, Token2 *t)
+{
+    do {
+        size_t i = ts->pos;
+        while (i < ts->len && (isalnum((unsigned char)ts->text[i]) || ts->text[i] == '_')) i++;
+        tok_put(t, ts->text + ts->pos, i - ts->pos);
+        src_skip(ts, i - ts->pos);
+        if (i < ts->len) return;
+    } while (src_fill(ts, 1));
+}
+
+/* Appends the run of hex digits at the cursor to t */
+static void take_hex(TokStream2 *ts, Token2 *t)
+{
+    do {
+        size_t i = ts->pos;
+        while (i < ts->len && isxdigit((unsigned char)ts->text[i])) i++;
+        tok_put(t, ts->text + ts->pos, i - ts->pos);
+        src_skip(ts, i - ts->pos);
+        if (i < ts->len) return;
+    } while (src_fill(ts, 1));
+}
+
+/* Skips whitespace and '#' comments */
+static void skip_space(TokStream2 *ts)
+{
+    bool comment = false;
+    do {
+        while (ts->pos < ts->len) {
+            char c = ts->text[ts->pos];
+            if (c == '\n') {
+                comment = false;
+                ts->line++;
+                ts->col = 1;
+                ts->pos++;
+            } else if (comment || c == ' ' || c == '\t' || c == '\r') {
+                src_skip(ts, 1);
+            } else if (c == '#') {
+                comment = true;
+                src_skip(ts, 1);
+            } else {
+                return;
             }
-            break;
         }
+    } while (src_fill(ts, 1));
+}
 
-        if (pos >= len) {
-            Token2 eof = {0}; eof.type = TOK_EOF_TOK; eof.line = line; eof.column = col;
-            ta2_push(&result, eof);
+/* A bad escape or missing closing quote gives TOK_ERROR, then the
+ * string as read so far as TOK_STRING. */
+static void lex_string(TokStream2 *ts, Token2 *t)
+{
+    char quote = ts->text[ts->pos];
+    int sl = ts->line, sc = ts->col;
+    src_adv(ts);
+    /* From text, escape-free strings are not copied */
+    bool copy = ts->read != NULL;
+    size_t start = ts->pos;
+    if (copy) tok_put(t, "", 0);
+    const char stops[3] = { quote, '\\', '\n' };
+    bool terminated = false, str_error = false;
+    int err_line = 0, err_col = 0;
+    const char *err_msg = NULL;
+    char err_first = '\0';
+
+    while (src_more(ts)) {
+        size_t n = ts->len - ts->pos;
+        size_t k = east_find_any(ts->text + ts->pos, n, stops, 3);
+        if (copy) tok_put(t, ts->text + ts->pos, k);
+        src_skip(ts, k);
+        if (k == n) continue;
+        char cc = ts->text[ts->pos];
+        if (cc == quote) { src_adv(ts); terminated = true; break; }
+        if (cc == '\n') {
+            if (copy) tok_putc(t, '\n');
+            src_adv(ts);
+            continue;
+        }
+        if (!copy) {
+            copy = true;
+            tok_put(t, ts->text + start, ts->pos - start);
+        }
+        int esc_line = ts->line, esc_col = ts->col;
+        src_adv(ts);
+        if (!src_more(ts)) {
+            /* Unterminated at end */
+            str_error = true;
+            err_line = ts->line; err_col = ts->col;
+            err_msg = "unterminated string (missing closing quote)";
+            err_first = '\0';
             break;
         }
+        char esc = ts->text[ts->pos];
+        src_adv(ts);
+        if (esc != '\\' && esc != quote && !str_error) {
+            /* Invalid escape: recorded, and the character kept for the
+             * non-error path */
+            str_error = true;
+            err_line = esc_line; err_col = esc_col + 1;
+            err_msg = "unexpected escape sequence in string";
+            err_first = esc;
+        }
+        tok_putc(t, esc);
+    }
+    if (!terminated && !str_error) {
+        str_error = true;
+        err_line = ts->line; err_col = ts->col;
+        err_msg = "unterminated string (missing closing quote)";
+        err_first = '\0';
+    }
 
-        char c = CUR2();
-        int sl = line, sc = col;
+    if (!copy) {
+        size_t end = terminated ? ts->pos - 1 : ts->pos;
+        if (!str_error) {
+            t->type = TOK_STRING;
+            t->text = ts->text + start;
+            t->text_len = end - start;
+            return;
+        }
+        tok_put(t, ts->text + start, end - start);
+    }
+    if (!str_error) {
+        t->type = TOK_STRING;
+        return;
+    }
+    ts->pending = t;
+    ts->pending_len = t->text_len;
+    ts->pending_line = sl;
+    ts->pending_col = sc;
+    ts->pending_quote = quote;
+    t->type = TOK_ERROR;
+    t->text = err_msg;
+    t->text_len = strlen(err_msg);
+    t->line = err_line;
+    t->column = err_col;
+    t->first = err_first;
+}
 
-        if (c == '[') { ADV2(); Token2 t = {0}; t.type = TOK_LBRACKET; t.line = sl; t.column = sc; ta2_push(&result, t); }
-        else if (c == ']') { ADV2(); Token2 t = {0}; t.type = TOK_RBRACKET; t.line = sl; t.column = sc; ta2_push(&result, t); }
-        else if (c == '{') { ADV2(); Token2 t = {0}; t.type = TOK_LBRACE; t.line = sl; t.column = sc; ta2_push(&result, t); }
-        else if (c == '}') { ADV2(); Token2 t = {0}; t.type = TOK_RBRACE; t.line = sl; t.column = sc; ta2_push(&result, t); }
-        else if (c == '(') { ADV2(); Token2 t = {0}; t.type = TOK_LPAREN; t.line = sl; t.column = sc; ta2_push(&result, t); }
-        else if (c == ')') { ADV2(); Token2 t = {0}; t.type = TOK_RPAREN; t.line = sl; t.column = sc; ta2_push(&result, t); }
-        else if (c == ',') { ADV2(); Token2 t = {0}; t.type = TOK_COMMA; t.line = sl; t.column = sc; ta2_push(&result, t); }
-        else if (c == ':') { ADV2(); Token2 t = {0}; t.type = TOK_COLON; t.line = sl; t.column = sc; ta2_push(&result, t); }
-        else if (c == '=') { ADV2(); Token2 t = {0}; t.type = TOK_EQUALS; t.line = sl; t.column = sc; ta2_push(&result, t); }
-        else if (c == '&') { ADV2(); Token2 t = {0}; t.type = TOK_AMPERSAND; t.line = sl; t.column = sc; ta2_push(&result, t); }
-        else if (c == '|') { ADV2(); Token2 t = {0}; t.type = TOK_PIPE; t.line = sl; t.column = sc; ta2_push(&result, t); }
+/* Numbers, datetimes and backreferences ("1#.a", "2#[0]") */
+static void lex_number(TokStream2 *ts, Token2 *t)
+{
+    /* Check -Infinity */
+    if (ts->text[ts->pos] == '-' && src_fill(ts, 9) &&
+        memcmp(ts->text + ts->pos + 1, "Infinity", 8) == 0) {
+        for (int i = 0; i < 9; i++) src_adv(ts);
+        t->type = TOK_FLOAT;
+        t->float_val = -INFINITY;
+        t->text = "-Infinity";
+        t->text_len = 9;
+        return;
+    }
 
-        /* Variant tag .Identifier */
-        else if (c == '.') {
-            ADV2();
-            char next = CUR2();
-            if (isalpha((unsigned char)next) || next == '_') {
-                size_t bcap = 64, blen = 0;
-                char *buf = malloc(bcap);
-                while (pos < len) {
-                    char cc = CUR2();
-                    if (isalnum((unsigned char)cc) || cc == '_') {
-                        buf[blen++] = cc; ADV2();
-                    } else break;
-                    if (blen >= bcap - 1) { bcap *= 2; buf = realloc(buf, bcap); }
+    /* Collect number/datetime chars */
+    tok_put(t, "", 0);
+    bool has_t = false, has_minus = false;
+    do {
+        size_t i = ts->pos;
+        for (; i < ts->len; i++) {
+            char cc = ts->text[i];
+            if (cc == ':') {
+                if (!has_t && !has_minus) break;
+            } else if (cc == '-') {
+                has_minus = true;
+            } else if (cc == 'T') {
+                has_t = true;
+            } else if (!isdigit((unsigned char)cc) && cc != '+' && cc != '.' &&
+                       cc != 'Z' && cc != 'e' && cc != 'E') {
+                break;
+            }
+        }
+        tok_put(t, ts->text + ts->pos, i - ts->pos);
+        src_skip(ts, i - ts->pos);
+        if (i < ts->len) break;
+    } while (src_fill(ts, 1));
+
+    /* Check for backreference: integer immediately followed by # */
+    if (src_cur(ts) == '#' && !has_t &&
+        !memchr(t->buf, '.', t->text_len) && !memchr(t->buf, ':', t->text_len)) {
+        tok_putc(t, '#'); src_adv(ts);
+        /* Consume path components: .identifier or [content] */
+        while (src_more(ts)) {
+            char cc = ts->text[ts->pos];
+            if (cc == '.') {
+                tok_putc(t, cc); src_adv(ts);
+                take_ident(ts, t);
+            } else if (cc == '[') {
+                int depth = 1;
+                tok_putc(t, cc); src_adv(ts);
+                while (src_more(ts) && depth > 0) {
+                    cc = ts->text[ts->pos];
+                    if (cc == '[') depth++;
+                    else if (cc == ']') depth--;
+                    tok_putc(t, cc); src_adv(ts);
                 }
-                buf[blen] = '\0';
-                Token2 t = {0}; t.type = TOK_VARIANT_TAG; t.text = buf; t.text_len = blen;
-                t.line = sl; t.column = sc;
-                ta2_push(&result, t);
             } else {
-                Token2 t = {0}; t.type = TOK_DOT; t.line = sl; t.column = sc;
-                ta2_push(&result, t);
+                break;
             }
         }
+        t->type = TOK_BACKREF;
+    } else if (has_t || (memchr(t->buf, ':', t->text_len) && memchr(t->buf, '-', t->text_len))) {
+        t->type = TOK_DATETIME_LIT;
+    } else if (memchr(t->buf, '.', t->text_len) || memchr(t->buf, 'e', t->text_len) ||
+               memchr(t->buf, 'E', t->text_len)) {
+        t->type = TOK_FLOAT;
+        east_parse_double(t->buf, t->text_len, &t->float_val);
+    } else {
+        t->type = TOK_INTEGER;
+        east_parse_int64(t->buf, t->text_len, &t->int_val, NULL);
+    }
+}
 
-        /* String */
-        else if (c == '"' || c == '\'') {
-            char quote = c;
-            ADV2();
-            size_t bcap = 64, blen = 0;
-            char *buf = malloc(bcap);
-            bool str_error = false;
-            int err_line = 0, err_col = 0;
-            char *err_msg = NULL;
-            bool terminated = false;
-            while (pos < len) {
-                char cc = CUR2();
-                if (cc == quote) { ADV2(); terminated = true; break; }
-                if (cc == '\\') {
-                    int esc_line = line, esc_col = col;
-                    ADV2();
-                    if (pos >= len) {
-                        /* Unterminated at end */
-                        str_error = true;
-                        err_line = line; err_col = col;
-                        err_msg = strdup("unterminated string (missing closing quote)");
-                        break;
-                    }
-                    char esc = CUR2(); ADV2();
-                    if (esc == '\\') buf[blen++] = '\\';
-                    else if (esc == quote) buf[blen++] = quote;
-                    else {
-                        /* Invalid escape — record error but continue for non-error path */
-                        if (!str_error) {
-                            str_error = true;
-                            err_line = esc_line; err_col = esc_col + 1;
-                            err_msg = strdup("unexpected escape sequence in string");
-                        }
-                        buf[blen++] = esc;
-                    }
-                } else {
-                    buf[blen++] = cc; ADV2();
-                }
-                if (blen >= bcap - 1) { bcap *= 2; buf = realloc(buf, bcap); }
-            }
-            if (!terminated && !str_error) {
-                str_error = true;
-                err_line = line; err_col = col;
-                err_msg = strdup("unterminated string (missing closing quote)");
-            }
-            buf[blen] = '\0';
-            if (str_error) {
-                /* Emit error token followed by a string token */
-                Token2 te = {0}; te.type = TOK_ERROR; te.text = err_msg;
-                te.line = err_line; te.column = err_col;
-                ta2_push(&result, te);
-                /* Also push the string so non-error path still works */
-                Token2 ts2 = {0}; ts2.type = TOK_STRING; ts2.text = buf; ts2.text_len = blen;
-                ts2.line = sl; ts2.column = sc;
-                ta2_push(&result, ts2);
+/* Identifiers, `quoted identifiers` and keywords */
+static void lex_identifier(TokStream2 *ts, Token2 *t)
+{
+    tok_put(t, "", 0);
+    if (ts->text[ts->pos] == '`') {
+        src_adv(ts);
+        while (src_more(ts) && src_cur(ts) != '`') {
+            tok_putc(t, src_cur(ts)); src_adv(ts);
+        }
+        if (src_cur(ts) == '`') src_adv(ts);
+        t->type = TOK_IDENTIFIER;
+        return;
+    }
+    take_ident(ts, t);
+    const char *w = t->buf;
+    if (strcmp(w, "null") == 0) t->type = TOK_NULL_TOK;
+    else if (strcmp(w, "true") == 0) t->type = TOK_TRUE;
+    else if (strcmp(w, "false") == 0) t->type = TOK_FALSE;
+    else if (strcmp(w, "NaN") == 0) { t->type = TOK_FLOAT; t->float_val = NAN; }
+    else if (strcmp(w, "Infinity") == 0) { t->type = TOK_FLOAT; t->float_val = INFINITY; }
+    else t->type = TOK_IDENTIFIER;
+}
+
+/* Reads the next token into t, reusing t's buffer */
+static void ts2_lex(TokStream2 *ts, Token2 *t)
+{
+    t->type = TOK_EOF_TOK;
+    t->text = NULL;
+    t->text_len = 0;
+    t->int_val = 0;
+    t->float_val = 0.0;
+    t->first = '\0';
+
+    if (ts->pending) {
+        /* The string behind an error token */
+        Token2 *e = ts->pending;
+        ts->pending = NULL;
+        tok_put(t, e->buf, ts->pending_len);
+        t->type = TOK_STRING;
+        t->line = ts->pending_line;
+        t->column = ts->pending_col;
+        t->first = ts->pending_quote;
+        return;
+    }
+
+    for (;;) {
+        skip_space(ts);
+
+        t->line = ts->line;
+        t->column = ts->col;
+        if (!src_more(ts)) return;   /* TOK_EOF_TOK */
+
+        char c = ts->text[ts->pos];
+        t->first = c;
+        switch (c) {
+        case '[': src_skip(ts, 1); t->type = TOK_LBRACKET; return;
+        case ']': src_skip(ts, 1); t->type = TOK_RBRACKET; return;
+        case '{': src_skip(ts, 1); t->type = TOK_LBRACE; return;
+        case '}': src_skip(ts, 1); t->type = TOK_RBRACE; return;
+        case '(': src_skip(ts, 1); t->type = TOK_LPAREN; return;
+        case ')': src_skip(ts, 1); t->type = TOK_RPAREN; return;
+        case ',': src_skip(ts, 1); t->type = TOK_COMMA; return;
+        case ':': src_skip(ts, 1); t->type = TOK_COLON; return;
+        case '=': src_skip(ts, 1); t->type = TOK_EQUALS; return;
+        case '&': src_skip(ts, 1); t->type = TOK_AMPERSAND; return;
+        case '|': src_skip(ts, 1); t->type = TOK_PIPE; return;
+        default: break;
+        }
+
+        /* Variant tag .Identifier */
+        if (c == '.') {
+            src_adv(ts);
+            char next = src_cur(ts);
+            if (isalpha((unsigned char)next) || next == '_') {
+                tok_put(t, "", 0);
+                take_ident(ts, t);
+                t->type = TOK_VARIANT_TAG;
             } else {
-                Token2 t = {0}; t.type = TOK_STRING; t.text = buf; t.text_len = blen;
-                t.line = sl; t.column = sc;
-                ta2_push(&result, t);
+                t->type = TOK_DOT;
             }
+            return;
+        }
+
+        if (c == '"' || c == '\'') {
+            lex_string(ts, t);
+            return;
         }
 
         /* Blob 0x... */
-        else if (c == '0' && PEEK2(1) == 'x') {
-            ADV2(); ADV2();
-            size_t bcap = 64, blen = 0;
-            char *buf = malloc(bcap);
-            while (pos < len && isxdigit((unsigned char)CUR2())) {
-                buf[blen++] = CUR2(); ADV2();
-                if (blen >= bcap - 1) { bcap *= 2; buf = realloc(buf, bcap); }
-            }
-            buf[blen] = '\0';
-            Token2 t = {0}; t.type = TOK_HEX; t.text = buf; t.text_len = blen;
-            t.line = sl; t.column = sc;
-            ta2_push(&result, t);
-        }
-
-        /* Number or datetime */
-        else if (isdigit((unsigned char)c) || (c == '-' && (isdigit((unsigned char)PEEK2(1)) || PEEK2(1) == 'I'))) {
-            /* Check -Infinity */
-            if (c == '-' && pos + 9 <= len && memcmp(text + pos + 1, "Infinity", 8) == 0) {
-                for (int i = 0; i < 9; i++) ADV2();
-                Token2 t = {0}; t.type = TOK_FLOAT; t.float_val = -INFINITY;
-                t.text = strdup("-Infinity"); t.text_len = 9;
-                t.line = sl; t.column = sc;
-                ta2_push(&result, t);
-            } else {
-                /* Collect number/datetime chars */
-                size_t bcap = 64, blen = 0;
-                char *buf = malloc(bcap);
-                bool has_t = false;
-                while (pos < len) {
-                    char cc = CUR2();
-                    if (cc == ':') {
-                        if (has_t || memchr(buf, '-', blen)) {
-                            buf[blen++] = cc; ADV2();
-                        } else break;
-                    } else if (isdigit((unsigned char)cc) || cc == '+' || cc == '-' ||
-                               cc == '.' || cc == 'T' || cc == 'Z' || cc == 'e' || cc == 'E') {
-                        if (cc == 'T') has_t = true;
-                        buf[blen++] = cc; ADV2();
-                    } else break;
-                    if (blen >= bcap - 1) { bcap *= 2; buf = realloc(buf, bcap); }
-                }
-                buf[blen] = '\0';
-                Token2 t = {0};
-                t.line = sl; t.column = sc;
-
-                /* Check for backreference: integer immediately followed by # */
-                if (pos < len && text[pos] == '#' && !has_t &&
-                    !memchr(buf, '.', blen) && !memchr(buf, ':', blen)) {
-                    buf[blen++] = '#';
-                    if (blen >= bcap) { bcap *= 2; buf = realloc(buf, bcap); }
-                    ADV2();
-                    /* Consume path components: .identifier or [content] */
-                    while (pos < len) {
-                        char cc = CUR2();
-                        if (cc == '.') {
-                            if (blen >= bcap - 1) { bcap *= 2; buf = realloc(buf, bcap); }
-                            buf[blen++] = cc; ADV2();
-                            while (pos < len && (isalnum((unsigned char)CUR2()) || CUR2() == '_')) {
-                                if (blen >= bcap - 1) { bcap *= 2; buf = realloc(buf, bcap); }
-                                buf[blen++] = CUR2(); ADV2();
-                            }
-                        } else if (cc == '[') {
-                            int depth2 = 1;
-                            if (blen >= bcap - 1) { bcap *= 2; buf = realloc(buf, bcap); }
-                            buf[blen++] = cc; ADV2();
-                            while (pos < len && depth2 > 0) {
-                                cc = CUR2();
-                                if (cc == '[') depth2++;
-                                else if (cc == ']') depth2--;
-                                if (blen >= bcap - 1) { bcap *= 2; buf = realloc(buf, bcap); }
-                                buf[blen++] = cc; ADV2();
-                            }
-                        } else {
-                            break;
-                        }
-                    }
-                    buf[blen] = '\0';
-                    t.type = TOK_BACKREF;
-                    t.text = buf; t.text_len = blen;
-                    ta2_push(&result, t);
-                } else if (has_t || (memchr(buf, ':', blen) && memchr(buf, '-', blen))) {
-                    t.type = TOK_DATETIME_LIT;
-                    t.text = buf; t.text_len = blen;
-                    ta2_push(&result, t);
-                } else if (memchr(buf, '.', blen) || memchr(buf, 'e', blen) || memchr(buf, 'E', blen)) {
-                    t.type = TOK_FLOAT;
-                    t.float_val = strtod(buf, NULL);
-                    t.text = buf; t.text_len = blen;
-                    ta2_push(&result, t);
-                } else {
-                    t.type = TOK_INTEGER;
-                    t.int_val = strtoll(buf, NULL, 10);
-                    t.text = buf; t.text_len = blen;
-                    ta2_push(&result, t);
-                }
-            }
+        if (c == '0' && src_peek(ts, 1) == 'x') {
+            src_adv(ts); src_adv(ts);
+            tok_put(t, "", 0);
+            take_hex(ts, t);
+            t->type = TOK_HEX;
+            return;
         }
 
-        /* Identifier/keyword */
-        else if (isalpha((unsigned char)c) || c == '_' || c == '`') {
-            if (c == '`') {
-                ADV2();
-                size_t bcap = 64, blen = 0;
-                char *buf = malloc(bcap);
-                while (pos < len && CUR2() != '`') {
-                    buf[blen++] = CUR2(); ADV2();
-                    if (blen >= bcap - 1) { bcap *= 2; buf = realloc(buf, bcap); }
-                }
-                if (CUR2() == '`') ADV2();
-                buf[blen] = '\0';
-                Token2 t = {0}; t.type = TOK_IDENTIFIER; t.text = buf; t.text_len = blen;
-                t.line = sl; t.column = sc;
-                ta2_push(&result, t);
-            } else {
-                size_t bcap = 64, blen = 0;
-                char *buf = malloc(bcap);
-                while (pos < len && (isalnum((unsigned char)CUR2()) || CUR2() == '_')) {
-                    buf[blen++] = CUR2(); ADV2();
-                    if (blen >= bcap - 1) { bcap *= 2; buf = realloc(buf, bcap); }
-                }
-                buf[blen] = '\0';
-                Token2 t = {0}; t.text = buf; t.text_len = blen;
-                t.line = sl; t.column = sc;
-
-                if (strcmp(buf, "null") == 0) t.type = TOK_NULL_TOK;
-                else if (strcmp(buf, "true") == 0) t.type = TOK_TRUE;
-                else if (strcmp(buf, "false") == 0) t.type = TOK_FALSE;
-                else if (strcmp(buf, "NaN") == 0) { t.type = TOK_FLOAT; t.float_val = NAN; }
-                else if (strcmp(buf, "Infinity") == 0) { t.type = TOK_FLOAT; t.float_val = INFINITY; }
-                else t.type = TOK_IDENTIFIER;
-
-                ta2_push(&result, t);
-            }
-        } else {
-            ADV2(); /* skip unrecognized */
+        if (isdigit((unsigned char)c) ||
+            (c == '-' && (isdigit((unsigned char)src_peek(ts, 1)) || src_peek(ts, 1) == 'I'))) {
+            lex_number(ts, t);
+            return;
         }
-    }
 
-    #undef ADV2
-    #undef CUR2
-    #undef PEEK2
+        if (isalpha((unsigned char)c) || c == '_' || c == '`') {
+            lex_identifier(ts, t);
+            return;
+        }
 
-    return result;
+        src_adv(ts); /* skip unrecognized */
+    }
 }
 
 /* ================================================================== */
 /*  Stream helpers                                                     */
 /* ================================================================== */
 
-static TokStream2 ts2_new(const char *text)
+/* The stream points into itself (pending), so it is set up in place */
+static void ts2_init(TokStream2 *ts, const char *text, EastReadFn read, void *read_ctx)
 {
-    TokStream2 ts;
-    ts.ta = tokenize2(text);
-    ts.pos = 0;
-    return ts;
+    memset(ts, 0, sizeof(*ts));
+    ts->text = text;
+    ts->len = text ? strlen(text) : 0;
+    ts->read = read;
+    ts->read_ctx = read_ctx;
+    ts->line = 1;
+    ts->col = 1;
+    ts2_lex(ts, &ts->ring[0]);
 }
 
 static void ts2_free(TokStream2 *ts)
 {
-    ta2_free(&ts->ta);
+    for (size_t i = 0; i < TS_RING; i++) free(ts->ring[i].buf);
+    free(ts->window);
 }
 
 static Token2 *ts2_cur(TokStream2 *ts)
 {
-    if (ts->pos >= ts->ta.count) return &ts->ta.tokens[ts->ta.count - 1];
-    return &ts->ta.tokens[ts->pos];
+    return &ts->ring[ts->cur];
 }
 
+/* Returns the token advanced past; the stream stays at end of input */
 static Token2 *ts2_adv(TokStream2 *ts)
 {
-    Token2 *t = ts2_cur(ts);
-    if (ts->pos < ts->ta.count - 1) ts->pos++;
+    Token2 *t = &ts->ring[ts->cur];
+    if (t->type == TOK_EOF_TOK) return t;
+    ts->cur = (ts->cur + 1) % TS_RING;
+    ts2_lex(ts, &ts->ring[ts->cur]);
     return t;
 }
 
@@ -858,6 +997,8 @@ static EastValue *parse_val(TokStream2 *ts, EastType *type, ParseContext *ctx)
         for (size_t i = 0; i < type->data.variant.num_cases; i++) {
             if (strcmp(type->data.variant.cases[i].name, case_name) == 0) {
                 case_type = type->data.variant.cases[i].type;
+                /* The tag token is recycled while the case value is read */
+                case_name = type->data.variant.cases[i].name;
                 break;
             }
         }
@@ -1020,7 +1161,8 @@ static EastValue *parse_val(TokStream2 *ts, EastType *type, ParseContext *ctx)
 EastValue *east_parse_value(const char *text, EastType *type)
 {
     if (!text || !type) return NULL;
-    TokStream2 ts = ts2_new(text);
+    TokStream2 ts;
+    ts2_init(&ts, text, NULL, NULL);
     ParseContext ctx = {0};
     EastValue *result = parse_val(&ts, type, &ctx);
     pctx_free(&ctx);
@@ -1074,61 +1216,23 @@ static void pe_prepend_path(ParseErr *e, const char *segment) {
 }
 
 /* Format "got" for a token: either 'c' for the first char, or "end of input" */
-static char *pe_got_token(Token2 *tok, const char *input) {
+static char *pe_got_token(Token2 *tok) {
     if (tok->type == TOK_EOF_TOK) return strdup("end of input");
-    /* Get the character at the token's position in the original input */
-    /* We can reconstruct from token line/col, but simpler: use the token text or type */
-    /* For single-char tokens, we know what they are */
-    char c = '\0';
-    switch (tok->type) {
-        case TOK_LBRACKET: c = '['; break;
-        case TOK_RBRACKET: c = ']'; break;
-        case TOK_LBRACE: c = '{'; break;
-        case TOK_RBRACE: c = '}'; break;
-        case TOK_LPAREN: c = '('; break;
-        case TOK_RPAREN: c = ')'; break;
-        case TOK_COMMA: c = ','; break;
-        case TOK_COLON: c = ':'; break;
-        case TOK_EQUALS: c = '='; break;
-        case TOK_AMPERSAND: c = '&'; break;
-        case TOK_PIPE: c = '|'; break;
-        case TOK_DOT: c = '.'; break;
-        default: break;
-    }
-    if (c) {
-        char buf[8];
-        snprintf(buf, sizeof(buf), "'%c'", c);
-        return strdup(buf);
-    }
-    /* For multi-char tokens, get the first character from input text at the token's position */
-    if (input) {
-        /* Find position in input by scanning to line/col */
-        int line = 1, col = 1;
-        const char *p = input;
-        while (*p) {
-            if (line == tok->line && col == tok->column) {
-                char buf[8];
-                snprintf(buf, sizeof(buf), "'%c'", *p);
-                return strdup(buf);
-            }
-            if (*p == '\n') { line++; col = 1; } else { col++; }
-            p++;
-        }
-    }
+    /* The input character at the token's position, kept by the lexer */
+    char c = tok->first;
     /* Fallback: use first char of token text */
-    if (tok->text && tok->text[0]) {
-        char buf[8];
-        snprintf(buf, sizeof(buf), "'%c'", tok->text[0]);
-        return strdup(buf);
-    }
-    return strdup("end of input");
+    if (!c && tok->text && tok->text_len) c = tok->text[0];
+    if (!c) return strdup("end of input");
+    char buf[8];
+    snprintf(buf, sizeof(buf), "'%c'", c);
+    return strdup(buf);
 }
 
 static EastValue *parse_val_err(TokStream2 *ts, EastType *type, ParseContext *ctx,
-                                 ParseErr *err, const char *input);
+                                 ParseErr *err);
 
 static EastValue *parse_val_err(TokStream2 *ts, EastType *type, ParseContext *ctx,
-                                 ParseErr *err, const char *input)
+                                 ParseErr *err)
 {
     if (!type) return NULL;
     Token2 *tok = ts2_cur(ts);
@@ -1137,7 +1241,7 @@ static EastValue *parse_val_err(TokStream2 *ts, EastType *type, ParseContext *ct
     case EAST_TYPE_NULL:
         if (tok->type == TOK_NULL_TOK) { ts2_adv(ts); return east_null(); }
         if (err) {
-            char *got = pe_got_token(tok, input);
+            char *got = pe_got_token(tok);
             size_t len = 30 + strlen(got);
             char *msg = malloc(len);
             snprintf(msg, len, "expected null, got %s", got);
@@ -1150,7 +1254,7 @@ static EastValue *parse_val_err(TokStream2 *ts, EastType *type, ParseContext *ct
         if (tok->type == TOK_TRUE) { ts2_adv(ts); return east_boolean(true); }
         if (tok->type == TOK_FALSE) { ts2_adv(ts); return east_boolean(false); }
         if (err) {
-            char *got = pe_got_token(tok, input);
+            char *got = pe_got_token(tok);
             size_t len = 30 + strlen(got);
             char *msg = malloc(len);
             snprintf(msg, len, "expected boolean, got %s", got);
@@ -1179,7 +1283,7 @@ static EastValue *parse_val_err(TokStream2 *ts, EastType *type, ParseContext *ct
             return east_integer(tok->int_val);
         }
         if (err) {
-            char *got = pe_got_token(tok, input);
+            char *got = pe_got_token(tok);
             size_t len = 30 + strlen(got);
             char *msg = malloc(len);
             snprintf(msg, len, "expected integer, got %s", got);
@@ -1207,7 +1311,7 @@ static EastValue *parse_val_err(TokStream2 *ts, EastType *type, ParseContext *ct
         }
         if (tok->type == TOK_INTEGER) { ts2_adv(ts); return east_float((double)tok->int_val); }
         if (err) {
-            char *got = pe_got_token(tok, input);
+            char *got = pe_got_token(tok);
             size_t len = 30 + strlen(got);
             char *msg = malloc(len);
             snprintf(msg, len, "expected float, got %s", got);
@@ -1230,7 +1334,7 @@ static EastValue *parse_val_err(TokStream2 *ts, EastType *type, ParseContext *ct
             return east_string_len(tok->text, tok->text_len);
         }
         if (err) {
-            char *got = pe_got_token(tok, input);
+            char *got = pe_got_token(tok);
             size_t len = 30 + strlen(got);
             char *msg = malloc(len);
             snprintf(msg, len, "expected '\"', got %s", got);
@@ -1346,7 +1450,7 @@ static EastValue *parse_val_err(TokStream2 *ts, EastType *type, ParseContext *ct
                 if (ctx) pctx_push_path(ctx, idx_buf);
 
                 ParseErr inner = {0};
-                EastValue *elem = parse_val_err(ts, elem_type, ctx, err ? &inner : NULL, input);
+                EastValue *elem = parse_val_err(ts, elem_type, ctx, err ? &inner : NULL);
                 if (ctx) pctx_pop_path(ctx);
                 if (!elem) {
                     if (err && inner.message) {
@@ -1395,7 +1499,7 @@ static EastValue *parse_val_err(TokStream2 *ts, EastType *type, ParseContext *ct
                 snprintf(idx_buf, sizeof(idx_buf), "[%zu]", idx);
 
                 ParseErr inner = {0};
-                EastValue *elem = parse_val_err(ts, elem_type, ctx, err ? &inner : NULL, input);
+                EastValue *elem = parse_val_err(ts, elem_type, ctx, err ? &inner : NULL);
                 if (!elem) {
                     if (err && inner.message) {
                         pe_prepend_path(&inner, idx_buf);
@@ -1462,7 +1566,7 @@ static EastValue *parse_val_err(TokStream2 *ts, EastType *type, ParseContext *ct
             snprintf(key_path, sizeof(key_path), "[%zu](key)", entry_idx);
 
             ParseErr inner = {0};
-            EastValue *k = parse_val_err(ts, key_type, ctx, err ? &inner : NULL, input);
+            EastValue *k = parse_val_err(ts, key_type, ctx, err ? &inner : NULL);
             if (!k) {
                 if (err && inner.message) {
                     pe_prepend_path(&inner, key_path);
@@ -1493,7 +1597,7 @@ static EastValue *parse_val_err(TokStream2 *ts, EastType *type, ParseContext *ct
             snprintf(val_path, vpath_len, "[%s]", key_str);
 
             ParseErr inner2 = {0};
-            EastValue *v = parse_val_err(ts, val_type, ctx, err ? &inner2 : NULL, input);
+            EastValue *v = parse_val_err(ts, val_type, ctx, err ? &inner2 : NULL);
             if (!v) {
                 if (err && inner2.message) {
                     pe_prepend_path(&inner2, val_path);
@@ -1622,7 +1726,7 @@ static EastValue *parse_val_err(TokStream2 *ts, EastType *type, ParseContext *ct
 
             ParseErr inner = {0};
             values[fi] = parse_val_err(ts, type->data.struct_.fields[fi].type, ctx,
-                                       err ? &inner : NULL, input);
+                                       err ? &inner : NULL);
             if (ctx) pctx_pop_path(ctx);
             if (!values[fi]) {
                 if (err && inner.message) {
@@ -1714,6 +1818,8 @@ static EastValue *parse_val_err(TokStream2 *ts, EastType *type, ParseContext *ct
         for (size_t i = 0; i < type->data.variant.num_cases; i++) {
             if (strcmp(type->data.variant.cases[i].name, case_name) == 0) {
                 case_type = type->data.variant.cases[i].type;
+                /* The tag token is recycled while the case value is read */
+                case_name = type->data.variant.cases[i].name;
                 break;
             }
         }
@@ -1760,7 +1866,7 @@ static EastValue *parse_val_err(TokStream2 *ts, EastType *type, ParseContext *ct
             } else {
                 /* Non-null data for a null case */
                 if (err) {
-                    char *got = pe_got_token(next, input);
+                    char *got = pe_got_token(next);
                     size_t len = 30 + strlen(got);
                     char *msg = malloc(len);
                     snprintf(msg, len, "expected null, got %s", got);
@@ -1777,7 +1883,7 @@ static EastValue *parse_val_err(TokStream2 *ts, EastType *type, ParseContext *ct
             snprintf(path_buf, sizeof(path_buf), ".%s", case_name);
 
             ParseErr inner = {0};
-            case_value = parse_val_err(ts, case_type, ctx, err ? &inner : NULL, input);
+            case_value = parse_val_err(ts, case_type, ctx, err ? &inner : NULL);
             if (!case_value) {
                 if (err && inner.message) {
                     pe_prepend_path(&inner, path_buf);
@@ -1796,7 +1902,7 @@ static EastValue *parse_val_err(TokStream2 *ts, EastType *type, ParseContext *ct
         if (ctx && ts2_cur(ts)->type == TOK_BACKREF)
             return pctx_resolve_backref(ts, ctx);
         if (!ts2_match(ts, TOK_AMPERSAND)) return NULL;
-        EastValue *inner = parse_val_err(ts, type->data.element, ctx, err, input);
+        EastValue *inner = parse_val_err(ts, type->data.element, ctx, err);
         if (!inner) return NULL;
         EastValue *ref = east_ref_new(inner);
         east_value_release(inner);
@@ -1819,7 +1925,7 @@ static EastValue *parse_val_err(TokStream2 *ts, EastType *type, ParseContext *ct
         void *tmp = malloc(cap * elem_size);
         if (ts2_cur(ts)->type != TOK_RBRACKET) {
             for (;;) {
-                EastValue *elem = parse_val_err(ts, elem_type, ctx, err, input);
+                EastValue *elem = parse_val_err(ts, elem_type, ctx, err);
                 if (!elem) { free(tmp); return NULL; }
                 if (vlen >= cap) { cap *= 2; tmp = realloc(tmp, cap * elem_size); }
                 if (elem_type->kind == EAST_TYPE_FLOAT) ((double *)tmp)[vlen] = elem->data.float64;
@@ -1858,7 +1964,7 @@ static EastValue *parse_val_err(TokStream2 *ts, EastType *type, ParseContext *ct
                 if (ts2_cur(ts)->type != TOK_RBRACKET) {
                     for (;;) {
                         if (flat_len >= cap_flat) { cap_flat *= 2; flat = realloc(flat, cap_flat * elem_size); }
-                        EastValue *elem = parse_val_err(ts, elem_type, ctx, err, input);
+                        EastValue *elem = parse_val_err(ts, elem_type, ctx, err);
                         if (!elem) { free(flat); return NULL; }
                         if (elem_type->kind == EAST_TYPE_FLOAT) ((double *)flat)[flat_len] = elem->data.float64;
                         else if (elem_type->kind == EAST_TYPE_INTEGER) ((int64_t *)flat)[flat_len] = elem->data.integer;
@@ -1883,7 +1989,7 @@ static EastValue *parse_val_err(TokStream2 *ts, EastType *type, ParseContext *ct
 
     case EAST_TYPE_RECURSIVE:
         if (type->data.recursive.node)
-            return parse_val_err(ts, type->data.recursive.node, ctx, err, input);
+            return parse_val_err(ts, type->data.recursive.node, ctx, err);
         return NULL;
 
     case EAST_TYPE_NEVER:
@@ -1898,19 +2004,18 @@ static EastValue *parse_val_err(TokStream2 *ts, EastType *type, ParseContext *ct
 /*  Public API: east_parse_value_with_error                            */
 /* ================================================================== */
 
-EastValue *east_parse_value_with_error(const char *text, EastType *type, char **error_out)
+/* Parses a whole value from ts, which it frees */
+static EastValue *parse_value_with_error(TokStream2 *ts, EastType *type, char **error_out)
 {
-    if (!text || !type) return NULL;
-    TokStream2 ts = ts2_new(text);
     ParseContext ctx = {0};
     ParseErr err;
     pe_init(&err);
 
-    EastValue *result = parse_val_err(&ts, type, &ctx, error_out ? &err : NULL, text);
+    EastValue *result = parse_val_err(ts, type, &ctx, error_out ? &err : NULL);
 
-    if (result && ts2_cur(&ts)->type != TOK_EOF_TOK) {
+    if (result && ts2_cur(ts)->type != TOK_EOF_TOK) {
         /* Unexpected trailing input */
-        Token2 *extra = ts2_cur(&ts);
+        Token2 *extra = ts2_cur(ts);
         if (error_out) {
             char *type_str = east_print_type(type);
             size_t total = 200 + (type_str ? strlen(type_str) : 0);
@@ -1949,10 +2054,27 @@ EastValue *east_parse_value_with_error(const char *text, EastType *type, char **
 
     pe_free(&err);
     pctx_free(&ctx);
-    ts2_free(&ts);
+    ts2_free(ts);
     return result;
 }
 
+EastValue *east_parse_value_with_error(const char *text, EastType *type, char **error_out)
+{
+    if (!text || !type) return NULL;
+    TokStream2 ts;
+    ts2_init(&ts, text, NULL, NULL);
+    return parse_value_with_error(&ts, type, error_out);
+}
+
+EastValue *east_parse_value_stream(EastReadFn read, void *ctx, EastType *type,
+                                   char **error_out)
+{
+    if (!read || !type) return NULL;
+    TokStream2 ts;
+    ts2_init(&ts, NULL, read, ctx);
+    return parse_value_with_error(&ts, type, error_out);
+}
+
 /* ================================================================== */
 /*  Type parser                                                        */
 /* ================================================================== */
@@ -2082,7 +2204,7 @@ static EastType *parse_type_internal(TokStream2 *ts)
                     if (strcmp(n->text, "name") == 0) {
                         Token2 *s = ts2_cur(ts);
                         if (s->type == TOK_STRING) {
-                            fname = strdup(s->text);
+                            fname = tok_dup(s);
                             ts2_adv(ts);
                         }
                     } else if (strcmp(n->text, "type") == 0) {
@@ -2146,7 +2268,7 @@ static EastType *parse_type_internal(TokStream2 *ts)
                     if (strcmp(n->text, "name") == 0) {
                         Token2 *s = ts2_cur(ts);
                         if (s->type == TOK_STRING) {
-                            cname = strdup(s->text);
+                            cname = tok_dup(s);
                             ts2_adv(ts);
                         }
                     } else if (strcmp(n->text, "type") == 0) {
@@ -2255,7 +2377,8 @@ static EastType *parse_type_internal(TokStream2 *ts)
 EastType *east_parse_type(const char *text)
 {
     if (!text) return NULL;
-    TokStream2 ts = ts2_new(text);
+    TokStream2 ts;
+    ts2_init(&ts, text, NULL, NULL);
     EastType *result = parse_type_internal(&ts);
     ts2_free(&ts);
     return result;
@@ -5,6 +5,11 @@
  *
  * east_print_value(value, type) -> char*  (allocated string)
  * east_print_type(type) -> char*          (allocated string)
+ *
+ * Values are scanned once before printing: the scan estimates the output
+ * size, so the buffer is allocated once, and checks whether any container
+ * is reachable twice. Only then does printing track paths for
+ * backreferences; otherwise it runs without the alias context.
  */
 
 #include "east/serialization.h"
@@ -256,6 +261,196 @@ static void ctx_free(PrintContext *ctx) {
     free(ctx->path);
 }
 
+/* ================================================================== */
+/*  Pre-pass: aliasing and output size                                 */
+/* ================================================================== */
+
+/* Upper bounds for the scalars, by printed form */
+#define EST_INTEGER 20      /* -9223372036854775808 */
+#define EST_FLOAT 24        /* -2.2250738585072014e-308 */
+#define EST_DATETIME 23     /* 2024-01-01T00:00:00.000 */
+#define EST_COLUMNAR_STRING 16
+
+typedef struct {
+    uintptr_t *slots;    /* open-addressed pointer set, 0 = empty */
+    size_t mask;
+    size_t count;
+    size_t bytes;        /* estimated output size */
+    bool aliased;        /* some container is reachable twice */
+} PrintScan;
+
+/* False if ptr was already in the set */
+static bool scan_insert(PrintScan *s, EastValue *ptr)
+{
+    if ((s->count + 1) * 10 >= (s->mask + 1) * 7) {
+        size_t cap = s->slots ? (s->mask + 1) * 2 : 64;
+        uintptr_t *slots = calloc(cap, sizeof(uintptr_t));
+        if (!slots) {
+            /* Without the set, assume the worst */
+            s->aliased = true;
+            return false;
+        }
+        for (size_t i = 0; s->slots && i <= s->mask; i++) {
+            if (!s->slots[i]) continue;
+            size_t h = print_hash_ptr(s->slots[i]) & (cap - 1);
+            while (slots[h]) h = (h + 1) & (cap - 1);
+            slots[h] = s->slots[i];
+        }
+        free(s->slots);
+        s->slots = slots;
+        s->mask = cap - 1;
+    }
+    uintptr_t key = (uintptr_t)ptr;
+    size_t h = print_hash_ptr(key) & s->mask;
+    for (; s->slots[h]; h = (h + 1) & s->mask)
+        if (s->slots[h] == key) return false;
+    s->slots[h] = key;
+    s->count++;
+    return true;
+}
+
+/* Printed size of a value of a fixed-size type, or 0 if it varies */
+static size_t fixed_size(EastType *type)
+{
+    switch (type->kind) {
+    case EAST_TYPE_NEVER:
+    case EAST_TYPE_NULL:     return 4;
+    case EAST_TYPE_BOOLEAN:  return 5;
+    case EAST_TYPE_INTEGER:  return EST_INTEGER;
+    case EAST_TYPE_FLOAT:    return EST_FLOAT;
+    case EAST_TYPE_DATETIME: return EST_DATETIME;
+    case EAST_TYPE_FUNCTION:
+    case EAST_TYPE_ASYNC_FUNCTION: return 2;
+    default:                 return 0;
+    }
+}
+
+/* Per-row estimate for a columnar array, whose fields are all scalars */
+static size_t columnar_row_size(EastType *row_type)
+{
+    size_t n = 2;
+    for (size_t i = 0; i < row_type->data.struct_.num_fields; i++) {
+        EastType *ft = row_type->data.struct_.fields[i].type;
+        n += strlen(row_type->data.struct_.fields[i].name) + 3;
+        if (ft->kind == EAST_TYPE_VARIANT) {
+            /* Option<T>: ".some " and the value, or ".none" */
+            n += 6;
+            ft = ft->data.variant.num_cases > 1 ? ft->data.variant.cases[1].type : ft;
+        }
+        size_t f = fixed_size(ft);
+        n += f ? f : EST_COLUMNAR_STRING;
+    }
+    return n;
+}
+
+/* Containers only count once they are shared: a container held once
+ * cannot be reached twice from the root. Stops at the first alias. */
+static void scan_val(PrintScan *s, EastValue *value, EastType *type)
+{
+    if (s->aliased) return;
+    if (!type || !value) {
+        s->bytes += 4;
+        return;
+    }
+    size_t fixed = fixed_size(type);
+    if (fixed) {
+        s->bytes += fixed;
+        return;
+    }
+
+    switch (type->kind) {
+    case EAST_TYPE_STRING:
+        s->bytes += value->data.string.len + 2;
+        break;
+
+    case EAST_TYPE_BLOB:
+        s->bytes += 2 + 2 * value->data.blob.len;
+        break;
+
+    case EAST_TYPE_ARRAY:
+    case EAST_TYPE_SET:
+    case EAST_TYPE_DICT:
+    case EAST_TYPE_REF:
+        if (value->ref_count > 1 && !scan_insert(s, value)) {
+            s->aliased = true;
+            return;
+        }
+        if (type->kind == EAST_TYPE_ARRAY) {
+            size_t n = value->data.array.len;
+            size_t elem = fixed_size(type->data.element);
+            if (value->columnar) {
+                s->bytes += 2 + n * (2 + columnar_row_size(type->data.element));
+            } else if (elem) {
+                s->bytes += 2 + n * (2 + elem);
+            } else {
+                s->bytes += 2 + 2 * n;
+                for (size_t i = 0; i < n && !s->aliased; i++)
+                    scan_val(s, value->data.array.items[i], type->data.element);
+            }
+        } else if (type->kind == EAST_TYPE_SET) {
+            s->bytes += 3 + value->data.set.len;
+            for (size_t i = 0; i < value->data.set.len && !s->aliased; i++)
+                scan_val(s, value->data.set.items[i], type->data.element);
+        } else if (type->kind == EAST_TYPE_DICT) {
+            s->bytes += 3 + 2 * value->data.dict.len;
+            for (size_t i = 0; i < value->data.dict.len && !s->aliased; i++) {
+                scan_val(s, value->data.dict.keys[i], type->data.dict.key);
+                scan_val(s, value->data.dict.values[i], type->data.dict.value);
+            }
+        } else {
+            s->bytes += 1;
+            scan_val(s, value->data.ref.value, type->data.element);
+        }
+        break;
+
+    case EAST_TYPE_STRUCT:
+        s->bytes += 2;
+        for (size_t i = 0; i < type->data.struct_.num_fields && !s->aliased; i++) {
+            s->bytes += strlen(type->data.struct_.fields[i].name) + 3;
+            EastValue *fval = (value->kind == EAST_VAL_STRUCT && i < value->data.struct_.num_fields)
+                            ? value->data.struct_.field_values[i] : NULL;
+            scan_val(s, fval, type->data.struct_.fields[i].type);
+        }
+        break;
+
+    case EAST_TYPE_VARIANT: {
+        if (value->kind != EAST_VAL_VARIANT || !value->data.variant.case_name) {
+            s->bytes += 4;
+            break;
+        }
+        const char *case_name = value->data.variant.case_name;
+        s->bytes += strlen(case_name) + 2;
+        for (size_t i = 0; i < type->data.variant.num_cases; i++) {
+            if (strcmp(type->data.variant.cases[i].name, case_name) == 0) {
+                scan_val(s, value->data.variant.value, type->data.variant.cases[i].type);
+                break;
+            }
+        }
+        break;
+    }
+
+    case EAST_TYPE_VECTOR: {
+        size_t elem = fixed_size(type->data.element);
+        s->bytes += 5 + value->data.vector.len * (2 + elem);
+        break;
+    }
+
+    case EAST_TYPE_MATRIX: {
+        size_t elem = fixed_size(type->data.element);
+        size_t rows = value->data.matrix.rows, cols = value->data.matrix.cols;
+        s->bytes += 5 + rows * (4 + cols * (2 + elem));
+        break;
+    }
+
+    case EAST_TYPE_RECURSIVE:
+        scan_val(s, value, type->data.recursive.node);
+        break;
+
+    default:
+        break;
+    }
+}
+
 /* ================================================================== */
 /*  Value printer                                                      */
 /* ================================================================== */
@@ -391,10 +586,14 @@ static void print_val(PBuf *sb, EastValue *value, EastType *type, PrintContext *
             pbuf_append_char(sb, '[');
             for (size_t i = 0; i < count; i++) {
                 if (i > 0) pbuf_append_str(sb, ", ");
+                if (!ctx) {
+                    print_val(sb, east_array_get(value, i), elem_type, NULL);
+                    continue;
+                }
                 char idx_buf[24];
                 snprintf(idx_buf, sizeof(idx_buf), "[%zu]", i);
                 ctx_push_path(ctx, idx_buf);
-                print_val(sb, value->data.array.items[i], elem_type, ctx);
+                print_val(sb, east_array_get(value, i), elem_type, ctx);
                 ctx_pop_path(ctx);
             }
             pbuf_append_char(sb, ']');
@@ -472,6 +671,10 @@ static void print_val(PBuf *sb, EastValue *value, EastType *type, PrintContext *
                 /* Struct values always have fields in type schema order */
                 EastValue *fval = (value->kind == EAST_VAL_STRUCT && i < value->data.struct_.num_fields)
                                 ? value->data.struct_.field_values[i] : NULL;
+                if (!ctx) {
+                    print_val(sb, fval, ftype, NULL);
+                    continue;
+                }
                 /* Push field path component: ".fieldname" */
                 char path_buf[256];
                 snprintf(path_buf, sizeof(path_buf), ".%s", fname);
@@ -633,10 +836,24 @@ static void print_val(PBuf *sb, EastValue *value, EastType *type, PrintContext *
 
 char *east_print_value(EastValue *value, EastType *type)
 {
-    PBuf sb = pbuf_new(256);
-    PrintContext ctx = {0};
-    print_val(&sb, value, type, &ctx);
-    ctx_free(&ctx);
+    PrintScan scan = {0};
+    scan_val(&scan, value, type);
+    free(scan.slots);
+
+    if (scan.aliased) {
+        PBuf sb = pbuf_new(256);
+        PrintContext ctx = {0};
+        print_val(&sb, value, type, &ctx);
+        ctx_free(&ctx);
+        return pbuf_finish(&sb);
+    }
+    PBuf sb = pbuf_new(scan.bytes + 1);
+    print_val(&sb, value, type, NULL);
+    /* The estimate is an upper bound for numbers; give back a large excess */
+    if (sb.data && sb.cap > 2 * sb.len + 4096) {
+        char *nd = realloc(sb.data, sb.len + 1);
+        if (nd) sb.data = nd;
+    }
     return pbuf_finish(&sb);
 }
 
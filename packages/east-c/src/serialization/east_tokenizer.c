@@ -16,6 +16,7 @@
 #include "east/serialization.h"
 #include "east/types.h"
 #include "east/values.h"
+#include "east/numparse.h"
 
 #include <ctype.h>
 #include <math.h>
@@ -280,13 +281,13 @@ static EastToken tok_read_number_or_datetime(Tokenizer *t)
     /* Check for float */
     if (memchr(buf, '.', len) || memchr(buf, 'e', len) || memchr(buf, 'E', len)) {
         tok.type = TOK_FLOAT;
-        tok.float_val = strtod(buf, NULL);
+        east_parse_double(buf, len, &tok.float_val);
         return tok;
     }
 
     /* Integer */
     tok.type = TOK_INTEGER;
-    tok.int_val = strtoll(buf, NULL, 10);
+    east_parse_int64(buf, len, &tok.int_val, NULL);
     return tok;
 }
 
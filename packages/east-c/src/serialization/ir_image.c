@@ -0,0 +1,1200 @@
+/*
+ * Program images for converted IR trees.
+ *
+ * An image is a flat, pointer-free encoding of an IRNode tree that can be
+ * turned back into IRNodes without going through the IR value form.
+ *
+ * Layout:
+ *   magic "\x89EastIR" + version byte
+ *   source hash (8 bytes little-endian)
+ *   root node
+ *
+ * Node:     kind byte | type | locations | kind-specific payload
+ * Type:     kind byte | kind-specific payload
+ * String:   varint (len + 1) + bytes, or varint 0 for NULL
+ * Location: string filename + zigzag line + zigzag column
+ *
+ * Compound types and nodes are numbered in pre-order as they are written;
+ * a later occurrence of the same pointer is written as TAG_BACKREF + index
+ * so shared subtrees stay shared.  Self-references inside a Recursive type
+ * are back-references to the wrapper.
+ */
+
+#include "east/ir_image.h"
+#include "east/type_of_type.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define TAG_NULL    0xFE
+#define TAG_BACKREF 0xFF
+
+static const uint8_t IMAGE_MAGIC[7] = { 0x89, 'E', 'a', 's', 't', 'I', 'R' };
+
+uint64_t east_ir_image_hash(const uint8_t *data, size_t len)
+{
+    uint64_t h = 0xcbf29ce484222325ULL;
+    for (size_t i = 0; i < len; i++) {
+        h ^= data[i];
+        h *= 0x100000001b3ULL;
+    }
+    return h;
+}
+
+/* ================================================================== */
+/*  Pointer -> index map (encoder memo)                                */
+/* ================================================================== */
+
+typedef struct {
+    uintptr_t key;     /* 0 = empty slot */
+    size_t index;
+} PtrSlot;
+
+typedef struct {
+    PtrSlot *slots;
+    size_t mask;
+    size_t count;
+} PtrMap;
+
+static inline size_t ptr_slot(uintptr_t p, size_t mask)
+{
+    return (size_t)(((uint64_t)p >> 4) * 0x9E3779B97F4A7C15ULL >> 32) & mask;
+}
+
+static void ptr_map_free(PtrMap *m)
+{
+    free(m->slots);
+    m->slots = NULL;
+    m->mask = 0;
+    m->count = 0;
+}
+
+static bool ptr_map_find(PtrMap *m, const void *p, size_t *out_index)
+{
+    if (!m->slots) return false;
+    uintptr_t key = (uintptr_t)p;
+    size_t i = ptr_slot(key, m->mask);
+    while (m->slots[i].key) {
+        if (m->slots[i].key == key) {
+            *out_index = m->slots[i].index;
+            return true;
+        }
+        i = (i + 1) & m->mask;
+    }
+    return false;
+}
+
+static void ptr_map_add(PtrMap *m, const void *p, size_t index)
+{
+    if (!m->slots || (m->count + 1) * 2 > m->mask + 1) {
+        size_t new_cap = m->slots ? (m->mask + 1) * 2 : 64;
+        PtrSlot *slots = calloc(new_cap, sizeof(PtrSlot));
+        if (!slots) return;
+        for (size_t i = 0; m->slots && i <= m->mask; i++) {
+            if (!m->slots[i].key) continue;
+            size_t j = ptr_slot(m->slots[i].key, new_cap - 1);
+            while (slots[j].key) j = (j + 1) & (new_cap - 1);
+            slots[j] = m->slots[i];
+        }
+        free(m->slots);
+        m->slots = slots;
+        m->mask = new_cap - 1;
+    }
+    uintptr_t key = (uintptr_t)p;
+    size_t i = ptr_slot(key, m->mask);
+    while (m->slots[i].key) i = (i + 1) & m->mask;
+    m->slots[i].key = key;
+    m->slots[i].index = index;
+    m->count++;
+}
+
+/* ================================================================== */
+/*  Encoder                                                            */
+/* ================================================================== */
+
+typedef struct {
+    ByteBuffer *buf;
+    PtrMap types;
+    size_t num_types;
+    PtrMap nodes;
+    size_t num_nodes;
+    int rec_depth;     /* > 0 while inside a Recursive type's node */
+    IRNode *root;
+    bool ok;
+} ImageWriter;
+
+static void write_u64_le(ByteBuffer *buf, uint64_t v)
+{
+    uint8_t bytes[8];
+    for (int i = 0; i < 8; i++) bytes[i] = (uint8_t)(v >> (8 * i));
+    byte_buffer_write_bytes(buf, bytes, 8);
+}
+
+static void write_str(ByteBuffer *buf, const char *s)
+{
+    if (!s) { write_varint(buf, 0); return; }
+    size_t len = strlen(s);
+    write_varint(buf, (uint64_t)len + 1);
+    byte_buffer_write_bytes(buf, (const uint8_t *)s, len);
+}
+
+static void write_type(ImageWriter *w, EastType *t)
+{
+    if (!t) { byte_buffer_write_u8(w->buf, TAG_NULL); return; }
+    if (t->kind <= EAST_TYPE_BLOB) {
+        byte_buffer_write_u8(w->buf, (uint8_t)t->kind);
+        return;
+    }
+
+    size_t idx;
+    if (ptr_map_find(&w->types, t, &idx)) {
+        byte_buffer_write_u8(w->buf, TAG_BACKREF);
+        write_varint(w->buf, (uint64_t)idx);
+        return;
+    }
+    idx = w->num_types++;
+    /* Inside a recursive node only the wrappers themselves are shared:
+     * finalize counts back-references by walking the tree, so every other
+     * subtree must be rebuilt as its own copy. */
+    if (w->rec_depth == 0 || t->kind == EAST_TYPE_RECURSIVE) {
+        ptr_map_add(&w->types, t, idx);
+    }
+
+    byte_buffer_write_u8(w->buf, (uint8_t)t->kind);
+    switch (t->kind) {
+    case EAST_TYPE_ARRAY:
+    case EAST_TYPE_SET:
+    case EAST_TYPE_REF:
+    case EAST_TYPE_VECTOR:
+    case EAST_TYPE_MATRIX:
+        write_type(w, t->data.element);
+        break;
+    case EAST_TYPE_DICT:
+        write_type(w, t->data.dict.key);
+        write_type(w, t->data.dict.value);
+        break;
+    case EAST_TYPE_STRUCT:
+        write_varint(w->buf, t->data.struct_.num_fields);
+        for (size_t i = 0; i < t->data.struct_.num_fields; i++) {
+            write_str(w->buf, t->data.struct_.fields[i].name);
+            write_type(w, t->data.struct_.fields[i].type);
+        }
+        break;
+    case EAST_TYPE_VARIANT:
+        write_varint(w->buf, t->data.variant.num_cases);
+        for (size_t i = 0; i < t->data.variant.num_cases; i++) {
+            write_str(w->buf, t->data.variant.cases[i].name);
+            write_type(w, t->data.variant.cases[i].type);
+        }
+        break;
+    case EAST_TYPE_FUNCTION:
+    case EAST_TYPE_ASYNC_FUNCTION:
+        write_varint(w->buf, t->data.function.num_inputs);
+        for (size_t i = 0; i < t->data.function.num_inputs; i++) {
+            write_type(w, t->data.function.inputs[i]);
+        }
+        write_type(w, t->data.function.output);
+        break;
+    case EAST_TYPE_RECURSIVE:
+        w->rec_depth++;
+        write_type(w, t->data.recursive.node);
+        w->rec_depth--;
+        break;
+    default:
+        w->ok = false;
+        break;
+    }
+}
+
+/* IR literals are always primitives (see east_literal_value_type). */
+static void write_literal(ImageWriter *w, EastValue *v)
+{
+    if (!v) { byte_buffer_write_u8(w->buf, TAG_NULL); return; }
+    byte_buffer_write_u8(w->buf, (uint8_t)v->kind);
+    switch (v->kind) {
+    case EAST_VAL_NULL:
+        break;
+    case EAST_VAL_BOOLEAN:
+        byte_buffer_write_u8(w->buf, v->data.boolean ? 1 : 0);
+        break;
+    case EAST_VAL_INTEGER:
+        write_zigzag(w->buf, v->data.integer);
+        break;
+    case EAST_VAL_FLOAT: {
+        uint64_t bits;
+        memcpy(&bits, &v->data.float64, 8);
+        write_u64_le(w->buf, bits);
+        break;
+    }
+    case EAST_VAL_STRING:
+        write_varint(w->buf, v->data.string.len);
+        byte_buffer_write_bytes(w->buf, (const uint8_t *)v->data.string.data,
+                                v->data.string.len);
+        break;
+    case EAST_VAL_DATETIME:
+        write_zigzag(w->buf, v->data.datetime);
+        break;
+    case EAST_VAL_BLOB:
+        write_varint(w->buf, v->data.blob.len);
+        byte_buffer_write_bytes(w->buf, v->data.blob.data, v->data.blob.len);
+        break;
+    default:
+        w->ok = false;
+        break;
+    }
+}
+
+static void write_vars(ImageWriter *w, IRVariable *vars, size_t n)
+{
+    write_varint(w->buf, n);
+    for (size_t i = 0; i < n; i++) {
+        write_str(w->buf, vars[i].name);
+        byte_buffer_write_u8(w->buf, (uint8_t)((vars[i].mutable ? 1 : 0) |
+                                               (vars[i].captured ? 2 : 0)));
+    }
+}
+
+static void write_node(ImageWriter *w, IRNode *n);
+
+static void write_nodes(ImageWriter *w, IRNode **nodes, size_t n)
+{
+    write_varint(w->buf, n);
+    for (size_t i = 0; i < n; i++) write_node(w, nodes[i]);
+}
+
+static void write_types(ImageWriter *w, EastType **types, size_t n)
+{
+    write_varint(w->buf, n);
+    for (size_t i = 0; i < n; i++) write_type(w, types[i]);
+}
+
+static void write_function_source(ImageWriter *w, IRNode *n)
+{
+    /* The root is compiled from its body directly and never becomes a
+     * closure value, so its source (the whole program) is not needed. */
+    if (n == w->root) { write_varint(w->buf, 0); return; }
+
+    if (!n->data.function.source_ir) { write_varint(w->buf, 0); return; }
+
+    if (!east_ir_type) east_type_of_type_init();
+    ByteBuffer *src = east_beast2_encode(n->data.function.source_ir, east_ir_type);
+    if (!src) { w->ok = false; return; }
+    write_varint(w->buf, src->len);
+    byte_buffer_write_bytes(w->buf, src->data, src->len);
+    byte_buffer_free(src);
+}
+
+static void write_node(ImageWriter *w, IRNode *n)
+{
+    if (!n) { byte_buffer_write_u8(w->buf, TAG_NULL); return; }
+
+    size_t idx;
+    if (ptr_map_find(&w->nodes, n, &idx)) {
+        byte_buffer_write_u8(w->buf, TAG_BACKREF);
+        write_varint(w->buf, (uint64_t)idx);
+        return;
+    }
+    ptr_map_add(&w->nodes, n, w->num_nodes++);
+
+    byte_buffer_write_u8(w->buf, (uint8_t)n->kind);
+    write_type(w, n->type);
+    write_varint(w->buf, n->num_locations);
+    for (size_t i = 0; i < n->num_locations; i++) {
+        write_str(w->buf, n->locations[i].filename);
+        write_zigzag(w->buf, n->locations[i].line);
+        write_zigzag(w->buf, n->locations[i].column);
+    }
+
+    switch (n->kind) {
+    case IR_VALUE:
+        write_literal(w, n->data.value.value);
+        break;
+    case IR_VARIABLE:
+        write_str(w->buf, n->data.variable.name);
+        byte_buffer_write_u8(w->buf, (uint8_t)((n->data.variable.mutable ? 1 : 0) |
+                                               (n->data.variable.captured ? 2 : 0)));
+        break;
+    case IR_LET:
+        write_vars(w, &n->data.let.var, 1);
+        write_node(w, n->data.let.value);
+        break;
+    case IR_ASSIGN:
+        write_str(w->buf, n->data.assign.name);
+        write_node(w, n->data.assign.value);
+        break;
+    case IR_BLOCK:
+        write_nodes(w, n->data.block.stmts, n->data.block.num_stmts);
+        break;
+    case IR_IF_ELSE:
+        write_node(w, n->data.if_else.cond);
+        write_node(w, n->data.if_else.then_branch);
+        write_node(w, n->data.if_else.else_branch);
+        break;
+    case IR_MATCH:
+        write_node(w, n->data.match.expr);
+        write_varint(w->buf, n->data.match.num_cases);
+        for (size_t i = 0; i < n->data.match.num_cases; i++) {
+            write_str(w->buf, n->data.match.cases[i].case_name);
+            write_str(w->buf, n->data.match.cases[i].bind_name);
+            write_node(w, n->data.match.cases[i].body);
+        }
+        break;
+    case IR_WHILE:
+        write_node(w, n->data.while_.cond);
+        write_node(w, n->data.while_.body);
+        write_str(w->buf, n->data.while_.label);
+        break;
+    case IR_FOR_ARRAY:
+        write_str(w->buf, n->data.for_array.var_name);
+        write_str(w->buf, n->data.for_array.index_name);
+        write_node(w, n->data.for_array.array);
+        write_node(w, n->data.for_array.body);
+        write_str(w->buf, n->data.for_array.label);
+        break;
+    case IR_FOR_SET:
+        write_str(w->buf, n->data.for_set.var_name);
+        write_node(w, n->data.for_set.set);
+        write_node(w, n->data.for_set.body);
+        write_str(w->buf, n->data.for_set.label);
+        break;
+    case IR_FOR_DICT:
+        write_str(w->buf, n->data.for_dict.key_name);
+        write_str(w->buf, n->data.for_dict.val_name);
+        write_node(w, n->data.for_dict.dict);
+        write_node(w, n->data.for_dict.body);
+        write_str(w->buf, n->data.for_dict.label);
+        break;
+    case IR_FUNCTION:
+    case IR_ASYNC_FUNCTION:
+        write_vars(w, n->data.function.captures, n->data.function.num_captures);
+        write_vars(w, n->data.function.params, n->data.function.num_params);
+        write_node(w, n->data.function.body);
+        write_function_source(w, n);
+        break;
+    case IR_CALL:
+    case IR_CALL_ASYNC:
+        write_node(w, n->data.call.func);
+        write_nodes(w, n->data.call.args, n->data.call.num_args);
+        break;
+    case IR_PLATFORM:
+        write_str(w->buf, n->data.platform.name);
+        write_types(w, n->data.platform.type_params, n->data.platform.num_type_params);
+        write_nodes(w, n->data.platform.args, n->data.platform.num_args);
+        byte_buffer_write_u8(w->buf, (uint8_t)((n->data.platform.is_async ? 1 : 0) |
+                                               (n->data.platform.optional ? 2 : 0)));
+        break;
+    case IR_BUILTIN:
+        write_str(w->buf, n->data.builtin.name);
+        write_types(w, n->data.builtin.type_params, n->data.builtin.num_type_params);
+        write_nodes(w, n->data.builtin.args, n->data.builtin.num_args);
+        break;
+    case IR_RETURN:
+        write_node(w, n->data.return_.value);
+        break;
+    case IR_BREAK:
+    case IR_CONTINUE:
+        write_str(w->buf, n->data.loop_ctrl.label);
+        break;
+    case IR_ERROR:
+        write_node(w, n->data.error.message);
+        break;
+    case IR_TRY_CATCH:
+        write_node(w, n->data.try_catch.try_body);
+        write_str(w->buf, n->data.try_catch.message_var);
+        write_str(w->buf, n->data.try_catch.stack_var);
+        write_node(w, n->data.try_catch.catch_body);
+        write_node(w, n->data.try_catch.finally_body);
+        break;
+    case IR_NEW_ARRAY:
+    case IR_NEW_SET:
+        write_nodes(w, n->data.new_collection.items, n->data.new_collection.num_items);
+        break;
+    case IR_NEW_DICT:
+        write_varint(w->buf, n->data.new_dict.num_pairs);
+        for (size_t i = 0; i < n->data.new_dict.num_pairs; i++) {
+            write_node(w, n->data.new_dict.keys[i]);
+            write_node(w, n->data.new_dict.values[i]);
+        }
+        break;
+    case IR_NEW_REF:
+        write_node(w, n->data.new_ref.value);
+        break;
+    case IR_NEW_VECTOR:
+        write_nodes(w, n->data.new_vector.items, n->data.new_vector.num_items);
+        break;
+    case IR_STRUCT:
+        write_varint(w->buf, n->data.struct_.num_fields);
+        for (size_t i = 0; i < n->data.struct_.num_fields; i++) {
+            write_str(w->buf, n->data.struct_.field_names[i]);
+            write_node(w, n->data.struct_.field_values[i]);
+        }
+        break;
+    case IR_GET_FIELD:
+        write_node(w, n->data.get_field.expr);
+        write_str(w->buf, n->data.get_field.field_name);
+        break;
+    case IR_VARIANT:
+        write_str(w->buf, n->data.variant.case_name);
+        write_node(w, n->data.variant.value);
+        break;
+    case IR_WRAP_RECURSIVE:
+    case IR_UNWRAP_RECURSIVE:
+        write_node(w, n->data.recursive.value);
+        break;
+    }
+}
+
+ByteBuffer *east_ir_image_encode(IRNode *ir, uint64_t source_hash)
+{
+    if (!ir) return NULL;
+
+    ImageWriter w = { .buf = byte_buffer_new(4096), .root = ir, .ok = true };
+    if (!w.buf) return NULL;
+
+    byte_buffer_write_bytes(w.buf, IMAGE_MAGIC, sizeof(IMAGE_MAGIC));
+    byte_buffer_write_u8(w.buf, EAST_IR_IMAGE_VERSION);
+    write_u64_le(w.buf, source_hash);
+    write_node(&w, ir);
+
+    ptr_map_free(&w.types);
+    ptr_map_free(&w.nodes);
+    if (!w.ok) {
+        byte_buffer_free(w.buf);
+        return NULL;
+    }
+    return w.buf;
+}
+
+/* ================================================================== */
+/*  Decoder                                                            */
+/* ================================================================== */
+
+typedef struct {
+    const uint8_t *data;
+    size_t len;
+    size_t pos;
+    bool err;
+    EastType **types;   /* borrowed; NULL while a slot is being built */
+    size_t num_types;
+    size_t cap_types;
+    IRNode **nodes;     /* borrowed; NULL while a slot is being built */
+    size_t num_nodes;
+    size_t cap_nodes;
+} ImageReader;
+
+static uint8_t read_u8(ImageReader *r)
+{
+    if (r->pos >= r->len) { r->err = true; return 0; }
+    return r->data[r->pos++];
+}
+
+static uint64_t read_uvarint(ImageReader *r)
+{
+    uint64_t result = 0;
+    int shift = 0;
+    while (r->pos < r->len && shift < 64) {
+        uint8_t byte = r->data[r->pos++];
+        result |= (uint64_t)(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) return result;
+        shift += 7;
+    }
+    r->err = true;
+    return 0;
+}
+
+static int64_t read_szigzag(ImageReader *r)
+{
+    uint64_t v = read_uvarint(r);
+    return (int64_t)((v >> 1) ^ -(v & 1));
+}
+
+static const uint8_t *read_span(ImageReader *r, size_t n)
+{
+    if (n > r->len - r->pos) { r->err = true; return NULL; }
+    const uint8_t *p = r->data + r->pos;
+    r->pos += n;
+    return p;
+}
+
+static uint64_t read_u64_le(ImageReader *r)
+{
+    const uint8_t *p = read_span(r, 8);
+    if (!p) return 0;
+    uint64_t v = 0;
+    for (int i = 0; i < 8; i++) v |= (uint64_t)p[i] << (8 * i);
+    return v;
+}
+
+/* Returns a malloc'd string, or NULL for an encoded NULL (check r->err). */
+static char *read_str(ImageReader *r)
+{
+    uint64_t n = read_uvarint(r);
+    if (r->err || n == 0) return NULL;
+    const uint8_t *p = read_span(r, (size_t)(n - 1));
+    if (!p) return NULL;
+    char *s = malloc((size_t)n);
+    if (!s) { r->err = true; return NULL; }
+    memcpy(s, p, (size_t)(n - 1));
+    s[n - 1] = '\0';
+    return s;
+}
+
+static bool reserve_slot(void ***slots, size_t *num, size_t *cap, size_t *out_idx)
+{
+    if (*num >= *cap) {
+        size_t new_cap = *cap ? *cap * 2 : 64;
+        void **ns = realloc(*slots, new_cap * sizeof(void *));
+        if (!ns) return false;
+        *slots = ns;
+        *cap = new_cap;
+    }
+    (*slots)[*num] = NULL;
+    *out_idx = (*num)++;
+    return true;
+}
+
+static EastType *primitive_type(uint8_t kind)
+{
+    switch (kind) {
+    case EAST_TYPE_NEVER:    return &east_never_type;
+    case EAST_TYPE_NULL:     return &east_null_type;
+    case EAST_TYPE_BOOLEAN:  return &east_boolean_type;
+    case EAST_TYPE_INTEGER:  return &east_integer_type;
+    case EAST_TYPE_FLOAT:    return &east_float_type;
+    case EAST_TYPE_STRING:   return &east_string_type;
+    case EAST_TYPE_DATETIME: return &east_datetime_type;
+    case EAST_TYPE_BLOB:     return &east_blob_type;
+    default:                 return NULL;
+    }
+}
+
+/* Returns a new reference (or NULL for an encoded NULL / on error). */
+static EastType *read_type(ImageReader *r)
+{
+    uint8_t tag = read_u8(r);
+    if (r->err || tag == TAG_NULL) return NULL;
+
+    if (tag == TAG_BACKREF) {
+        uint64_t idx = read_uvarint(r);
+        if (r->err || idx >= r->num_types || !r->types[idx]) {
+            r->err = true;
+            return NULL;
+        }
+        east_type_retain(r->types[idx]);
+        return r->types[idx];
+    }
+    if (tag <= EAST_TYPE_BLOB) return primitive_type(tag);
+
+    size_t idx;
+    if (!reserve_slot((void ***)&r->types, &r->num_types, &r->cap_types, &idx)) {
+        r->err = true;
+        return NULL;
+    }
+
+    EastType *t = NULL;
+    switch (tag) {
+    case EAST_TYPE_ARRAY:
+    case EAST_TYPE_SET:
+    case EAST_TYPE_REF:
+    case EAST_TYPE_VECTOR:
+    case EAST_TYPE_MATRIX: {
+        EastType *elem = read_type(r);
+        if (r->err) break;
+        if (tag == EAST_TYPE_ARRAY) t = east_array_type(elem);
+        else if (tag == EAST_TYPE_SET) t = east_set_type(elem);
+        else if (tag == EAST_TYPE_REF) t = east_ref_type(elem);
+        else if (tag == EAST_TYPE_VECTOR) t = east_vector_type(elem);
+        else t = east_matrix_type(elem);
+        east_type_release(elem);
+        break;
+    }
+    case EAST_TYPE_DICT: {
+        EastType *key = read_type(r);
+        EastType *val = read_type(r);
+        if (!r->err) t = east_dict_type(key, val);
+        east_type_release(key);
+        east_type_release(val);
+        break;
+    }
+    case EAST_TYPE_STRUCT:
+    case EAST_TYPE_VARIANT: {
+        uint64_t n = read_uvarint(r);
+        if (r->err || n > r->len) { r->err = true; break; }
+        char **names = calloc(n ? n : 1, sizeof(char *));
+        EastType **types = calloc(n ? n : 1, sizeof(EastType *));
+        if (!names || !types) {
+            free(names);
+            free(types);
+            r->err = true;
+            break;
+        }
+        for (uint64_t i = 0; i < n && !r->err; i++) {
+            names[i] = read_str(r);
+            types[i] = read_type(r);
+            if (!names[i]) r->err = true;
+        }
+        if (!r->err) {
+            t = tag == EAST_TYPE_STRUCT
+                ? east_struct_type((const char **)names, types, (size_t)n)
+                : east_variant_type((const char **)names, types, (size_t)n);
+        }
+        for (uint64_t i = 0; i < n; i++) {
+            free(names[i]);
+            east_type_release(types[i]);
+        }
+        free(names);
+        free(types);
+        break;
+    }
+    case EAST_TYPE_FUNCTION:
+    case EAST_TYPE_ASYNC_FUNCTION: {
+        uint64_t n = read_uvarint(r);
+        if (r->err || n > r->len) { r->err = true; break; }
+        EastType **inputs = calloc(n ? n : 1, sizeof(EastType *));
+        if (!inputs) { r->err = true; break; }
+        for (uint64_t i = 0; i < n && !r->err; i++) inputs[i] = read_type(r);
+        EastType *output = read_type(r);
+        if (!r->err) {
+            t = tag == EAST_TYPE_FUNCTION
+                ? east_function_type(inputs, (size_t)n, output)
+                : east_async_function_type(inputs, (size_t)n, output);
+        }
+        for (uint64_t i = 0; i < n; i++) east_type_release(inputs[i]);
+        free(inputs);
+        east_type_release(output);
+        break;
+    }
+    case EAST_TYPE_RECURSIVE: {
+        /* Publish the wrapper before reading its node so self-references
+         * resolve to it, then close the cycle as type_of_type does. */
+        EastType *rec = east_recursive_type_new();
+        if (!rec) { r->err = true; break; }
+        r->types[idx] = rec;
+        EastType *node = read_type(r);
+        if (r->err || !node) {
+            /* The partial node's self-references go with it; then drop
+             * the wrapper, and the break below clears its slot. */
+            r->err = true;
+            east_type_release(node);
+            east_type_release(rec);
+            break;
+        }
+        east_recursive_type_set(rec, node);
+        east_recursive_type_finalize(rec);
+        return rec;
+    }
+    default:
+        r->err = true;
+        break;
+    }
+
+    if (!t) r->err = true;
+    r->types[idx] = t;
+    return t;
+}
+
+static EastValue *read_literal(ImageReader *r)
+{
+    uint8_t tag = read_u8(r);
+    if (r->err || tag == TAG_NULL) return NULL;
+    switch (tag) {
+    case EAST_VAL_NULL:
+        return east_null();
+    case EAST_VAL_BOOLEAN:
+        return east_boolean(read_u8(r) != 0);
+    case EAST_VAL_INTEGER:
+        return east_integer(read_szigzag(r));
+    case EAST_VAL_FLOAT: {
+        uint64_t bits = read_u64_le(r);
+        double d;
+        memcpy(&d, &bits, 8);
+        return east_float(d);
+    }
+    case EAST_VAL_STRING: {
+        uint64_t n = read_uvarint(r);
+        const uint8_t *p = r->err ? NULL : read_span(r, (size_t)n);
+        if (!p) return NULL;
+        return east_string_len((const char *)p, (size_t)n);
+    }
+    case EAST_VAL_DATETIME:
+        return east_datetime(read_szigzag(r));
+    case EAST_VAL_BLOB: {
+        uint64_t n = read_uvarint(r);
+        const uint8_t *p = r->err ? NULL : read_span(r, (size_t)n);
+        if (!p) return NULL;
+        return east_blob(p, (size_t)n);
+    }
+    default:
+        r->err = true;
+        return NULL;
+    }
+}
+
+static IRVariable *read_vars(ImageReader *r, size_t *out_n)
+{
+    uint64_t n = read_uvarint(r);
+    *out_n = 0;
+    if (r->err || n == 0) return NULL;
+    if (n > r->len) { r->err = true; return NULL; }
+    IRVariable *vars = calloc((size_t)n, sizeof(IRVariable));
+    if (!vars) { r->err = true; return NULL; }
+    for (uint64_t i = 0; i < n && !r->err; i++) {
+        vars[i].name = read_str(r);
+        uint8_t flags = read_u8(r);
+        vars[i].mutable = (flags & 1) != 0;
+        vars[i].captured = (flags & 2) != 0;
+    }
+    *out_n = (size_t)n;
+    return vars;
+}
+
+static void free_vars(IRVariable *vars, size_t n)
+{
+    for (size_t i = 0; i < n; i++) free(vars[i].name);
+    free(vars);
+}
+
+static IRNode *read_node(ImageReader *r);
+
+static IRNode **read_nodes(ImageReader *r, size_t *out_n)
+{
+    uint64_t n = read_uvarint(r);
+    *out_n = 0;
+    if (r->err || n == 0) return NULL;
+    if (n > r->len) { r->err = true; return NULL; }
+    IRNode **nodes = calloc((size_t)n, sizeof(IRNode *));
+    if (!nodes) { r->err = true; return NULL; }
+    for (uint64_t i = 0; i < n && !r->err; i++) nodes[i] = read_node(r);
+    *out_n = (size_t)n;
+    return nodes;
+}
+
+static void free_nodes(IRNode **nodes, size_t n)
+{
+    for (size_t i = 0; i < n; i++) ir_node_release(nodes[i]);
+    free(nodes);
+}
+
+static EastType **read_types(ImageReader *r, size_t *out_n)
+{
+    uint64_t n = read_uvarint(r);
+    *out_n = 0;
+    if (r->err || n == 0) return NULL;
+    if (n > r->len) { r->err = true; return NULL; }
+    EastType **types = calloc((size_t)n, sizeof(EastType *));
+    if (!types) { r->err = true; return NULL; }
+    for (uint64_t i = 0; i < n && !r->err; i++) types[i] = read_type(r);
+    *out_n = (size_t)n;
+    return types;
+}
+
+static void free_types(EastType **types, size_t n)
+{
+    for (size_t i = 0; i < n; i++) east_type_release(types[i]);
+    free(types);
+}
+
+static IRNode *read_node_body(ImageReader *r, uint8_t kind, EastType *type)
+{
+    IRNode *result = NULL;
+
+    switch ((IRNodeKind)kind) {
+    case IR_VALUE: {
+        EastValue *v = read_literal(r);
+        if (!r->err) result = ir_value(type, v);
+        east_value_release(v);
+        break;
+    }
+    case IR_VARIABLE: {
+        char *name = read_str(r);
+        uint8_t flags = read_u8(r);
+        if (!r->err) result = ir_variable(type, name, flags & 1, (flags & 2) != 0);
+        free(name);
+        break;
+    }
+    case IR_LET: {
+        size_t nv;
+        IRVariable *var = read_vars(r, &nv);
+        IRNode *value = read_node(r);
+        if (!r->err && nv == 1) {
+            result = ir_let(type, var[0].name, var[0].mutable, var[0].captured, value);
+        }
+        free_vars(var, nv);
+        ir_node_release(value);
+        break;
+    }
+    case IR_ASSIGN: {
+        char *name = read_str(r);
+        IRNode *value = read_node(r);
+        if (!r->err) result = ir_assign(type, name, value);
+        free(name);
+        ir_node_release(value);
+        break;
+    }
+    case IR_BLOCK: {
+        size_t n;
+        IRNode **stmts = read_nodes(r, &n);
+        if (!r->err) result = ir_block(type, stmts, n);
+        free_nodes(stmts, n);
+        break;
+    }
+    case IR_IF_ELSE: {
+        IRNode *cond = read_node(r);
+        IRNode *then_b = read_node(r);
+        IRNode *else_b = read_node(r);
+        if (!r->err) result = ir_if_else(type, cond, then_b, else_b);
+        ir_node_release(cond);
+        ir_node_release(then_b);
+        ir_node_release(else_b);
+        break;
+    }
+    case IR_MATCH: {
+        IRNode *expr = read_node(r);
+        uint64_t n = read_uvarint(r);
+        if (r->err || n > r->len) { r->err = true; ir_node_release(expr); break; }
+        IRMatchCase *cases = calloc(n ? (size_t)n : 1, sizeof(IRMatchCase));
+        if (!cases) { r->err = true; ir_node_release(expr); break; }
+        for (uint64_t i = 0; i < n && !r->err; i++) {
+            cases[i].case_name = read_str(r);
+            cases[i].bind_name = read_str(r);
+            cases[i].body = read_node(r);
+        }
+        if (!r->err) result = ir_match(type, expr, cases, (size_t)n);
+        ir_node_release(expr);
+        for (uint64_t i = 0; i < n; i++) {
+            free(cases[i].case_name);
+            free(cases[i].bind_name);
+            ir_node_release(cases[i].body);
+        }
+        free(cases);
+        break;
+    }
+    case IR_WHILE: {
+        IRNode *cond = read_node(r);
+        IRNode *body = read_node(r);
+        char *label = read_str(r);
+        if (!r->err) result = ir_while(type, cond, body, label);
+        ir_node_release(cond);
+        ir_node_release(body);
+        free(label);
+        break;
+    }
+    case IR_FOR_ARRAY: {
+        char *var = read_str(r);
+        char *idx = read_str(r);
+        IRNode *array = read_node(r);
+        IRNode *body = read_node(r);
+        char *label = read_str(r);
+        if (!r->err) result = ir_for_array(type, var, idx, array, body, label);
+        free(var);
+        free(idx);
+        ir_node_release(array);
+        ir_node_release(body);
+        free(label);
+        break;
+    }
+    case IR_FOR_SET: {
+        char *var = read_str(r);
+        IRNode *set = read_node(r);
+        IRNode *body = read_node(r);
+        char *label = read_str(r);
+        if (!r->err) result = ir_for_set(type, var, set, body, label);
+        free(var);
+        ir_node_release(set);
+        ir_node_release(body);
+        free(label);
+        break;
+    }
+    case IR_FOR_DICT: {
+        char *key = read_str(r);
+        char *val = read_str(r);
+        IRNode *dict = read_node(r);
+        IRNode *body = read_node(r);
+        char *label = read_str(r);
+        if (!r->err) result = ir_for_dict(type, key, val, dict, body, label);
+        free(key);
+        free(val);
+        ir_node_release(dict);
+        ir_node_release(body);
+        free(label);
+        break;
+    }
+    case IR_FUNCTION:
+    case IR_ASYNC_FUNCTION: {
+        size_t nc, np;
+        IRVariable *caps = read_vars(r, &nc);
+        IRVariable *params = read_vars(r, &np);
+        IRNode *body = read_node(r);
+        uint64_t src_len = read_uvarint(r);
+        const uint8_t *src = (r->err || src_len == 0) ? NULL : read_span(r, (size_t)src_len);
+        if (!r->err) {
+            result = kind == IR_FUNCTION
+                ? ir_function(type, caps, nc, params, np, body)
+                : ir_async_function(type, caps, nc, params, np, body);
+            if (result && src) {
+                /* Decoded here, on the loading thread, rather than when a
+                 * closure is first serialized: the node is shared by every
+                 * run of a cached program, and a value is tracked by the
+                 * cycle collector of the thread that created it. */
+                if (!east_ir_type) east_type_of_type_init();
+                result->data.function.source_ir =
+                    east_beast2_decode(src, (size_t)src_len, east_ir_type);
+                if (!result->data.function.source_ir) {
+                    r->err = true;
+                    ir_node_release(result);
+                    result = NULL;
+                }
+            }
+        }
+        free_vars(caps, nc);
+        free_vars(params, np);
+        ir_node_release(body);
+        break;
+    }
+    case IR_CALL:
+    case IR_CALL_ASYNC: {
+        IRNode *func = read_node(r);
+        size_t n;
+        IRNode **args = read_nodes(r, &n);
+        if (!r->err) {
+            result = kind == IR_CALL ? ir_call(type, func, args, n)
+                                     : ir_call_async(type, func, args, n);
+        }
+        ir_node_release(func);
+        free_nodes(args, n);
+        break;
+    }
+    case IR_PLATFORM: {
+        char *name = read_str(r);
+        size_t ntp, nargs;
+        EastType **tp = read_types(r, &ntp);
+        IRNode **args = read_nodes(r, &nargs);
+        uint8_t flags = read_u8(r);
+        if (!r->err) {
+            result = ir_platform(type, name, tp, ntp, args, nargs,
+                                 (flags & 1) != 0, (flags & 2) != 0);
+        }
+        free(name);
+        free_types(tp, ntp);
+        free_nodes(args, nargs);
+        break;
+    }
+    case IR_BUILTIN: {
+        char *name = read_str(r);
+        size_t ntp, nargs;
+        EastType **tp = read_types(r, &ntp);
+        IRNode **args = read_nodes(r, &nargs);
+        if (!r->err) result = ir_builtin(type, name, tp, ntp, args, nargs);
+        free(name);
+        free_types(tp, ntp);
+        free_nodes(args, nargs);
+        break;
+    }
+    case IR_RETURN: {
+        IRNode *value = read_node(r);
+        if (!r->err) result = ir_return(type, value);
+        ir_node_release(value);
+        break;
+    }
+    case IR_BREAK:
+    case IR_CONTINUE: {
+        char *label = read_str(r);
+        if (!r->err) result = kind == IR_BREAK ? ir_break(label) : ir_continue(label);
+        if (result && type && !result->type) {
+            east_type_retain(type);
+            result->type = type;
+        }
+        free(label);
+        break;
+    }
+    case IR_ERROR: {
+        IRNode *msg = read_node(r);
+        if (!r->err) result = ir_error(type, msg);
+        ir_node_release(msg);
+        break;
+    }
+    case IR_TRY_CATCH: {
+        IRNode *try_body = read_node(r);
+        char *message_var = read_str(r);
+        char *stack_var = read_str(r);
+        IRNode *catch_body = read_node(r);
+        IRNode *finally_body = read_node(r);
+        if (!r->err) {
+            result = ir_try_catch(type, try_body, message_var, stack_var,
+                                  catch_body, finally_body);
+        }
+        ir_node_release(try_body);
+        free(message_var);
+        free(stack_var);
+        ir_node_release(catch_body);
+        ir_node_release(finally_body);
+        break;
+    }
+    case IR_NEW_ARRAY:
+    case IR_NEW_SET:
+    case IR_NEW_VECTOR: {
+        size_t n;
+        IRNode **items = read_nodes(r, &n);
+        if (!r->err) {
+            if (kind == IR_NEW_ARRAY) result = ir_new_array(type, items, n);
+            else if (kind == IR_NEW_SET) result = ir_new_set(type, items, n);
+            else result = ir_new_vector(type, items, n);
+        }
+        free_nodes(items, n);
+        break;
+    }
+    case IR_NEW_DICT: {
+        uint64_t n = read_uvarint(r);
+        if (r->err || n > r->len) { r->err = true; break; }
+        IRNode **keys = calloc(n ? (size_t)n : 1, sizeof(IRNode *));
+        IRNode **values = calloc(n ? (size_t)n : 1, sizeof(IRNode *));
+        if (!keys || !values) {
+            free(keys);
+            free(values);
+            r->err = true;
+            break;
+        }
+        for (uint64_t i = 0; i < n && !r->err; i++) {
+            keys[i] = read_node(r);
+            values[i] = read_node(r);
+        }
+        if (!r->err) result = ir_new_dict(type, keys, values, (size_t)n);
+        free_nodes(keys, (size_t)n);
+        free_nodes(values, (size_t)n);
+        break;
+    }
+    case IR_NEW_REF: {
+        IRNode *value = read_node(r);
+        if (!r->err) result = ir_new_ref(type, value);
+        ir_node_release(value);
+        break;
+    }
+    case IR_STRUCT: {
+        uint64_t n = read_uvarint(r);
+        if (r->err || n > r->len) { r->err = true; break; }
+        char **names = calloc(n ? (size_t)n : 1, sizeof(char *));
+        IRNode **values = calloc(n ? (size_t)n : 1, sizeof(IRNode *));
+        if (!names || !values) {
+            free(names);
+            free(values);
+            r->err = true;
+            break;
+        }
+        for (uint64_t i = 0; i < n && !r->err; i++) {
+            names[i] = read_str(r);
+            values[i] = read_node(r);
+        }
+        if (!r->err) result = ir_struct(type, names, values, (size_t)n);
+        for (uint64_t i = 0; i < n; i++) free(names[i]);
+        free(names);
+        free_nodes(values, (size_t)n);
+        break;
+    }
+    case IR_GET_FIELD: {
+        IRNode *expr = read_node(r);
+        char *field = read_str(r);
+        if (!r->err) result = ir_get_field(type, expr, field);
+        ir_node_release(expr);
+        free(field);
+        break;
+    }
+    case IR_VARIANT: {
+        char *case_name = read_str(r);
+        IRNode *value = read_node(r);
+        if (!r->err) result = ir_variant(type, case_name, value);
+        free(case_name);
+        ir_node_release(value);
+        break;
+    }
+    case IR_WRAP_RECURSIVE:
+    case IR_UNWRAP_RECURSIVE: {
+        IRNode *value = read_node(r);
+        if (!r->err) {
+            result = kind == IR_WRAP_RECURSIVE ? ir_wrap_recursive(type, value)
+                                               : ir_unwrap_recursive(type, value);
+        }
+        ir_node_release(value);
+        break;
+    }
+    default:
+        r->err = true;
+        break;
+    }
+
+    if (!result) r->err = true;
+    return result;
+}
+
+/* Returns a new reference (or NULL for an encoded NULL / on error). */
+static IRNode *read_node(ImageReader *r)
+{
+    uint8_t tag = read_u8(r);
+    if (r->err || tag == TAG_NULL) return NULL;
+
+    if (tag == TAG_BACKREF) {
+        uint64_t idx = read_uvarint(r);
+        if (r->err || idx >= r->num_nodes || !r->nodes[idx]) {
+            r->err = true;
+            return NULL;
+        }
+        ir_node_retain(r->nodes[idx]);
+        return r->nodes[idx];
+    }
+    if (tag > IR_UNWRAP_RECURSIVE) { r->err = true; return NULL; }
+
+    size_t idx;
+    if (!reserve_slot((void ***)&r->nodes, &r->num_nodes, &r->cap_nodes, &idx)) {
+        r->err = true;
+        return NULL;
+    }
+
+    EastType *type = read_type(r);
+    uint64_t nloc = read_uvarint(r);
+    if (r->err || nloc > r->len) {
+        r->err = true;
+        east_type_release(type);
+        return NULL;
+    }
+    EastLocation *locs = nloc ? calloc((size_t)nloc, sizeof(EastLocation)) : NULL;
+    if (nloc && !locs) {
+        r->err = true;
+        east_type_release(type);
+        return NULL;
+    }
+    for (uint64_t i = 0; i < nloc && !r->err; i++) {
+        locs[i].filename = read_str(r);
+        locs[i].line = read_szigzag(r);
+        locs[i].column = read_szigzag(r);
+    }
+
+    IRNode *node = r->err ? NULL : read_node_body(r, tag, type);
+    east_type_release(type);
+    if (!node) {
+        east_locations_free(locs, (size_t)nloc);
+        return NULL;
+    }
+    node->locations = locs;
+    node->num_locations = (size_t)nloc;
+    r->nodes[idx] = node;
+    return node;
+}
+
+IRNode *east_ir_image_decode(const uint8_t *data, size_t len, uint64_t source_hash)
+{
+    if (!data || len < sizeof(IMAGE_MAGIC) + 1 + 8) return NULL;
+    if (memcmp(data, IMAGE_MAGIC, sizeof(IMAGE_MAGIC)) != 0) return NULL;
+    if (data[sizeof(IMAGE_MAGIC)] != EAST_IR_IMAGE_VERSION) return NULL;
+
+    ImageReader r = { .data = data, .len = len, .pos = sizeof(IMAGE_MAGIC) + 1 };
+    if (read_u64_le(&r) != source_hash) return NULL;
+
+    IRNode *root = read_node(&r);
+    free(r.types);
+    free(r.nodes);
+
+    if (r.err || !root || r.pos != len) {
+        ir_node_release(root);
+        return NULL;
+    }
+    return root;
+}
@@ -25,6 +25,8 @@
 #include "east/serialization.h"
 #include "east/types.h"
 #include "east/values.h"
+#include "east/search.h"
+#include "east/numparse.h"
 
 #include <ctype.h>
 #include <math.h>
@@ -337,7 +339,7 @@ static void json_encode_value(StrBuf *sb, EastValue *value, EastType *type)
         strbuf_append_char(sb, '[');
         for (size_t i = 0; i < value->data.array.len; i++) {
             if (i > 0) strbuf_append_char(sb, ',');
-            json_encode_value(sb, value->data.array.items[i], elem_type);
+            json_encode_value(sb, east_array_get(value, i), elem_type);
         }
         strbuf_append_char(sb, ']');
         break;
@@ -567,6 +569,8 @@ static void jp_skip_json_value(JsonParser *p)
         /* Skip string */
         p->pos++; /* skip opening quote */
         while (p->pos < p->len) {
+            p->pos += east_find_any(p->input + p->pos, p->len - p->pos, "\"\\", 2);
+            if (p->pos >= p->len) break;
             char sc = p->input[p->pos++];
             if (sc == '\\' && p->pos < p->len) p->pos++; /* skip escaped char */
             else if (sc == '"') break;
@@ -631,6 +635,11 @@ static char *jp_parse_string(JsonParser *p, size_t *out_len)
 
     StrBuf sb = strbuf_new(64);
     while (p->pos < p->len) {
+        /* Copy up to the next quote or escape in one go */
+        size_t run = east_find_any(p->input + p->pos, p->len - p->pos, "\"\\", 2);
+        strbuf_append(&sb, p->input + p->pos, run);
+        p->pos += run;
+        if (p->pos >= p->len) break;
         char c = p->input[p->pos];
         if (c == '"') {
             p->pos++;
@@ -685,12 +694,9 @@ static char *jp_parse_string(JsonParser *p, size_t *out_len)
     return NULL;
 }
 
-/* Parse a JSON number, returning it as a double.
- * Also stores the raw string in raw_buf if non-NULL. */
-static double jp_parse_number(JsonParser *p, char *raw_buf, size_t raw_cap)
+/* Skips the longest prefix that looks like a JSON number */
+static void jp_skip_number(JsonParser *p)
 {
-    jp_skip_ws(p);
-    size_t start = p->pos;
     if (p->pos < p->len && p->input[p->pos] == '-') p->pos++;
     while (p->pos < p->len && isdigit((unsigned char)p->input[p->pos])) p->pos++;
     if (p->pos < p->len && p->input[p->pos] == '.') {
@@ -703,16 +709,36 @@ static double jp_parse_number(JsonParser *p, char *raw_buf, size_t raw_cap)
             p->pos++;
         while (p->pos < p->len && isdigit((unsigned char)p->input[p->pos])) p->pos++;
     }
+}
+
+/* Parse a JSON number, returning it as a double.
+ * Also stores the raw string in raw_buf if non-NULL. */
+static double jp_parse_number(JsonParser *p, char *raw_buf, size_t raw_cap)
+{
+    jp_skip_ws(p);
+    size_t start = p->pos;
+    double v = 0.0;
+    size_t n = 0;
+    if (p->pos < p->len && p->input[p->pos] != '+')
+        n = east_parse_double(p->input + p->pos, p->len - p->pos, &v);
+    if (n > 0) {
+        p->pos += n;
+        /* An exponent marker without digits ("1e") reads as its prefix */
+        if (p->pos < p->len && (p->input[p->pos] == 'e' || p->input[p->pos] == 'E')) {
+            p->pos++;
+            if (p->pos < p->len && (p->input[p->pos] == '+' || p->input[p->pos] == '-'))
+                p->pos++;
+        }
+    } else {
+        /* No digits ("-", "-.e"): skipped over and read as 0 */
+        jp_skip_number(p);
+    }
     size_t numlen = p->pos - start;
     if (raw_buf && numlen < raw_cap) {
         memcpy(raw_buf, p->input + start, numlen);
         raw_buf[numlen] = '\0';
     }
-    char tmp[128];
-    if (numlen >= sizeof(tmp)) numlen = sizeof(tmp) - 1;
-    memcpy(tmp, p->input + start, numlen);
-    tmp[numlen] = '\0';
-    return strtod(tmp, NULL);
+    return v;
 }
 
 /* ================================================================== */
@@ -1039,10 +1065,10 @@ static EastValue *jp_decode(JsonParser *p, EastType *type, JRefCtx *ctx)
         size_t slen;
         char *s = jp_parse_string(p, &slen);
         if (!s) return NULL;
-        char *end;
-        long long val = strtoll(s, &end, 10);
+        int64_t val = 0;
+        east_parse_int64(s, slen, &val, NULL);
         free(s);
-        return east_integer((int64_t)val);
+        return east_integer(val);
     }
 
     case EAST_TYPE_FLOAT: {
@@ -1057,7 +1083,7 @@ static EastValue *jp_decode(JsonParser *p, EastType *type, JRefCtx *ctx)
             else if (strcmp(s, "Infinity") == 0) v = INFINITY;
             else if (strcmp(s, "-Infinity") == 0) v = -INFINITY;
             else if (strcmp(s, "-0.0") == 0) v = -0.0;
-            else v = strtod(s, NULL);
+            else east_parse_double(s, slen, &v);
             free(s);
             return east_float(v);
         }
@@ -1556,27 +1582,26 @@ static EastValue *jp_decode_err(JsonParser *p, EastType *type, JRefCtx *ctx, JDe
                 return NULL;
             }
             /* Try to parse as integer */
-            char *end;
-            long long val = strtoll(s, &end, 10);
-            if (*end != '\0') {
+            int64_t val;
+            bool overflow;
+            if (east_parse_int64(s, slen, &val, &overflow) != slen) {
                 /* Non-numeric string */
                 free(s);
                 if (err) { p->pos = save; jde_set_msg(err, jp_fmt_error(p, "expected string representing integer")); }
                 return NULL;
             }
-            /* Check for overflow: strtoll saturates at LLONG_MAX/LLONG_MIN
-             * but we can also check the string representation */
-            /* Simple overflow check: if the string doesn't round-trip */
-            char check[32];
-            snprintf(check, sizeof(check), "%lld", val);
-            if (strcmp(check, s) != 0) {
-                /* Overflow */
+            /* Only the canonical spelling is accepted: "+1", "01" and
+             * "-0" are rejected along with values outside 64 bits */
+            bool canonical = s[0] != '+' &&
+                             !(s[0] == '0' && slen > 1) &&
+                             !(s[0] == '-' && s[1] == '0');
+            if (overflow || !canonical) {
                 free(s);
                 if (err) { p->pos = save; jde_set_msg(err, jp_fmt_error(p, "integer out of range (must be 64-bit signed)")); }
                 return NULL;
             }
             free(s);
-            return east_integer((int64_t)val);
+            return east_integer(val);
         }
         /* Not a string at all */
         if (err) jde_set_msg(err, jp_fmt_error(p, "expected string representing integer"));
@@ -456,7 +456,7 @@ static EastType *east_type_from_value_ctx(EastValue *v, RecCtx *ctx)
         const char **names = malloc(n * sizeof(char *));
         EastType **types = malloc(n * sizeof(EastType *));
         for (size_t i = 0; i < n; i++) {
-            EastValue *field = payload->data.array.items[i];
+            EastValue *field = east_array_get(payload, i);
             EastValue *name_v = east_struct_get_field(field, "name");
             EastValue *type_v = east_struct_get_field(field, "type");
             names[i] = name_v->data.string.data;
@@ -479,7 +479,7 @@ static EastType *east_type_from_value_ctx(EastValue *v, RecCtx *ctx)
         const char **names = malloc(n * sizeof(char *));
         EastType **types = malloc(n * sizeof(EastType *));
         for (size_t i = 0; i < n; i++) {
-            EastValue *cas = payload->data.array.items[i];
+            EastValue *cas = east_array_get(payload, i);
             EastValue *name_v = east_struct_get_field(cas, "name");
             EastValue *type_v = east_struct_get_field(cas, "type");
             names[i] = name_v->data.string.data;
@@ -502,7 +502,7 @@ static EastType *east_type_from_value_ctx(EastValue *v, RecCtx *ctx)
         size_t ni = inputs_v->data.array.len;
         EastType **inputs = malloc(ni * sizeof(EastType *));
         for (size_t i = 0; i < ni; i++) {
-            inputs[i] = east_type_from_value_ctx(inputs_v->data.array.items[i], ctx);
+            inputs[i] = east_type_from_value_ctx(east_array_get(inputs_v, i), ctx);
         }
         EastType *output = east_type_from_value_ctx(output_v, ctx);
         EastType *t;
@@ -854,6 +854,9 @@ static const char *label_from_value(EastValue *label_v)
  * Works because the beast2 decoder deduplicates Struct/Variant values
  * by byte range — identical bytes produce the same EastValue pointer.
  * So pointer equality is sufficient for cache lookup: O(1).
+ *
+ * Thread-local: parallel workers decode their function's IR at the same
+ * time, each with its own cache.
  */
 typedef struct {
     EastValue **values;  /* type descriptor values (NOT retained — just pointers for comparison) */
@@ -862,7 +865,7 @@ typedef struct {
     size_t cap;
 } TypeCache;
 
-static TypeCache ir_type_cache = { NULL, NULL, 0, 0 };
+static _Thread_local TypeCache ir_type_cache = { NULL, NULL, 0, 0 };
 
 static void type_cache_init(void)
 {
@@ -988,7 +991,7 @@ static IRNode **convert_ir_array(EastValue *arr, size_t *out_count)
     if (n == 0) return NULL;
     IRNode **nodes = calloc(n, sizeof(IRNode *));
     for (size_t i = 0; i < n; i++) {
-        nodes[i] = convert_ir(arr->data.array.items[i]);
+        nodes[i] = convert_ir(east_array_get(arr, i));
     }
     return nodes;
 }
@@ -1005,7 +1008,7 @@ static EastType **convert_type_array(EastValue *arr, size_t *out_count)
     if (n == 0) return NULL;
     EastType **types = calloc(n, sizeof(EastType *));
     for (size_t i = 0; i < n; i++) {
-        types[i] = type_cache_get(arr->data.array.items[i]);
+        types[i] = type_cache_get(east_array_get(arr, i));
     }
     return types;
 }
@@ -1039,7 +1042,7 @@ static void apply_location(IRNode *node, EastValue *s)
     if (!locs) return;
 
     for (size_t i = 0; i < n; i++) {
-        EastValue *loc = loc_arr->data.array.items[i];
+        EastValue *loc = east_array_get(loc_arr, i);
         if (loc && loc->kind == EAST_VAL_STRUCT) {
             EastValue *fn = east_struct_get_field(loc, "filename");
             EastValue *ln = east_struct_get_field(loc, "line");
@@ -1144,7 +1147,7 @@ static IRNode *convert_ir(EastValue *v)
 
         result = else_body;
         for (size_t i = ifs->data.array.len; i > 0; i--) {
-            EastValue *branch = ifs->data.array.items[i - 1];
+            EastValue *branch = east_array_get(ifs, i - 1);
             IRNode *pred = convert_ir(get_field(branch, "predicate"));
             IRNode *body = convert_ir(get_field(branch, "body"));
             IRNode *next = ir_if_else(type, pred, body, result);
@@ -1164,7 +1167,7 @@ static IRNode *convert_ir(EastValue *v)
         size_t nc = cases_v ? cases_v->data.array.len : 0;
         IRMatchCase *cases = calloc(nc > 0 ? nc : 1, sizeof(IRMatchCase));
         for (size_t i = 0; i < nc; i++) {
-            EastValue *c = cases_v->data.array.items[i];
+            EastValue *c = east_array_get(cases_v, i);
             cases[i].case_name = strdup(get_str(c, "case"));
             EastValue *var_v = get_field(c, "variable");
             if (var_v && var_v->kind == EAST_VAL_VARIANT) {
@@ -1266,10 +1269,10 @@ static IRNode *convert_ir(EastValue *v)
         IRVariable *params = np > 0 ? calloc(np, sizeof(IRVariable)) : NULL;
 
         for (size_t i = 0; i < nc; i++) {
-            captures[i] = var_from_ir_value(caps_v->data.array.items[i]);
+            captures[i] = var_from_ir_value(east_array_get(caps_v, i));
         }
         for (size_t i = 0; i < np; i++) {
-            params[i] = var_from_ir_value(params_v->data.array.items[i]);
+            params[i] = var_from_ir_value(east_array_get(params_v, i));
         }
 
         if (strcmp(tag, "AsyncFunction") == 0) {
@@ -1407,7 +1410,7 @@ static IRNode *convert_ir(EastValue *v)
         IRNode **keys = calloc(n > 0 ? n : 1, sizeof(IRNode *));
         IRNode **values = calloc(n > 0 ? n : 1, sizeof(IRNode *));
         for (size_t i = 0; i < n; i++) {
-            EastValue *entry = vals->data.array.items[i];
+            EastValue *entry = east_array_get(vals, i);
             keys[i] = convert_ir(get_field(entry, "key"));
             values[i] = convert_ir(get_field(entry, "value"));
         }
@@ -1441,7 +1444,7 @@ static IRNode *convert_ir(EastValue *v)
         char **names = calloc(n > 0 ? n : 1, sizeof(char *));
         IRNode **values = calloc(n > 0 ? n : 1, sizeof(IRNode *));
         for (size_t i = 0; i < n; i++) {
-            EastValue *f = fields->data.array.items[i];
+            EastValue *f = east_array_get(fields, i);
             names[i] = strdup(get_str(f, "name"));
             values[i] = convert_ir(get_field(f, "value"));
         }
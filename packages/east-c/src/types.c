@@ -1,4 +1,5 @@
 #include "east/types.h"
+#include "east/memory.h"
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -27,9 +28,18 @@ static EastType *alloc_type(EastTypeKind kind)
     if (!t) return NULL;
     t->kind = kind;
     t->ref_count = 1;
+    if (east_mem_accounting)
+        east_mem_account(EAST_MEM_TYPES, -1, (int64_t)sizeof(EastType), 1);
     return t;
 }
 
+static void free_type(EastType *t)
+{
+    if (east_mem_accounting)
+        east_mem_account(EAST_MEM_TYPES, -1, -(int64_t)sizeof(EastType), -1);
+    free(t);
+}
+
 static int field_cmp(const void *a, const void *b)
 {
     const EastTypeField *fa = a;
@@ -78,7 +88,7 @@ EastType *east_struct_type(const char **names, EastType **types, size_t count)
     EastTypeField *fields = NULL;
     if (count > 0) {
         fields = calloc(count, sizeof(EastTypeField));
-        if (!fields) { free(t); return NULL; }
+        if (!fields) { free_type(t); return NULL; }
         for (size_t i = 0; i < count; i++) {
             fields[i].name = strdup(names[i]);
             if (!fields[i].name) {
@@ -87,7 +97,7 @@ EastType *east_struct_type(const char **names, EastType **types, size_t count)
                     east_type_release(fields[j].type);
                 }
                 free(fields);
-                free(t);
+                free_type(t);
                 return NULL;
             }
             east_type_retain(types[i]);
@@ -108,7 +118,7 @@ EastType *east_variant_type(const char **names, EastType **types, size_t count)
     EastTypeField *cases = NULL;
     if (count > 0) {
         cases = calloc(count, sizeof(EastTypeField));
-        if (!cases) { free(t); return NULL; }
+        if (!cases) { free_type(t); return NULL; }
         for (size_t i = 0; i < count; i++) {
             cases[i].name = strdup(names[i]);
             if (!cases[i].name) {
@@ -117,7 +127,7 @@ EastType *east_variant_type(const char **names, EastType **types, size_t count)
                     east_type_release(cases[j].type);
                 }
                 free(cases);
-                free(t);
+                free_type(t);
                 return NULL;
             }
             east_type_retain(types[i]);
@@ -166,7 +176,7 @@ EastType *east_function_type(EastType **inputs, size_t num_inputs, EastType *out
     EastType **inp = NULL;
     if (num_inputs > 0) {
         inp = calloc(num_inputs, sizeof(EastType *));
-        if (!inp) { free(t); return NULL; }
+        if (!inp) { free_type(t); return NULL; }
         for (size_t i = 0; i < num_inputs; i++) {
             east_type_retain(inputs[i]);
             inp[i] = inputs[i];
@@ -188,7 +198,7 @@ EastType *east_async_function_type(EastType **inputs, size_t num_inputs, EastTyp
     EastType **inp = NULL;
     if (num_inputs > 0) {
         inp = calloc(num_inputs, sizeof(EastType *));
-        if (!inp) { free(t); return NULL; }
+        if (!inp) { free_type(t); return NULL; }
         for (size_t i = 0; i < num_inputs; i++) {
             east_type_retain(inputs[i]);
             inp[i] = inputs[i];
@@ -431,7 +441,7 @@ void east_type_release(EastType *t)
             nullify_back_refs(inner, t);
             east_type_release(inner);
         }
-        free(t);
+        free_type(t);
         return;  /* skip the free(t) below */
     }
 
@@ -440,7 +450,7 @@ void east_type_release(EastType *t)
         break;
     }
 
-    free(t);
+    free_type(t);
 }
 
 /* ------------------------------------------------------------------ */
@@ -1,6 +1,8 @@
 #include "east/values.h"
 #include "east/arena.h"
+#include "east/columnar.h"
 #include "east/gc.h"
+#include "east/memory.h"
 #include "east/types.h"
 
 #include <inttypes.h>
@@ -9,6 +11,9 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 /* ------------------------------------------------------------------ */
 /*  Global null singleton                                              */
@@ -35,6 +40,86 @@ static bool is_gc_type(EastValueKind kind) {
     }
 }
 
+static size_t elem_size_for_type(EastType *elem_type);
+static size_t string_index_bytes(const EastStringIndex *ix);
+
+/* Bytes owned by a value (struct plus payload), for memory accounting. */
+static size_t value_footprint(const EastValue *v) {
+    size_t n = sizeof(EastValue);
+    switch (v->kind) {
+    case EAST_VAL_STRING:
+        if (v->data.string.data && v->data.string.data != v->data.string.small)
+            n += v->payload_inline || !v->data.string.cap
+                 ? v->data.string.len + 1 : v->data.string.cap;
+        n += string_index_bytes(v->data.string.index);
+        break;
+    case EAST_VAL_BLOB:
+        if (v->data.blob.data) n += v->data.blob.len;
+        break;
+    case EAST_VAL_ARRAY:
+        if (v->columnar)
+            n += east_columns_bytes(v->data.array.columns) +
+                 (v->data.array.items ? v->data.array.columns->rows_cap * sizeof(EastValue *) : 0);
+        else
+            n += v->data.array.cap * sizeof(EastValue *);
+        break;
+    case EAST_VAL_SET:
+        n += v->data.set.cap * sizeof(EastValue *);
+        break;
+    case EAST_VAL_DICT:
+        n += 2 * v->data.dict.cap * sizeof(EastValue *);
+        break;
+    case EAST_VAL_STRUCT:
+        n += v->data.struct_.num_fields * (sizeof(char *) + sizeof(EastValue *));
+        for (size_t i = 0; i < v->data.struct_.num_fields; i++) {
+            if (v->data.struct_.field_names && v->data.struct_.field_names[i])
+                n += strlen(v->data.struct_.field_names[i]) + 1;
+        }
+        break;
+    case EAST_VAL_VARIANT:
+        if (v->data.variant.case_name) n += strlen(v->data.variant.case_name) + 1;
+        break;
+    /* A view's elements are counted once, by the value that allocated them */
+    case EAST_VAL_VECTOR:
+        if (v->data.vector.data && !v->data.vector.shared)
+            n += v->data.vector.len * elem_size_for_type(v->data.vector.elem_type);
+        break;
+    case EAST_VAL_MATRIX:
+        if (v->data.matrix.data && !v->data.matrix.shared)
+            n += v->data.matrix.rows * v->data.matrix.cols
+                 * elem_size_for_type(v->data.matrix.elem_type);
+        break;
+    default:
+        break;
+    }
+    return n;
+}
+
+/* Bring the accounted size of v up to date. mem_bytes records what was
+ * counted, so values created before accounting was enabled (mem_bytes 0)
+ * are picked up here and a release always subtracts exactly what was
+ * added. Per-value counts saturate at 4 GiB. */
+void east_value_mem_update(EastValue *v) {
+    if (!east_mem_accounting || !v || v->ref_count < 0) return;
+    size_t now = value_footprint(v);
+    if (now > UINT32_MAX) now = UINT32_MAX;
+    int64_t delta = (int64_t)now - (int64_t)v->mem_bytes;
+    if (delta == 0) return;
+    east_mem_account(EAST_MEM_VALUES, v->kind, delta, v->mem_bytes ? 0 : 1);
+    v->mem_bytes = (uint32_t)now;
+}
+
+static inline void value_mem_update(EastValue *v) {
+    if (east_mem_accounting) east_value_mem_update(v);
+}
+
+static inline void value_mem_release(EastValue *v) {
+    if (v->mem_bytes) {
+        east_mem_account(EAST_MEM_VALUES, v->kind, -(int64_t)v->mem_bytes, -1);
+        v->mem_bytes = 0;
+    }
+}
+
 static EastValue *alloc_value(EastValueKind kind) {
     EastValue *v = east_calloc(1, sizeof(EastValue));
     if (!v) return NULL;
@@ -46,84 +131,41 @@ static EastValue *alloc_value(EastValueKind kind) {
     if (is_gc_type(kind)) {
         east_gc_track(v);
     }
+    value_mem_update(v);
     return v;
 }
 
-/*
- * Format a double identically to ECMAScript Number::toString(x).
- * Implements the algorithm from ECMA-262 section 6.1.6.1.20 exactly:
- *   1. NaN → "NaN"
- *   2. +0 or -0 → "0"
- *   3. Negative → "-" + ToString(-x)
- *   4. Infinity → "Infinity"
- *   5. Find minimal k significant digits, then format per spec rules.
- */
-int east_fmt_double(char *out, size_t out_size, double val) {
-    if (isnan(val)) return snprintf(out, out_size, "NaN");
-    if (val == 0.0) return snprintf(out, out_size, "0"); /* both +0 and -0 */
-    if (isinf(val)) return snprintf(out, out_size, val > 0 ? "Infinity" : "-Infinity");
-
-    int pos = 0;
-    if (val < 0) { out[pos++] = '-'; val = -val; }
-
-    /* Find shortest %e representation that round-trips */
-    char ebuf[32];
-    int prec;
-    for (prec = 0; prec <= 20; prec++) {
-        snprintf(ebuf, sizeof(ebuf), "%.*e", prec, val);
-        if (strtod(ebuf, NULL) == val) break;
-    }
-
-    /* Parse significant digits and exponent from %e output (e.g. "3.14e+02") */
-    char digits[24];
-    int k = 0;
-    char *p = ebuf;
-    digits[k++] = *p++;
-    if (*p == '.') {
-        p++;
-        while (*p && *p != 'e' && *p != 'E')
-            digits[k++] = *p++;
-    }
-    digits[k] = '\0';
-
-    /* Strip trailing zeros from digit string */
-    while (k > 1 && digits[k - 1] == '0') k--;
-    digits[k] = '\0';
-
-    int exp_val = 0;
-    if (*p == 'e' || *p == 'E') { p++; exp_val = atoi(p); }
-    int n = exp_val + 1; /* ECMAScript "n" */
-
-    /* ECMAScript formatting rules (steps 6-10 of 9.8.1) */
-    if (k <= n && n <= 21) {
-        /* digits followed by (n-k) zeros */
-        for (int i = 0; i < k; i++) out[pos++] = digits[i];
-        for (int i = 0; i < n - k; i++) out[pos++] = '0';
-        out[pos] = '\0';
-    } else if (0 < n && n <= 21) {
-        /* first n digits, '.', remaining digits */
-        for (int i = 0; i < n; i++) out[pos++] = digits[i];
-        out[pos++] = '.';
-        for (int i = n; i < k; i++) out[pos++] = digits[i];
-        out[pos] = '\0';
-    } else if (-6 < n && n <= 0) {
-        /* "0.", (-n) zeros, then digits */
-        out[pos++] = '0'; out[pos++] = '.';
-        for (int i = 0; i < -n; i++) out[pos++] = '0';
-        for (int i = 0; i < k; i++) out[pos++] = digits[i];
-        out[pos] = '\0';
-    } else {
-        /* Scientific notation */
-        int e = n - 1;
-        out[pos++] = digits[0];
-        if (k > 1) {
-            out[pos++] = '.';
-            for (int i = 1; i < k; i++) out[pos++] = digits[i];
-        }
-        pos += snprintf(out + pos, out_size - pos, "e%c%d",
-                        e >= 0 ? '+' : '-', e >= 0 ? e : -e);
+/* A String of len bytes (left uninitialized, NUL-terminated) stored in
+ * the value, or right after it in the same allocation. */
+static EastValue *alloc_string(size_t len) {
+    if (len < EAST_STRING_SMALL) {
+        EastValue *v = alloc_value(EAST_VAL_STRING);
+        if (!v) return NULL;
+        v->payload_inline = true;
+        v->data.string.data = v->data.string.small;
+        v->data.string.len = len;
+        v->data.string.data[len] = '\0';
+        return v;
     }
-    return pos;
+    if (len > SIZE_MAX - sizeof(EastValue) - 1) return NULL;
+    EastValue *v = east_alloc(sizeof(EastValue) + len + 1);
+    if (!v) return NULL;
+    memset(v, 0, sizeof(EastValue));
+    v->kind = EAST_VAL_STRING;
+    v->ref_count = 1;
+    v->payload_inline = true;
+    v->data.string.data = (char *)(v + 1);
+    v->data.string.len = len;
+    v->data.string.data[len] = '\0';
+    value_mem_update(v);
+    return v;
+}
+
+/* Free a value whose constructor failed part-way. */
+static void discard_value(EastValue *v) {
+    if (v->gc_tracked) east_gc_untrack(v);
+    value_mem_release(v);
+    east_free(v);
 }
 
 /* Return the byte size of a single element for vector/matrix storage. */
@@ -168,33 +210,163 @@ EastValue *east_float(double val) {
 
 EastValue *east_string(const char *str) {
     if (!str) str = "";
-    EastValue *v = alloc_value(EAST_VAL_STRING);
-    if (!v) return NULL;
-    v->data.string.len = strlen(str);
-    v->data.string.data = east_strdup(str);
-    if (!v->data.string.data) {
-        east_free(v);
-        return NULL;
-    }
-    return v;
+    return east_string_len(str, strlen(str));
 }
 
 EastValue *east_string_len(const char *str, size_t len) {
-    EastValue *v = alloc_value(EAST_VAL_STRING);
+    EastValue *v = alloc_string(len);
     if (!v) return NULL;
-    v->data.string.len = len;
-    v->data.string.data = east_alloc(len + 1);
-    if (!v->data.string.data) {
-        east_free(v);
-        return NULL;
-    }
     if (str && len > 0) {
         memcpy(v->data.string.data, str, len);
     }
-    v->data.string.data[len] = '\0';
     return v;
 }
 
+/* ------------------------------------------------------------------ */
+/*  String codepoint index                                             */
+/* ------------------------------------------------------------------ */
+
+#define STRING_INDEX_STRIDE 64   /* codepoints between index marks */
+#define STRING_INDEX_MIN 256     /* bytes; shorter strings are walked */
+
+struct EastStringIndex {
+    size_t cp_len;
+    size_t *marks;       /* marks[k]: byte offset of codepoint k * STRING_INDEX_STRIDE */
+    size_t num_marks;
+};
+
+/* Shared by every ASCII string: codepoint i is byte i */
+static EastStringIndex ascii_index;
+
+static size_t string_index_bytes(const EastStringIndex *ix) {
+    if (!ix || ix == &ascii_index) return 0;
+    return sizeof(EastStringIndex) + ix->num_marks * sizeof(size_t);
+}
+
+static void string_index_free(EastStringIndex *ix) {
+    if (!ix || ix == &ascii_index) return;
+    east_free(ix->marks);
+    east_free(ix);
+}
+
+/* Byte length of the UTF-8 sequence led by c; invalid bytes count as one
+ * codepoint each, as in the String builtins. */
+static inline size_t utf8_seq_len(unsigned char c) {
+    if (c < 0x80) return 1;
+    if ((c & 0xE0) == 0xC0) return 2;
+    if ((c & 0xF0) == 0xE0) return 3;
+    if ((c & 0xF8) == 0xF0) return 4;
+    return 1;
+}
+
+/* Length of the ASCII prefix of p[0..n) */
+static size_t ascii_prefix(const unsigned char *p, size_t n) {
+    size_t i = 0;
+#ifdef __SSE2__
+    for (; i + 16 <= n; i += 16) {
+        int m = _mm_movemask_epi8(_mm_loadu_si128((const __m128i *)(p + i)));
+        if (m) return i + (size_t)__builtin_ctz((unsigned)m);
+    }
+#endif
+    for (; i + 8 <= n; i += 8) {
+        uint64_t w;
+        memcpy(&w, p + i, 8);
+        if (w & 0x8080808080808080ULL) break;
+    }
+    while (i < n && p[i] < 0x80) i++;
+    return i;
+}
+
+/* The index of s, built on first use; NULL if out of memory. */
+static EastStringIndex *string_index(EastValue *s) {
+    if (s->data.string.index) return s->data.string.index;
+    const unsigned char *p = (const unsigned char *)s->data.string.data;
+    size_t len = s->data.string.len;
+    size_t i = ascii_prefix(p, len);
+    if (i == len) return s->data.string.index = &ascii_index;
+
+    EastStringIndex *ix = east_calloc(1, sizeof(EastStringIndex));
+    if (!ix) return NULL;
+    if (len >= STRING_INDEX_MIN) {
+        ix->marks = east_alloc((len / STRING_INDEX_STRIDE + 1) * sizeof(size_t));
+    }
+    /* In the ASCII prefix codepoints are bytes */
+    size_t cp = i;
+    if (ix->marks) {
+        for (size_t k = 0; k * STRING_INDEX_STRIDE < i; k++)
+            ix->marks[k] = k * STRING_INDEX_STRIDE;
+        ix->num_marks = (i + STRING_INDEX_STRIDE - 1) / STRING_INDEX_STRIDE;
+    }
+    while (i < len) {
+        if (ix->marks && cp % STRING_INDEX_STRIDE == 0)
+            ix->marks[ix->num_marks++] = i;
+        i += utf8_seq_len(p[i]);
+        cp++;
+    }
+    ix->cp_len = cp;
+    s->data.string.index = ix;
+    value_mem_update(s);
+    return ix;
+}
+
+bool east_string_is_ascii(EastValue *s) {
+    return string_index(s) == &ascii_index;
+}
+
+size_t east_string_cp_len(EastValue *s) {
+    EastStringIndex *ix = string_index(s);
+    if (ix == &ascii_index) return s->data.string.len;
+    if (ix) return ix->cp_len;
+    const unsigned char *p = (const unsigned char *)s->data.string.data;
+    size_t cp = 0;
+    for (size_t i = 0; i < s->data.string.len; i += utf8_seq_len(p[i])) cp++;
+    return cp;
+}
+
+size_t east_string_cp_to_byte(EastValue *s, size_t cp) {
+    const unsigned char *p = (const unsigned char *)s->data.string.data;
+    size_t len = s->data.string.len;
+    EastStringIndex *ix = string_index(s);
+    if (ix == &ascii_index) return cp < len ? cp : len;
+    size_t i = 0, c = 0;
+    if (ix && ix->marks) {
+        size_t k = cp / STRING_INDEX_STRIDE;
+        if (k >= ix->num_marks) k = ix->num_marks - 1;
+        c = k * STRING_INDEX_STRIDE;
+        i = ix->marks[k];
+    }
+    while (i < len && c < cp) {
+        i += utf8_seq_len(p[i]);
+        c++;
+    }
+    return i < len ? i : len;
+}
+
+size_t east_string_byte_to_cp(EastValue *s, size_t byte) {
+    const unsigned char *p = (const unsigned char *)s->data.string.data;
+    size_t len = s->data.string.len;
+    if (byte > len) byte = len;
+    EastStringIndex *ix = string_index(s);
+    if (ix == &ascii_index) return byte;
+    size_t i = 0, c = 0;
+    if (ix && ix->marks) {
+        /* Last mark at or before byte */
+        size_t lo = 0, hi = ix->num_marks;
+        while (hi - lo > 1) {
+            size_t mid = lo + (hi - lo) / 2;
+            if (ix->marks[mid] <= byte) lo = mid;
+            else hi = mid;
+        }
+        c = lo * STRING_INDEX_STRIDE;
+        i = ix->marks[lo];
+    }
+    while (i < byte) {
+        i += utf8_seq_len(p[i]);
+        c++;
+    }
+    return c;
+}
+
 EastValue *east_datetime(int64_t millis) {
     EastValue *v = alloc_value(EAST_VAL_DATETIME);
     if (!v) return NULL;
@@ -202,23 +374,108 @@ EastValue *east_datetime(int64_t millis) {
     return v;
 }
 
+/* Howard Hinnant's days_from_civil / civil_from_days: years are grouped
+ * into 400-year eras and each year starts on March 1st, so the leap day
+ * comes last and the month lengths follow a fixed 153-days-per-5 rule. */
+#define MS_PER_DAY 86400000
+
+int64_t east_days_from_civil(int64_t year, int month, int day) {
+    year -= month <= 2;
+    int64_t era = (year >= 0 ? year : year - 399) / 400;
+    int64_t yoe = year - era * 400;
+    int64_t doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    int64_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+
+void east_datetime_parts(int64_t millis, EastDateTimeParts *out) {
+    int64_t days = millis / MS_PER_DAY;
+    int64_t rem = millis % MS_PER_DAY;
+    if (rem < 0) { rem += MS_PER_DAY; days--; }
+    int ms = (int)rem;
+    out->hour = ms / 3600000;
+    out->minute = ms / 60000 % 60;
+    out->second = ms / 1000 % 60;
+    out->millisecond = ms % 1000;
+    /* 1970-01-01 was a Thursday */
+    int64_t wd = (days + 4) % 7;
+    out->weekday = (int)(wd < 0 ? wd + 7 : wd);
+
+    int64_t z = days + 719468;
+    int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+    int64_t doe = z - era * 146097;
+    int64_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    int64_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    int64_t mp = (5 * doy + 2) / 153;
+    out->day = (int)(doy - (153 * mp + 2) / 5 + 1);
+    out->month = (int)(mp < 10 ? mp + 3 : mp - 9);
+    out->year = yoe + era * 400 + (out->month <= 2);
+}
+
 EastValue *east_blob(const uint8_t *data, size_t len) {
     EastValue *v = alloc_value(EAST_VAL_BLOB);
     if (!v) return NULL;
     v->data.blob.len = len;
-    if (len > 0 && data) {
+    if (len > 0) {
         v->data.blob.data = east_alloc(len);
         if (!v->data.blob.data) {
-            east_free(v);
+            discard_value(v);
             return NULL;
         }
-        memcpy(v->data.blob.data, data, len);
+        if (data) memcpy(v->data.blob.data, data, len);
     } else {
         v->data.blob.data = NULL;
     }
+    value_mem_update(v);
+    return v;
+}
+
+EastValue *east_string_adopt(char *data, size_t len) {
+    /* A small string is cheaper inline than as a second allocation */
+    if (len < EAST_STRING_SMALL) {
+        EastValue *v = east_string_len(data, len);
+        free(data);
+        return v;
+    }
+    EastValue *v = alloc_value(EAST_VAL_STRING);
+    if (!v) {
+        free(data);
+        return NULL;
+    }
+    v->data.string.data = data;
+    v->data.string.len = len;
+    value_mem_update(v);
     return v;
 }
 
+bool east_string_append(EastValue *s, const char *data, size_t len) {
+    size_t old = s->data.string.len;
+    if (len > SIZE_MAX / 2 - old - 1) return false;
+    size_t need = old + len + 1;
+    bool owned = !s->payload_inline;
+    if (!owned || s->data.string.cap < need) {
+        size_t cap = need < 64 ? 64 : need + need / 2;
+        char *buf = owned ? realloc(s->data.string.data, cap) : malloc(cap);
+        if (!buf) return false;
+        if (!owned) {
+            /* Inline and trailing bytes cannot grow: move to a buffer of
+             * our own. Trailing bytes stay allocated with the value until
+             * it is freed. */
+            memcpy(buf, s->data.string.data, old);
+            s->payload_inline = false;
+        }
+        s->data.string.data = buf;
+        s->data.string.cap = cap;
+    }
+    memcpy(s->data.string.data + old, data, len);
+    s->data.string.len = old + len;
+    s->data.string.data[old + len] = '\0';
+    string_index_free(s->data.string.index);
+    s->data.string.index = NULL;
+    value_mem_update(s);
+    return true;
+}
+
 /* ------------------------------------------------------------------ */
 /*  Constructors: collections                                          */
 /* ------------------------------------------------------------------ */
@@ -230,16 +487,18 @@ EastValue *east_array_new(EastType *elem_type) {
     v->data.array.cap = 4;
     v->data.array.items = east_alloc(4 * sizeof(EastValue *));
     if (!v->data.array.items) {
-        east_free(v);
+        discard_value(v);
         return NULL;
     }
     v->data.array.elem_type = elem_type;
     if (elem_type) east_type_retain(elem_type);
+    value_mem_update(v);
     return v;
 }
 
 void east_array_push(EastValue *arr, EastValue *val) {
     if (!arr || arr->kind != EAST_VAL_ARRAY) return;
+    east_array_ensure_rows(arr);
     if (arr->data.array.len >= arr->data.array.cap) {
         size_t old_cap = arr->data.array.cap;
         size_t new_cap = old_cap * 2;
@@ -249,14 +508,17 @@ void east_array_push(EastValue *arr, EastValue *val) {
         if (!new_items) return;
         arr->data.array.items = new_items;
         arr->data.array.cap = new_cap;
+        value_mem_update(arr);
     }
     if (val) east_value_retain(val);
     arr->data.array.items[arr->data.array.len++] = val;
+    east_value_invalidate_hashes();
 }
 
 EastValue *east_array_get(EastValue *arr, size_t index) {
     if (!arr || arr->kind != EAST_VAL_ARRAY) return NULL;
     if (index >= arr->data.array.len) return NULL;
+    if (arr->columnar) return east_columnar_get(arr, index);
     return arr->data.array.items[index];
 }
 
@@ -276,11 +538,12 @@ EastValue *east_set_new(EastType *elem_type) {
     v->data.set.cap = 4;
     v->data.set.items = east_alloc(4 * sizeof(EastValue *));
     if (!v->data.set.items) {
-        east_free(v);
+        discard_value(v);
         return NULL;
     }
     v->data.set.elem_type = elem_type;
     if (elem_type) east_type_retain(elem_type);
+    value_mem_update(v);
     return v;
 }
 
@@ -327,6 +590,7 @@ void east_set_insert(EastValue *set, EastValue *val) {
         if (!new_items) return;
         set->data.set.items = new_items;
         set->data.set.cap = new_cap;
+        value_mem_update(set);
     }
 
     /* Shift elements right to make room. */
@@ -339,6 +603,7 @@ void east_set_insert(EastValue *set, EastValue *val) {
     if (val) east_value_retain(val);
     set->data.set.items[pos] = val;
     set->data.set.len++;
+    east_value_invalidate_hashes();
 }
 
 bool east_set_has(EastValue *set, EastValue *val) {
@@ -360,6 +625,7 @@ bool east_set_delete(EastValue *set, EastValue *val) {
                 remaining * sizeof(EastValue *));
     }
     set->data.set.len--;
+    east_value_invalidate_hashes();
     return true;
 }
 
@@ -382,13 +648,14 @@ EastValue *east_dict_new(EastType *key_type, EastType *val_type) {
     if (!v->data.dict.keys || !v->data.dict.values) {
         east_free(v->data.dict.keys);
         east_free(v->data.dict.values);
-        east_free(v);
+        discard_value(v);
         return NULL;
     }
     v->data.dict.key_type = key_type;
     if (key_type) east_type_retain(key_type);
     v->data.dict.val_type = val_type;
     if (val_type) east_type_retain(val_type);
+    value_mem_update(v);
     return v;
 }
 
@@ -404,6 +671,7 @@ void east_dict_set(EastValue *dict, EastValue *key, EastValue *val) {
         if (val) east_value_retain(val);
         east_value_release(dict->data.dict.values[pos]);
         dict->data.dict.values[pos] = val;
+        east_value_invalidate_hashes();
         return;
     }
 
@@ -426,6 +694,7 @@ void east_dict_set(EastValue *dict, EastValue *key, EastValue *val) {
         dict->data.dict.keys = new_keys;
         dict->data.dict.values = new_vals;
         dict->data.dict.cap = new_cap;
+        value_mem_update(dict);
     }
 
     /* Shift elements right. */
@@ -443,6 +712,7 @@ void east_dict_set(EastValue *dict, EastValue *key, EastValue *val) {
     dict->data.dict.keys[pos] = key;
     dict->data.dict.values[pos] = val;
     dict->data.dict.len++;
+    east_value_invalidate_hashes();
 }
 
 EastValue *east_dict_get(EastValue *dict, EastValue *key) {
@@ -476,6 +746,7 @@ bool east_dict_delete(EastValue *dict, EastValue *key) {
                 remaining * sizeof(EastValue *));
     }
     dict->data.dict.len--;
+    east_value_invalidate_hashes();
     return true;
 }
 
@@ -494,6 +765,7 @@ EastValue *east_dict_pop(EastValue *dict, EastValue *key) {
                 remaining * sizeof(EastValue *));
     }
     dict->data.dict.len--;
+    east_value_invalidate_hashes();
     return val;
 }
 
@@ -520,7 +792,7 @@ EastValue *east_struct_new(const char **names, EastValue **values,
         if (!v->data.struct_.field_names || !v->data.struct_.field_values) {
             east_free(v->data.struct_.field_names);
             east_free(v->data.struct_.field_values);
-            east_free(v);
+            discard_value(v);
             return NULL;
         }
         for (size_t i = 0; i < count; i++) {
@@ -532,6 +804,7 @@ EastValue *east_struct_new(const char **names, EastValue **values,
 
     v->data.struct_.type = type;
     if (type) east_type_retain(type);
+    value_mem_update(v);
     return v;
 }
 
@@ -551,13 +824,14 @@ EastValue *east_variant_new(const char *case_name, EastValue *value,
     if (!v) return NULL;
     v->data.variant.case_name = east_strdup(case_name ? case_name : "");
     if (!v->data.variant.case_name) {
-        east_free(v);
+        discard_value(v);
         return NULL;
     }
     v->data.variant.value = value;
     if (value) east_value_retain(value);
     v->data.variant.type = type;
     if (type) east_type_retain(type);
+    value_mem_update(v);
     return v;
 }
 
@@ -579,6 +853,7 @@ void east_ref_set(EastValue *ref, EastValue *value) {
     if (value) east_value_retain(value);
     east_value_release(ref->data.ref.value);
     ref->data.ref.value = value;
+    east_value_invalidate_hashes();
 }
 
 /* ------------------------------------------------------------------ */
@@ -596,12 +871,13 @@ EastValue *east_vector_new(EastType *elem_type, size_t len) {
         v->data.vector.data = east_calloc(len, esize);
         if (!v->data.vector.data) {
             if (elem_type) east_type_release(elem_type);
-            east_free(v);
+            discard_value(v);
             return NULL;
         }
     } else {
         v->data.vector.data = NULL;
     }
+    value_mem_update(v);
     return v;
 }
 
@@ -618,15 +894,91 @@ EastValue *east_matrix_new(EastType *elem_type, size_t rows, size_t cols) {
         v->data.matrix.data = east_calloc(count, esize);
         if (!v->data.matrix.data) {
             if (elem_type) east_type_release(elem_type);
-            east_free(v);
+            discard_value(v);
             return NULL;
         }
     } else {
         v->data.matrix.data = NULL;
     }
+    value_mem_update(v);
+    return v;
+}
+
+/* The buffer of a Vector or Matrix, wrapped for sharing on first use. */
+static EastSharedBuffer *share_buffer(EastValue *v) {
+    bool is_vec = v->kind == EAST_VAL_VECTOR;
+    EastSharedBuffer **slot = is_vec ? &v->data.vector.shared : &v->data.matrix.shared;
+    if (!*slot) {
+        EastSharedBuffer *sb = east_alloc(sizeof(EastSharedBuffer));
+        if (!sb) return NULL;
+        sb->refcount = 1;
+        sb->base = is_vec ? v->data.vector.data : v->data.matrix.data;
+        *slot = sb;
+    }
+    (*slot)->refcount++;
+    return *slot;
+}
+
+static void release_buffer(void *data, EastSharedBuffer *sb) {
+    if (!sb) {
+        free(data);
+    } else if (--sb->refcount == 0) {
+        free(sb->base);
+        east_free(sb);
+    }
+}
+
+EastValue *east_vector_view(EastValue *src, size_t offset, size_t len) {
+    bool is_vec = src->kind == EAST_VAL_VECTOR;
+    EastType *elem_type = is_vec ? src->data.vector.elem_type : src->data.matrix.elem_type;
+    if (len == 0) return east_vector_new(elem_type, 0);
+
+    EastValue *v = alloc_value(EAST_VAL_VECTOR);
+    if (!v) return NULL;
+    EastSharedBuffer *sb = share_buffer(src);
+    if (!sb) {
+        discard_value(v);
+        return NULL;
+    }
+    char *data = is_vec ? src->data.vector.data : src->data.matrix.data;
+    v->data.vector.data = data + offset * elem_size_for_type(elem_type);
+    v->data.vector.len = len;
+    v->data.vector.elem_type = elem_type;
+    v->data.vector.shared = sb;
+    if (elem_type) east_type_retain(elem_type);
+    value_mem_update(v);
     return v;
 }
 
+bool east_value_make_writable(EastValue *v) {
+    EastSharedBuffer **slot;
+    void **data;
+    size_t bytes;
+    if (v->kind == EAST_VAL_VECTOR) {
+        slot = &v->data.vector.shared;
+        data = &v->data.vector.data;
+        bytes = v->data.vector.len * elem_size_for_type(v->data.vector.elem_type);
+    } else if (v->kind == EAST_VAL_MATRIX) {
+        slot = &v->data.matrix.shared;
+        data = &v->data.matrix.data;
+        bytes = v->data.matrix.rows * v->data.matrix.cols
+                * elem_size_for_type(v->data.matrix.elem_type);
+    } else {
+        return true;
+    }
+    /* Sole remaining user: the buffer is ours to write */
+    if (!*slot || (*slot)->refcount == 1) return true;
+
+    void *copy = east_alloc(bytes);
+    if (!copy) return false;
+    memcpy(copy, *data, bytes);
+    (*slot)->refcount--;
+    *slot = NULL;
+    *data = copy;
+    value_mem_update(v);
+    return true;
+}
+
 /* ------------------------------------------------------------------ */
 /*  Function                                                           */
 /* ------------------------------------------------------------------ */
@@ -656,6 +1008,7 @@ void east_value_release(EastValue *v) {
 
     /* Remove from GC tracking list before freeing. */
     if (v->gc_tracked) east_gc_untrack(v);
+    value_mem_release(v);
 
     /* ref_count == 0: free resources. */
     switch (v->kind) {
@@ -668,7 +1021,9 @@ void east_value_release(EastValue *v) {
         break;
 
     case EAST_VAL_STRING:
-        free(v->data.string.data);
+        string_index_free(v->data.string.index);
+        if (!v->payload_inline)
+            free(v->data.string.data);
         break;
 
     case EAST_VAL_BLOB:
@@ -676,10 +1031,13 @@ void east_value_release(EastValue *v) {
         break;
 
     case EAST_VAL_ARRAY:
-        for (size_t i = 0; i < v->data.array.len; i++) {
-            east_value_release(v->data.array.items[i]);
+        if (v->data.array.items) {
+            for (size_t i = 0; i < v->data.array.len; i++) {
+                east_value_release(v->data.array.items[i]);
+            }
+            free(v->data.array.items);
         }
-        free(v->data.array.items);
+        if (v->columnar) east_columns_free(v->data.array.columns);
         if (v->data.array.elem_type)
             east_type_release(v->data.array.elem_type);
         break;
@@ -729,13 +1087,13 @@ void east_value_release(EastValue *v) {
         break;
 
     case EAST_VAL_VECTOR:
-        free(v->data.vector.data);
+        release_buffer(v->data.vector.data, v->data.vector.shared);
         if (v->data.vector.elem_type)
             east_type_release(v->data.vector.elem_type);
         break;
 
     case EAST_VAL_MATRIX:
-        free(v->data.matrix.data);
+        release_buffer(v->data.matrix.data, v->data.matrix.shared);
         if (v->data.matrix.elem_type)
             east_type_release(v->data.matrix.elem_type);
         break;
@@ -754,11 +1112,34 @@ void east_value_release(EastValue *v) {
 /*  Structural equality                                                */
 /* ------------------------------------------------------------------ */
 
+_Thread_local uint64_t east_mutation_epoch = 1;
+
+/* Hash cache slot of a container, or NULL for kinds that do not cache
+ * (scalars are cheap to rehash; dicts have no room left in the union). */
+static EastHashCache *hash_cache(EastValue *v) {
+    switch (v->kind) {
+    case EAST_VAL_ARRAY:   return &v->data.array.hc;
+    case EAST_VAL_SET:     return &v->data.set.hc;
+    case EAST_VAL_STRUCT:  return &v->data.struct_.hc;
+    case EAST_VAL_VARIANT: return &v->data.variant.hc;
+    case EAST_VAL_REF:     return &v->data.ref.hc;
+    default:               return NULL;
+    }
+}
+
 bool east_value_equal(EastValue *a, EastValue *b) {
     if (a == b) return true;
     if (!a || !b) return false;
     if (a->kind != b->kind) return false;
 
+    /* Different cached hashes prove inequality without descending. */
+    EastHashCache *ha = hash_cache(a);
+    if (ha && ha->epoch == east_mutation_epoch) {
+        EastHashCache *hb = hash_cache(b);
+        if (hb->epoch == east_mutation_epoch && ha->hash != hb->hash)
+            return false;
+    }
+
     switch (a->kind) {
     case EAST_VAL_NULL:
         return true;
@@ -794,8 +1175,8 @@ bool east_value_equal(EastValue *a, EastValue *b) {
     case EAST_VAL_ARRAY:
         if (a->data.array.len != b->data.array.len) return false;
         for (size_t i = 0; i < a->data.array.len; i++) {
-            if (!east_value_equal(a->data.array.items[i],
-                                  b->data.array.items[i]))
+            if (!east_value_equal(east_array_get(a, i),
+                                  east_array_get(b, i)))
                 return false;
         }
         return true;
@@ -869,6 +1250,119 @@ bool east_value_equal(EastValue *a, EastValue *b) {
     return false;
 }
 
+/* ------------------------------------------------------------------ */
+/*  Structural hashing                                                 */
+/* ------------------------------------------------------------------ */
+
+static inline uint64_t hash_mix(uint64_t h, uint64_t x) {
+    /* splitmix64 finalizer over the combined state */
+    h ^= x + 0x9E3779B97F4A7C15ULL + (h << 6) + (h >> 2);
+    h ^= h >> 30;
+    h *= 0xBF58476D1CE4E5B9ULL;
+    h ^= h >> 27;
+    h *= 0x94D049BB133111EBULL;
+    h ^= h >> 31;
+    return h;
+}
+
+static uint64_t hash_bytes(uint64_t h, const void *data, size_t len) {
+    const unsigned char *p = data;
+    uint64_t f = 14695981039346656037ULL;
+    for (size_t i = 0; i < len; i++) {
+        f ^= p[i];
+        f *= 1099511628211ULL;
+    }
+    return hash_mix(h, f ^ len);
+}
+
+static uint64_t hash_str(uint64_t h, const char *s) {
+    return hash_bytes(h, s, s ? strlen(s) : 0);
+}
+
+static uint64_t compute_hash(EastValue *v);
+
+/*
+ * Mirrors east_value_equal: NaNs hash alike, +0 and -0 differ, sets and
+ * dicts hash in their (sorted) storage order, functions by identity.
+ * Containers are hashed Merkle-style from their children's hashes, so
+ * after one pass every nested container has its hash cached.
+ */
+uint64_t east_value_hash(EastValue *v) {
+    if (!v) return 0;
+    EastHashCache *hc = hash_cache(v);
+    if (!hc) return compute_hash(v);
+    if (hc->epoch == east_mutation_epoch) return hc->hash;
+    uint64_t h = compute_hash(v);
+    hc->hash = h;
+    hc->epoch = east_mutation_epoch;
+    return h;
+}
+
+static uint64_t compute_hash(EastValue *v) {
+    uint64_t h = hash_mix(0, (uint64_t)v->kind);
+
+    switch (v->kind) {
+    case EAST_VAL_NULL:
+        return h;
+    case EAST_VAL_BOOLEAN:
+        return hash_mix(h, v->data.boolean);
+    case EAST_VAL_INTEGER:
+        return hash_mix(h, (uint64_t)v->data.integer);
+    case EAST_VAL_FLOAT: {
+        double d = v->data.float64;
+        uint64_t bits;
+        if (isnan(d)) d = NAN;
+        memcpy(&bits, &d, sizeof(bits));
+        return hash_mix(h, bits);
+    }
+    case EAST_VAL_STRING:
+        return hash_bytes(h, v->data.string.data, v->data.string.len);
+    case EAST_VAL_DATETIME:
+        return hash_mix(h, (uint64_t)v->data.datetime);
+    case EAST_VAL_BLOB:
+        return hash_bytes(h, v->data.blob.data, v->data.blob.len);
+    case EAST_VAL_ARRAY:
+        for (size_t i = 0; i < v->data.array.len; i++)
+            h = hash_mix(h, east_value_hash(east_array_get(v, i)));
+        return hash_mix(h, v->data.array.len);
+    case EAST_VAL_SET:
+        for (size_t i = 0; i < v->data.set.len; i++)
+            h = hash_mix(h, east_value_hash(v->data.set.items[i]));
+        return hash_mix(h, v->data.set.len);
+    case EAST_VAL_DICT:
+        for (size_t i = 0; i < v->data.dict.len; i++) {
+            h = hash_mix(h, east_value_hash(v->data.dict.keys[i]));
+            h = hash_mix(h, east_value_hash(v->data.dict.values[i]));
+        }
+        return hash_mix(h, v->data.dict.len);
+    case EAST_VAL_STRUCT:
+        for (size_t i = 0; i < v->data.struct_.num_fields; i++) {
+            h = hash_str(h, v->data.struct_.field_names[i]);
+            h = hash_mix(h, east_value_hash(v->data.struct_.field_values[i]));
+        }
+        return h;
+    case EAST_VAL_VARIANT:
+        h = hash_str(h, v->data.variant.case_name);
+        return hash_mix(h, east_value_hash(v->data.variant.value));
+    case EAST_VAL_REF:
+        return hash_mix(h, east_value_hash(v->data.ref.value));
+    case EAST_VAL_VECTOR:
+        if (v->data.vector.len == 0) return h;
+        return hash_bytes(h, v->data.vector.data,
+                          v->data.vector.len * elem_size_for_type(v->data.vector.elem_type));
+    case EAST_VAL_MATRIX: {
+        size_t n = v->data.matrix.rows * v->data.matrix.cols;
+        h = hash_mix(h, v->data.matrix.rows);
+        if (n == 0) return h;
+        return hash_bytes(h, v->data.matrix.data,
+                          n * elem_size_for_type(v->data.matrix.elem_type));
+    }
+    case EAST_VAL_FUNCTION:
+        return hash_mix(h, (uint64_t)(uintptr_t)v->data.function.compiled);
+    }
+    return h;
+}
+
 /* ------------------------------------------------------------------ */
 /*  Total ordering                                                     */
 /* ------------------------------------------------------------------ */
@@ -984,8 +1478,8 @@ int east_value_compare(EastValue *a, EastValue *b) {
                              ? a->data.array.len
                              : b->data.array.len;
         for (size_t i = 0; i < min_len; i++) {
-            int c = east_value_compare(a->data.array.items[i],
-                                       b->data.array.items[i]);
+            int c = east_value_compare(east_array_get(a, i),
+                                       east_array_get(b, i));
             if (c != 0) return c;
         }
         return cmp_size(a->data.array.len, b->data.array.len);
@@ -1169,7 +1663,7 @@ static int print_value(EastValue *v, char *buf, size_t buf_size, int pos) {
         pos += buf_append(buf, buf_size, pos, "[");
         for (size_t i = 0; i < v->data.array.len; i++) {
             if (i > 0) pos += buf_append(buf, buf_size, pos, ", ");
-            pos = print_value(v->data.array.items[i], buf, buf_size, pos);
+            pos = print_value(east_array_get(v, i), buf, buf_size, pos);
         }
         pos += buf_append(buf, buf_size, pos, "]");
         return pos;
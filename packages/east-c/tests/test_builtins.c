@@ -17,6 +17,7 @@
 #include <east/types.h>
 #include <east/values.h>
 #include <east/builtins.h>
+#include <east/columnar.h>
 
 static int tests_run = 0;
 static int tests_passed = 0;
@@ -60,6 +61,13 @@ static EastValue *call2(const char *name, EastValue *a, EastValue *b) {
     return fn(args, 2);
 }
 
+/* Helper to call a builtin with any number of args. */
+static EastValue *calln(const char *name, EastValue **args, size_t n) {
+    BuiltinImpl fn = builtin_registry_get(reg, name, NULL, 0);
+    if (!fn) return NULL;
+    return fn(args, n);
+}
+
 /* Helper to call a 1-arg builtin. */
 static EastValue *call1(const char *name, EastValue *a) {
     BuiltinImpl fn = builtin_registry_get(reg, name, NULL, 0);
@@ -429,6 +437,187 @@ TEST(string_length) {
     east_value_release(r);
 }
 
+TEST(string_search_builtins) {
+    /* Searches run over the whole length, past embedded NULs */
+    EastValue *s = east_string_len("ab\0cd\0cd", 8);
+    EastValue *cd = east_string("cd");
+    EastValue *r = call2("StringIndexOf", s, cd);
+    ASSERT_EQ_INT(r->data.integer, 3);
+    east_value_release(r);
+    r = call2("StringContains", s, cd);
+    ASSERT(r->data.boolean);
+    east_value_release(r);
+    EastValue *nul = east_string_len("\0", 1);
+    r = call2("StringSplit", s, nul);
+    ASSERT_EQ_INT((int64_t)r->data.array.len, 3);
+    ASSERT_EQ_STR(east_array_get(r, 2)->data.string.data, "cd");
+    east_value_release(r);
+    EastValue *x = east_string("x");
+    EastValue *rep[] = {s, cd, x};
+    r = calln("StringReplace", rep, 3);
+    ASSERT_EQ_INT((int64_t)r->data.string.len, 6);
+    ASSERT(memcmp(r->data.string.data, "ab\0x\0x", 6) == 0);
+    east_value_release(r);
+
+    /* Needles long enough for the skip table, near-misses included */
+    char hay[400], needle[41];
+    for (int i = 0; i < 400; i++) hay[i] = "abcab"[i % 5];
+    memcpy(needle, hay + 3, 40);
+    needle[39] = 'z';
+    memcpy(hay + 357, needle, 40);
+    needle[40] = '\0';
+    EastValue *h = east_string_len(hay, 400);
+    EastValue *n = east_string(needle);
+    r = call2("StringIndexOf", h, n);
+    ASSERT_EQ_INT(r->data.integer, 357);
+    east_value_release(r);
+    r = call2("StringSplit", h, n);
+    ASSERT_EQ_INT((int64_t)r->data.array.len, 2);
+    ASSERT_EQ_INT((int64_t)east_array_get(r, 0)->data.string.len, 357);
+    east_value_release(r);
+
+    east_value_release(s);
+    east_value_release(cd);
+    east_value_release(nul);
+    east_value_release(x);
+    east_value_release(h);
+    east_value_release(n);
+}
+
+/* ------------------------------------------------------------------ */
+/*  DateTime formats                                                   */
+/* ------------------------------------------------------------------ */
+
+/* Appends a format token; lit is the literal text, or NULL for a field */
+static void push_token(EastValue *fmt, const char *name, const char *lit) {
+    EastValue *v = lit ? east_string(lit) : east_null();
+    EastValue *t = east_variant_new(name, v, NULL);
+    east_array_push(fmt, t);
+    east_value_release(t);
+    east_value_release(v);
+}
+
+TEST(datetime_format_print_parse) {
+    EastValue *fmt = east_array_new(NULL);
+    push_token(fmt, "year4", NULL);
+    push_token(fmt, "literal", "-");
+    push_token(fmt, "month2", NULL);
+    push_token(fmt, "literal", "-");
+    push_token(fmt, "day2", NULL);
+    push_token(fmt, "literal", " ");
+    push_token(fmt, "hour24_2", NULL);
+    push_token(fmt, "literal", ":");
+    push_token(fmt, "minute2", NULL);
+    push_token(fmt, "literal", ":");
+    push_token(fmt, "second2", NULL);
+    push_token(fmt, "literal", ".");
+    push_token(fmt, "millisecond3", NULL);
+
+    /* 2024-02-29 13:05:09.007 UTC */
+    EastValue *d = east_datetime(1709211909007LL);
+    EastValue *s = call2("DateTimePrintFormat", d, fmt);
+    ASSERT_EQ_STR(s->data.string.data, "2024-02-29 13:05:09.007");
+    EastValue *back = call2("DateTimeParseFormat", s, fmt);
+    ASSERT(back != NULL);
+    ASSERT_EQ_INT(back->data.datetime, 1709211909007LL);
+    east_value_release(back);
+    east_value_release(s);
+    east_value_release(d);
+
+    /* Sub-second times before the epoch round down, as in JavaScript */
+    d = east_datetime(-1);
+    s = call2("DateTimePrintFormat", d, fmt);
+    ASSERT_EQ_STR(s->data.string.data, "1969-12-31 23:59:59.999");
+    back = call2("DateTimeParseFormat", s, fmt);
+    ASSERT(back != NULL);
+    ASSERT_EQ_INT(back->data.datetime, -1);
+    east_value_release(back);
+    east_value_release(s);
+    east_value_release(d);
+
+    /* Growing the array after use recompiles its cached plan */
+    push_token(fmt, "literal", " ");
+    push_token(fmt, "weekdayNameShort", NULL);
+    push_token(fmt, "literal", " ");
+    push_token(fmt, "ampmUpper", NULL);
+    d = east_datetime(0);
+    s = call2("DateTimePrintFormat", d, fmt);
+    ASSERT_EQ_STR(s->data.string.data, "1970-01-01 00:00:00.000 Thu AM");
+    east_value_release(s);
+
+    /* Dates that do not exist are rejected */
+    s = east_string("2023-02-29 00:00:00.000 Wed AM");
+    back = call2("DateTimeParseFormat", s, fmt);
+    ASSERT(back == NULL);
+    free(east_builtin_get_error());
+    east_value_release(s);
+
+    east_value_release(d);
+
+    /* Clearing the plans drops their references to the array */
+    ASSERT_EQ_INT(fmt->ref_count, 2);
+    east_datetime_plans_clear();
+    ASSERT_EQ_INT(fmt->ref_count, 1);
+    east_value_release(fmt);
+}
+
+TEST(datetime_components) {
+    static const char *getters[] = {
+        "DateTimeGetYear", "DateTimeGetMonth", "DateTimeGetDayOfMonth",
+        "DateTimeGetHour", "DateTimeGetMinute", "DateTimeGetSecond",
+        "DateTimeGetMillisecond", "DateTimeGetDayOfWeek",
+    };
+    static const char *fields[] = {
+        "year", "month", "day", "hour", "minute", "second", "millisecond", "dayOfWeek",
+    };
+    int64_t ms[] = {0, -1, 1709211909007LL, -62135596800001LL, 253402300799999LL,
+                    951782400000LL, -86400000LL};
+    size_t n = sizeof(ms) / sizeof(ms[0]);
+    EastValue *arr = east_array_new(NULL);
+    EastValue *vec = east_vector_new(&east_integer_type, n);
+    for (size_t i = 0; i < n; i++) {
+        EastValue *d = east_datetime(ms[i]);
+        east_array_push(arr, d);
+        east_value_release(d);
+        ((int64_t *)vec->data.vector.data)[i] = ms[i];
+    }
+
+    EastValue *from_arr = call1("DateTimeComponents", arr);
+    EastValue *from_vec = call1("DateTimeComponents", vec);
+    ASSERT(from_arr != NULL && from_vec != NULL);
+    for (int k = 0; k < 8; k++) {
+        EastValue *ca = east_struct_get_field(from_arr, fields[k]);
+        EastValue *cv = east_struct_get_field(from_vec, fields[k]);
+        ASSERT_EQ_INT((int64_t)ca->data.vector.len, (int64_t)n);
+        for (size_t i = 0; i < n; i++) {
+            /* Alternate timestamps so the getters' cache is missed and hit */
+            EastValue *d = east_datetime(ms[i]);
+            EastValue *g = call1(getters[k], d);
+            ASSERT_EQ_INT(((int64_t *)ca->data.vector.data)[i], g->data.integer);
+            ASSERT_EQ_INT(((int64_t *)cv->data.vector.data)[i], g->data.integer);
+            east_value_release(g);
+            east_value_release(d);
+        }
+    }
+    /* 1969-12-31 23:59:59.999, a Wednesday */
+    EastValue *years = east_struct_get_field(from_arr, "year");
+    EastValue *dows = east_struct_get_field(from_arr, "dayOfWeek");
+    ASSERT_EQ_INT(((int64_t *)years->data.vector.data)[1], 1969);
+    ASSERT_EQ_INT(((int64_t *)dows->data.vector.data)[1], 3);
+    east_value_release(from_arr);
+    east_value_release(from_vec);
+
+    EastValue *bad = east_array_new(NULL);
+    EastValue *i1 = east_integer(1);
+    east_array_push(bad, i1);
+    ASSERT(call1("DateTimeComponents", bad) == NULL);
+    free(east_builtin_get_error());
+    east_value_release(i1);
+    east_value_release(bad);
+    east_value_release(arr);
+    east_value_release(vec);
+}
+
 /* ------------------------------------------------------------------ */
 /*  Comparison builtins (may not be implemented yet)                   */
 /* ------------------------------------------------------------------ */
@@ -524,6 +713,521 @@ TEST(array_push_builtin) {
     if (r != arr) east_value_release(r);
 }
 
+/* ------------------------------------------------------------------ */
+/*  Vector builtins                                                    */
+/* ------------------------------------------------------------------ */
+
+static EastValue *float_vector(const double *xs, size_t n) {
+    EastValue *v = east_vector_new(&east_float_type, n);
+    memcpy(v->data.vector.data, xs, n * sizeof(double));
+    return v;
+}
+
+static EastValue *integer_vector(const int64_t *xs, size_t n) {
+    EastValue *v = east_vector_new(&east_integer_type, n);
+    memcpy(v->data.vector.data, xs, n * sizeof(int64_t));
+    return v;
+}
+
+TEST(vector_arithmetic) {
+    /* 19 elements: exercises both the unrolled body and the tail */
+    double xa[19], xb[19];
+    for (int i = 0; i < 19; i++) { xa[i] = i; xb[i] = 0.5 * i; }
+    EastValue *a = float_vector(xa, 19);
+    EastValue *b = float_vector(xb, 19);
+    EastValue *two = east_float(2.0);
+
+    EastValue *sum = call2("VectorAdd", a, b);
+    ASSERT(sum != NULL);
+    ASSERT_EQ_INT((int64_t)sum->data.vector.len, 19);
+    ASSERT(((double *)sum->data.vector.data)[18] == 27.0);
+    EastValue *scaled = call2("VectorMultiply", a, two);
+    ASSERT(scaled != NULL);
+    ASSERT(((double *)scaled->data.vector.data)[7] == 14.0);
+
+    /* Integer division floors, like IntegerDivide */
+    int64_t xi[] = {7, -7, 7, 5};
+    int64_t yi[] = {2, 2, -2, 0};
+    EastValue *ia = integer_vector(xi, 4);
+    EastValue *ib = integer_vector(yi, 4);
+    EastValue *q = call2("VectorDivide", ia, ib);
+    ASSERT(q != NULL);
+    int64_t *qd = q->data.vector.data;
+    ASSERT(qd[0] == 3 && qd[1] == -4 && qd[2] == -4 && qd[3] == 0);
+
+    /* Mismatched lengths are an error */
+    EastValue *bad = call2("VectorAdd", a, ia);
+    ASSERT(bad == NULL);
+    free(east_builtin_get_error());
+
+    east_value_release(sum);
+    east_value_release(scaled);
+    east_value_release(q);
+    east_value_release(a);
+    east_value_release(b);
+    east_value_release(two);
+    east_value_release(ia);
+    east_value_release(ib);
+}
+
+TEST(vector_reductions) {
+    double xs[] = {3.0, NAN, -0.0, 0.0, -1.0};
+    EastValue *v = float_vector(xs, 5);
+    EastValue *r = call1("VectorArgMax", v);
+    ASSERT(r != NULL);
+    ASSERT_EQ_INT(r->data.integer, 1);      /* NaN sorts last */
+    east_value_release(r);
+    r = call1("VectorArgMin", v);
+    ASSERT(r != NULL);
+    ASSERT_EQ_INT(r->data.integer, 4);
+    east_value_release(r);
+
+    double zs[] = {0.0, -0.0};
+    EastValue *z = float_vector(zs, 2);
+    r = call1("VectorMin", z);
+    ASSERT(r != NULL);
+    ASSERT(r->data.float64 == 0.0 && signbit(r->data.float64));
+    east_value_release(r);
+
+    int64_t xi[100];
+    for (int i = 0; i < 100; i++) xi[i] = i + 1;
+    EastValue *iv = integer_vector(xi, 100);
+    r = call1("VectorSum", iv);
+    ASSERT(r != NULL);
+    ASSERT_EQ_INT(r->data.integer, 5050);
+    east_value_release(r);
+    r = call1("VectorMean", iv);
+    ASSERT(r != NULL);
+    ASSERT(r->data.float64 == 50.5);
+    east_value_release(r);
+    r = call2("VectorDot", iv, iv);
+    ASSERT(r != NULL);
+    ASSERT_EQ_INT(r->data.integer, 338350);
+    east_value_release(r);
+    r = call1("VectorCumulativeSum", iv);
+    ASSERT(r != NULL);
+    ASSERT_EQ_INT(((int64_t *)r->data.vector.data)[99], 5050);
+    east_value_release(r);
+
+    EastValue *empty = east_vector_new(&east_integer_type, 0);
+    r = call1("VectorMax", empty);
+    ASSERT(r == NULL);
+    free(east_builtin_get_error());
+
+    east_value_release(v);
+    east_value_release(z);
+    east_value_release(iv);
+    east_value_release(empty);
+}
+
+TEST(vector_comparisons) {
+    /* Same semantics as Equal / Less on Floats */
+    double xs[] = {NAN, -0.0, 1.0};
+    double ys[] = {NAN, 0.0, 2.0};
+    EastValue *a = float_vector(xs, 3);
+    EastValue *b = float_vector(ys, 3);
+    EastValue *eq = call2("VectorEqual", a, b);
+    ASSERT(eq != NULL);
+    ASSERT_EQ_INT(eq->data.vector.elem_type->kind, EAST_TYPE_BOOLEAN);
+    bool *e = eq->data.vector.data;
+    ASSERT(e[0] && !e[1] && !e[2]);
+    EastValue *lt = call2("VectorLess", a, b);
+    ASSERT(lt != NULL);
+    bool *l = lt->data.vector.data;
+    ASSERT(!l[0] && l[1] && l[2]);
+
+    EastValue *zero = east_float(0.0);
+    EastValue *gt = call2("VectorGreater", a, zero);
+    ASSERT(gt != NULL);
+    bool *g = gt->data.vector.data;
+    ASSERT(g[0] && !g[1] && g[2]);
+
+    east_value_release(eq);
+    east_value_release(lt);
+    east_value_release(gt);
+    east_value_release(zero);
+    east_value_release(a);
+    east_value_release(b);
+}
+
+/* ------------------------------------------------------------------ */
+/*  Matrix builtins                                                    */
+/* ------------------------------------------------------------------ */
+
+/* Deterministic values with a fractional part, so rounding order shows */
+static EastValue *test_matrix(size_t rows, size_t cols, uint64_t seed) {
+    EastValue *m = east_matrix_new(&east_float_type, rows, cols);
+    double *d = m->data.matrix.data;
+    for (size_t i = 0; i < rows * cols; i++) {
+        seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+        d[i] = (double)(seed >> 40) / 1048576.0 - 8.0;
+    }
+    return m;
+}
+
+/* MatrixMultiply must match the textbook loop bit for bit */
+static bool check_matmul(size_t m, size_t k, size_t n) {
+    EastValue *a = test_matrix(m, k, 1);
+    EastValue *b = test_matrix(k, n, 2);
+    EastValue *c = call2("MatrixMultiply", a, b);
+    bool ok = c != NULL && c->data.matrix.rows == m && c->data.matrix.cols == n;
+    const double *ad = a->data.matrix.data, *bd = b->data.matrix.data;
+    for (size_t i = 0; ok && i < m; i++) {
+        for (size_t j = 0; ok && j < n; j++) {
+            double sum = 0;
+            for (size_t p = 0; p < k; p++) sum += ad[i * k + p] * bd[p * n + j];
+            ok = ((double *)c->data.matrix.data)[i * n + j] == sum;
+        }
+    }
+    east_value_release(a);
+    east_value_release(b);
+    east_value_release(c);
+    return ok;
+}
+
+TEST(matrix_multiply) {
+    ASSERT(check_matmul(5, 7, 9));          /* partial tiles everywhere */
+    ASSERT(check_matmul(33, 300, 517));     /* several k and n blocks */
+    ASSERT(check_matmul(300, 300, 300));    /* large enough to use threads */
+
+    int64_t xa[] = {1, 2, 3, 4, 5, 6};
+    EastValue *ia = east_matrix_new(&east_integer_type, 2, 3);
+    memcpy(ia->data.matrix.data, xa, sizeof(xa));
+    EastValue *ib = east_matrix_new(&east_integer_type, 3, 2);
+    memcpy(ib->data.matrix.data, xa, sizeof(xa));
+    EastValue *ic = call2("MatrixMultiply", ia, ib);
+    ASSERT(ic != NULL);
+    int64_t *cd = ic->data.matrix.data;
+    ASSERT(cd[0] == 22 && cd[1] == 28 && cd[2] == 49 && cd[3] == 64);
+
+    /* Inner dimensions must agree */
+    EastValue *bad = call2("MatrixMultiply", ia, ia);
+    ASSERT(bad == NULL);
+    free(east_builtin_get_error());
+
+    int64_t xv[] = {1, 0, -1};
+    EastValue *v = integer_vector(xv, 3);
+    EastValue *mv = call2("MatrixVectorMultiply", ia, v);
+    ASSERT(mv != NULL);
+    ASSERT_EQ_INT((int64_t)mv->data.vector.len, 2);
+    ASSERT(((int64_t *)mv->data.vector.data)[0] == -2);
+    ASSERT(((int64_t *)mv->data.vector.data)[1] == -2);
+
+    EastValue *cs = call1("MatrixColSums", ia);
+    ASSERT(cs != NULL);
+    int64_t *csd = cs->data.vector.data;
+    ASSERT(csd[0] == 5 && csd[1] == 7 && csd[2] == 9);
+    EastValue *rm = call1("MatrixRowMeans", ia);
+    ASSERT(rm != NULL);
+    ASSERT(((double *)rm->data.vector.data)[1] == 5.0);
+
+    EastValue *two = east_integer(2);
+    EastValue *scaled = call2("MatrixElementMultiply", ia, two);
+    ASSERT(scaled != NULL);
+    ASSERT(((int64_t *)scaled->data.matrix.data)[5] == 12);
+
+    east_value_release(ia);
+    east_value_release(ib);
+    east_value_release(ic);
+    east_value_release(v);
+    east_value_release(mv);
+    east_value_release(cs);
+    east_value_release(rm);
+    east_value_release(two);
+    east_value_release(scaled);
+}
+
+TEST(matrix_solve) {
+    /* Needs a row swap: the leading entry is zero */
+    double xa[] = {0, 2, 1,
+                   1, 1, 1,
+                   2, 1, 3};
+    EastValue *a = east_matrix_new(&east_float_type, 3, 3);
+    memcpy(a->data.matrix.data, xa, sizeof(xa));
+    double xb[] = {7, 6, 13};               /* x = (1, 2, 3) */
+    EastValue *b = float_vector(xb, 3);
+    EastValue *x = call2("MatrixSolve", a, b);
+    ASSERT(x != NULL);
+    double *xd = x->data.vector.data;
+    for (int i = 0; i < 3; i++) ASSERT(fabs(xd[i] - (i + 1)) < 1e-12);
+
+    /* Symmetric positive definite, two right-hand sides */
+    double xs[] = {4, 2, 0,
+                   2, 5, 3,
+                   0, 3, 10};
+    EastValue *spd = east_matrix_new(&east_float_type, 3, 3);
+    memcpy(spd->data.matrix.data, xs, sizeof(xs));
+    double xr[] = {8, 10, 15, 18, 16, 33};   /* columns: A(1,2,1), A(2,1,3) */
+    EastValue *rhs = east_matrix_new(&east_float_type, 3, 2);
+    memcpy(rhs->data.matrix.data, xr, sizeof(xr));
+    EastValue *y = call2("MatrixCholeskySolve", spd, rhs);
+    ASSERT(y != NULL);
+    double want[] = {1, 2, 2, 1, 1, 3};
+    for (int i = 0; i < 6; i++) ASSERT(fabs(((double *)y->data.matrix.data)[i] - want[i]) < 1e-12);
+
+    double xz[] = {1, 2, 2, 4};
+    EastValue *sing = east_matrix_new(&east_float_type, 2, 2);
+    memcpy(sing->data.matrix.data, xz, sizeof(xz));
+    EastValue *b2 = float_vector(xb, 2);
+    ASSERT(call2("MatrixSolve", sing, b2) == NULL);
+    char *err = east_builtin_get_error();
+    ASSERT(err != NULL && strstr(err, "singular") != NULL);
+    free(err);
+    ASSERT(call2("MatrixCholeskySolve", sing, b2) == NULL);
+    free(east_builtin_get_error());
+
+    east_value_release(a);
+    east_value_release(b);
+    east_value_release(x);
+    east_value_release(spd);
+    east_value_release(rhs);
+    east_value_release(y);
+    east_value_release(sing);
+    east_value_release(b2);
+}
+
+TEST(matrix_transpose) {
+    /* Big enough to recurse several levels, with ragged leaves */
+    EastValue *a = test_matrix(37, 53, 3);
+    EastValue *t = call1("MatrixTranspose", a);
+    ASSERT(t != NULL);
+    ASSERT(t->data.matrix.rows == 53 && t->data.matrix.cols == 37);
+    const double *ad = a->data.matrix.data, *td = t->data.matrix.data;
+    bool same = true;
+    for (size_t r = 0; r < 37; r++)
+        for (size_t c = 0; c < 53; c++) same = same && td[c * 37 + r] == ad[r * 53 + c];
+    ASSERT(same);
+
+    EastValue *five = east_integer(5);
+    EastValue *col = call2("MatrixGetCol", a, five);
+    ASSERT(col != NULL && col->data.vector.len == 37);
+    ASSERT(memcmp(col->data.vector.data, td + 5 * 37, 37 * sizeof(double)) == 0);
+
+    EastValue *b = east_matrix_new(&east_boolean_type, 19, 40);
+    bool *bd = b->data.matrix.data;
+    for (size_t i = 0; i < 19 * 40; i++) bd[i] = i % 3 == 0;
+    EastValue *bt = call1("MatrixTranspose", b);
+    ASSERT(bt != NULL);
+    ASSERT(((bool *)bt->data.matrix.data)[7 * 19 + 2] == bd[2 * 40 + 7]);
+
+    east_value_release(a);
+    east_value_release(t);
+    east_value_release(five);
+    east_value_release(col);
+    east_value_release(b);
+    east_value_release(bt);
+}
+
+TEST(matrix_row_views) {
+    EastValue *m = test_matrix(4, 3, 4);
+    double *md = m->data.matrix.data;
+    double orig = md[3];
+
+    /* Rows share the matrix buffer */
+    EastValue *one = east_integer(1);
+    EastValue *row = call2("MatrixGetRow", m, one);
+    ASSERT(row != NULL && row->data.vector.len == 3);
+    ASSERT(row->data.vector.data == (void *)(md + 3));
+
+    /* Writing the row copies it first; the matrix is unchanged */
+    EastValue *vset[] = { row, east_integer(0), east_float(99.0) };
+    ASSERT(calln("VectorSet", vset, 3) != NULL);
+    ASSERT(((double *)row->data.vector.data)[0] == 99.0);
+    ASSERT(m->data.matrix.data == md && md[3] == orig);
+
+    /* Writing the matrix leaves rows taken earlier alone */
+    EastValue *rows = call1("MatrixToRows", m);
+    EastValue *flat = call1("MatrixToVector", m);
+    ASSERT(rows != NULL && flat != NULL);
+    EastValue *mset[] = { m, east_integer(1), east_integer(0), east_float(-1.0) };
+    ASSERT(calln("MatrixSet", mset, 4) != NULL);
+    ASSERT(((double *)m->data.matrix.data)[3] == -1.0);
+    EastValue *row1 = east_array_get(rows, 1);
+    ASSERT(((double *)row1->data.vector.data)[0] == orig);
+    ASSERT(((double *)flat->data.vector.data)[3] == orig);
+
+    /* Views outlive the matrix */
+    east_value_release(m);
+    EastValue *row3 = east_array_get(rows, 3);
+    ASSERT(((double *)row3->data.vector.data)[2] == ((double *)flat->data.vector.data)[11]);
+
+    east_value_release(one);
+    east_value_release(row);
+    east_value_release(rows);
+    east_value_release(flat);
+    for (int i = 1; i < 3; i++) east_value_release(vset[i]);
+    for (int i = 1; i < 4; i++) east_value_release(mset[i]);
+}
+
+/* ------------------------------------------------------------------ */
+/*  Patch                                                              */
+/* ------------------------------------------------------------------ */
+
+static EastValue *int_array(const int64_t *xs, size_t n) {
+    EastValue *arr = east_array_new(&east_integer_type);
+    for (size_t i = 0; i < n; i++) {
+        EastValue *v = east_integer(xs[i]);
+        east_array_push(arr, v);
+        east_value_release(v);
+    }
+    return arr;
+}
+
+TEST(diff_array_ties) {
+    /* [1, 2, 1] -> [1, 3]: the trailing 1 is the one kept */
+    EastType *arr_type = east_array_type(&east_integer_type);
+    int64_t xa[] = {1, 2, 1}, xb[] = {1, 3};
+    EastValue *a = int_array(xa, 3);
+    EastValue *b = int_array(xb, 2);
+    EastType *tp[] = {arr_type};
+    BuiltinImpl diff = builtin_registry_get(reg, "Diff", tp, 1);
+    EastValue *args[] = {a, b};
+    EastValue *patch = diff(args, 2);
+    ASSERT(patch != NULL);
+    ASSERT_EQ_STR(patch->data.variant.case_name, "patch");
+    EastValue *ops = patch->data.variant.value;
+    ASSERT_EQ_INT((int64_t)east_array_len(ops), 3);
+    const char *tags[] = {"delete", "delete", "insert"};
+    int64_t keys[] = {0, 0, 1}, vals[] = {1, 2, 3};
+    for (size_t i = 0; i < 3; i++) {
+        EastValue *op = east_array_get(ops, i);
+        EastValue *operation = east_struct_get_field(op, "operation");
+        ASSERT_EQ_STR(operation->data.variant.case_name, tags[i]);
+        ASSERT_EQ_INT(east_struct_get_field(op, "key")->data.integer, keys[i]);
+        ASSERT_EQ_INT(operation->data.variant.value->data.integer, vals[i]);
+    }
+    east_value_release(patch);
+    east_value_release(a);
+    east_value_release(b);
+    east_type_release(arr_type);
+}
+
+TEST(diff_array_columnar_inputs) {
+    /* Diff reads columnar arrays without converting them back to rows */
+    const char *names[] = {"id"};
+    EastType *types[] = {&east_integer_type};
+    EastType *st = east_struct_type(names, types, 1);
+    EastType *at = east_array_type(st);
+    EastValue *a = east_columnar_array_new(st, 0);
+    EastValue *b = east_columnar_array_new(st, 0);
+    int64_t xa[] = {1, 2, 3}, xb[] = {1, 3, 4};
+    for (size_t i = 0; i < 3; i++) {
+        EastValue *va = east_integer(xa[i]), *vb = east_integer(xb[i]);
+        EastValue *ra = east_struct_new(names, &va, 1, st);
+        EastValue *rb = east_struct_new(names, &vb, 1, st);
+        ASSERT(east_columnar_push_struct(a, ra));
+        ASSERT(east_columnar_push_struct(b, rb));
+        east_value_release(ra);
+        east_value_release(rb);
+        east_value_release(va);
+        east_value_release(vb);
+    }
+    EastType *tp[] = {at};
+    BuiltinImpl diff = builtin_registry_get(reg, "Diff", tp, 1);
+    EastValue *args[] = {a, b};
+    EastValue *patch = diff(args, 2);
+    ASSERT(patch != NULL);
+    ASSERT_EQ_STR(patch->data.variant.case_name, "patch");
+    ASSERT_EQ_INT((int64_t)east_array_len(patch->data.variant.value), 2);
+    ASSERT(east_array_columns(a) != NULL);
+    ASSERT(east_array_columns(b) != NULL);
+    east_value_release(patch);
+    east_value_release(a);
+    east_value_release(b);
+    east_type_release(at);
+    east_type_release(st);
+}
+
+TEST(diff_array_large) {
+    /* 200k elements with a handful of edits: needs the linear-space diff */
+    EastType *arr_type = east_array_type(&east_integer_type);
+    size_t n = 200000;
+    EastValue *a = east_array_new(&east_integer_type);
+    EastValue *b = east_array_new(&east_integer_type);
+    for (size_t i = 0; i < n; i++) {
+        EastValue *v = east_integer((int64_t)i);
+        east_array_push(a, v);
+        if (i % 50000 == 7) {
+            EastValue *w = east_integer(-1);        /* replace */
+            east_array_push(b, w);
+            east_value_release(w);
+        } else if (i % 40000 != 3) {                /* else delete */
+            east_array_push(b, v);
+        }
+        east_value_release(v);
+    }
+    EastType *tp[] = {arr_type};
+    BuiltinImpl diff = builtin_registry_get(reg, "Diff", tp, 1);
+    EastValue *args[] = {a, b};
+    EastValue *patch = diff(args, 2);
+    ASSERT(patch != NULL);
+    ASSERT_EQ_STR(patch->data.variant.case_name, "patch");
+    /* 4 replacements (delete + insert) and 5 deletions */
+    ASSERT_EQ_INT((int64_t)east_array_len(patch->data.variant.value), 13);
+
+    BuiltinImpl apply = builtin_registry_get(reg, "ApplyPatch", tp, 1);
+    EastValue *apply_args[] = {a, patch};
+    EastValue *applied = apply(apply_args, 2);
+    ASSERT(applied != NULL);
+    ASSERT(east_value_equal(applied, b));
+
+    east_value_release(applied);
+    east_value_release(patch);
+    east_value_release(a);
+    east_value_release(b);
+    east_type_release(arr_type);
+}
+
+TEST(diff_dict_nested_roundtrip) {
+    /* {1: [1], 2: [2], 3: [3]} -> {1: [1], 3: [3, 4]} */
+    EastType *arr_type = east_array_type(&east_integer_type);
+    EastType *dict_type = east_dict_type(&east_integer_type, arr_type);
+    EastValue *a = east_dict_new(&east_integer_type, arr_type);
+    EastValue *b = east_dict_new(&east_integer_type, arr_type);
+    for (int64_t k = 1; k <= 3; k++) {
+        EastValue *key = east_integer(k);
+        EastValue *val = int_array(&k, 1);
+        east_dict_set(a, key, val);
+        if (k != 2) east_dict_set(b, key, val);
+        east_value_release(val);
+        east_value_release(key);
+    }
+    EastType *tp[] = {dict_type};
+    BuiltinImpl diff = builtin_registry_get(reg, "Diff", tp, 1);
+    BuiltinImpl apply = builtin_registry_get(reg, "ApplyPatch", tp, 1);
+    EastValue *args[] = {a, b};
+    EastValue *patch = diff(args, 2);
+    ASSERT(patch != NULL);
+    east_value_release(patch);
+
+    /* Both sides are hashed now: give a its own [3], then grow b's in place */
+    EastValue *three = east_integer(3);
+    EastValue *four = east_integer(4);
+    int64_t x3[] = {3};
+    EastValue *fresh = int_array(x3, 1);
+    east_dict_set(a, three, fresh);
+    east_array_push(east_dict_get(b, three), four);
+
+    patch = diff(args, 2);
+    ASSERT(patch != NULL);
+    ASSERT_EQ_STR(patch->data.variant.case_name, "patch");
+    EastValue *apply_args[] = {a, patch};
+    EastValue *applied = apply(apply_args, 2);
+    ASSERT(applied != NULL);
+    ASSERT_EQ_INT((int64_t)applied->data.dict.len, 2);
+    ASSERT(east_value_equal(applied, b));
+
+    east_value_release(applied);
+    east_value_release(patch);
+    east_value_release(fresh);
+    east_value_release(three);
+    east_value_release(four);
+    east_value_release(a);
+    east_value_release(b);
+    east_type_release(dict_type);
+    east_type_release(arr_type);
+}
+
 /* ------------------------------------------------------------------ */
 /*  Main                                                               */
 /* ------------------------------------------------------------------ */
@@ -572,6 +1276,9 @@ int main(void) {
     /* String */
     RUN_TEST(string_concat);
     RUN_TEST(string_length);
+    RUN_TEST(string_search_builtins);
+    RUN_TEST(datetime_format_print_parse);
+    RUN_TEST(datetime_components);
 
     /* Comparison */
     RUN_TEST(comparison_equal);
@@ -581,6 +1288,23 @@ int main(void) {
     RUN_TEST(array_size_builtin);
     RUN_TEST(array_push_builtin);
 
+    /* Vector */
+    RUN_TEST(vector_arithmetic);
+    RUN_TEST(vector_reductions);
+    RUN_TEST(vector_comparisons);
+
+    /* Matrix */
+    RUN_TEST(matrix_multiply);
+    RUN_TEST(matrix_solve);
+    RUN_TEST(matrix_transpose);
+    RUN_TEST(matrix_row_views);
+
+    /* Patch */
+    RUN_TEST(diff_array_ties);
+    RUN_TEST(diff_array_columnar_inputs);
+    RUN_TEST(diff_array_large);
+    RUN_TEST(diff_dict_nested_roundtrip);
+
     builtin_registry_free(reg);
 
     printf("\n  %d/%d tests passed\n", tests_passed, tests_run);
@@ -3,7 +3,8 @@
  *
  * Covers: building IR nodes, compiling, and evaluating expressions
  *         including arithmetic, let-bindings, if/else, functions,
- *         while loops, for_array loops, and try/catch.
+ *         while loops, for_array loops, try/catch, program images,
+ *         the profiler and memory accounting.
  */
 
 #include <stdio.h>
@@ -12,12 +13,18 @@
 
 #include <east/types.h>
 #include <east/values.h>
+#include <east/columnar.h>
 #include <east/ir.h>
 #include <east/compiler.h>
 #include <east/builtins.h>
 #include <east/platform.h>
 #include <east/env.h>
 #include <east/gc.h>
+#include <east/ir_image.h>
+#include <east/memory.h>
+#include <east/profiler.h>
+#include <east/serialization.h>
+#include <east/type_of_type.h>
 
 static int tests_run = 0;
 static int tests_passed = 0;
@@ -688,6 +695,610 @@ TEST(struct_ir) {
     east_type_release(stype);
 }
 
+/* ------------------------------------------------------------------ */
+/*  Columnar arrays through ArrayFilter / ArraySort / ArrayMap         */
+/* ------------------------------------------------------------------ */
+
+TEST(columnar_filter_sort_map) {
+    const char *tnames[] = {"id", "tag"};
+    EastType *ttypes[] = {&east_integer_type, &east_string_type};
+    EastType *st = east_struct_type(tnames, ttypes, 2);
+    EastType *at = east_array_type(st);
+
+    /* ids are a permutation of 0..19 */
+    EastValue *cols = east_columnar_array_new(st, 0);
+    for (int64_t i = 0; i < 20; i++) {
+        EastValue *vals[2] = { east_integer(i * 7 % 20), east_string(i % 2 ? "odd" : "even") };
+        EastValue *row = east_struct_new(tnames, vals, 2, st);
+        ASSERT(east_columnar_push_struct(cols, row));
+        east_value_release(row);
+        east_value_release(vals[0]);
+        east_value_release(vals[1]);
+    }
+
+    /* ArrayFilter(cols, (row, i) => Greater(row.id, 9)) */
+    IRNode *row_var = ir_variable(st, "row", false, false);
+    IRNode *id_node = ir_get_field(&east_integer_type, row_var, "id");
+    EastValue *nine = east_integer(9);
+    IRNode *nine_node = ir_value(&east_integer_type, nine);
+    IRNode *gt_args[] = {id_node, nine_node};
+    EastType *int_tp[] = {&east_integer_type};
+    IRNode *pred_body = ir_builtin(&east_boolean_type, "Greater", int_tp, 1, gt_args, 2);
+    IRVariable params[2] = {
+        {.name = "row", .mutable = false, .captured = false},
+        {.name = "i", .mutable = false, .captured = false},
+    };
+    EastType *pred_in[] = {st, &east_integer_type};
+    EastType *pred_type = east_function_type(pred_in, 2, &east_boolean_type);
+    IRNode *pred = ir_function(pred_type, NULL, 0, params, 2, pred_body);
+    IRNode *arr_node = ir_value(at, cols);
+    IRNode *filter_args[] = {arr_node, pred};
+    IRNode *filter = ir_builtin(at, "ArrayFilter", &st, 1, filter_args, 2);
+
+    EvalResult r = eval_node(filter);
+    ASSERT_EQ_INT(r.status, EVAL_OK);
+    ASSERT(east_array_columns(r.value) != NULL);
+    ASSERT_EQ_INT(east_array_len(r.value), 10);
+    for (size_t i = 0; i < 10; i++)
+        ASSERT(east_struct_get_field(east_array_get(r.value, i), "id")->data.integer > 9);
+    /* The source rows were only built for the callback, not cached */
+    ASSERT(cols->data.array.items == NULL);
+
+    /* ArraySort(cols, row => row.id) */
+    EastType *key_in[] = {st};
+    EastType *key_type = east_function_type(key_in, 1, &east_integer_type);
+    IRNode *key_fn = ir_function(key_type, NULL, 0, params, 1, id_node);
+    IRNode *sort_args[] = {arr_node, key_fn};
+    IRNode *sort = ir_builtin(at, "ArraySort", &st, 1, sort_args, 2);
+    EvalResult sorted = eval_node(sort);
+    ASSERT_EQ_INT(sorted.status, EVAL_OK);
+    ASSERT(east_array_columns(sorted.value) != NULL);
+    for (size_t i = 0; i < 20; i++) {
+        EastValue *row = east_array_get(sorted.value, i);
+        ASSERT_EQ_INT(east_struct_get_field(row, "id")->data.integer, (int64_t)i);
+        ASSERT_EQ_STR(east_struct_get_field(row, "tag")->data.string.data,
+                      (i * 3) % 20 % 2 ? "odd" : "even");
+    }
+
+    /* ArrayMap(cols, (row, i) => {id: row.id, tag: row.tag}) stays columnar */
+    IRNode *tag_node = ir_get_field(&east_string_type, row_var, "tag");
+    char *fnames[] = {(char *)"id", (char *)"tag"};
+    IRNode *fvals[] = {id_node, tag_node};
+    IRNode *map_body = ir_struct(st, fnames, fvals, 2);
+    EastType *map_type = east_function_type(pred_in, 2, st);
+    IRNode *map_fn = ir_function(map_type, NULL, 0, params, 2, map_body);
+    IRNode *map_args[] = {arr_node, map_fn};
+    IRNode *map = ir_builtin(at, "ArrayMap", &st, 1, map_args, 2);
+    EvalResult mapped = eval_node(map);
+    ASSERT_EQ_INT(mapped.status, EVAL_OK);
+    ASSERT(east_array_columns(mapped.value) != NULL);
+    ASSERT(east_value_equal(mapped.value, cols));
+
+    east_value_release(mapped.value);
+    east_value_release(sorted.value);
+    east_value_release(r.value);
+    ir_node_release(map);
+    ir_node_release(map_fn);
+    ir_node_release(map_body);
+    ir_node_release(tag_node);
+    ir_node_release(sort);
+    ir_node_release(key_fn);
+    ir_node_release(filter);
+    ir_node_release(arr_node);
+    ir_node_release(pred);
+    ir_node_release(pred_body);
+    ir_node_release(nine_node);
+    ir_node_release(id_node);
+    ir_node_release(row_var);
+    east_type_release(map_type);
+    east_type_release(key_type);
+    east_type_release(pred_type);
+    east_value_release(nine);
+    east_value_release(cols);
+    east_type_release(at);
+    east_type_release(st);
+}
+
+/* ------------------------------------------------------------------ */
+/*  Batched platform calls through ArrayMap                            */
+/* ------------------------------------------------------------------ */
+
+static int scale_calls = 0;
+static int scale_batches = 0;
+
+static EvalResult scale_fn(EastValue **args, size_t num_args) {
+    (void)num_args;
+    scale_calls++;
+    return eval_ok(east_integer(args[0]->data.integer * 10));
+}
+
+static EvalResult scale_batch(EastValue **args, size_t num_args, size_t count,
+                              EastValue **results) {
+    scale_batches++;
+    for (size_t i = 0; i < count; i++)
+        results[i] = east_integer(args[i * num_args]->data.integer * 10);
+    return eval_ok(NULL);
+}
+
+TEST(platform_batch_array_map) {
+    platform_registry_add(platform, "scale", scale_fn, false);
+    platform_registry_set_batch(platform, "scale", scale_batch);
+    EastType *at = east_array_type(&east_integer_type);
+    EastValue *arr = east_array_new(&east_integer_type);
+    for (int64_t i = 1; i <= 5; i++) {
+        EastValue *v = east_integer(i);
+        east_array_push(arr, v);
+        east_value_release(v);
+    }
+
+    /* ArrayMap(arr, (x, i) => scale(x)): one crossing */
+    IRNode *x_var = ir_variable(&east_integer_type, "x", false, false);
+    IRNode *i_var = ir_variable(&east_integer_type, "i", false, false);
+    IRNode *call = ir_platform(&east_integer_type, "scale", NULL, 0, &x_var, 1, false, false);
+    IRVariable params[2] = {
+        {.name = "x", .mutable = false, .captured = false},
+        {.name = "i", .mutable = false, .captured = false},
+    };
+    EastType *fn_in[] = {&east_integer_type, &east_integer_type};
+    EastType *fn_type = east_function_type(fn_in, 2, &east_integer_type);
+    IRNode *map_fn = ir_function(fn_type, NULL, 0, params, 2, call);
+    IRNode *arr_node = ir_value(at, arr);
+    IRNode *map_args[] = {arr_node, map_fn};
+    EastType *int_tp[] = {&east_integer_type};
+    IRNode *map = ir_builtin(at, "ArrayMap", int_tp, 1, map_args, 2);
+
+    EvalResult r = eval_node(map);
+    ASSERT_EQ_INT(r.status, EVAL_OK);
+    ASSERT_EQ_INT(east_array_len(r.value), 5);
+    for (size_t k = 0; k < 5; k++)
+        ASSERT_EQ_INT(east_array_get(r.value, k)->data.integer, (int64_t)(k + 1) * 10);
+    ASSERT_EQ_INT(scale_batches, 1);
+    ASSERT_EQ_INT(scale_calls, 0);
+
+    /* (x, i) => scale(IntegerAdd(x, i)) calls a builtin first: one call each */
+    IRNode *add_args[] = {x_var, i_var};
+    IRNode *add = ir_builtin(&east_integer_type, "IntegerAdd", NULL, 0, add_args, 2);
+    IRNode *call2 = ir_platform(&east_integer_type, "scale", NULL, 0, &add, 1, false, false);
+    IRNode *map_fn2 = ir_function(fn_type, NULL, 0, params, 2, call2);
+    IRNode *map_args2[] = {arr_node, map_fn2};
+    IRNode *map2 = ir_builtin(at, "ArrayMap", int_tp, 1, map_args2, 2);
+    EvalResult r2 = eval_node(map2);
+    ASSERT_EQ_INT(r2.status, EVAL_OK);
+    ASSERT_EQ_INT(east_array_get(r2.value, 4)->data.integer, 90);
+    ASSERT_EQ_INT(scale_batches, 1);
+    ASSERT_EQ_INT(scale_calls, 5);
+
+    east_value_release(r2.value);
+    east_value_release(r.value);
+    ir_node_release(map2);
+    ir_node_release(map_fn2);
+    ir_node_release(call2);
+    ir_node_release(add);
+    ir_node_release(map);
+    ir_node_release(arr_node);
+    ir_node_release(map_fn);
+    ir_node_release(call);
+    ir_node_release(i_var);
+    ir_node_release(x_var);
+    east_type_release(fn_type);
+    east_value_release(arr);
+    east_type_release(at);
+}
+
+TEST(string_append_in_place) {
+    /*
+     *   let mut acc = ""
+     *   for item in pieces { acc = StringConcat(acc, item) }
+     *   let snap = acc
+     *   acc = StringConcat(acc, "!")
+     */
+    EastType *arr_type = east_array_type(&east_string_type);
+    EastValue *pieces = east_array_new(&east_string_type);
+    const char *words[] = {"ab", "cd", "\xC3\xA9", "ef"};
+    for (int i = 0; i < 40; i++) {
+        EastValue *w = east_string(words[i % 4]);
+        east_array_push(pieces, w);
+        east_value_release(w);
+    }
+    EastValue *empty = east_string("");
+    EastValue *bang = east_string("!");
+    IRNode *lit_pieces = ir_value(arr_type, pieces);
+    IRNode *lit_empty = ir_value(&east_string_type, empty);
+    IRNode *lit_bang = ir_value(&east_string_type, bang);
+    east_value_release(pieces);
+    east_value_release(empty);
+    east_value_release(bang);
+
+    IRNode *let_acc = ir_let(&east_null_type, "acc", true, false, lit_empty);
+    IRNode *acc1 = ir_variable(&east_string_type, "acc", true, false);
+    IRNode *item = ir_variable(&east_string_type, "item", false, false);
+    IRNode *cat1_args[] = {acc1, item};
+    IRNode *cat1 = ir_builtin(&east_string_type, "StringConcat", NULL, 0, cat1_args, 2);
+    IRNode *append = ir_assign(&east_null_type, "acc", cat1);
+    IRNode *loop = ir_for_array(&east_null_type, "item", NULL, lit_pieces, append, NULL);
+    IRNode *acc2 = ir_variable(&east_string_type, "acc", true, false);
+    IRNode *let_snap = ir_let(&east_null_type, "snap", false, false, acc2);
+    IRNode *acc3 = ir_variable(&east_string_type, "acc", true, false);
+    IRNode *cat2_args[] = {acc3, lit_bang};
+    IRNode *cat2 = ir_builtin(&east_string_type, "StringConcat", NULL, 0, cat2_args, 2);
+    IRNode *bang_assign = ir_assign(&east_null_type, "acc", cat2);
+    IRNode *stmts[] = {let_acc, loop, let_snap, bang_assign};
+    IRNode *block = ir_block(&east_null_type, stmts, 4);
+
+    Environment *env = env_new(NULL);
+    EvalResult r = eval_ir(block, env, platform, builtins);
+    ASSERT_EQ_INT(r.status, EVAL_OK);
+    east_value_release(r.value);
+
+    /* The loop grew one buffer; appending to a shared value copies and
+     * the alias keeps its bytes */
+    EastValue *acc = env_get(env, "acc");
+    EastValue *snap = env_get(env, "snap");
+    ASSERT_EQ_INT((int64_t)snap->data.string.len, 80);
+    ASSERT(!snap->payload_inline && snap->data.string.cap > 80);
+    ASSERT(strncmp(snap->data.string.data, "abcd\xC3\xA9""efab", 10) == 0);
+    ASSERT_EQ_INT((int64_t)east_string_cp_len(snap), 70);
+    ASSERT_EQ_INT((int64_t)acc->data.string.len, 81);
+    ASSERT(strncmp(acc->data.string.data, snap->data.string.data, 80) == 0);
+    ASSERT_EQ_STR(acc->data.string.data + 80, "!");
+
+    /* Growing in place drops the cached codepoint count */
+    EastValue *tail = east_string("\xC3\xA9");
+    ASSERT(east_string_append(snap, tail->data.string.data, tail->data.string.len));
+    ASSERT_EQ_INT((int64_t)east_string_cp_len(snap), 71);
+    east_value_release(tail);
+
+    env_release(env);
+    ir_node_release(block);
+    ir_node_release(let_acc);
+    ir_node_release(loop);
+    ir_node_release(let_snap);
+    ir_node_release(bang_assign);
+    ir_node_release(append);
+    ir_node_release(cat1);
+    ir_node_release(cat2);
+    ir_node_release(acc1);
+    ir_node_release(acc2);
+    ir_node_release(acc3);
+    ir_node_release(item);
+    ir_node_release(lit_pieces);
+    ir_node_release(lit_empty);
+    ir_node_release(lit_bang);
+    east_type_release(arr_type);
+}
+
+/* ------------------------------------------------------------------ */
+/*  Program image round trip                                           */
+/* ------------------------------------------------------------------ */
+
+TEST(ir_image_roundtrip) {
+    /* { let add = fn(a, b) { IntegerAdd(a, b) }; add(3, 4) } with a
+     * location on the call and the function type shared by two nodes. */
+    IRNode *var_a = ir_variable(&east_integer_type, "a", false, false);
+    IRNode *var_b = ir_variable(&east_integer_type, "b", false, false);
+    IRNode *body_args[] = {var_a, var_b};
+    IRNode *body = ir_builtin(&east_integer_type, "IntegerAdd", NULL, 0, body_args, 2);
+
+    IRVariable params[2] = {
+        {.name = "a", .mutable = false, .captured = false},
+        {.name = "b", .mutable = false, .captured = false},
+    };
+    EastType *inp[] = {&east_integer_type, &east_integer_type};
+    EastType *fn_type = east_function_type(inp, 2, &east_integer_type);
+    IRNode *fn_node = ir_function(fn_type, NULL, 0, params, 2, body);
+    IRNode *let_add = ir_let(&east_null_type, "add", false, false, fn_node);
+
+    IRNode *var_add = ir_variable(fn_type, "add", false, false);
+    EastValue *v3 = east_integer(3);
+    EastValue *v4 = east_integer(4);
+    IRNode *arg3 = ir_value(&east_integer_type, v3);
+    IRNode *arg4 = ir_value(&east_integer_type, v4);
+    IRNode *call_args[] = {arg3, arg4};
+    IRNode *call = ir_call(&east_integer_type, var_add, call_args, 2);
+    EastLocation loc = {.filename = "prog.east", .line = 2, .column = 5};
+    ir_node_set_location(call, &loc, 1);
+
+    IRNode *stmts[] = {let_add, call};
+    IRNode *block = ir_block(&east_integer_type, stmts, 2);
+
+    ByteBuffer *img = east_ir_image_encode(block, 42);
+    ASSERT(img != NULL);
+
+    /* Wrong source hash and truncated data are rejected. */
+    ASSERT(east_ir_image_decode(img->data, img->len, 43) == NULL);
+    ASSERT(east_ir_image_decode(img->data, img->len - 1, 42) == NULL);
+
+    IRNode *loaded = east_ir_image_decode(img->data, img->len, 42);
+    ASSERT(loaded != NULL);
+    ASSERT_EQ_INT(loaded->kind, IR_BLOCK);
+    ASSERT_EQ_INT(loaded->data.block.num_stmts, 2);
+
+    IRNode *loaded_call = loaded->data.block.stmts[1];
+    ASSERT_EQ_INT(loaded_call->num_locations, 1);
+    ASSERT_EQ_STR(loaded_call->locations[0].filename, "prog.east");
+    ASSERT_EQ_INT(loaded_call->locations[0].line, 2);
+    ASSERT_EQ_INT(loaded_call->locations[0].column, 5);
+    ASSERT(east_type_equal(loaded_call->data.call.func->type, fn_type));
+
+    EvalResult r = eval_node(loaded);
+    ASSERT_EQ_INT(r.status, EVAL_OK);
+    ASSERT_EQ_INT(r.value->data.integer, 7);
+
+    east_value_release(r.value);
+    ir_node_release(loaded);
+    byte_buffer_free(img);
+    ir_node_release(block);
+    ir_node_release(let_add);
+    ir_node_release(call);
+    ir_node_release(var_add);
+    ir_node_release(fn_node);
+    ir_node_release(body);
+    ir_node_release(var_a);
+    ir_node_release(var_b);
+    ir_node_release(arg3);
+    ir_node_release(arg4);
+    east_value_release(v3);
+    east_value_release(v4);
+    east_type_release(fn_type);
+}
+
+/* fn() { fn(x) { x } } as IR text: the inner function keeps its source */
+#define SRC_LOC "location=[(filename=\"test\", line=1, column=1)]"
+#define SRC_X ".Variable (type=.Integer, " SRC_LOC ", name=\"x\", mutable=false, captured=false)"
+static const char *nested_fn_program =
+    ".Function (type=.Function (inputs=[], output=.Function (inputs=[.Integer], output=.Integer)), "
+    SRC_LOC ", captures=[], parameters=[], "
+    "body=.Function (type=.Function (inputs=[.Integer], output=.Integer), " SRC_LOC ", "
+    "captures=[], parameters=[" SRC_X "], body=" SRC_X "))";
+
+TEST(ir_image_function_source) {
+    east_type_of_type_init();
+    EastValue *ir_val = east_parse_value(nested_fn_program, east_ir_type);
+    ASSERT(ir_val != NULL);
+    IRNode *ir = east_ir_from_value(ir_val);
+    east_value_release(ir_val);
+    ASSERT(ir != NULL);
+
+    ByteBuffer *img = east_ir_image_encode(ir, 7);
+    ASSERT(img != NULL);
+    IRNode *loaded = east_ir_image_decode(img->data, img->len, 7);
+    ASSERT(loaded != NULL);
+
+    /* The inner function's source is decoded with the image; the root's
+     * is dropped, since the root never becomes a closure value. */
+    ASSERT(loaded->data.function.source_ir == NULL);
+    IRNode *inner = loaded->data.function.body;
+    ASSERT_EQ_INT(inner->kind, IR_FUNCTION);
+    ASSERT(inner->data.function.source_ir != NULL);
+    ASSERT(east_value_equal(inner->data.function.source_ir,
+                            ir->data.function.body->data.function.source_ir));
+
+    /* Re-imaging a loaded tree carries the source again */
+    ByteBuffer *img2 = east_ir_image_encode(loaded, 7);
+    ASSERT(img2 != NULL);
+    ASSERT_EQ_INT((int64_t)img2->len, (int64_t)img->len);
+    ASSERT(memcmp(img2->data, img->data, img->len) == 0);
+
+    byte_buffer_free(img2);
+    ir_node_release(loaded);
+    byte_buffer_free(img);
+    ir_node_release(ir);
+}
+
+TEST(ir_image_recursive_type) {
+    /* List = Recursive(Variant { cons: Struct { head: Integer, tail: List }, nil: Null }) */
+    EastType *rec = east_recursive_type_new();
+    const char *field_names[] = {"head", "tail"};
+    EastType *field_types[] = {&east_integer_type, rec};
+    EastType *cons = east_struct_type(field_names, field_types, 2);
+    const char *case_names[] = {"cons", "nil"};
+    EastType *case_types[] = {cons, &east_null_type};
+    EastType *variant = east_variant_type(case_names, case_types, 2);
+    east_type_release(cons);
+    east_recursive_type_set(rec, variant);
+    east_recursive_type_finalize(rec);
+
+    EastType *arr = east_array_type(rec);
+    IRNode *node = ir_new_array(arr, NULL, 0);
+
+    ByteBuffer *img = east_ir_image_encode(node, 0);
+    ASSERT(img != NULL);
+    IRNode *loaded = east_ir_image_decode(img->data, img->len, 0);
+    ASSERT(loaded != NULL);
+    ASSERT(east_type_equal(loaded->type, arr));
+
+    /* Images cut inside the Recursive type fail cleanly */
+    for (size_t n = 0; n < img->len; n++) {
+        ASSERT(east_ir_image_decode(img->data, n, 0) == NULL);
+    }
+
+    ir_node_release(loaded);
+    byte_buffer_free(img);
+    ir_node_release(node);
+    east_type_release(arr);
+    east_type_release(rec);
+}
+
+/* ------------------------------------------------------------------ */
+/*  Profiler                                                           */
+/* ------------------------------------------------------------------ */
+
+TEST(profiler_folded_stacks) {
+    /* fn(a, b) { IntegerAdd(a, b) } called twice under the profiler */
+    IRNode *var_a = ir_variable(&east_integer_type, "a", false, false);
+    IRNode *var_b = ir_variable(&east_integer_type, "b", false, false);
+    IRNode *body_args[] = {var_a, var_b};
+    IRNode *body = ir_builtin(&east_integer_type, "IntegerAdd", NULL, 0, body_args, 2);
+    EastLocation loc = {.filename = "add.east", .line = 1, .column = 3};
+    ir_node_set_location(body, &loc, 1);
+
+    IRVariable params[2] = {
+        {.name = "a", .mutable = false, .captured = false},
+        {.name = "b", .mutable = false, .captured = false},
+    };
+    EastType *inp[] = {&east_integer_type, &east_integer_type};
+    EastType *fn_type = east_function_type(inp, 2, &east_integer_type);
+    IRNode *fn_node = ir_function(fn_type, NULL, 0, params, 2, body);
+
+    Environment *env = env_new(NULL);
+    EvalResult fn_res = eval_ir(fn_node, env, platform, builtins);
+    ASSERT_EQ_INT(fn_res.status, EVAL_OK);
+
+    EastProfiler *prof = east_profiler_new();
+    east_profiler_start(prof);
+    EastValue *a1 = east_integer(1);
+    EastValue *a2 = east_integer(2);
+    EastValue *call_args[] = {a1, a2};
+    for (int i = 0; i < 2; i++) {
+        EvalResult r = east_call(fn_res.value->data.function.compiled, call_args, 2);
+        ASSERT_EQ_INT(r.status, EVAL_OK);
+        ASSERT_EQ_INT(r.value->data.integer, 3);
+        east_value_release(r.value);
+    }
+    east_profiler_stop(prof);
+    ASSERT(east_profiler_active == NULL);
+    ASSERT(east_profiler_total_ns(prof) > 0);
+
+    FILE *f = tmpfile();
+    ASSERT(f != NULL);
+    ASSERT(east_profiler_write_folded(prof, f));
+    rewind(f);
+    char line[512];
+    bool saw_builtin = false, saw_gc = false;
+    while (fgets(line, sizeof(line), f)) {
+        if (strncmp(line, "[east];fn add.east:1:3;IntegerAdd ", 34) == 0) saw_builtin = true;
+        if (strncmp(line, "[east];[gc] ", 12) == 0) saw_gc = true;
+    }
+    fclose(f);
+    ASSERT(saw_builtin);
+    ASSERT(saw_gc);
+
+    east_profiler_free(prof);
+    east_value_release(a1);
+    east_value_release(a2);
+    east_value_release(fn_res.value);
+    env_release(env);
+    ir_node_release(fn_node);
+    ir_node_release(body);
+    ir_node_release(var_a);
+    ir_node_release(var_b);
+    east_type_release(fn_type);
+}
+
+/* ------------------------------------------------------------------ */
+/*  Memory accounting                                                  */
+/* ------------------------------------------------------------------ */
+
+TEST(memory_accounting) {
+    east_mem_enable();
+    EastMemStats strings0 = east_mem_value_kind(EAST_VAL_STRING);
+    EastMemStats arrays0 = east_mem_value_kind(EAST_VAL_ARRAY);
+    EastMemStats values0 = east_mem_subsystem(EAST_MEM_VALUES);
+
+    EastValue *arr = east_array_new(&east_string_type);
+    for (int i = 0; i < 100; i++) {
+        EastValue *s = east_string("0123456789");
+        east_array_push(arr, s);
+        east_value_release(s);
+    }
+    EastMemStats strings1 = east_mem_value_kind(EAST_VAL_STRING);
+    EastMemStats arrays1 = east_mem_value_kind(EAST_VAL_ARRAY);
+    ASSERT_EQ_INT(strings1.objects - strings0.objects, 100);
+    /* Short strings are stored inside the value */
+    ASSERT_EQ_INT(strings1.live - strings0.live, 100 * sizeof(EastValue));
+    EastValue *long_str = east_string("0123456789012345678901234567890123456789");
+    ASSERT_EQ_INT(east_mem_value_kind(EAST_VAL_STRING).live - strings1.live,
+                  sizeof(EastValue) + 41);
+    east_value_release(long_str);
+    ASSERT_EQ_INT(arrays1.objects - arrays0.objects, 1);
+    ASSERT(arrays1.live - arrays0.live >= sizeof(EastValue) + 100 * sizeof(EastValue *));
+
+    east_value_release(arr);
+    ASSERT_EQ_INT(east_mem_value_kind(EAST_VAL_STRING).live, strings0.live);
+    ASSERT_EQ_INT(east_mem_value_kind(EAST_VAL_ARRAY).objects, arrays0.objects);
+    EastMemStats values2 = east_mem_subsystem(EAST_MEM_VALUES);
+    ASSERT_EQ_INT(values2.live, values0.live);
+    ASSERT(values2.peak >= values0.live + strings1.live - strings0.live);
+
+    /* A builtin call site shows up in the report */
+    EastValue *str_v = east_string("ab");
+    IRNode *str = ir_value(&east_string_type, str_v);
+    east_value_release(str_v);
+    EastValue *count_v = east_integer(1000);
+    IRNode *count = ir_value(&east_integer_type, count_v);
+    east_value_release(count_v);
+    IRNode *rep_args[] = {str, count};
+    IRNode *rep = ir_builtin(&east_string_type, "StringRepeat", NULL, 0, rep_args, 2);
+    EastLocation loc = {.filename = "mem.east", .line = 4, .column = 2};
+    ir_node_set_location(rep, &loc, 1);
+    Environment *env = env_new(NULL);
+    EvalResult r = eval_ir(rep, env, platform, builtins);
+    ASSERT_EQ_INT(r.status, EVAL_OK);
+    east_value_release(r.value);
+
+    FILE *f = tmpfile();
+    ASSERT(f != NULL);
+    east_mem_write_report(f, 0);
+    rewind(f);
+    char line[512];
+    bool saw_site = false, saw_kind = false;
+    while (fgets(line, sizeof(line), f)) {
+        if (strstr(line, "StringRepeat mem.east:4:2")) saw_site = true;
+        if (strstr(line, "String")) saw_kind = true;
+    }
+    fclose(f);
+    ASSERT(saw_site);
+    ASSERT(saw_kind);
+
+    env_release(env);
+    ir_node_release(rep);
+    ir_node_release(str);
+    ir_node_release(count);
+    east_mem_reset();
+    east_mem_disable();
+}
+
+TEST(memory_soft_limit) {
+    east_mem_enable();
+    east_mem_set_limit(east_mem_total().live + 64 * 1024);
+
+    /* StringRepeat("x", 1 MiB) exceeds the limit and raises an East error */
+    EastValue *str_v = east_string("x");
+    IRNode *str = ir_value(&east_string_type, str_v);
+    east_value_release(str_v);
+    EastValue *count_v = east_integer(1 << 20);
+    IRNode *count = ir_value(&east_integer_type, count_v);
+    east_value_release(count_v);
+    IRNode *rep_args[] = {str, count};
+    IRNode *rep = ir_builtin(&east_string_type, "StringRepeat", NULL, 0, rep_args, 2);
+    Environment *env = env_new(NULL);
+    EvalResult r = eval_ir(rep, env, platform, builtins);
+    ASSERT_EQ_INT(r.status, EVAL_ERROR);
+    ASSERT(r.error_message != NULL);
+    ASSERT(strstr(r.error_message, "Memory limit exceeded") != NULL);
+    eval_result_free(&r);
+
+    /* The oversized result was freed, so small work succeeds again */
+    EastValue *small_v = east_integer(3);
+    IRNode *small = ir_value(&east_integer_type, small_v);
+    east_value_release(small_v);
+    IRNode *small_args[] = {str, small};
+    IRNode *rep2 = ir_builtin(&east_string_type, "StringRepeat", NULL, 0, small_args, 2);
+    r = eval_ir(rep2, env, platform, builtins);
+    ASSERT_EQ_INT(r.status, EVAL_OK);
+    ASSERT(strcmp(r.value->data.string.data, "xxx") == 0);
+    east_value_release(r.value);
+
+    east_mem_set_limit(0);
+    east_mem_disable();
+    env_release(env);
+    ir_node_release(rep2);
+    ir_node_release(small);
+    ir_node_release(rep);
+    ir_node_release(str);
+    ir_node_release(count);
+}
+
 /* ------------------------------------------------------------------ */
 /*  Main                                                               */
 /* ------------------------------------------------------------------ */
@@ -716,6 +1327,15 @@ int main(void) {
     RUN_TEST(undefined_variable_error);
     RUN_TEST(new_array_ir);
     RUN_TEST(struct_ir);
+    RUN_TEST(columnar_filter_sort_map);
+    RUN_TEST(platform_batch_array_map);
+    RUN_TEST(string_append_in_place);
+    RUN_TEST(ir_image_roundtrip);
+    RUN_TEST(ir_image_function_source);
+    RUN_TEST(ir_image_recursive_type);
+    RUN_TEST(profiler_folded_stacks);
+    RUN_TEST(memory_accounting);
+    RUN_TEST(memory_soft_limit);
 
     builtin_registry_free(builtins);
     platform_registry_free(platform);
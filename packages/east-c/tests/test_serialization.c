@@ -9,13 +9,16 @@
  * will detect NULL returns and skip gracefully.
  */
 
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
+#include <east/numparse.h>
 #include <east/types.h>
 #include <east/values.h>
 #include <east/serialization.h>
+#include <east/columnar.h>
 
 static int tests_run = 0;
 static int tests_passed = 0;
@@ -340,6 +343,141 @@ TEST(beast2_array_roundtrip) {
     byte_buffer_free(buf);
 }
 
+/* ------------------------------------------------------------------ */
+/*  Columnar Array<Struct> (CSV / BEAST2 decode)                       */
+/* ------------------------------------------------------------------ */
+
+/* Array<{id: Integer, name: String, score: Option<Float>}> in rows */
+static EastType *rows_type(void) {
+    const char *case_names[] = {"none", "some"};
+    EastType *case_types[] = {&east_null_type, &east_float_type};
+    EastType *opt = east_variant_type(case_names, case_types, 2);
+    const char *names[] = {"id", "name", "score"};
+    EastType *types[] = {&east_integer_type, &east_string_type, opt};
+    EastType *st = east_struct_type(names, types, 3);
+    EastType *at = east_array_type(st);
+    east_type_release(st);
+    east_type_release(opt);
+    return at;
+}
+
+static EastValue *sample_rows(EastType *at, size_t n) {
+    static const char *labels[] = {"alpha", "beta", "gamma, delta"};
+    EastType *st = at->data.element;
+    EastType *opt = st->data.struct_.fields[2].type;
+    const char *names[] = {"id", "name", "score"};
+    EastValue *arr = east_array_new(st);
+    for (size_t i = 0; i < n; i++) {
+        EastValue *vals[3];
+        vals[0] = east_integer((int64_t)i * 7 - 50);
+        vals[1] = east_string(labels[i % 3]);
+        EastValue *f = east_float((double)i * 0.5);
+        vals[2] = i % 4 == 3 ? east_variant_new("none", east_null(), opt)
+                             : east_variant_new("some", f, opt);
+        east_value_release(f);
+        EastValue *row = east_struct_new(names, vals, 3, st);
+        east_array_push(arr, row);
+        east_value_release(row);
+        for (int j = 0; j < 3; j++) east_value_release(vals[j]);
+    }
+    return arr;
+}
+
+TEST(beast2_header_split) {
+    /* Full encoding == header + headerless value bytes */
+    EastType *type = east_array_type(&east_string_type);
+    EastValue *v = east_array_new(&east_string_type);
+    EastValue *s = east_string("hello");
+    east_array_push(v, s);
+    east_value_release(s);
+
+    ByteBuffer *full = east_beast2_encode_full(v, type);
+    ByteBuffer *header = east_beast2_encode_header(type);
+    ByteBuffer *body = east_beast2_encode(v, type);
+    ASSERT(full && header && body);
+    ASSERT(full->len == header->len + body->len);
+    ASSERT(memcmp(full->data, header->data, header->len) == 0);
+    ASSERT(memcmp(full->data + header->len, body->data, body->len) == 0);
+
+    size_t header_len = 0;
+    EastType *decoded_type = east_beast2_decode_header(full->data, full->len, &header_len);
+    ASSERT(decoded_type != NULL);
+    ASSERT(header_len == header->len);
+    ASSERT(east_type_equal(decoded_type, type));
+    ASSERT(east_beast2_decode_header(body->data, body->len, &header_len) == NULL);
+
+    east_type_release(decoded_type);
+    byte_buffer_free(full);
+    byte_buffer_free(header);
+    byte_buffer_free(body);
+    east_value_release(v);
+    east_type_release(type);
+}
+
+TEST(beast2_columnar_roundtrip) {
+    EastType *at = rows_type();
+    EastValue *rows = sample_rows(at, 100);
+    ByteBuffer *buf = east_beast2_encode(rows, at);
+    ASSERT(buf != NULL);
+
+    EastValue *cols = east_beast2_decode(buf->data, buf->len, at);
+    ASSERT(cols != NULL);
+    ASSERT(east_array_columns(cols) != NULL);
+    ASSERT_EQ_INT(east_array_columns(cols)->cols[1].num_strings, 3);
+    ASSERT(east_value_equal(rows, cols));
+    ASSERT(east_value_hash(rows) == east_value_hash(cols));
+
+    /* Encoding from the columns gives the same bytes */
+    ByteBuffer *again = east_beast2_encode(cols, at);
+    ASSERT(again != NULL);
+    ASSERT_EQ_INT(again->len, buf->len);
+    ASSERT(memcmp(again->data, buf->data, buf->len) == 0);
+
+    EastValue *row = east_array_get(cols, 3);
+    EastValue *score = east_struct_get_field(row, "score");
+    ASSERT_EQ_STR(score->data.variant.case_name, "none");
+    ASSERT_EQ_INT(east_struct_get_field(row, "id")->data.integer, -29);
+
+    /* Mutation switches back to rows and keeps the contents */
+    east_array_push(cols, row);
+    ASSERT(east_array_columns(cols) == NULL);
+    ASSERT_EQ_INT(east_array_len(cols), 101);
+    ASSERT(east_value_equal(east_array_get(cols, 100), east_array_get(rows, 3)));
+
+    byte_buffer_free(again);
+    byte_buffer_free(buf);
+    east_value_release(cols);
+    east_value_release(rows);
+    east_type_release(at);
+}
+
+TEST(csv_columnar_roundtrip) {
+    EastType *at = rows_type();
+    EastValue *rows = sample_rows(at, 50);
+    char *csv = east_csv_encode(rows, at, NULL);
+    ASSERT(csv != NULL);
+
+    EastValue *cols = east_csv_decode(csv, at, NULL);
+    ASSERT(cols != NULL);
+    ASSERT(east_array_columns(cols) != NULL);
+    ASSERT(east_value_equal(rows, cols));
+
+    char *again = east_csv_encode(cols, at, NULL);
+    ASSERT(again != NULL);
+    ASSERT_EQ_STR(again, csv);
+
+    /* Materializing keeps the same values */
+    east_array_materialize(cols);
+    ASSERT(east_array_columns(cols) == NULL);
+    ASSERT(east_value_equal(rows, cols));
+
+    free(again);
+    free(csv);
+    east_value_release(cols);
+    east_value_release(rows);
+    east_type_release(at);
+}
+
 /* ------------------------------------------------------------------ */
 /*  East text format round-trip tests                                  */
 /* ------------------------------------------------------------------ */
@@ -439,6 +577,265 @@ TEST(east_text_array_roundtrip) {
     free(text);
 }
 
+TEST(east_text_shared_containers) {
+    EastType *inner_t = east_array_type(&east_integer_type);
+    EastType *outer_t = east_array_type(inner_t);
+    EastValue *inner = east_array_new(&east_integer_type);
+    EastValue *copy = east_array_new(&east_integer_type);
+    for (int64_t k = 1; k <= 2; k++) {
+        EastValue *iv = east_integer(k);
+        east_array_push(inner, iv);
+        east_array_push(copy, iv);
+        east_value_release(iv);
+    }
+
+    /* inner is held elsewhere but reached once: printed in full */
+    EastValue *distinct = east_array_new(inner_t);
+    east_array_push(distinct, inner);
+    east_array_push(distinct, copy);
+    char *text = east_print_value(distinct, outer_t);
+    ASSERT(text != NULL);
+    ASSERT_EQ_STR(text, "[[1, 2], [1, 2]]");
+    free(text);
+
+    /* Reached twice: the second occurrence is a backreference */
+    EastValue *shared = east_array_new(inner_t);
+    east_array_push(shared, inner);
+    east_array_push(shared, inner);
+    text = east_print_value(shared, outer_t);
+    ASSERT(text != NULL);
+    ASSERT_EQ_STR(text, "[[1, 2], 1#[0]]");
+    EastValue *decoded = east_parse_value(text, outer_t);
+    ASSERT(decoded != NULL);
+    ASSERT(east_array_get(decoded, 0) == east_array_get(decoded, 1));
+    free(text);
+
+    east_value_release(decoded);
+    east_value_release(shared);
+    east_value_release(distinct);
+    east_value_release(copy);
+    east_value_release(inner);
+    east_type_release(outer_t);
+    east_type_release(inner_t);
+}
+
+/* Hands out the text a few bytes at a time */
+typedef struct {
+    const char *text;
+    size_t len;
+    size_t pos;
+    size_t chunk;
+} ChunkReader;
+
+static size_t read_chunks(void *ctx, char *buf, size_t cap)
+{
+    ChunkReader *r = ctx;
+    size_t n = r->len - r->pos;
+    if (n > r->chunk) n = r->chunk;
+    if (n > cap) n = cap;
+    memcpy(buf, r->text + r->pos, n);
+    r->pos += n;
+    return n;
+}
+
+TEST(east_text_stream_chunks) {
+    EastType *rows_t = east_array_type(&east_integer_type);
+    EastType *grid_t = east_array_type(rows_t);
+    const char *names[] = {"name", "v", "rows"};
+    const char *cases[] = {"A", "B"};
+    EastType *case_types[] = {&east_integer_type, &east_null_type};
+    EastType *var_t = east_variant_type(cases, case_types, 2);
+    EastType *types[] = {&east_string_type, var_t, grid_t};
+    EastType *st = east_struct_type(names, types, 3);
+
+    const char *text =
+        "(name=\"say \\\"hi\\\" \\\\ bye\nnext\", # comment\n"
+        " v=.A 42, rows=[[1, 2], 1#[0], [-3]])";
+    EastValue *whole = east_parse_value(text, st);
+    ASSERT(whole != NULL);
+    for (size_t chunk = 1; chunk <= 7; chunk++) {
+        ChunkReader r = { text, strlen(text), 0, chunk };
+        char *err = NULL;
+        EastValue *v = east_parse_value_stream(read_chunks, &r, st, &err);
+        ASSERT(v != NULL);
+        ASSERT(err == NULL);
+        ASSERT(east_value_equal(v, whole));
+        /* The backreference still aliases the first row */
+        EastValue *rows = east_struct_get_field(v, "rows");
+        ASSERT(east_array_get(rows, 0) == east_array_get(rows, 1));
+        east_value_release(v);
+    }
+
+    east_value_release(whole);
+    east_type_release(st);
+    east_type_release(var_t);
+    east_type_release(grid_t);
+    east_type_release(rows_t);
+}
+
+TEST(east_text_stream_errors) {
+    EastType *arr_t = east_array_type(&east_string_type);
+    const char *inputs[] = {
+        "[\"ok\", \"bad \\q escape\"]",
+        "[\"ok\", \"unterminated",
+        "[\"ends in escape\\",
+        "[\"a\"] \"trailing\"",
+        "[\"a\", 1]",
+        "[\"a\"",
+    };
+    for (size_t i = 0; i < sizeof(inputs) / sizeof(inputs[0]); i++) {
+        char *expected = NULL;
+        EastValue *v = east_parse_value_with_error(inputs[i], arr_t, &expected);
+        ASSERT(v == NULL);
+        ASSERT(expected != NULL);
+        for (size_t chunk = 1; chunk <= 4; chunk += 3) {
+            ChunkReader r = { inputs[i], strlen(inputs[i]), 0, chunk };
+            char *err = NULL;
+            v = east_parse_value_stream(read_chunks, &r, arr_t, &err);
+            ASSERT(v == NULL);
+            ASSERT(err != NULL);
+            ASSERT_EQ_STR(err, expected);
+            free(err);
+        }
+        free(expected);
+    }
+
+    char *err = NULL;
+    EastValue *v = east_parse_value_with_error("[\"ok\", \"bad \\q\"]", arr_t, &err);
+    ASSERT(v == NULL);
+    ASSERT_EQ_STR(err, "Error occurred because unexpected escape sequence in string "
+                       "at [1] (line 1, col 14) while parsing value of type \".Array .String\"");
+    free(err);
+    east_type_release(arr_t);
+}
+
+/* ------------------------------------------------------------------ */
+/*  Number parsing (shared by the JSON, CSV and East text decoders)    */
+/* ------------------------------------------------------------------ */
+
+static bool same_double(double a, double b) { return memcmp(&a, &b, sizeof(a)) == 0; }
+
+TEST(parse_double_matches_strtod) {
+    static const char *cases[] = {
+        "0", "-0", "1", "-1.5", "+.5", "7.", "0.1", "1e23", "8.41e21",
+        "9007199254740993", "2.2250738585072011e-308", "2.2250738585072014e-308",
+        "4.9406564584124654e-324", "2.4703282292062327e-324", "2.4703282292062328e-324",
+        "1.7976931348623157e308", "1.7976931348623159e308", "1e-400", "1e400",
+        "0.000000000000000000000000000000000000000001234567890123456789012345",
+        "123456789012345678901234567890e-10",
+        "1e", "1e+", "2.5E-", "3.e2x", "12,5",
+    };
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        const char *s = cases[i];
+        char *end;
+        double want = strtod(s, &end);
+        double got = 0.0;
+        ASSERT_EQ_INT(east_parse_double(s, strlen(s), &got), end - s);
+        ASSERT(same_double(got, want));
+    }
+
+    /* Not numbers */
+    double v = 42.0;
+    ASSERT_EQ_INT(east_parse_double("", 0, &v), 0);
+    ASSERT_EQ_INT(east_parse_double("-", 1, &v), 0);
+    ASSERT_EQ_INT(east_parse_double(".e1", 3, &v), 0);
+    ASSERT_EQ_INT(east_parse_double(" 1", 2, &v), 0);
+    ASSERT_EQ_INT(east_parse_double("inf", 3, &v), 0);
+    ASSERT(v == 42.0);
+    /* The length bounds the read */
+    ASSERT_EQ_INT(east_parse_double("1.25e3", 4, &v), 4);
+    ASSERT(v == 1.25);
+
+    /* Random digit strings, up to 40 digits, against strtod */
+    uint64_t st = 0x9E3779B97F4A7C15ull;
+    char buf[96];
+    for (int it = 0; it < 200000; it++) {
+        st ^= st << 13; st ^= st >> 7; st ^= st << 17;
+        uint64_t r = st;
+        int n = 0, digits = 1 + (int)(r % 40), dot = (int)((r >> 8) % 42);
+        if (r & (1u << 16)) buf[n++] = '-';
+        for (int k = 0; k < digits; k++) {
+            if (k == dot) buf[n++] = '.';
+            buf[n++] = (char)('0' + (r >> (20 + k % 40)) % 10);
+        }
+        if (r & (1ull << 17)) n += snprintf(buf + n, 16, "e%d", (int)((r >> 40) % 700) - 350);
+        buf[n] = '\0';
+        char *end;
+        double want = strtod(buf, &end);
+        double got;
+        ASSERT_EQ_INT(east_parse_double(buf, (size_t)n, &got), end - buf);
+        ASSERT(same_double(got, want));
+    }
+}
+
+TEST(parse_int64_limits) {
+    int64_t v;
+    bool overflow;
+    ASSERT_EQ_INT(east_parse_int64("9223372036854775807", 19, &v, &overflow), 19);
+    ASSERT(v == INT64_MAX && !overflow);
+    ASSERT_EQ_INT(east_parse_int64("-9223372036854775808", 20, &v, &overflow), 20);
+    ASSERT(v == INT64_MIN && !overflow);
+    ASSERT_EQ_INT(east_parse_int64("9223372036854775808", 19, &v, &overflow), 19);
+    ASSERT(v == INT64_MAX && overflow);
+    ASSERT_EQ_INT(east_parse_int64("-99999999999999999999999", 24, &v, &overflow), 24);
+    ASSERT(v == INT64_MIN && overflow);
+    ASSERT_EQ_INT(east_parse_int64("+0012x", 6, &v, &overflow), 5);
+    ASSERT(v == 12 && !overflow);
+    ASSERT_EQ_INT(east_parse_int64("-", 1, &v, NULL), 0);
+    ASSERT_EQ_INT(east_parse_int64(" 1", 2, &v, NULL), 0);
+}
+
+TEST(decoders_parse_numbers) {
+    char *err = NULL;
+
+    /* JSON numbers longer than any fixed buffer are still read exactly */
+    char json[320] = "0.";
+    memset(json + 2, '0', 280);
+    strcpy(json + 282, "15625e280");
+    EastValue *f = east_json_decode(json, &east_float_type);
+    ASSERT(f != NULL);
+    ASSERT(same_double(f->data.float64, 0.15625));
+    east_value_release(f);
+
+    EastValue *i = east_json_decode_with_error("\"-9223372036854775808\"", &east_integer_type, &err);
+    ASSERT(i != NULL);
+    ASSERT(i->data.integer == INT64_MIN);
+    east_value_release(i);
+    static const char *out_of_range[] = {"\"9223372036854775808\"", "\"007\"", "\"+1\"", "\"-0\""};
+    for (size_t k = 0; k < 4; k++) {
+        ASSERT(east_json_decode_with_error(out_of_range[k], &east_integer_type, &err) == NULL);
+        ASSERT(err != NULL && strstr(err, "integer out of range") != NULL);
+        free(err);
+        err = NULL;
+    }
+    ASSERT(east_json_decode_with_error("\"12a\"", &east_integer_type, &err) == NULL);
+    ASSERT(err != NULL && strstr(err, "expected string representing integer") != NULL);
+    free(err);
+    err = NULL;
+
+    /* CSV integers outside 64 bits are an error rather than saturating */
+    EastType *at = rows_type();
+    ASSERT(east_csv_decode_with_error("id,name,score\n99999999999999999999,a,1.5\n",
+                                      at, NULL, &err) == NULL);
+    ASSERT(err != NULL && strstr(err, "out of range") != NULL);
+    free(err);
+    err = NULL;
+    ASSERT(east_csv_decode_with_error("id,name,score\n1,a,1.5x\n", at, NULL, &err) == NULL);
+    ASSERT(err != NULL && strstr(err, "expected float") != NULL);
+    free(err);
+    east_type_release(at);
+
+    /* East text */
+    EastValue *g = east_parse_value("2.2250738585072011e-308", &east_float_type);
+    ASSERT(g != NULL);
+    ASSERT(same_double(g->data.float64, strtod("2.2250738585072011e-308", NULL)));
+    east_value_release(g);
+    EastValue *h = east_parse_value("-9223372036854775808", &east_integer_type);
+    ASSERT(h != NULL);
+    ASSERT(h->data.integer == INT64_MIN);
+    east_value_release(h);
+}
+
 /* ------------------------------------------------------------------ */
 /*  Binary utility tests (varint/zigzag -- always available)           */
 /* ------------------------------------------------------------------ */
@@ -557,6 +954,11 @@ int main(void) {
     RUN_TEST(beast2_string_roundtrip);
     RUN_TEST(beast2_boolean_roundtrip);
     RUN_TEST(beast2_array_roundtrip);
+    RUN_TEST(beast2_header_split);
+    RUN_TEST(beast2_columnar_roundtrip);
+
+    /* CSV */
+    RUN_TEST(csv_columnar_roundtrip);
 
     /* East text format */
     RUN_TEST(east_text_integer_roundtrip);
@@ -564,6 +966,14 @@ int main(void) {
     RUN_TEST(east_text_boolean_roundtrip);
     RUN_TEST(east_text_null_roundtrip);
     RUN_TEST(east_text_array_roundtrip);
+    RUN_TEST(east_text_shared_containers);
+    RUN_TEST(east_text_stream_chunks);
+    RUN_TEST(east_text_stream_errors);
+
+    /* Number parsing */
+    RUN_TEST(parse_double_matches_strtod);
+    RUN_TEST(parse_int64_limits);
+    RUN_TEST(decoders_parse_numbers);
 
     /* Binary utilities (always available) */
     RUN_TEST(varint_roundtrip);
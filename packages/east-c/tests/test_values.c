@@ -5,6 +5,8 @@
  *         collections, structs, variants, and printing.
  */
 
+#include <math.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -135,6 +137,39 @@ TEST(string_len) {
     east_value_release(v);
 }
 
+TEST(string_codepoint_index) {
+    EastValue *a = east_string("plain ascii text");
+    ASSERT(east_string_is_ascii(a));
+    ASSERT_EQ_INT((int64_t)east_string_cp_len(a), 16);
+    ASSERT_EQ_INT((int64_t)east_string_cp_to_byte(a, 6), 6);
+    ASSERT_EQ_INT((int64_t)east_string_cp_to_byte(a, 99), 16);
+    east_value_release(a);
+
+    /* Long enough for index marks: 1-, 2-, 3- and 4-byte codepoints */
+    char buf[4096];
+    size_t len = 0;
+    const char *pieces[] = {"a", "\xC3\xA9", "\xE2\x82\xAC", "\xF0\x9F\x98\x80"};
+    for (int i = 0; i < 400; i++) {
+        size_t pl = strlen(pieces[i % 4]);
+        memcpy(buf + len, pieces[i % 4], pl);
+        len += pl;
+    }
+    EastValue *u = east_string_len(buf, len);
+    ASSERT(!east_string_is_ascii(u));
+    ASSERT_EQ_INT((int64_t)east_string_cp_len(u), 400);
+    size_t byte = 0;
+    for (size_t cp = 0; cp < 400; cp++) {
+        ASSERT_EQ_INT((int64_t)east_string_cp_to_byte(u, cp), (int64_t)byte);
+        ASSERT_EQ_INT((int64_t)east_string_byte_to_cp(u, byte), (int64_t)cp);
+        /* Inside a sequence: counts the codepoint that starts before it */
+        if (cp % 4) ASSERT_EQ_INT((int64_t)east_string_byte_to_cp(u, byte + 1), (int64_t)cp + 1);
+        byte += cp % 4 + 1;
+    }
+    ASSERT_EQ_INT((int64_t)east_string_cp_to_byte(u, 400), (int64_t)len);
+    ASSERT_EQ_INT((int64_t)east_string_byte_to_cp(u, len), 400);
+    east_value_release(u);
+}
+
 TEST(datetime_value) {
     EastValue *v = east_datetime(1700000000000LL);
     ASSERT(v != NULL);
@@ -567,6 +602,47 @@ TEST(ref_create_get_set) {
     east_value_release(r);
 }
 
+/* ------------------------------------------------------------------ */
+/*  Structural hashing                                                 */
+/* ------------------------------------------------------------------ */
+
+static EastValue *wrap_in_struct(EastValue *arr) {
+    const char *names[] = {"items"};
+    EastValue *vals[] = {arr};
+    return east_struct_new(names, vals, 1, NULL);
+}
+
+TEST(hash_cache_follows_mutation) {
+    EastValue *one = east_integer(1);
+    EastValue *two = east_integer(2);
+    EastValue *arr_a = east_array_new(&east_integer_type);
+    EastValue *arr_b = east_array_new(&east_integer_type);
+    east_array_push(arr_a, one);
+    east_array_push(arr_b, one);
+    EastValue *a = wrap_in_struct(arr_a);
+    EastValue *b = wrap_in_struct(arr_b);
+
+    uint64_t h = east_value_hash(a);
+    ASSERT(h == east_value_hash(b));
+    ASSERT(east_value_equal(a, b));
+
+    /* Mutating a nested array must not leave a stale hash on the parent */
+    east_array_push(arr_a, two);
+    ASSERT(east_value_hash(a) != h);
+    ASSERT(!east_value_equal(a, b));
+
+    east_array_push(arr_b, two);
+    ASSERT(east_value_equal(a, b));
+    ASSERT(east_value_hash(a) == east_value_hash(b));
+
+    east_value_release(one);
+    east_value_release(two);
+    east_value_release(arr_a);
+    east_value_release(arr_b);
+    east_value_release(a);
+    east_value_release(b);
+}
+
 /* ------------------------------------------------------------------ */
 /*  Ref counting                                                       */
 /* ------------------------------------------------------------------ */
@@ -745,6 +821,81 @@ TEST(print_dict) {
     east_value_release(d);
 }
 
+/* ------------------------------------------------------------------ */
+/*  Float formatting                                                   */
+/* ------------------------------------------------------------------ */
+
+TEST(fmt_double_cases) {
+    /* Expected strings are JavaScript's String(x) */
+    static const struct { double v; const char *s; } cases[] = {
+        {1.0, "1"}, {-1.5, "-1.5"}, {0.1, "0.1"}, {0.1 + 0.2, "0.30000000000000004"},
+        {100.0, "100"}, {123456789012345680000.0, "123456789012345680000"},
+        {1e21, "1e+21"}, {1.5e300, "1.5e+300"}, {0.000001, "0.000001"},
+        {1.234e-7, "1.234e-7"}, {-0.0, "0"}, {5e-324, "5e-324"},
+        {1.7976931348623157e308, "1.7976931348623157e+308"},
+        {2.2250738585072014e-308, "2.2250738585072014e-308"},
+        {9007199254740993.0, "9007199254740992"}, {0.3, "0.3"},
+        {2.0 / 3.0, "0.6666666666666666"},
+        /* 2^-296: the shortest digits are not the correctly rounded ones */
+        {0x1p-296, "7.854549544476363e-90"},
+        {0x1p-140, "7.174648137343064e-43"},
+    };
+    char buf[64];
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        int n = east_fmt_double(buf, sizeof(buf), cases[i].v);
+        ASSERT_EQ_STR(buf, cases[i].s);
+        ASSERT_EQ_INT(n, (int64_t)strlen(cases[i].s));
+    }
+    east_fmt_double(buf, sizeof(buf), NAN);
+    ASSERT_EQ_STR(buf, "NaN");
+    east_fmt_double(buf, sizeof(buf), -INFINITY);
+    ASSERT_EQ_STR(buf, "-Infinity");
+}
+
+/* Significant digits in a formatted number */
+static int significant_digits(const char *s) {
+    int k = 0, zeros = 0;
+    bool leading = true;
+    for (; *s && *s != 'e'; s++) {
+        if (*s < '0' || *s > '9') continue;
+        if (*s == '0') {
+            if (!leading) zeros++;
+            continue;
+        }
+        leading = false;
+        k += zeros + 1;
+        zeros = 0;
+    }
+    return k;
+}
+
+TEST(fmt_double_round_trip) {
+    /* Random bit patterns plus every power of two and its neighbours:
+     * the output must read back exactly and be no longer than the
+     * shortest correctly rounded %e form that does */
+    uint64_t x = 88172645463325252ULL;
+    char buf[64], ebuf[40];
+    for (int i = 0; i < 50000 + 3 * 2098; i++) {
+        double v;
+        if (i < 50000) {
+            x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+            memcpy(&v, &x, sizeof(v));
+        } else {
+            int j = i - 50000;
+            v = ldexp(1.0, j / 3 - 1074);
+            if (j % 3 == 1) v = nextafter(v, 0);
+            if (j % 3 == 2) v = nextafter(v, INFINITY);
+        }
+        if (isnan(v) || isinf(v) || v == 0) continue;
+        east_fmt_double(buf, sizeof(buf), v);
+        ASSERT(strtod(buf, NULL) == v);
+        int prec = 0;
+        do snprintf(ebuf, sizeof(ebuf), "%.*e", prec++, v);
+        while (strtod(ebuf, NULL) != v);
+        ASSERT(significant_digits(buf) <= prec);
+    }
+}
+
 /* ------------------------------------------------------------------ */
 /*  Kind name                                                          */
 /* ------------------------------------------------------------------ */
@@ -776,6 +927,7 @@ int main(void) {
     RUN_TEST(string_empty);
     RUN_TEST(string_null_arg);
     RUN_TEST(string_len);
+    RUN_TEST(string_codepoint_index);
     RUN_TEST(datetime_value);
     RUN_TEST(blob_value);
 
@@ -818,6 +970,9 @@ int main(void) {
     /* Refs */
     RUN_TEST(ref_create_get_set);
 
+    /* Structural hashing */
+    RUN_TEST(hash_cache_follows_mutation);
+
     /* Ref counting */
     RUN_TEST(refcount_basic);
     RUN_TEST(refcount_null_singleton);
@@ -838,6 +993,10 @@ int main(void) {
     RUN_TEST(print_variant_null_payload);
     RUN_TEST(print_dict);
 
+    /* Float formatting */
+    RUN_TEST(fmt_double_cases);
+    RUN_TEST(fmt_double_round_trip);
+
     /* Kind name */
     RUN_TEST(kind_name);
 